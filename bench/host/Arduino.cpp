@@ -0,0 +1,98 @@
+/***************************************************************************************
+ * Host stand-in for the parts of the Arduino/ESP32 core used by ytGraph
+ * Platform: Linux (PlatformIO native)
+ *
+ *  - delay() does not sleep, it only advances millis()/micros()
+ *  - random() is a fixed seed xorshift, so every benchmark run sees the same data
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   host framebuffer backend for benchmarks
+****************************************************************************************/
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <chrono>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static uint64_t delayedMicros = 0;    // time "spent" in delay()
+static uint32_t randState = 2463534242u; // xorshift32 state
+
+static uint64_t steadyMicros()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis() { return (unsigned long)((steadyMicros() + delayedMicros) / 1000); }
+unsigned long micros() { return (unsigned long)(steadyMicros() + delayedMicros); }
+void delay(unsigned long ms) { delayedMicros += (uint64_t)ms * 1000; }
+
+void randomSeed(unsigned long seed) { randState = seed ? (uint32_t)seed : 2463534242u; }
+
+long random(long howbig)
+{
+  if (howbig <= 0)
+    return 0;
+  randState ^= randState << 13;
+  randState ^= randState >> 17;
+  randState ^= randState << 5;
+  return randState % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+  if (howsmall >= howbig)
+    return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(int n) { return printf("%d", n); }
+size_t Print::print(unsigned int n) { return printf("%u", n); }
+size_t Print::print(long n) { return printf("%ld", n); }
+size_t Print::print(unsigned long n) { return printf("%lu", n); }
+size_t Print::print(double n, int digits) { return printf("%.*f", digits, n); }
+size_t Print::println() { return print("\r\n"); }
+size_t Print::println(const char *s) { return print(s) + println(); }
+size_t Print::println(int n) { return print(n) + println(); }
+size_t Print::println(double n, int digits) { return print(n, digits) + println(); }
+
+size_t Print::printf(const char *format, ...)
+{
+  char buf[128];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  return write((const uint8_t *)buf, (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1);
+}
+
+size_t HardwareSerial::write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+
+uint32_t EspClass::getHeapSize() { return 327680; }
+uint32_t EspClass::getFreeHeap() { return 262144; }
+uint32_t EspClass::getMinFreeHeap() { return 245760; }
+uint32_t EspClass::getMaxAllocHeap() { return 114676; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(steadyMicros() * 240); } // 240 MHz core
+uint32_t EspClass::getCpuFreqMHz() { return 240; }
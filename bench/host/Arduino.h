@@ -0,0 +1,78 @@
+/***************************************************************************************
+ * Host stand-in for the parts of the Arduino/ESP32 core used by ytGraph
+ * Platform: Linux (PlatformIO native)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   host framebuffer backend for benchmarks
+****************************************************************************************/
+
+#ifndef YTGRAPH_HOST_ARDUINO_h
+#define YTGRAPH_HOST_ARDUINO_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define PROGMEM
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class Print // minimal Arduino Print, everything ends up in write()
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(int n);
+  size_t print(unsigned int n);
+  size_t print(long n);
+  size_t print(unsigned long n);
+  size_t print(double n, int digits = 2);
+  size_t println();
+  size_t println(const char *s);
+  size_t println(int n);
+  size_t println(double n, int digits = 2);
+  size_t printf(const char *format, ...);
+};
+
+class HardwareSerial : public Print // Serial goes to stdout
+{
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+};
+
+class EspClass // heap figures of a M5Stack core (no PSRAM), cycle counter from steady clock
+{
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz();
+};
+
+extern HardwareSerial Serial;
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,40 @@
+/***************************************************************************************
+ * Host stand-in for the M5Stack library (display part only)
+ * Platform: Linux (PlatformIO native)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   host framebuffer backend for benchmarks
+****************************************************************************************/
+
+#ifndef YTGRAPH_HOST_M5STACK_h
+#define YTGRAPH_HOST_M5STACK_h
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+class M5Display : public TFT_eSPI
+{
+};
+
+class M5Stack
+{
+public:
+  struct
+  {
+    void begin() {}
+  } Power;
+  M5Display Lcd;
+
+  void begin() {}
+};
+
+extern M5Stack M5;
+
+#endif
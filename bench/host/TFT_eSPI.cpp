@@ -0,0 +1,610 @@
+/***************************************************************************************
+ * Host stand-in for the TFT_eSPI display and sprite classes used by ytGraph
+ * Platform: Linux (PlatformIO native)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   host framebuffer backend for benchmarks
+****************************************************************************************/
+
+#include <TFT_eSPI.h>
+#include <M5Stack.h>
+#include <chrono>
+
+thread_local hostStats hostCounters{};
+uint32_t hostSpiClock = 0;
+M5Stack M5;
+
+void hostStatsReset()
+{
+  hostCounters = hostStats{};
+}
+
+static const uint16_t default4bitPalette[16] = { // same order as in TFT_eSPI
+    TFT_BLACK, TFT_BROWN, TFT_RED, TFT_ORANGE, TFT_YELLOW, TFT_GREEN, TFT_BLUE, TFT_PURPLE,
+    TFT_DARKGREY, TFT_WHITE, TFT_CYAN, TFT_MAGENTA, TFT_MAROON, TFT_DARKGREEN, TFT_NAVY, TFT_PINK};
+
+static uint8_t glyphColumn(char c, int col) // deterministic stand-in for a 5x7 font
+{
+  if (c == ' ')
+    return 0;
+  uint32_t h = (uint32_t)(uint8_t)c * 2654435761u + (uint32_t)col * 40503u;
+  return (uint8_t)(((h >> 13) & 0x7F) | 0x01);
+}
+
+/***************************************************************************************
+ * panel
+****************************************************************************************/
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : _width(w), _height(h), _fb(nullptr), _cursorX(0), _cursorY(0),
+      _textSize(1), _textDatum(TL_DATUM), _textColor(TFT_WHITE), _textBgColor(TFT_WHITE),
+      _cmd(0), _argc(0), _args{}, _tfa(0), _vsa(0), _vsp(0)
+{
+  if (w > 0 && h > 0)
+    _fb = (uint16_t *)calloc((size_t)w * h, sizeof(uint16_t));
+}
+
+TFT_eSPI::~TFT_eSPI()
+{
+  free(_fb);
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return;
+  _fb[x + y * _width] = color;
+  hostCounters.pixelWrites++;
+  hostCounters.pushBytes += 2;
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y)
+{
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return 0;
+  return _fb[x + y * _width];
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  for (int32_t i = 0; i < w; i++)
+    drawPixel(x + i, y, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  for (int32_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  for (int32_t i = 0; i < h; i++)
+    drawFastHLine(x, y + i, w, color);
+}
+
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+  // same Bresenham split into fast H/V runs as TFT_eSPI, so pixel results match the device
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  int32_t t;
+  if (steep)
+  {
+    t = x0, x0 = y0, y0 = t;
+    t = x1, x1 = y1, y1 = t;
+  }
+  if (x0 > x1)
+  {
+    t = x0, x0 = x1, x1 = t;
+    t = y0, y0 = y1, y1 = t;
+  }
+
+  int32_t dx = x1 - x0, dy = abs(y1 - y0);
+  int32_t err = dx >> 1, ystep = -1, xs = x0, dlen = 0;
+  if (y0 < y1)
+    ystep = 1;
+
+  if (steep)
+  {
+    for (; x0 <= x1; x0++)
+    {
+      dlen++;
+      err -= dy;
+      if (err < 0)
+      {
+        err += dx;
+        if (dlen == 1)
+          drawPixel(y0, xs, color);
+        else
+          drawFastVLine(y0, xs, dlen, color);
+        dlen = 0;
+        y0 += ystep;
+        xs = x0 + 1;
+      }
+    }
+    if (dlen)
+      drawFastVLine(y0, xs, dlen, color);
+  }
+  else
+  {
+    for (; x0 <= x1; x0++)
+    {
+      dlen++;
+      err -= dy;
+      if (err < 0)
+      {
+        err += dx;
+        if (dlen == 1)
+          drawPixel(xs, y0, color);
+        else
+          drawFastHLine(xs, y0, dlen, color);
+        dlen = 0;
+        y0 += ystep;
+        xs = x0 + 1;
+      }
+    }
+    if (dlen)
+      drawFastHLine(xs, y0, dlen, color);
+  }
+}
+
+void TFT_eSPI::drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+{
+  int32_t byteWidth = (w + 7) / 8;
+  for (int32_t j = 0; j < h; j++)
+    for (int32_t i = 0; i < w; i++)
+      if (bitmap[j * byteWidth + i / 8] & (1 << (i & 7))) // XBM is LSB first
+        drawPixel(x + i, y + j, color);
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
+{
+  for (int32_t j = 0; j < h; j++)
+  {
+    int32_t py = y + j;
+    if (py < 0 || py >= _height)
+      continue;
+    for (int32_t i = 0; i < w; i++)
+    {
+      int32_t px = x + i;
+      if (px >= 0 && px < _width)
+        _fb[px + py * _width] = data[i + j * w];
+    }
+  }
+  hostCounters.pushBytes += (uint64_t)w * h * 2;
+  if (hostSpiClock) // 16 clocks per pixel
+  {
+    auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds((uint64_t)w * h * 16 * 1000000000ull / hostSpiClock);
+    while (std::chrono::steady_clock::now() < until)
+      ;
+  }
+}
+
+void TFT_eSPI::writecommand(uint8_t c)
+{
+  _cmd = c;
+  _argc = 0;
+  if (c == 0x13) // normal mode, scrolling off
+    _tfa = _vsa = _vsp = 0;
+  hostCounters.pushBytes += 1;
+}
+
+void TFT_eSPI::writedata(uint8_t d)
+{
+  if (_argc < sizeof(_args))
+    _args[_argc++] = d;
+  if (_cmd == 0x33 && _argc == 6)
+  {
+    _tfa = (_args[0] << 8) | _args[1];
+    _vsa = (_args[2] << 8) | _args[3];
+  }
+  else if (_cmd == 0x37 && _argc == 2)
+    _vsp = (_args[0] << 8) | _args[1];
+  hostCounters.pushBytes += 1;
+}
+
+uint16_t TFT_eSPI::readDisplayed(int32_t x, int32_t y)
+{
+  // in landscape the panel memory lines are the screen columns
+  if (_vsa && x >= _tfa && x < _tfa + _vsa)
+    x = _tfa + (x - _tfa + _vsp - _tfa + _vsa) % _vsa;
+  return readPixel(x, y);
+}
+
+void TFT_eSPI::drawGlyph(int32_t x, int32_t y, char c, int sx, int sy, bool fillBg)
+{
+  for (int col = 0; col < 6; col++)
+  {
+    uint8_t bits = col < 5 ? glyphColumn(c, col) : 0;
+    for (int row = 0; row < 8; row++)
+    {
+      bool on = row < 7 && (bits & (1 << row));
+      if (on || fillBg)
+        fillRect(x + col * sx, y + row * sy, sx, sy, on ? _textColor : _textBgColor);
+    }
+  }
+}
+
+size_t TFT_eSPI::write(uint8_t c)
+{
+  if (c == '\n')
+  {
+    _cursorX = 0;
+    _cursorY += 8 * _textSize;
+  }
+  else if (c != '\r')
+  {
+    drawGlyph(_cursorX, _cursorY, (char)c, _textSize, _textSize, _textBgColor != _textColor);
+    _cursorX += 6 * _textSize;
+  }
+  return 1;
+}
+
+int16_t TFT_eSPI::textWidth(const char *string, uint8_t font)
+{
+  return (int16_t)strlen(string) * (font == 2 ? 8 : 6) * _textSize;
+}
+
+int16_t TFT_eSPI::fontHeight(uint8_t font)
+{
+  return (font == 2 ? 16 : 8) * _textSize;
+}
+
+int16_t TFT_eSPI::drawString(const char *string, int32_t x, int32_t y, uint8_t font)
+{
+  int16_t w = textWidth(string, font);
+  int16_t h = fontHeight(font);
+  int sx = _textSize;
+  int sy = (font == 2 ? 2 : 1) * _textSize;
+
+  switch (_textDatum % 3) // horizontal alignment
+  {
+  case 1:
+    x -= w / 2;
+    break;
+  case 2:
+    x -= w;
+    break;
+  }
+  switch (_textDatum / 3) // vertical alignment
+  {
+  case 1:
+    y -= h / 2;
+    break;
+  case 2:
+    y -= h;
+    break;
+  }
+
+  for (const char *p = string; *p; p++)
+  {
+    drawGlyph(x, y, *p, sx, sy, _textBgColor != _textColor);
+    x += (font == 2 ? 8 : 6) * _textSize;
+  }
+  return w;
+}
+
+/***************************************************************************************
+ * sprite
+****************************************************************************************/
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI *tft)
+    : TFT_eSPI(0, 0), _tft(tft), _created(false), _bpp(16), _iwidth(0), _iheight(0),
+      _dwidth(0), _dheight(0), _bitwidth(0), _img8(nullptr), _img(nullptr), _img4(nullptr), _img8_1(nullptr),
+      _img8_2(nullptr), _colorMap(nullptr), _bitmapFg(TFT_WHITE), _bitmapBg(TFT_BLACK), _sx(0), _sy(0), _sw(0), _sh(0),
+      _scolor(TFT_BLACK), _lastColor(TFT_BLACK), _lastIndex(0)
+{
+}
+
+TFT_eSprite::~TFT_eSprite()
+{
+  deleteSprite();
+}
+
+void *TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t)
+{
+  if (_created)
+    return _img8;
+  if (w < 1 || h < 1)
+    return nullptr;
+
+  _dwidth = _iwidth = w;
+  _dheight = _iheight = h;
+  _bitwidth = (w + 7) & 0xFFF8;
+  if (_bpp == 1)
+    _iwidth = _bitwidth;
+
+  size_t bytes;
+  if (_bpp == 16)
+    bytes = (size_t)w * h * 2;
+  else if (_bpp == 4)
+  {
+    _iwidth = (w + 1) & 0xFFFE; // two pixels per byte, rows start on a byte
+    bytes = (size_t)_iwidth * h / 2;
+  }
+  else
+    bytes = (size_t)_bitwidth * h / 8;
+
+  _img8 = (uint8_t *)calloc(bytes, 1);
+  if (!_img8)
+    return nullptr;
+  _img = (uint16_t *)_img8;
+  _img4 = _img8_1 = _img8_2 = _img8;
+  _created = true;
+  if (_bpp == 4 && !_colorMap)
+    createPalette(default4bitPalette);
+  setScrollRect(0, 0, _dwidth, _dheight, TFT_BLACK);
+  return _img8;
+}
+
+void TFT_eSprite::deleteSprite()
+{
+  free(_colorMap); // the palette goes first, also of a sprite that is not created
+  _colorMap = nullptr;
+  if (!_created)
+    return;
+  free(_img8_1);
+  _img8 = _img4 = _img8_1 = _img8_2 = nullptr;
+  _img = nullptr;
+  _created = false;
+}
+
+void TFT_eSprite::createPalette(const uint16_t *colorMap, uint8_t colors)
+{
+  if (!_created)
+    return;
+  if (!colorMap)
+    colorMap = default4bitPalette;
+  if (!_colorMap)
+    _colorMap = (uint16_t *)calloc(16, sizeof(uint16_t));
+  for (uint8_t i = 0; i < 16; i++)
+    _colorMap[i] = i < colors ? colorMap[i] : 0;
+  _lastColor = _colorMap[0]; // colorToIndex() cache
+  _lastIndex = 0;
+}
+
+void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if (x < 0)
+    w += x, x = 0;
+  if (y < 0)
+    h += y, y = 0;
+  if (x + w > _dwidth)
+    w = _dwidth - x;
+  if (y + h > _dheight)
+    h = _dheight - y;
+  if (w < 1 || h < 1)
+    return;
+  _sx = x, _sy = y, _sw = w, _sh = h;
+  _scolor = color;
+}
+
+uint8_t TFT_eSprite::colorToIndex(uint16_t color)
+{
+  if (!_colorMap)
+    return 0; // no palette, every colour is index 0
+  if (color == _lastColor)
+    return _lastIndex;
+
+  // exact palette match first, otherwise the nearest palette colour
+  uint8_t best = 0;
+  int32_t bestDist = INT32_MAX;
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    uint16_t p = _colorMap[i];
+    int32_t dr = ((p >> 11) & 0x1F) - ((color >> 11) & 0x1F);
+    int32_t dg = ((p >> 5) & 0x3F) - ((color >> 5) & 0x3F);
+    int32_t db = (p & 0x1F) - (color & 0x1F);
+    int32_t dist = 4 * dr * dr + dg * dg + 4 * db * db;
+    if (dist < bestDist)
+      best = i, bestDist = dist;
+    if (dist == 0)
+      break;
+  }
+  _lastColor = color;
+  _lastIndex = best;
+  return best;
+}
+
+uint16_t TFT_eSprite::rawPixel(int32_t x, int32_t y)
+{
+  if (_bpp == 16)
+  {
+    uint16_t c = _img[x + y * _iwidth];
+    return (c >> 8) | (c << 8);
+  }
+  if (_bpp == 4)
+  {
+    uint8_t b = _img8[(x + y * _iwidth) >> 1];
+    return getPaletteColor((x & 1) ? (b & 0x0F) : (b >> 4));
+  }
+  return (_img8[(x + y * _bitwidth) >> 3] & (0x80 >> (x & 7))) ? _bitmapFg : _bitmapBg;
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y)
+{
+  if (!_created || x < 0 || y < 0 || x >= _dwidth || y >= _dheight)
+    return 0xFFFF;
+  return rawPixel(x, y);
+}
+
+void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (!_created || x < 0 || y < 0 || x >= _dwidth || y >= _dheight)
+    return;
+
+  if (_bpp == 16)
+    _img[x + y * _iwidth] = (uint16_t)((color >> 8) | (color << 8)); // TFT_eSPI keeps sprites byte swapped
+  else if (_bpp == 4)
+  {
+    uint8_t c = colorToIndex(color);
+    uint8_t &b = _img8[(x + y * _iwidth) >> 1];
+    b = (x & 1) ? (b & 0xF0) | c : (b & 0x0F) | (c << 4);
+  }
+  else
+  {
+    uint8_t &b = _img8[(x + y * _bitwidth) >> 3];
+    if (color)
+      b |= 0x80 >> (x & 7);
+    else
+      b &= ~(0x80 >> (x & 7));
+  }
+  hostCounters.pixelWrites++;
+}
+
+void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  if (!_created || y < 0 || y >= _dheight)
+    return;
+  if (x < 0)
+    w += x, x = 0;
+  if (x + w > _dwidth)
+    w = _dwidth - x;
+  if (w < 1)
+    return;
+
+  if (_bpp == 16)
+  {
+    uint16_t c = (uint16_t)((color >> 8) | (color << 8));
+    uint16_t *p = _img + x + y * _iwidth;
+    for (int32_t i = 0; i < w; i++)
+      p[i] = c;
+    hostCounters.pixelWrites += w;
+  }
+  else
+  {
+    for (int32_t i = 0; i < w; i++)
+      drawPixel(x + i, y, color);
+  }
+}
+
+void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  if (!_created || x < 0 || x >= _dwidth)
+    return;
+  if (y < 0)
+    h += y, y = 0;
+  if (y + h > _dheight)
+    h = _dheight - y;
+  for (int32_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  if (y < 0)
+    h += y, y = 0;
+  if (y + h > _dheight)
+    h = _dheight - y;
+  for (int32_t i = 0; i < h; i++)
+    drawFastHLine(x, y + i, w, color);
+}
+
+void TFT_eSprite::scroll(int16_t dx, int16_t dy)
+{
+  if (!_created || abs(dx) >= _sw || abs(dy) >= _sh)
+  {
+    fillRect(_sx, _sy, _sw, _sh, _scolor);
+    return;
+  }
+
+  // move the scroll window content pixel by pixel, as TFT_eSPI does for 1 and 4 bit sprites
+  int32_t w = _sw - abs(dx), h = _sh - abs(dy);
+  int32_t srcX = _sx + (dx < 0 ? -dx : 0), dstX = _sx + (dx > 0 ? dx : 0);
+  int32_t srcY = _sy + (dy < 0 ? -dy : 0), dstY = _sy + (dy > 0 ? dy : 0);
+  for (int32_t j = 0; j < h; j++)
+  {
+    int32_t y = dy > 0 ? h - 1 - j : j; // copy away from the destination
+    if (_bpp == 16)
+    {
+      memmove(_img + dstX + (dstY + y) * _iwidth, _img + srcX + (srcY + y) * _iwidth, w * 2);
+      hostCounters.pixelWrites += w;
+    }
+    else
+    {
+      for (int32_t i = 0; i < w; i++)
+      {
+        int32_t x = dx > 0 ? w - 1 - i : i;
+        drawPixel(dstX + x, dstY + y, rawPixel(srcX + x, srcY + y));
+      }
+    }
+  }
+
+  // fill the area that was scrolled in
+  if (dx < 0)
+    fillRect(_sx + _sw + dx, _sy, -dx, _sh, _scolor);
+  else if (dx > 0)
+    fillRect(_sx, _sy, dx, _sh, _scolor);
+  if (dy < 0)
+    fillRect(_sx, _sy + _sh + dy, _sw, -dy, _scolor);
+  else if (dy > 0)
+    fillRect(_sx, _sy, _sw, dy, _scolor);
+}
+
+void TFT_eSprite::pushRegion(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh,
+                             bool useTransparent, uint16_t transparent)
+{
+  if (!_created || !_tft)
+    return;
+  hostCounters.pushCount++;
+
+  uint16_t line[1024];
+  if (sw > 1024)
+    sw = 1024;
+  for (int32_t j = 0; j < sh; j++)
+  {
+    int32_t i = 0;
+    while (i < sw)
+    {
+      if (useTransparent) // skip transparent pixels, send only the visible runs
+      {
+        while (i < sw && rawPixel(sx + i, sy + j) == transparent)
+          i++;
+      }
+      int32_t start = i;
+      while (i < sw)
+      {
+        uint16_t c = rawPixel(sx + i, sy + j);
+        if (useTransparent && c == transparent)
+          break;
+        line[i - start] = c;
+        i++;
+      }
+      if (i > start)
+        _tft->pushImage(tx + start, ty + j, i - start, 1, line);
+    }
+  }
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y)
+{
+  pushRegion(x, y, 0, 0, _dwidth, _dheight, false, 0);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transparent)
+{
+  pushRegion(x, y, 0, 0, _dwidth, _dheight, true, transparent);
+}
+
+bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh)
+{
+  if (sx < 0)
+    sw += sx, tx -= sx, sx = 0;
+  if (sy < 0)
+    sh += sy, ty -= sy, sy = 0;
+  if (sx + sw > _dwidth)
+    sw = _dwidth - sx;
+  if (sy + sh > _dheight)
+    sh = _dheight - sy;
+  if (sw < 1 || sh < 1)
+    return false;
+  pushRegion(tx, ty, sx, sy, sw, sh, false, 0);
+  return true;
+}
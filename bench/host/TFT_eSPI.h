@@ -0,0 +1,200 @@
+/***************************************************************************************
+ * Host stand-in for the TFT_eSPI display and sprite classes used by ytGraph
+ * Platform: Linux (PlatformIO native)
+ *
+ *  - in-memory 16 bit panel framebuffer
+ *  - 1/4/16 bit sprites with the same memory layout as TFT_eSPI
+ *  - counts pixel writes and bytes "sent over SPI" (see hostStats)
+ *  - text is drawn as a deterministic 5x7 pattern, not a real font
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   host framebuffer backend for benchmarks
+****************************************************************************************/
+
+#ifndef YTGRAPH_HOST_TFT_ESPI_h
+#define YTGRAPH_HOST_TFT_ESPI_h
+
+#include <Arduino.h>
+
+#ifndef HOST_TFT_WIDTH
+#define HOST_TFT_WIDTH 320 // M5Stack panel in landscape mode
+#endif
+#ifndef HOST_TFT_HEIGHT
+#define HOST_TFT_HEIGHT 240
+#endif
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_DARKCYAN 0x03EF
+#define TFT_MAROON 0x7800
+#define TFT_PURPLE 0x780F
+#define TFT_OLIVE 0x7BE0
+#define TFT_LIGHTGREY 0xD69A
+#define TFT_DARKGREY 0x7BEF
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK 0xFE19
+#define TFT_BROWN 0x9A60
+#define TFT_GOLD 0xFEA0
+#define TFT_SILVER 0xC618
+#define TFT_SKYBLUE 0x867D
+#define TFT_VIOLET 0x915C
+
+#define TL_DATUM 0 // text datums as in TFT_eSPI
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+struct hostStats // everything the benchmarks count
+{
+  uint64_t pixelWrites; // pixels written into sprite or panel memory
+  uint64_t pushCount;   // number of pushSprite() calls
+  uint64_t pushBytes;   // bytes that would travel over SPI (16 bit per pixel)
+};
+
+extern thread_local hostStats hostCounters; // of the calling thread, the pipeline draws and pushes in different threads
+void hostStatsReset();
+
+extern uint32_t hostSpiClock; // Hz, pushes busy wait for their transfer time like the blocking SPI of the ESP32, 0 = no wait
+
+class TFT_eSPI : public Print
+{
+public:
+  TFT_eSPI(int16_t w = HOST_TFT_WIDTH, int16_t h = HOST_TFT_HEIGHT);
+  virtual ~TFT_eSPI();
+
+  void begin() {}
+  void init() {}
+  void setRotation(uint8_t) {}
+  void startWrite() {} // SPI transaction around several pushes, nothing to do on the host
+  void endWrite() {}
+
+  virtual int16_t width() { return _width; }
+  virtual int16_t height() { return _height; }
+
+  virtual void drawPixel(int32_t x, int32_t y, uint32_t color);
+  virtual uint16_t readPixel(int32_t x, int32_t y);
+  virtual void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  virtual void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+  virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+  void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+  void fillScreen(uint32_t color) { fillRect(0, 0, width(), height(), color); }
+  void drawXBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color);
+
+  // panel memory write of a 16 bit block, counts as SPI transfer
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
+
+  void setCursor(int16_t x, int16_t y) { _cursorX = x, _cursorY = y; }
+  int16_t getCursorX() { return _cursorX; }
+  int16_t getCursorY() { return _cursorY; }
+  void setTextSize(uint8_t s) { _textSize = s > 0 ? s : 1; }
+  void setTextColor(uint16_t c) { _textColor = _textBgColor = c; }
+  void setTextColor(uint16_t c, uint16_t b) { _textColor = c, _textBgColor = b; }
+  void setTextDatum(uint8_t d) { _textDatum = d; }
+  int16_t textWidth(const char *string, uint8_t font = 1);
+  int16_t fontHeight(uint8_t font = 1);
+  int16_t drawString(const char *string, int32_t x, int32_t y, uint8_t font = 1);
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // ILI9341 commands, only the vertical scroll (0x33, 0x37, 0x13) is emulated
+  void writecommand(uint8_t c);
+  void writedata(uint8_t d);
+  uint16_t readDisplayed(int32_t x, int32_t y); // what the panel shows, scroll applied
+
+  const uint16_t *framebuffer() const { return _fb; } // panel memory, native byte order
+
+protected:
+  void drawGlyph(int32_t x, int32_t y, char c, int sx, int sy, bool fillBg);
+
+  int16_t _width, _height;
+  uint16_t *_fb;
+  int16_t _cursorX, _cursorY;
+  uint8_t _textSize, _textDatum;
+  uint16_t _textColor, _textBgColor;
+  uint8_t _cmd, _argc, _args[8]; // command being received
+  uint16_t _tfa, _vsa, _vsp;     // scroll area in screen columns (landscape)
+};
+
+class TFT_eSprite : public TFT_eSPI
+{
+public:
+  explicit TFT_eSprite(TFT_eSPI *tft);
+  ~TFT_eSprite();
+
+  void setColorDepth(int8_t b) { _bpp = (b == 1 || b == 4) ? b : 16; }
+  int8_t getColorDepth() { return _created ? _bpp : 0; }
+  void *createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void deleteSprite();
+  bool created() { return _created; }
+  void *getPointer() { return _img8; }
+  void setBitmapColor(uint16_t fg, uint16_t bg) { _bitmapFg = fg, _bitmapBg = bg; }
+  void createPalette(const uint16_t *colorMap = nullptr, uint8_t colors = 16); // only of a created sprite, like TFT_eSPI
+  void setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color = TFT_BLACK);
+
+  int16_t width() override { return _dwidth; }
+  int16_t height() override { return _dheight; }
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+  uint16_t readPixel(int32_t x, int32_t y) override; // returns 565 colour
+  void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override;
+  void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override;
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override;
+  void fillSprite(uint32_t color) { fillRect(0, 0, _dwidth, _dheight, color); }
+  void scroll(int16_t dx, int16_t dy = 0);
+
+  void pushSprite(int32_t x, int32_t y);
+  void pushSprite(int32_t x, int32_t y, uint16_t transparent);
+  bool pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
+
+  uint8_t colorToIndex(uint16_t color); // 565 colour to 4 bit palette index
+  uint16_t getPaletteColor(uint8_t index) { return _colorMap ? _colorMap[index & 0x0F] : 0; }
+
+protected:
+  void pushRegion(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh,
+                  bool useTransparent, uint16_t transparent);
+  uint16_t rawPixel(int32_t x, int32_t y); // 565 colour without bounds check
+
+  TFT_eSPI *_tft;
+  bool _created;
+  int8_t _bpp;
+  int16_t _iwidth, _iheight;   // allocated size (4 bit rows are padded to even width)
+  int16_t _dwidth, _dheight;   // size seen by the drawing functions
+  int16_t _bitwidth;           // 1 bit rows are padded to full bytes
+  uint8_t *_img8;              // pixel memory
+  uint16_t *_img;              // same memory as 16 bit
+  uint8_t *_img4;              // TFT_eSPI: 4 bit view and the two frame buffers, all the same memory here,
+  uint8_t *_img8_1, *_img8_2;  // deleteSprite() frees _img8_1
+  uint16_t *_colorMap;         // 4 bit colour map, from the heap like in TFT_eSPI
+  uint16_t _bitmapFg, _bitmapBg; // 1 bit colours
+  int32_t _sx, _sy, _sw, _sh;  // scroll window
+  uint16_t _scolor;            // fill colour of scrolled in area
+  uint16_t _lastColor;         // colorToIndex() cache
+  uint8_t _lastIndex;
+};
+
+#endif
@@ -0,0 +1,10 @@
+// Host stand-in: flash and RAM are the same thing on Linux
+#ifndef YTGRAPH_HOST_PGMSPACE_h
+#define YTGRAPH_HOST_PGMSPACE_h
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+
+#endif
@@ -0,0 +1,271 @@
+/***************************************************************************************
+ * Benchmarks for the threshold alarms in ytGraphAlarm.h
+ *
+ *  - one sample of 4 channels: add() in O(rules) vs. evaluating the rules over the
+ *    buffer again, and the redraw of a page of alarm intervals
+ *  - long random sequences: the interval list is the same as the runs beyond the
+ *    limit (with hysteresis) of at least the minimum duration, found afterwards
+ *  - a scrolling graph with bands drawn frame by frame shows the same picture as
+ *    the same graph without them plus ytGraphDrawAlarms() of the page
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphAlarm.h"
+
+#define ALARM_BENCH_CHANNELS 4
+
+static int16_t alarmSample(uint32_t &seed, int16_t prev, uint8_t c) // random walks around different levels
+{
+  seed = seed * 1103515245 + 12345;
+  int16_t lo = c == 2 ? 44 : 0, hi = c == 2 ? 60 : 30;
+  int16_t v = prev + (int16_t)((seed >> 16) % 7) - 3;
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+static void alarmRules(ytGraphAlarms &a, uint16_t minDuration)
+{
+  // temperature3 above 55 (delayed), the others raised at once: 0 and 3, 1 and 2 overlap
+  a.addRule({2, ALARM_ABOVE, ALARM_BAND, 55, 2, minDuration, TFT_MAROON});
+  a.addRule({0, ALARM_BELOW, ALARM_MARK, 8, 0, 0, TFT_DARKGREEN});
+  a.addRule({3, ALARM_BELOW, ALARM_BAND, 5, 1, 0, TFT_NAVY});
+  a.addRule({1, ALARM_ABOVE, ALARM_MARK, 25, 3, 0, TFT_PURPLE});
+}
+
+// the runs beyond the limit of one rule over the whole sequence, found afterwards
+static void alarmRuns(const ytGraphAlarmRule &rule, const std::vector<int16_t> &v, std::vector<ytGraphAlarmInterval> &runs)
+{
+  std::vector<bool> beyond(v.size());
+  for (size_t n = 0; n < v.size(); n++)
+  {
+    bool prev = n && beyond[n - 1];
+    int32_t enter = rule.limit, leave = rule.type == ALARM_ABOVE ? rule.limit - rule.hysteresis : rule.limit + rule.hysteresis;
+    beyond[n] = rule.type == ALARM_ABOVE ? (prev ? v[n] > leave : v[n] > enter) : (prev ? v[n] < leave : v[n] < enter);
+  }
+  uint32_t need = rule.minDuration ? rule.minDuration : 1;
+  for (size_t n = 0; n < v.size();)
+  {
+    if (!beyond[n])
+    {
+      n++;
+      continue;
+    }
+    size_t e = n;
+    while (e < v.size() && beyond[e])
+      e++;
+    if (e - n >= need)
+      runs.push_back({(uint32_t)n, e == v.size() ? ALARM_OPEN : (uint32_t)e, 0});
+    n = e;
+  }
+}
+
+BENCH_CASE(alarmFrame) // one sample: incremental rules vs. a rescan of the buffer, redraw of the intervals
+{
+  uint32_t page = GRAPH_WIDTH + 1, seed = 3;
+  ytGraphAlarms a;
+  a.begin(64);
+  alarmRules(a, 3);
+  std::vector<int16_t> ring[ALARM_BENCH_CHANNELS];
+  for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+    ring[c].assign(page, 0);
+  int16_t y[ALARM_BENCH_CHANNELS] = {15, 15, 50, 15};
+  static volatile uint32_t sink; // keeps the results alive
+  for (int k = 0; k < 2; k++)
+  {
+    benchFrames f(k ? "add(), 4 rules" : "rescan 241 samples, 4 rules", ALARM_BENCH_CHANNELS);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+        ring[c][i % page] = y[c] = alarmSample(seed, y[c], c);
+      f.begin();
+      if (k)
+      {
+        a.add(y);
+        sink += a.size();
+      }
+      else
+        for (uint8_t r = 0; r < a.rules(); r++)
+        {
+          std::vector<ytGraphAlarmInterval> runs;
+          alarmRuns(a.rule(r), ring[a.rule(r).channel], runs);
+          sink += runs.size();
+        }
+      f.end();
+    }
+  }
+
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  ytGraphCanvas canvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y);
+  canvas.begin();
+  benchFrames f("redraw the alarms of a page", ALARM_BENCH_CHANNELS);
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    Graph.fillSprite(GRAPH_BGRND_COLOR);
+    f.begin();
+    ytGraphDrawAlarms(canvas, ytGraphLayoutDefault, a, a.samples() - page, page);
+    f.end();
+  }
+}
+
+BENCH_CASE(alarmCheck) // interval list against the runs found afterwards, frame by frame = redraw of the page
+{
+  // the interval list of long random sequences, with and without minimum duration
+  for (uint16_t minDuration : {(uint16_t)0, (uint16_t)1, (uint16_t)4, (uint16_t)25})
+  {
+    ytGraphAlarms a;
+    a.begin(4096);
+    alarmRules(a, minDuration);
+    std::vector<int16_t> v[ALARM_BENCH_CHANNELS];
+    int16_t y[ALARM_BENCH_CHANNELS] = {15, 15, 50, 15};
+    uint32_t seed = 17 + minDuration, raised = 0;
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+      for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+        v[c].push_back(y[c] = alarmSample(seed, y[c], c));
+      a.add(y);
+      raised += __builtin_popcount(a.raised());
+    }
+    bool ok = a.dropped() == 0 && a.samples() == v[0].size() && raised == a.size();
+    for (uint8_t r = 0; r < a.rules(); r++)
+    {
+      std::vector<ytGraphAlarmInterval> runs, got;
+      alarmRuns(a.rule(r), v[a.rule(r).channel], runs);
+      for (uint16_t i = 0; i < a.size(); i++)
+        if (a[i].rule == r)
+          got.push_back(a[i]);
+      bool same = runs.size() == got.size() && !runs.empty();
+      for (size_t i = 0; same && i < runs.size(); i++)
+        same = runs[i].start == got[i].start && runs[i].end == got[i].end;
+      ok = ok && same && a.active(r) == (!got.empty() && got.back().end == ALARM_OPEN);
+      BENCH_CHECK(ctx, same, "min duration %u, rule %u: %u intervals, %u runs found afterwards", minDuration, r,
+                  (unsigned)got.size(), (unsigned)runs.size());
+    }
+    BENCH_CHECK(ctx, ok, "min duration %u: %u intervals, %u raised, %u dropped", minDuration, a.size(), raised, a.dropped());
+  }
+
+  // a full ring keeps the newest intervals, an active alarm pushed out is closed without harm
+  {
+    ytGraphAlarms all, few;
+    all.begin(1024);
+    few.begin(5);
+    alarmRules(all, 2);
+    alarmRules(few, 2);
+    int16_t y[ALARM_BENCH_CHANNELS] = {15, 15, 50, 15};
+    uint32_t seed = 5;
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+      for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+        y[c] = alarmSample(seed, y[c], c);
+      all.add(y);
+      few.add(y);
+    }
+    bool ok = few.size() == 5 && few.dropped() == all.size() - 5u;
+    for (uint16_t i = 0; ok && i < 5; i++)
+    {
+      const ytGraphAlarmInterval &p = all[all.size() - 5 + i], &q = few[i];
+      ok = p.start == q.start && p.end == q.end && p.rule == q.rule;
+    }
+    BENCH_CHECK(ctx, ok, "full ring: %u intervals, %u dropped, %u in the large ring", few.size(), few.dropped(), all.size());
+  }
+
+  // scrolling with the alarms of every frame vs. the same graph without them plus the redraw of the page
+  const ytGraphLayout &cfg = ytGraphLayoutDefault;
+  uint16_t colors[ALARM_BENCH_CHANNELS] = {TFT_CYAN, TFT_PINK, TFT_YELLOW, TFT_MAGENTA};
+  for (int ring = 0; ring < 2; ring++)
+  {
+    TFT_eSprite *Graph[2], *xAxis[2];
+    ytGraphCanvas *g[2], *x[2];
+    ytGraphChannel ch[2][ALARM_BENCH_CHANNELS];
+    for (int k = 0; k < 2; k++) // 0 = with alarms, 1 = without
+    {
+      Graph[k] = new TFT_eSprite(&benchTFT);
+      xAxis[k] = new TFT_eSprite(&benchTFT);
+      Graph[k]->setColorDepth(4);
+      Graph[k]->createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+      xAxis[k]->setColorDepth(1);
+      xAxis[k]->createSprite(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH);
+      g[k] = new ytGraphCanvas(*Graph[k], SPRITE_LEFT_X, SPRITE_UPPER_Y);
+      x[k] = new ytGraphCanvas(*xAxis[k], X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+      if (ring)
+      {
+        g[k]->beginRing();
+        x[k]->beginRing(CANVAS_LABEL_OVERRUN);
+      }
+      else
+      {
+        g[k]->begin();
+        x[k]->begin();
+      }
+      int16_t last;
+      ytGraphDrawGridXaxis(*g[k], *x[k], last);
+      for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+        ch[k][c] = ytGraphChannel{colors[c], GRAPH_WIDTH, GRAPH_HEIGHT};
+    }
+    TFT_eSprite page(&benchTFT);
+    page.setColorDepth(4);
+    page.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+
+    ytGraphAlarms a;
+    a.begin(256);
+    alarmRules(a, 3);
+    int16_t y[ALARM_BENCH_CHANNELS] = {15, 15, 50, 15};
+    uint32_t seed = 11, xValue = 0, wrong = 0, checks = 0, painted = 0;
+    for (uint32_t i = 0; i < 30 * (SAMPLE_COUNT + 1); i++)
+    {
+      for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+        y[c] = alarmSample(seed, y[c], c);
+      a.add(y);
+      bool newDiv = i % 5 == 0;
+      if (newDiv)
+        xValue += GRAPH_X_DIV;
+      for (int k = 0; k < 2; k++)
+      {
+        for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+          ch[k][c].ox -= cfg.scrollStep;
+        g[k]->scroll(-cfg.scrollStep);
+        x[k]->scroll(-cfg.scrollStep);
+        if (!k)
+          ytGraphDrawAlarmStep(*g[k], cfg, a);
+        ytGraphDrawDynamicGrid(*g[k], *x[k], cfg, ch[k][3].ox, newDiv, xValue);
+        for (int c = 0; c < ALARM_BENCH_CHANNELS; c++)
+          ytGraph(*g[k], SAMPLE_COUNT, y[c], ch[k][c]);
+        x[k]->push();
+        g[k]->push();
+      }
+      if (i < 2 * (SAMPLE_COUNT + 1) || i % 7)
+        continue;
+
+      // the page: the graph without alarms, then the intervals of the visible samples
+      g[0]->unwrap();
+      g[1]->unwrap();
+      for (int16_t py = 0; py < page.height(); py++)
+        for (int16_t px = 0; px < page.width(); px++)
+          page.drawPixel(px, py, Graph[1]->readPixel(px, py));
+      ytGraphDrawAlarms(page, cfg, a, a.samples() - (SAMPLE_COUNT + 1), SAMPLE_COUNT + 1);
+      checks++;
+      wrong += !benchSpritesEqual(*Graph[0], page);
+      for (int16_t px = 0; px < page.width(); px++)
+        painted += page.readPixel(px, 1) == TFT_MAROON;
+    }
+    BENCH_CHECK(ctx, !wrong && painted, "%s: %u of %u pages differ from the redraw, %u band columns", ring ? "ring" : "sprite",
+                wrong, checks, painted);
+    for (int k = 0; k < 2; k++)
+    {
+      delete g[k];
+      delete x[k];
+      delete Graph[k];
+      delete xAxis[k];
+    }
+  }
+}
@@ -0,0 +1,226 @@
+/***************************************************************************************
+ * Benchmarks for the memory arena in ytGraphArena.h
+ *
+ *  - screen changes: four graph instances are created and deleted again, their
+ *    sprites and buffers from the heap vs. from one arena that is reset
+ *  - a graph in the arena draws the same pixels as one on the heap
+ *  - arenaBytes() is exactly what begin() takes, a graph that does not fit fails
+ *    before the first allocation, reset() gives the same memory again and the
+ *    high-water mark does not grow over many screen changes
+ *  - an arena sprite has the palette of a heap sprite, a sprite the arena cannot hold
+ *    comes from the heap and a delete through TFT_eSprite & leaves the arena alone
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphInstance.h"
+#include "ytGraphStrip.h"
+#include <algorithm>
+
+static ytGraphConfig arenaConfig(uint8_t quarter) // the 2x2 graphs of the multi graph demo
+{
+  static const uint16_t samples[4] = {25, 20, 50, 10}, xDiv[4] = {5, 5, 10, 2};
+  ytGraphConfig cfg = ytGraphConfigDefault;
+  cfg.left = quarter & 1 ? 200 : 30;
+  cfg.bottom = quarter & 2 ? 200 : 90;
+  cfg.width = 100;
+  cfg.height = 60;
+  cfg.samples = samples[quarter];
+  cfg.xDiv = xDiv[quarter];
+  cfg.timeFormat = "SSMH"[quarter];
+  cfg.yDiv = 20;
+  cfg.xLabel = "";
+  cfg.yLabel = "";
+  return cfg;
+}
+
+static uint8_t arenaScale(uint8_t quarter) { return quarter == 2 ? GRAPH_SCALE_AUTO : GRAPH_SCALE_FIXED; }
+
+static uint32_t screenBytes(uint8_t channels) // budget of the four graphs
+{
+  uint32_t bytes = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    bytes += ytGraphInstance::arenaBytes(ytGraphLayout(arenaConfig(i)), channels, arenaScale(i));
+  return bytes;
+}
+
+BENCH_CASE(arenaScreens) // one screen change: begin() and end() of four graphs, heap vs. arena
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  static char text[2][64];
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+
+  for (int ch : ctx.channels)
+  {
+    uint8_t channels = std::min(ch, GRAPH_MAX_CHANNELS);
+    ytGraphArena arena;
+    arena.begin(screenBytes(channels));
+    for (int a = 0; a < 2; a++)
+    {
+      benchFrames f(a ? "arena, reset per screen" : "heap, free per sprite", channels);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        f.begin();
+        {
+          ytGraphInstance g[4] = {{benchTFT, arenaConfig(0)}, {benchTFT, arenaConfig(1)}, {benchTFT, arenaConfig(2)},
+                                  {benchTFT, arenaConfig(3)}};
+          for (uint8_t k = 0; k < 4; k++)
+          {
+            g[k].setArena(a ? &arena : nullptr);
+            g[k].begin(colors, channels, arenaScale(k));
+          }
+        }
+        if (a)
+          arena.reset();
+        f.end();
+      }
+      if (a)
+      {
+        ytGraphArenaStats s = arena.stats();
+        snprintf(text[a], sizeof(text[a]), "arena %.1f KB, high-water %.1f KB, %u failures", s.size / 1024.0,
+                 s.highWater / 1024.0, s.failures);
+        f.extra(text[a]);
+      }
+    }
+  }
+}
+
+BENCH_CASE(arenaCheck) // same pixels, exact budget, fails up front, reset reuses the memory
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+
+  // the arena itself: aligned, zeroed, marks, stats
+  {
+    ytGraphArena a;
+    a.begin(64);
+    uint8_t *p = (uint8_t *)a.alloc(5), *q = (uint8_t *)a.alloc(8);
+    bool ok = p && q && q - p == 8 && ((uintptr_t)q & (ARENA_ALIGN - 1)) == 0 && a.stats().used == 16;
+    memset(q, 0xAA, 8);
+    uint32_t m = a.mark();
+    ok = ok && a.alloc(48) != nullptr && a.alloc(1) == nullptr && a.stats().failures == 1 && a.stats().lastFailed == 4;
+    a.reset(m - 8);
+    uint8_t *r = (uint8_t *)a.alloc(8);
+    ok = ok && r == q && r[0] == 0 && r[7] == 0 && a.stats().highWater == 64 && a.stats().resets == 1;
+    BENCH_CHECK(ctx, ok, "arena allocations, marks or stats are wrong");
+  }
+
+  // a graph in the arena: same pixels as on the heap, begin() takes exactly arenaBytes()
+  for (uint8_t quarter = 0; quarter < 4; quarter++)
+  {
+    ytGraphLayout cfg(arenaConfig(quarter));
+    uint8_t scale = arenaScale(quarter);
+    ytGraphArena arena;
+    arena.begin(ytGraphInstance::arenaBytes(cfg, 3, scale));
+    ytGraphInstance a(benchTFT, cfg), b(benchTFT, cfg);
+    a.setArena(&arena);
+    bool begun = a.begin(colors, 3, scale) && b.begin(colors, 3, scale);
+    BENCH_CHECK(ctx, begun, "graph %u: begin() failed", quarter);
+    BENCH_CHECK(ctx, arena.stats().used == arena.stats().size && arena.stats().failures == 0,
+                "graph %u: begin() took %u bytes, arenaBytes() is %u", quarter, arena.stats().used, arena.stats().size);
+    int16_t y[3];
+    for (uint32_t i = 0; i < 3u * cfg.samples; i++)
+    {
+      for (uint8_t c = 0; c < 3; c++)
+        y[c] = (int16_t)((i * (5 + c) + 9 * c) % (quarter == 2 ? 97 : 59));
+      a.add(y);
+      b.add(y);
+    }
+    a.graph().unwrap();
+    b.graph().unwrap();
+    a.xAxis().unwrap();
+    b.xAxis().unwrap();
+    BENCH_CHECK(ctx, benchSpritesEqual(a.graph().sprite(), b.graph().sprite()) &&
+                         benchSpritesEqual(a.xAxis().sprite(), b.xAxis().sprite()),
+                "graph %u: the arena graph differs from the heap graph", quarter);
+    BENCH_CHECK(ctx, a.labels().misses() == b.labels().misses() && a.rescales() == b.rescales(),
+                "graph %u: labels or rescales differ", quarter);
+  }
+
+  // arena sprites: the palette of a 4 bit sprite, the fall back to the heap, delete through the base class
+  {
+    ytGraphArena arena;
+    arena.begin(ytGraphSprite::bytes(40, 20, 4) + ytGraphSprite::bytes(40, 20, 1) + 4 * ARENA_ALIGN);
+    ytGraphSprite s4(&benchTFT), s1(&benchTFT), heap(&benchTFT), tiny(&benchTFT), twice(&benchTFT);
+    s4.setArena(&arena);
+    s1.setArena(&arena);
+    twice.setArena(&arena);
+    tiny.setArena(&arena);
+    s4.setColorDepth(4);
+    s1.setColorDepth(1);
+    heap.setColorDepth(4);
+    tiny.setColorDepth(1);
+    bool ok = s4.createSprite(40, 20) && s1.createSprite(40, 20) && heap.createSprite(40, 20) && s4.inArena() && s1.inArena();
+    uint32_t used = arena.stats().used;
+    for (uint8_t i = 0; i < 16; i++)
+      ok = ok && s4.getPaletteColor(i) == heap.getPaletteColor(i);
+    s4.drawPixel(3, 2, TFT_RED);
+    ok = ok && s4.readPixel(3, 2) == TFT_RED && s4.readPixel(0, 0) == TFT_BLACK;
+    BENCH_CHECK(ctx, ok, "an arena sprite is not like a heap sprite (palette or pixels)");
+
+    ok = twice.createSprite(8, 8, 2) && !twice.inArena() && tiny.createSprite(1, 8) && !tiny.inArena() &&
+         tiny.created() && arena.stats().used == used;
+    BENCH_CHECK(ctx, ok, "a double buffered or unchecked sprite is not from the heap (arena use %u, was %u)",
+                arena.stats().used, used);
+
+    TFT_eSprite &base = s4; // the non-virtual deleteSprite() of TFT_eSprite must not free arena memory
+    base.deleteSprite();
+    ok = !s4.created() && s4.createSprite(40, 20) == nullptr && arena.stats().used == used;
+    s1.deleteSprite();
+    arena.reset();
+    ok = ok && s4.createSprite(40, 20) && s4.inArena() && s4.getPaletteColor(15) == heap.getPaletteColor(15);
+    BENCH_CHECK(ctx, ok, "delete through TFT_eSprite & or the next createSprite() failed");
+  }
+
+  // a graph that does not fit fails before the first allocation
+  {
+    ytGraphLayout cfg(arenaConfig(0));
+    ytGraphArena arena;
+    uint32_t need = ytGraphInstance::arenaBytes(cfg, 2);
+    arena.begin(need - ARENA_ALIGN);
+    ytGraphInstance g(benchTFT, cfg);
+    g.setArena(&arena);
+    bool ok = !g.begin(colors, 2) && arena.stats().used == 0 && arena.stats().failures == 1 && arena.stats().lastFailed == need;
+    BENCH_CHECK(ctx, ok, "a graph too large for the arena allocated %u bytes", arena.stats().used);
+  }
+
+  // many screen changes: the same memory again, the high-water mark stays
+  {
+    ytGraphArena arena;
+    arena.begin(screenBytes(4) + ytGraphSprite::bytes(STRIP_WIDTH, 122, 16) + 16);
+    ytGraphStrip persistent(benchTFT); // allocated before the mark, survives the screen changes
+    persistent.begin(ytGraphLayoutDefault, 16, STRIP_WIDTH, &arena);
+    uint32_t mark = arena.mark(), high = 0;
+    bool ok = persistent.bytes() > 0;
+    for (int screen = 0; screen < 50 && ok; screen++)
+    {
+      {
+        ytGraphInstance g[4] = {{benchTFT, arenaConfig(0)}, {benchTFT, arenaConfig(1)}, {benchTFT, arenaConfig(2)},
+                                {benchTFT, arenaConfig(3)}};
+        for (uint8_t k = 0; k < 4; k++)
+        {
+          g[k].setArena(&arena);
+          ok = ok && g[k].begin(colors, 4, arenaScale(k));
+        }
+        if (screen == 0)
+          high = arena.stats().highWater;
+      }
+      arena.reset(mark);
+      ok = ok && arena.stats().used == mark && arena.stats().highWater == high;
+    }
+    BENCH_CHECK(ctx, ok, "screen changes: used %u of %u, high-water %u, %u failures", arena.stats().used, arena.stats().size,
+                arena.stats().highWater, arena.stats().failures);
+  }
+}
@@ -0,0 +1,297 @@
+/***************************************************************************************
+ * Benchmarks for the auto scaled y axis in ytGraphAutoscale.h
+ *
+ *  - min/max of the visible samples: ytGraphMinMax vs. a scan of the window per sample
+ *  - a rescale: redraw from the stored samples vs. clear() and adding the page again
+ *  - checks: min/max equals the scan, nice ranges, hysteresis, an auto scaled
+ *    instance shows the same pixels as a fixed one with the final y range
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphAutoscale.h"
+#include "ytGraphInstance.h"
+#include <algorithm>
+
+static ytGraphConfig autoscaleConfig() // sample rate 1 and x min 0: a redraw matches the scrolled pixels
+{
+  ytGraphConfig cfg = ytGraphConfigDefault;
+  cfg.left = 30;
+  cfg.bottom = 200;
+  cfg.width = 200;
+  cfg.height = 120;
+  cfg.samples = 50;
+  cfg.sampleRate = 1;
+  cfg.xMin = 0;
+  cfg.xDiv = 10;
+  cfg.yMin = 0;
+  cfg.yMax = 100;
+  cfg.yDiv = 20;
+  cfg.xLabel = "";
+  cfg.yLabel = "";
+  return cfg;
+}
+
+static uint32_t autoscaleRandom(uint32_t &state) // xorshift, the same sequence on every host
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void naiveMinMax(const std::vector<int16_t> &v, size_t end, uint32_t window, int16_t &lo, int16_t &hi)
+{
+  size_t first = end > window ? end - window : 0;
+  lo = hi = v[first];
+  for (size_t i = first; i < end; i++)
+  {
+    lo = std::min(lo, v[i]);
+    hi = std::max(hi, v[i]);
+  }
+}
+
+BENCH_CASE(autoscaleMinMax) // min/max of the last n samples, per sample: deques vs. scan
+{
+  static char labels[6][32];
+  uint32_t frames = std::max<uint32_t>(ctx.frames, 1);
+  int k = 0;
+  for (uint32_t window : {SAMPLE_COUNT + 1, 241, 1001})
+  {
+    std::vector<int16_t> v(frames + window);
+    uint32_t state = 7;
+    for (int16_t &x : v)
+      x = (int16_t)(autoscaleRandom(state) % 2001) - 1000;
+    volatile int32_t sink = 0;
+
+    snprintf(labels[k], sizeof(labels[k]), "ytGraphMinMax, window %u", window);
+    {
+      ytGraphMinMax m;
+      m.begin(window);
+      for (uint32_t i = 0; i < window; i++)
+        m.push(v[i], v[i]);
+      benchFrames f(labels[k++], 0);
+      for (uint32_t i = window; i < window + frames; i++)
+      {
+        f.begin();
+        m.push(v[i], v[i]);
+        sink += m.min() + m.max();
+        f.end();
+      }
+    }
+    snprintf(labels[k], sizeof(labels[k]), "scan, window %u", window);
+    {
+      benchFrames f(labels[k++], 0);
+      for (uint32_t i = window; i < window + frames; i++)
+      {
+        int16_t lo, hi;
+        f.begin();
+        naiveMinMax(v, i + 1, window, lo, hi);
+        sink += lo + hi;
+        f.end();
+      }
+    }
+  }
+}
+
+static int16_t autoscaleSample(uint32_t i, uint8_t c) // slow waves with some noise, the amplitude grows
+{
+  return (int16_t)(20 * c + (i / 10) % 40 + (i * (7 + c)) % 5);
+}
+
+BENCH_CASE(autoscaleRedraw) // a rescale with a full page: redraw from the stored samples vs. clear() + add() again
+{
+  ytGraphConfig cfg = autoscaleConfig();
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+
+  for (int ch : ctx.channels)
+  {
+    ch = std::min(ch, GRAPH_MAX_CHANNELS);
+    ytGraphLayout l(cfg);
+    int16_t y[GRAPH_MAX_CHANNELS];
+    {
+      ytGraphInstance g(benchTFT, l);
+      g.begin(colors, ch);
+      ytGraphAutoscale a;
+      a.begin(l, ch);
+      for (uint32_t i = 0; i <= cfg.samples; i++)
+      {
+        for (int c = 0; c < ch; c++)
+          y[c] = autoscaleSample(i, c);
+        a.add(y);
+      }
+      ytGraphChannel lines[GRAPH_MAX_CHANNELS];
+      for (int c = 0; c < ch; c++)
+        lines[c] = ytGraphChannel{colors[c], 0, 0};
+      benchFrames f("rescale: redraw", ch);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        f.begin();
+        a.redraw(g.graph().sprite(), l, lines);
+        f.end();
+      }
+    }
+    {
+      ytGraphInstance g(benchTFT, l);
+      g.begin(colors, ch);
+      benchFrames f("rescale: clear() + add()", ch);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        f.begin();
+        g.clear();
+        for (uint32_t k = 0; k <= cfg.samples; k++)
+        {
+          for (int c = 0; c < ch; c++)
+            y[c] = autoscaleSample(k, c);
+          g.add(y);
+        }
+        f.end();
+      }
+    }
+  }
+}
+
+static bool graphsEqual(ytGraphInstance &a, ytGraphInstance &b)
+{
+  a.graph().unwrap();
+  b.graph().unwrap();
+  return benchSpritesEqual(a.graph().sprite(), b.graph().sprite());
+}
+
+// feeds the same samples to an auto scaled instance and to a fixed one with the final y range
+static bool sameAsFixed(ytGraphConfig cfg, uint8_t channels, uint32_t n, int16_t (*sample)(uint32_t, uint8_t),
+                        uint32_t &rescales)
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  int16_t y[GRAPH_MAX_CHANNELS];
+
+  ytGraphInstance a(benchTFT, ytGraphLayout(cfg));
+  a.begin(colors, channels, GRAPH_SCALE_AUTO);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    for (uint8_t c = 0; c < channels; c++)
+      y[c] = sample(i, c);
+    a.add(y);
+  }
+  rescales = a.rescales();
+
+  ytGraphYRange r{(int16_t)a.config().yMin, (int16_t)a.config().yMax, a.config().yDiv};
+  ytGraphInstance b(benchTFT, ytGraphLayoutRange(cfg, r));
+  b.begin(colors, channels);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    for (uint8_t c = 0; c < channels; c++)
+      y[c] = sample(i, c);
+    b.add(y);
+  }
+  return graphsEqual(a, b);
+}
+
+static int16_t rampSample(uint32_t i, uint8_t c) // grows within the first page
+{
+  return (int16_t)(10 * c + 3 * i + (i * (3 + c)) % 7);
+}
+
+static int16_t stepSample(uint32_t i, uint8_t c) // flat, jumps up while scrolling
+{
+  return (int16_t)((i < 70 ? 40 : 230) + 4 * c);
+}
+
+BENCH_CASE(autoscaleCheck) // min/max, nice ranges, hysteresis, same pixels as a fixed range
+{
+  // the deques give the min/max of a scan over the last window samples
+  for (uint32_t window : {1, 5, 21})
+  {
+    ytGraphMinMax m;
+    m.begin(window);
+    std::vector<int16_t> v;
+    uint32_t state = 11 + window;
+    bool ok = m.empty();
+    for (int i = 0; i < 2000; i++)
+    {
+      int16_t x = (int16_t)(autoscaleRandom(state) % 201) - 100;
+      if (i % 300 < 50) // runs of rising and equal values
+        x = (int16_t)(i % 300 < 25 ? i % 300 : 30);
+      v.push_back(x);
+      m.push(x, x);
+      int16_t lo, hi;
+      naiveMinMax(v, v.size(), window, lo, hi);
+      ok = ok && m.min() == lo && m.max() == hi;
+    }
+    BENCH_CHECK(ctx, ok, "window %u: min/max differs from the scan", window);
+  }
+
+  // nice ranges hold the values in at most AUTOSCALE_DIVS divisions of 1, 2 or 5 * 10^n
+  {
+    uint32_t state = 3;
+    bool ok = true;
+    for (int i = 0; i < 5000 && ok; i++)
+    {
+      int16_t a = (int16_t)(autoscaleRandom(state) % 20001) - 10000;
+      int16_t b = (int16_t)(a + autoscaleRandom(state) % (i % 2 ? 50 : 20000));
+      ytGraphYRange r = ytGraphNiceRange(a, b);
+      uint16_t d = r.div;
+      while (d % 10 == 0)
+        d /= 10;
+      ok = r.min <= a && r.max >= b && r.max > r.min && (d == 1 || d == 2 || d == 5) && r.min % r.div == 0 &&
+           r.max % r.div == 0 && (r.max - r.min) / r.div <= AUTOSCALE_DIVS;
+      BENCH_CHECK(ctx, ok, "nice range of %d..%d is %d..%d / %u", a, b, r.min, r.max, r.div);
+    }
+    ytGraphYRange r = ytGraphNiceRange(3, 3);
+    BENCH_CHECK(ctx, r.min == 3 && r.max == 4 && r.div == 1, "nice range of 3..3 is %d..%d / %u", r.min, r.max, r.div);
+  }
+
+  // hysteresis: noise on a level does not rescale after the axis has settled, a step does
+  {
+    ytGraphYRange r{0, 100, 20};
+    ytGraphMinMax m;
+    m.begin(SAMPLE_COUNT + 1);
+    uint32_t state = 5, changes = 0, late = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+      int16_t x = (int16_t)(500 + autoscaleRandom(state) % 40);
+      m.push(x, x);
+      if (ytGraphAutoRange(r, m.min(), m.max()))
+      {
+        changes++;
+        late += i >= 100;
+      }
+    }
+    BENCH_CHECK(ctx, changes <= 3 && late == 0, "jitter: %u rescales, %u after settling", changes, late);
+    bool grown = ytGraphAutoRange(r, 500, 900);
+    BENCH_CHECK(ctx, grown && r.max >= 900, "a step out of the axis does not grow it");
+  }
+
+  // the layout of an auto range: bottom line at r.min, nothing folded back
+  {
+    ytGraphLayout l = ytGraphLayoutRange(autoscaleConfig(), ytGraphYRange{200, 500, 50});
+    bool ok = ytGraphMapY(l.scale, 200) == l.height && ytGraphMapY(l.scale, 500) == 0;
+    for (int16_t v = 200; v < 500 && ok; v++)
+      ok = ytGraphMapY(l.scale, v) >= ytGraphMapY(l.scale, v + 1);
+    BENCH_CHECK(ctx, ok && l.yStep == 20, "auto range 200..500 is not mapped onto the graph height");
+  }
+
+  // an auto scaled instance shows the same pixels as a fixed one with its final range
+  for (uint8_t ch : {1, 4, 16})
+  {
+    uint32_t rescales;
+    bool same = sameAsFixed(autoscaleConfig(), ch, autoscaleConfig().samples + 1, rampSample, rescales);
+    BENCH_CHECK(ctx, same && rescales > 1, "%u channels, page: differs from the fixed range (%u rescales)", ch, rescales);
+    same = sameAsFixed(autoscaleConfig(), ch, 90, stepSample, rescales);
+    BENCH_CHECK(ctx, same && rescales >= 1, "%u channels, scrolling: differs from the fixed range (%u rescales)", ch, rescales);
+  }
+}
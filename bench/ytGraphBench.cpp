@@ -0,0 +1,297 @@
+/***************************************************************************************
+ * Frame time benchmark harness for the ytGraph function set
+ * Platform: Linux (PlatformIO native, see [env:native] in platformio.ini)
+ *
+ * usage: program [-f frames] [-c 1,4,16] [name filter]
+ *        program -x stream.ytfx prefix   (frame export stream to prefix00000.ppm ...)
+ *
+ * The geometry (SAMPLE_COUNT, GRAPH_WIDTH, ...) is fixed at compile time,
+ * the native_* environments in platformio.ini build the size variants.
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraph.h"
+#include "ytGraphInstance.h"
+#include <algorithm>
+
+static benchCase *benchCases = nullptr;
+static benchCase **benchCasesTail = &benchCases;
+
+TFT_eSPI &benchTFT = M5.Lcd;
+
+benchRegistrar::benchRegistrar(const char *name, benchFunc func)
+{
+  benchCase *c = new benchCase{name, func, nullptr};
+  *benchCasesTail = c; // keep the order of the source files
+  benchCasesTail = &c->next;
+}
+
+benchFrames::benchFrames(const char *label, int channels)
+    : _label(label), _channels(channels), _extra(""), _frameStart(), _total()
+{
+  _ns.reserve(1024);
+}
+
+void benchFrames::begin()
+{
+  _frameStart = hostCounters;
+  _start = std::chrono::steady_clock::now();
+}
+
+void benchFrames::end()
+{
+  auto stop = std::chrono::steady_clock::now();
+  _ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - _start).count());
+  _total.pixelWrites += hostCounters.pixelWrites - _frameStart.pixelWrites;
+  _total.pushCount += hostCounters.pushCount - _frameStart.pushCount;
+  _total.pushBytes += hostCounters.pushBytes - _frameStart.pushBytes;
+}
+
+benchFrames::~benchFrames()
+{
+  if (_ns.empty())
+    return;
+  std::vector<uint64_t> s(_ns);
+  std::sort(s.begin(), s.end());
+  uint64_t sum = 0;
+  for (uint64_t v : s)
+    sum += v;
+  size_t n = s.size();
+  auto pct = [&](double p) { return s[std::min(n - 1, (size_t)(p * (n - 1) + 0.5))] / 1000.0; };
+
+  printf("  %-28s ch=%-2d frames=%-6zu mean=%9.2fus p50=%9.2fus p90=%9.2fus p99=%9.2fus max=%9.2fus"
+         " px/f=%9.1f push/f=%5.2f bytes/f=%9.1f %s\n",
+         _label, _channels, n, sum / 1000.0 / n, pct(0.50), pct(0.90), pct(0.99), s[n - 1] / 1000.0,
+         (double)_total.pixelWrites / n, (double)_total.pushCount / n, (double)_total.pushBytes / n, _extra);
+}
+
+uint16_t benchChannelColor(int channel)
+{
+  static const uint16_t colors[16] = {TFT_CYAN, TFT_PINK, TFT_YELLOW, TFT_MAGENTA, TFT_RED, TFT_GREEN,
+                                      TFT_BLUE, TFT_ORANGE, TFT_WHITE, TFT_PURPLE, TFT_BROWN, TFT_MAROON,
+                                      TFT_DARKGREEN, TFT_NAVY, TFT_DARKGREY, TFT_LIGHTGREY};
+  return colors[channel & 0x0F];
+}
+
+bool benchSpritesEqual(TFT_eSprite &a, TFT_eSprite &b)
+{
+  if (a.width() != b.width() || a.height() != b.height() || a.getColorDepth() != b.getColorDepth())
+    return false;
+  for (int32_t y = 0; y < a.height(); y++)
+    for (int32_t x = 0; x < a.width(); x++)
+      if (a.readPixel(x, y) != b.readPixel(x, y))
+        return false;
+  return true;
+}
+
+bool benchPanelShows(ytGraphInstance &g)
+{
+  ytGraphCanvas *cv[2] = {&g.graph(), &g.xAxis()};
+  for (ytGraphCanvas *c : cv)
+  {
+    c->unwrap();
+    TFT_eSprite &s = c->sprite();
+    for (int16_t y = 0; y < s.height(); y++)
+      for (int16_t x = 0; x < c->width() && c->screenX() + x < benchTFT.width(); x++)
+        if (benchTFT.readPixel(c->screenX() + x, c->screenY() + y) != s.readPixel(x, y))
+          return false;
+  }
+  return true;
+}
+
+/***************************************************************************************
+ * baseline cases, mirror the demo functions in main.cpp
+****************************************************************************************/
+
+static int16_t benchSample(int channel) // demo like data, every channel in its own band
+{
+  int16_t lo = (channel * 7) % 50;
+  return (int16_t)random(lo, lo + 10);
+}
+
+BENCH_CASE(ytGraphPoint) // one x step of every channel, no scroll and no push
+{
+  TFT_eSprite Graph(&benchTFT);
+  TFT_eSprite xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+
+  for (int ch : ctx.channels)
+  {
+    ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos);
+    std::vector<int16_t> ox(ch, 0), oy(ch, GRAPH_HEIGHT);
+    benchFrames f("ytGraph() per x step", ch);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      uint16_t x = i % (SAMPLE_COUNT + 1);
+      if (x == 0)
+        std::fill(ox.begin(), ox.end(), 0);
+      f.begin();
+      for (int c = 0; c < ch; c++)
+        ytGraph(Graph, x, benchSample(c), benchChannelColor(c), ox[c], oy[c]);
+      f.end();
+    }
+  }
+}
+
+BENCH_CASE(dynamicGrid) // scroll + ytGraphDrawDynamicGrid(), the per frame grid cost
+{
+  TFT_eSprite Graph(&benchTFT);
+  TFT_eSprite xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+  ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos);
+
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT);
+  benchFrames f("scroll + dynamic grid", 0);
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    f.begin();
+    Graph.scroll(-scrollX);
+    xAxis.scroll(-scrollX);
+    ytGraphDrawDynamicGrid(Graph, xAxis, GRAPH_WIDTH - scrollX, LastXGridLinePos);
+    f.end();
+  }
+}
+
+BENCH_CASE(dynamicFrame) // drawDynamicGraph(): scroll, grid, one point per channel, push both sprites
+{
+  TFT_eSprite Graph(&benchTFT);
+  TFT_eSprite xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT);
+
+  for (int ch : ctx.channels)
+  {
+    ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos);
+    std::vector<int16_t> ox(ch, GRAPH_WIDTH), oy(ch, GRAPH_HEIGHT);
+    benchFrames f("drawDynamicGraph()", ch);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      f.begin();
+      for (int c = 0; c < ch; c++)
+        ox[c] -= scrollX;
+      Graph.scroll(-scrollX);
+      xAxis.scroll(-scrollX);
+      ytGraphDrawDynamicGrid(Graph, xAxis, ox[ch - 1], LastXGridLinePos);
+      for (int c = 0; c < ch; c++)
+        ytGraph(Graph, SAMPLE_COUNT, benchSample(c), benchChannelColor(c), ox[c], oy[c]);
+      xAxis.pushSprite(X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+      Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y);
+      f.end();
+    }
+  }
+}
+
+BENCH_CASE(staticRedraw) // drawStaticGraphBuffer(): full history, one push per sample
+{
+  TFT_eSprite Graph(&benchTFT);
+  TFT_eSprite xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+
+  for (int ch : ctx.channels)
+  {
+    std::vector<int16_t> ox(ch), oy(ch);
+    uint32_t frames = std::max<uint32_t>(1, ctx.frames / (SAMPLE_COUNT + 1));
+    benchFrames f("drawStaticGraphBuffer()", ch);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos);
+      f.begin();
+      std::fill(ox.begin(), ox.end(), 0);
+      std::fill(oy.begin(), oy.end(), GRAPH_HEIGHT);
+      for (int16_t x = 0; x <= SAMPLE_COUNT; x++)
+      {
+        for (int c = 0; c < ch; c++)
+          ytGraph(Graph, x, benchSample(c), benchChannelColor(c), ox[c], oy[c]);
+        Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y);
+      }
+      f.end();
+    }
+  }
+}
+
+/***************************************************************************************
+ * main
+****************************************************************************************/
+
+static void parseChannels(const char *s, std::vector<int> &out)
+{
+  out.clear();
+  while (*s)
+  {
+    int n = atoi(s);
+    if (n > 0 && n <= 16)
+      out.push_back(n);
+    while (*s && *s != ',')
+      s++;
+    if (*s == ',')
+      s++;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  benchContext ctx;
+  ctx.frames = 2000;
+  ctx.channels = {1, 4, 16};
+  ctx.filter = nullptr;
+  ctx.failures = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-f") && i + 1 < argc)
+      ctx.frames = std::max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+      parseChannels(argv[++i], ctx.channels);
+    else if (!strcmp(argv[i], "-x") && i + 2 < argc) // decodes a recorded frame stream, no benchmark
+      return benchDecodeFrames(argv[i + 1], argv[i + 2]);
+    else
+      ctx.filter = argv[i];
+  }
+  if (ctx.channels.empty())
+    ctx.channels = {4};
+
+  printf("ytGraph bench: SAMPLE_COUNT=%d GRAPH_WIDTH=%d GRAPH_HEIGHT=%d frames=%u\n",
+         SAMPLE_COUNT, GRAPH_WIDTH, GRAPH_HEIGHT, ctx.frames);
+
+  for (benchCase *c = benchCases; c; c = c->next)
+  {
+    if (ctx.filter && !strstr(c->name, ctx.filter))
+      continue;
+    printf("%s\n", c->name);
+    randomSeed(1);
+    c->func(ctx);
+  }
+
+  if (ctx.failures)
+  {
+    printf("%u check(s) FAILED\n", ctx.failures);
+    return 1;
+  }
+  return 0;
+}
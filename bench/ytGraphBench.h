@@ -0,0 +1,97 @@
+/***************************************************************************************
+ * Frame time benchmark harness for the ytGraph function set
+ * Platform: Linux (PlatformIO native, see [env:native] in platformio.ini)
+ *
+ *  - every bench case registers itself with BENCH_CASE()
+ *  - per frame latency percentiles, pixel writes and SPI bytes from the host backend
+ *  - BENCH_CHECK() turns a case into a pixel/number compare, a failed check
+ *    makes the benchmark exit with an error
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_BENCH_h
+#define YTGRAPH_BENCH_h
+
+#include <Arduino.h>
+#include <M5Stack.h>
+#include <chrono>
+#include <vector>
+
+struct benchContext
+{
+  uint32_t frames;           // frames per measurement
+  std::vector<int> channels; // channel counts to sweep
+  const char *filter;        // only run cases containing this string
+  uint32_t failures;         // failed BENCH_CHECKs
+};
+
+typedef void (*benchFunc)(benchContext &ctx);
+
+struct benchCase
+{
+  const char *name;
+  benchFunc func;
+  benchCase *next;
+};
+
+struct benchRegistrar
+{
+  benchRegistrar(const char *name, benchFunc func);
+};
+
+#define BENCH_CASE(name)                                 \
+  static void name(benchContext &ctx);                   \
+  static benchRegistrar name##Registrar(#name, name);    \
+  static void name(benchContext &ctx)
+
+#define BENCH_CHECK(ctx, cond, ...)                      \
+  do                                                     \
+  {                                                      \
+    if (!(cond))                                         \
+    {                                                    \
+      (ctx).failures++;                                  \
+      printf("  CHECK FAILED %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__);                               \
+      printf("\n");                                      \
+    }                                                    \
+  } while (0)
+
+class benchFrames // collects one latency and counter sample per frame
+{
+public:
+  benchFrames(const char *label, int channels);
+  ~benchFrames(); // prints the report line
+
+  void begin(); // start of frame
+  void end();   // end of frame
+  void extra(const char *text) { _extra = text; } // optional note at the end of the line
+
+private:
+  const char *_label;
+  int _channels;
+  const char *_extra;
+  std::vector<uint64_t> _ns;
+  std::chrono::steady_clock::time_point _start;
+  hostStats _frameStart, _total;
+};
+
+extern TFT_eSPI &benchTFT; // the host panel all bench sprites push to
+
+uint16_t benchChannelColor(int channel); // 16 distinct line colours
+bool benchSpritesEqual(TFT_eSprite &a, TFT_eSprite &b); // same size, depth and pixels
+
+class ytGraphInstance;
+bool benchPanelShows(ytGraphInstance &g); // unwraps the rings, the panel must show the visible sprite columns
+
+int benchDecodeFrames(const char *stream, const char *prefix); // -x: a ytGraphFrameExport stream to PPM files
+
+#endif
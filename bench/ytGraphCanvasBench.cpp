@@ -0,0 +1,294 @@
+/***************************************************************************************
+ * Benchmarks for the dirty tracking canvas in ytGraphCanvas.h
+ *
+ *  - unbuffered drawing: full push per sample vs. dirty columns only
+ *  - scrolling: software scroll (everything dirty) vs. hardware scrolled panel
+ *  - ring mode: scrolling moves the ring head instead of the pixels
+ *  - the hardware scroll and ring paths must show the same picture on the (emulated) panel
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphCanvas.h"
+
+static int16_t canvasSample(int channel)
+{
+  int16_t lo = (channel * 7) % 50;
+  return (int16_t)random(lo, lo + 10);
+}
+
+BENCH_CASE(canvasUnbuffered) // drawUnbuffered(): one push per sample
+{
+  TFT_eSprite Graph(&benchTFT), xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  ytGraphCanvas g(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y), x(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+  g.begin();
+  x.begin();
+  int16_t LastXGridLinePos = 0;
+
+  for (int ch : ctx.channels)
+  {
+    std::vector<ytGraphChannel> channels(ch);
+    for (int pass = 0; pass < 2; pass++)
+    {
+      ytGraphDrawGridXaxis(g, x, LastXGridLinePos);
+      for (int c = 0; c < ch; c++)
+        channels[c] = ytGraphChannel{benchChannelColor(c), 0, 0};
+      benchFrames f(pass ? "unbuffered, dirty push" : "unbuffered, full push", ch);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        uint16_t sx = i % (SAMPLE_COUNT + 1);
+        if (sx == 0 && i)
+        {
+          ytGraphDrawGridXaxis(g, x, LastXGridLinePos); // new page
+          for (int c = 0; c < ch; c++)
+            channels[c].ox = channels[c].oy = 0;
+        }
+        f.begin();
+        for (int c = 0; c < ch; c++)
+          ytGraph(g, sx, canvasSample(c), channels[c]);
+        if (pass)
+          g.push();
+        else
+        {
+          Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y);
+          g.markClean();
+        }
+        f.end();
+      }
+    }
+  }
+}
+
+BENCH_CASE(canvasScroll) // drawDynamicGraph() with canvases, software vs. hardware scroll, sprite vs. ring
+{
+  static const char *labels[4] = {"canvas scroll, software", "canvas scroll, hw panel",
+                                  "canvas scroll, ring", "canvas scroll, ring + hw"};
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT);
+  for (int ch : ctx.channels)
+  {
+    for (int mode = 0; mode < 4; mode++)
+    {
+      bool hw = mode & 1, ring = mode & 2;
+      TFT_eSPI panel;
+      TFT_eSprite Graph(&panel), xAxis(&panel);
+      Graph.setColorDepth(4);
+      Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+      xAxis.setColorDepth(1);
+      xAxis.createSprite(X_AXIS_WIDTH + (ring ? CANVAS_LABEL_OVERRUN : 0), X_AXIS_HEIGTH);
+      ytGraphCanvas g(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y), x(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+      if (ring)
+      {
+        g.beginRing();
+        x.beginRing(CANVAS_LABEL_OVERRUN);
+      }
+      else
+      {
+        g.begin();
+        x.begin();
+      }
+      ytGraphHwScroll hs{};
+      if (hw)
+      {
+        ytGraphHwScrollBegin(hs, panel, SPRITE_LEFT_X, SPRITE_WIDTH, panel.width());
+        g.setHwScroll(&hs);
+        x.setHwScroll(&hs);
+      }
+      int16_t LastXGridLinePos = 0;
+      ytGraphDrawGridXaxis(g, x, LastXGridLinePos);
+      std::vector<ytGraphChannel> channels(ch, ytGraphChannel{0, GRAPH_WIDTH, GRAPH_HEIGHT});
+      for (int c = 0; c < ch; c++)
+        channels[c].color = benchChannelColor(c);
+
+      benchFrames f(labels[mode], ch);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        f.begin();
+        for (int c = 0; c < ch; c++)
+          channels[c].ox -= scrollX;
+        g.scroll(-scrollX);
+        x.scroll(-scrollX);
+        if (hw)
+          ytGraphHwScrollBy(hs, -scrollX);
+        ytGraphDrawDynamicGrid(g, x, channels[ch - 1].ox, LastXGridLinePos);
+        for (int c = 0; c < ch; c++)
+          ytGraph(g, SAMPLE_COUNT, canvasSample(c), channels[c]);
+        x.push();
+        g.push();
+        f.end();
+      }
+    }
+  }
+}
+
+// helper: one scrolling frame with a bench made grid (the library grid keeps static state)
+static void canvasFrame(ytGraphCanvas &g, ytGraphCanvas &x, ytGraphHwScroll *hs, ytGraphChannel *channels,
+                        const int16_t *values, int ch, uint32_t frame)
+{
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT);
+  for (int c = 0; c < ch; c++)
+    channels[c].ox -= scrollX;
+  g.scroll(-scrollX);
+  x.scroll(-scrollX);
+  if (hs)
+    ytGraphHwScrollBy(*hs, -scrollX);
+  if (frame % 5 == 0)
+  {
+    g.sprite().drawFastVLine(GRAPH_WIDTH, 0, GRAPH_HEIGHT, GRAPH_GRID_COLOR);
+    g.markDirty(GRAPH_WIDTH, 0, 1, GRAPH_HEIGHT);
+    x.sprite().setTextColor(GRAPH_AXIS_TEXT_COLOR, GRAPH_BGRND_COLOR);
+    x.sprite().setCursor(GRAPH_WIDTH + 5, X_AXIS_HEIGTH - 8);
+    x.sprite().print((int)frame);
+    x.markDirty(GRAPH_WIDTH, 0, X_AXIS_WIDTH - GRAPH_WIDTH, X_AXIS_HEIGTH);
+  }
+  for (int c = 0; c < ch; c++)
+    ytGraph(g, SAMPLE_COUNT, values[c], channels[c]);
+  x.push();
+  g.push();
+}
+
+BENCH_CASE(canvasHwScrollPixels) // the panel shows the same picture with and without hardware scroll
+{
+  TFT_eSPI panelA, panelB;
+  TFT_eSprite GraphA(&panelA), xAxisA(&panelA), GraphB(&panelB), xAxisB(&panelB);
+  TFT_eSprite *sprites[4] = {&GraphA, &xAxisA, &GraphB, &xAxisB};
+  for (int i = 0; i < 4; i++)
+  {
+    sprites[i]->setColorDepth(i & 1 ? 1 : 4);
+    sprites[i]->createSprite(i & 1 ? X_AXIS_WIDTH : SPRITE_WIDTH, i & 1 ? X_AXIS_HEIGTH : SPRITE_HEIGTH);
+    sprites[i]->fillSprite(GRAPH_BGRND_COLOR);
+  }
+  ytGraphCanvas gA(GraphA, SPRITE_LEFT_X, SPRITE_UPPER_Y), xA(xAxisA, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+  ytGraphCanvas gB(GraphB, SPRITE_LEFT_X, SPRITE_UPPER_Y), xB(xAxisB, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+  gA.begin(), xA.begin(), gB.begin(), xB.begin();
+  ytGraphHwScroll hs{};
+  ytGraphHwScrollBegin(hs, panelB, SPRITE_LEFT_X, SPRITE_WIDTH, panelB.width());
+  gB.setHwScroll(&hs);
+  xB.setHwScroll(&hs);
+
+  ytGraphChannel chA[4], chB[4];
+  for (int c = 0; c < 4; c++)
+    chA[c] = chB[c] = ytGraphChannel{benchChannelColor(c), GRAPH_WIDTH, GRAPH_HEIGHT};
+
+  uint32_t wrongFrames = 0;
+  for (uint32_t i = 0; i < 3 * (SAMPLE_COUNT + 1) + 7; i++)
+  {
+    int16_t values[4];
+    for (int c = 0; c < 4; c++)
+      values[c] = canvasSample(c);
+    canvasFrame(gA, xA, nullptr, chA, values, 4, i);
+    canvasFrame(gB, xB, &hs, chB, values, 4, i);
+
+    bool same = true;
+    for (int32_t y = 0; y < panelA.height() && same; y++)
+      for (int32_t x = 0; x < panelA.width() && same; x++)
+        same = panelA.readDisplayed(x, y) == panelB.readDisplayed(x, y);
+    if (!same)
+      wrongFrames++;
+  }
+  BENCH_CHECK(ctx, wrongFrames == 0, "hardware scroll picture differs in %u frames", wrongFrames);
+}
+
+BENCH_CASE(canvasRingPixels) // ring mode shows the same picture as the scrolled sprite, also with hw scroll
+{
+  TFT_eSPI panel[3];
+  TFT_eSprite *Graph[3], *xAxis[3];
+  ytGraphCanvas *g[3], *x[3];
+  ytGraphHwScroll hs{};
+  for (int k = 0; k < 3; k++) // 0 = scrolled sprite, 1 = ring, 2 = ring + hw scroll
+  {
+    Graph[k] = new TFT_eSprite(&panel[k]);
+    xAxis[k] = new TFT_eSprite(&panel[k]);
+    Graph[k]->setColorDepth(4);
+    Graph[k]->createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    xAxis[k]->setColorDepth(1);
+    xAxis[k]->createSprite(X_AXIS_WIDTH + (k ? CANVAS_LABEL_OVERRUN : 0), X_AXIS_HEIGTH);
+    g[k] = new ytGraphCanvas(*Graph[k], SPRITE_LEFT_X, SPRITE_UPPER_Y);
+    x[k] = new ytGraphCanvas(*xAxis[k], X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+    if (k)
+    {
+      g[k]->beginRing();
+      x[k]->beginRing(CANVAS_LABEL_OVERRUN);
+    }
+    else
+    {
+      g[k]->begin();
+      x[k]->begin();
+    }
+  }
+  ytGraphHwScrollBegin(hs, panel[2], SPRITE_LEFT_X, SPRITE_WIDTH, panel[2].width());
+  g[2]->setHwScroll(&hs);
+  x[2]->setHwScroll(&hs);
+
+  ytGraphChannel ch[3][4];
+  int16_t LastXGridLinePos[3];
+  for (int k = 0; k < 3; k++)
+  {
+    ytGraphDrawGridXaxis(*g[k], *x[k], LastXGridLinePos[k]);
+    for (int c = 0; c < 4; c++)
+      ch[k][c] = ytGraphChannel{benchChannelColor(c), GRAPH_WIDTH, GRAPH_HEIGHT};
+  }
+
+  ytGraphRing<int16_t, SAMPLE_COUNT + 1> history;
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT);
+  uint32_t xValue = 86380; // the labels grow over the sprite border after a few divisions ("1d0h0m5s")
+  uint32_t wrongFrames = 0, wrongHwFrames = 0;
+  for (uint32_t i = 0; i < 20 * (SAMPLE_COUNT + 1) + 7; i++)
+  {
+    int16_t values[4];
+    for (int c = 0; c < 4; c++)
+      values[c] = canvasSample(c);
+    history.push(values[0]);
+    bool newDiv = i % 5 == 0;
+    if (newDiv)
+      xValue += GRAPH_X_DIV;
+
+    for (int k = 0; k < 3; k++)
+    {
+      if (i == 150) // history redraw without restart, the ring has to be unwrapped
+        ytGraphDrawHistory(*g[k], history, ch[k], 1, [](int16_t v, uint8_t) { return v; });
+      for (int c = 0; c < 4; c++)
+        ch[k][c].ox -= scrollX;
+      g[k]->scroll(-scrollX);
+      x[k]->scroll(-scrollX);
+      if (k == 2)
+        ytGraphHwScrollBy(hs, -scrollX);
+      ytGraphDrawDynamicGrid(*g[k], *x[k], ch[k][3].ox, newDiv, xValue);
+      for (int c = 0; c < 4; c++)
+        ytGraph(*g[k], SAMPLE_COUNT, values[c], ch[k][c]);
+      x[k]->push();
+      g[k]->push();
+    }
+
+    if (memcmp(panel[0].framebuffer(), panel[1].framebuffer(), panel[0].width() * panel[0].height() * 2))
+      wrongFrames++;
+    bool same = true;
+    for (int32_t y = 0; y < panel[0].height() && same; y++)
+      for (int32_t px = 0; px < panel[0].width() && same; px++)
+        same = panel[0].readDisplayed(px, y) == panel[2].readDisplayed(px, y);
+    if (!same)
+      wrongHwFrames++;
+  }
+  BENCH_CHECK(ctx, wrongFrames == 0, "ring picture differs in %u frames", wrongFrames);
+  BENCH_CHECK(ctx, wrongHwFrames == 0, "ring + hw scroll picture differs in %u frames", wrongHwFrames);
+
+  for (int k = 0; k < 3; k++)
+  {
+    delete g[k];
+    delete x[k];
+    delete Graph[k];
+    delete xAxis[k];
+  }
+}
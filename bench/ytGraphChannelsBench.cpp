@@ -0,0 +1,257 @@
+/***************************************************************************************
+ * Benchmarks for the channel store and the column-major render pass in ytGraphChannels.h
+ *
+ *  - a whole page of every channel: ytGraph() per channel and sample (v0.5 way),
+ *    ytGraphSpanSeries() channel by channel and ytGraphDrawChannels() column by column
+ *  - the growth from 4 to 16 channels of each variant (median time of 16 / median time of 4)
+ *  - the column-major pass gives the same pixels as the span series channel by channel
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphChannels.h"
+#include <algorithm>
+
+#define CHANNELS_PAGE (SAMPLE_COUNT + 1) // samples of one page
+
+typedef ytGraphChannelStore<SPAN_CHANNELS, CHANNELS_PAGE> benchStore;
+
+static int16_t channelsSample(uint32_t i, int c) // every channel in its own band, some noise
+{
+  return (int16_t)(3 * c + ((i * (5 + c) + 7 * c) % 13));
+}
+
+static void fillStore(benchStore &s, uint32_t seed)
+{
+  int16_t y[SPAN_CHANNELS];
+  s.clear();
+  for (uint32_t i = 0; i < CHANNELS_PAGE; i++)
+  {
+    for (int c = 0; c < SPAN_CHANNELS; c++)
+      y[c] = channelsSample(seed + i, c);
+    s.push(y);
+  }
+}
+
+static void initChannels(ytGraphChannel *ch)
+{
+  for (int c = 0; c < SPAN_CHANNELS; c++)
+    ch[c] = {benchChannelColor(c), 0, 0};
+}
+
+#define VARIANT_YTGRAPH 0 // ytGraph() per channel and sample
+#define VARIANT_SERIES 1  // ytGraphSpanSeries() per channel
+#define VARIANT_COLUMNS 2 // ytGraphDrawChannels(), column by column
+
+static void drawVariant(TFT_eSprite &Graph, const benchStore &s, ytGraphChannel *ch, int channels, int variant)
+{
+  int16_t y[CHANNELS_PAGE];
+  if (variant == VARIANT_COLUMNS)
+  {
+    const int16_t *rows[SPAN_CHANNELS];
+    uint32_t len;
+    s.runs(0, s.size(), rows, len); // a full page starts at slot 0, one run
+    ytGraphSpanChannels(Graph, ch, channels, 0, rows, len);
+    return;
+  }
+  for (int c = 0; c < channels; c++)
+  {
+    if (variant == VARIANT_SERIES)
+    {
+      for (uint32_t i = 0; i < s.size(); i++)
+        y[i] = s.value(c, i);
+      ytGraphSpanSeries(Graph, ch[c], 0, y, s.size());
+    }
+    else
+      for (uint32_t i = 0; i < s.size(); i++)
+        ytGraph(Graph, i, s.value(c, i), ch[c]);
+  }
+}
+
+static void measure(benchContext &ctx, const char *label, int channels, int variant)
+{
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  benchStore s;
+  ytGraphChannel ch[SPAN_CHANNELS];
+  initChannels(ch);
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+  benchFrames f(label, channels);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    fillStore(s, i);
+    Graph.fillSprite(TFT_BLACK);
+    f.begin();
+    drawVariant(Graph, s, ch, channels, variant);
+    f.end();
+  }
+}
+
+BENCH_CASE(channelsPage) // a page of all channels, three ways
+{
+  static const char *labels[3] = {"ytGraph() per channel", "ytGraphSpanSeries() per channel", "ytGraphDrawChannels()"};
+  for (int ch : ctx.channels)
+    for (int v = VARIANT_YTGRAPH; v <= VARIANT_COLUMNS; v++)
+      measure(ctx, labels[v], std::min(ch, SPAN_CHANNELS), v);
+}
+
+BENCH_CASE(channelsGrowth) // 4 and 16 channels frame by frame (same host load), median of 16 / median of 4
+{
+  static const char *labels[3] = {"ytGraph() per channel", "ytGraphSpanSeries() per channel", "ytGraphDrawChannels()"};
+  static char text[3][48];
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  benchStore s;
+  ytGraphChannel ch[SPAN_CHANNELS];
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+
+  for (int v = VARIANT_YTGRAPH; v <= VARIANT_COLUMNS; v++)
+  {
+    benchFrames f16(labels[v], 16), f4(labels[v], 4); // destroyed in reverse order, the 4 channel line first
+    std::vector<double> us[2];
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      fillStore(s, i);
+      for (int k = 0; k < 2; k++)
+      {
+        benchFrames &f = k ? f16 : f4;
+        initChannels(ch);
+        Graph.fillSprite(TFT_BLACK);
+        auto start = std::chrono::steady_clock::now();
+        f.begin();
+        drawVariant(Graph, s, ch, k ? 16 : 4, v);
+        f.end();
+        us[k].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+      }
+    }
+    for (auto &u : us)
+      std::sort(u.begin(), u.end());
+    snprintf(text[v], sizeof(text[v]), "p50 %.2fx the one of 4 channels", us[1][frames / 2] / us[0][frames / 2]);
+    f16.extra(text[v]);
+  }
+}
+
+BENCH_CASE(channelsCheck) // store, same pixels as channel by channel, split runs
+{
+  // the store: oldest first, wraps, runs
+  {
+    ytGraphChannelStore<3, 5> s;
+    int16_t y[3];
+    for (int16_t i = 0; i < 7; i++)
+    {
+      y[0] = i, y[1] = 10 + i, y[2] = -i;
+      s.push(y);
+    }
+    bool ok = s.size() == 5 && s.full();
+    for (uint32_t i = 0; i < 5; i++)
+      ok = ok && s.value(0, i) == (int16_t)(2 + i) && s.value(1, i) == (int16_t)(12 + i) && s.value(2, i) == -(int16_t)(2 + i);
+    s.column(4, y);
+    ok = ok && y[0] == 6 && y[1] == 16 && y[2] == -6 && s.newest(1) == 16;
+    const int16_t *rows[3];
+    uint32_t len, rest = s.runs(1, 4, rows, len);
+    ok = ok && len + rest == 4 && rows[0][0] == 3 && (rest == 0 || s.row(0)[0] == (int16_t)(3 + len));
+    BENCH_CHECK(ctx, ok, "channel store returns wrong values");
+  }
+
+  // column by column gives the same pixels as ytGraphSpanSeries() channel by channel (4 and 16 bit, AA)
+  for (uint8_t bpp : {4, 16})
+    for (uint32_t seed = 0; seed < 8; seed++)
+    {
+      benchStore s;
+      fillStore(s, seed * 17);
+      TFT_eSprite a(&benchTFT), b(&benchTFT);
+      a.setColorDepth(bpp);
+      a.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+      a.fillSprite(TFT_BLACK);
+      b.setColorDepth(bpp);
+      b.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+      b.fillSprite(TFT_BLACK);
+      ytGraphChannel ca[SPAN_CHANNELS], cb[SPAN_CHANNELS];
+      initChannels(ca);
+      initChannels(cb);
+      bool aa = bpp == 16 && (seed & 1);
+
+      ytGraphDrawChannels(a, s, ca, 0, 0, s.size(), 2 + seed % 3, aa);
+      int16_t y[CHANNELS_PAGE];
+      for (int c = 0; c < SPAN_CHANNELS; c++)
+      {
+        for (uint32_t i = 0; i < s.size(); i++)
+          y[i] = s.value(c, i);
+        ytGraphSpanSeries(b, cb[c], 0, y, s.size(), 2 + seed % 3, aa);
+      }
+      bool last = true;
+      for (int c = 0; c < SPAN_CHANNELS; c++)
+        last = last && ca[c].ox == cb[c].ox && ca[c].oy == cb[c].oy;
+      BENCH_CHECK(ctx, benchSpritesEqual(a, b), "%u bit, seed %u: column by column differs from channel by channel", bpp, seed);
+      BENCH_CHECK(ctx, last, "%u bit, seed %u: last points differ", bpp, seed);
+    }
+
+  // a wrapped store is drawn in two runs, the second one continues the first
+  {
+    benchStore s;
+    fillStore(s, 5);
+    int16_t y[SPAN_CHANNELS];
+    for (int k = 0; k < 7; k++) // head in the middle of the ring
+    {
+      for (int c = 0; c < SPAN_CHANNELS; c++)
+        y[c] = channelsSample(100 + k, c);
+      s.push(y);
+    }
+    benchStore flat;
+    flat.clear();
+    for (uint32_t i = 0; i < s.size(); i++)
+    {
+      s.column(i, y);
+      flat.push(y);
+    }
+    TFT_eSprite a(&benchTFT), b(&benchTFT);
+    a.setColorDepth(4);
+    a.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    a.fillSprite(TFT_BLACK);
+    b.setColorDepth(4);
+    b.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    b.fillSprite(TFT_BLACK);
+    ytGraphChannel ca[SPAN_CHANNELS], cb[SPAN_CHANNELS];
+    initChannels(ca);
+    initChannels(cb);
+    ytGraphDrawChannels(a, s, ca, 0, 0, s.size());
+    ytGraphDrawChannels(b, flat, cb, 0, 0, flat.size());
+    BENCH_CHECK(ctx, benchSpritesEqual(a, b), "wrapped store differs from the same samples in one run");
+  }
+
+  // 1 bit sprite: falls back to ytGraphSeries()
+  {
+    benchStore s;
+    fillStore(s, 3);
+    TFT_eSprite a(&benchTFT), b(&benchTFT);
+    a.setColorDepth(1);
+    a.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    a.fillSprite(TFT_BLACK);
+    b.setColorDepth(1);
+    b.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    b.fillSprite(TFT_BLACK);
+    ytGraphChannel ca[SPAN_CHANNELS], cb[SPAN_CHANNELS];
+    initChannels(ca);
+    initChannels(cb);
+    ytGraphDrawChannels(a, s, ca, 0, 0, s.size());
+    int16_t y[CHANNELS_PAGE];
+    for (int c = 0; c < SPAN_CHANNELS; c++)
+    {
+      for (uint32_t i = 0; i < s.size(); i++)
+        y[i] = s.value(c, i);
+      ytGraphSeries(b, cb[c], 0, y, s.size());
+    }
+    BENCH_CHECK(ctx, benchSpritesEqual(a, b), "1 bit fallback differs from ytGraphSeries()");
+  }
+}
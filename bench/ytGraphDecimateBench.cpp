@@ -0,0 +1,204 @@
+/***************************************************************************************
+ * Benchmarks for the decimation in ytGraphDecimate.h
+ *
+ *  - one screen of a 100 samples/px signal: raw polyline vs. M4 columns vs. LTTB
+ *  - M4 columns must match a naive per column min/max, streaming must match bulk
+ *  - every spike must be visible in the drawn columns
+ *  - LTTB must pick the same points as a straight double implementation
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraph.h"
+
+#define DECIMATE_RATE 100 // raw samples per pixel column
+
+static void makeSignal(std::vector<int16_t> &v, uint32_t n, int channel)
+{
+  // slow wave with noise and a rare single sample spike
+  v.resize(n);
+  int16_t base = 10 + (channel * 7) % 30;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    int16_t s = base + (int16_t)(8 * sin(i * 0.0005 + channel)) + (int16_t)random(-2, 3);
+    if (random(0, 3000) == 0)
+      s = random(0, 2) ? GRAPH_Y_AXIS_MAX : GRAPH_Y_AXIS_MIN;
+    v[i] = s;
+  }
+}
+
+BENCH_CASE(decimateScreen) // one screen of DECIMATE_RATE samples per column
+{
+  uint32_t n = (uint32_t)GRAPH_WIDTH * DECIMATE_RATE;
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  std::vector<std::vector<int16_t>> raw(16);
+  for (int c = 0; c < 16; c++)
+    makeSignal(raw[c], n, c);
+  std::vector<uint16_t> px(n), lx(GRAPH_WIDTH);
+  for (uint32_t i = 0; i < n; i++)
+    px[i] = (uint64_t)i * GRAPH_WIDTH / n;
+  std::vector<int16_t> ly(GRAPH_WIDTH);
+
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 20);
+  for (int ch : ctx.channels)
+  {
+    std::vector<ytGraphChannel> channels(ch);
+    for (int c = 0; c < ch; c++)
+      channels[c].color = benchChannelColor(c);
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+      static const char *labels[3] = {"raw polyline", "M4 stream + columns", "LTTB + polyline"};
+      benchFrames f(labels[mode], ch);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        Graph.fillSprite(GRAPH_BGRND_COLOR);
+        f.begin();
+        for (int c = 0; c < ch; c++)
+        {
+          if (mode == 0)
+            ytGraphDrawPoints(Graph, channels[c], px.data(), raw[c].data(), n);
+          else if (mode == 1)
+          {
+            ytGraphDecimator d(n, GRAPH_WIDTH);
+            int16_t x = 0;
+            for (uint32_t k = 0; k < n; k++)
+              if (d.add(raw[c][k]))
+                ytGraphDrawColumn(Graph, x++, d.column(), channels[c]);
+          }
+          else
+          {
+            uint16_t m = ytGraphLTTB(raw[c].data(), n, lx.data(), ly.data(), GRAPH_WIDTH, GRAPH_WIDTH);
+            ytGraphDrawPoints(Graph, channels[c], lx.data(), ly.data(), m);
+          }
+        }
+        f.end();
+      }
+    }
+  }
+}
+
+// reference: column k holds the samples ceil(k * n / columns) .. ceil((k + 1) * n / columns) - 1
+static ytGraphColumn naiveColumn(const int16_t *in, uint32_t n, uint16_t columns, uint16_t k)
+{
+  uint32_t a = ((uint64_t)k * n + columns - 1) / columns, b = ((uint64_t)(k + 1) * n + columns - 1) / columns;
+  ytGraphColumn c{in[a], in[a], in[a], in[b - 1], (uint16_t)(b - a)};
+  for (uint32_t i = a; i < b; i++)
+  {
+    c.min = std::min(c.min, in[i]);
+    c.max = std::max(c.max, in[i]);
+  }
+  return c;
+}
+
+static bool sameColumn(const ytGraphColumn &a, const ytGraphColumn &b)
+{
+  return a.first == b.first && a.min == b.min && a.max == b.max && a.last == b.last && a.count == b.count;
+}
+
+// reference LTTB in double, straight from the paper
+static void naiveLTTB(const int16_t *in, uint32_t n, std::vector<uint32_t> &pick, uint16_t points)
+{
+  pick.assign(1, 0);
+  uint32_t a = 0;
+  for (uint32_t b = 0; b < (uint32_t)points - 2; b++)
+  {
+    uint32_t start = 1 + (uint32_t)((uint64_t)b * (n - 2) / (points - 2));
+    uint32_t end = 1 + (uint32_t)((uint64_t)(b + 1) * (n - 2) / (points - 2));
+    uint32_t nextEnd = b + 3 == points ? n : 1 + (uint32_t)((uint64_t)(b + 2) * (n - 2) / (points - 2));
+    double cx = 0, cy = 0;
+    for (uint32_t i = end; i < nextEnd; i++)
+      cx += i, cy += in[i];
+    cx /= nextEnd - end;
+    cy /= nextEnd - end;
+    double best = -1;
+    uint32_t p = start;
+    for (uint32_t i = start; i < end; i++)
+    {
+      double area = fabs((a - cx) * (in[i] - in[a]) - (a - (double)i) * (cy - in[a]));
+      if (area > best)
+        best = area, p = i;
+    }
+    pick.push_back(p);
+    a = p;
+  }
+  pick.push_back(n - 1);
+}
+
+BENCH_CASE(decimateCheck) // M4 and LTTB against straight implementations, spikes stay visible
+{
+  const uint32_t sizes[3] = {(uint32_t)GRAPH_WIDTH * DECIMATE_RATE, 1000, GRAPH_WIDTH + 7};
+  std::vector<int16_t> raw;
+  std::vector<ytGraphColumn> bulk(GRAPH_WIDTH), stream;
+  uint32_t wrongBulk = 0, wrongStream = 0, lostSpikes = 0, wrongLTTB = 0;
+
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(16);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+
+  for (int t = 0; t < 3; t++)
+  {
+    uint32_t n = sizes[t];
+    makeSignal(raw, n, t);
+
+    uint16_t cols = ytGraphDecimateM4(raw.data(), n, bulk.data(), GRAPH_WIDTH);
+    BENCH_CHECK(ctx, cols == GRAPH_WIDTH, "n=%u: %u columns instead of %u", n, cols, GRAPH_WIDTH);
+    for (uint16_t k = 0; k < cols; k++)
+      if (!sameColumn(bulk[k], naiveColumn(raw.data(), n, GRAPH_WIDTH, k)))
+        wrongBulk++;
+
+    // streaming in chunks of random size gives the same columns
+    ytGraphDecimator d(n, GRAPH_WIDTH);
+    stream.clear();
+    for (uint32_t i = 0; i < n;)
+    {
+      uint32_t chunk = std::min<uint32_t>(n - i, random(1, 500));
+      for (uint32_t k = 0; k < chunk; k++)
+        if (d.add(raw[i + k]))
+          stream.push_back(d.column());
+      i += chunk;
+    }
+    if (d.flush())
+      stream.push_back(d.column());
+    if (stream.size() != cols)
+      wrongStream++;
+    for (uint16_t k = 0; k < cols && k < stream.size(); k++)
+      if (!sameColumn(bulk[k], stream[k]))
+        wrongStream++;
+
+    // the min and the max of every column are drawn
+    Graph.fillSprite(TFT_BLACK);
+    ytGraphChannel ch{TFT_WHITE, 0, 0};
+    ytGraphDrawColumns(Graph, ch, 0, bulk.data(), cols);
+    for (uint16_t k = 0; k < cols; k++)
+      if (Graph.readPixel(k, ytGraphMapY(ytGraphScaleDefault, bulk[k].max)) != TFT_WHITE ||
+          Graph.readPixel(k, ytGraphMapY(ytGraphScaleDefault, bulk[k].min)) != TFT_WHITE)
+        lostSpikes++;
+
+    // LTTB
+    std::vector<uint16_t> px(GRAPH_WIDTH);
+    std::vector<int16_t> py(GRAPH_WIDTH);
+    std::vector<uint32_t> ref;
+    uint16_t m = ytGraphLTTB(raw.data(), n, px.data(), py.data(), GRAPH_WIDTH / 2, GRAPH_WIDTH);
+    naiveLTTB(raw.data(), n, ref, GRAPH_WIDTH / 2);
+    BENCH_CHECK(ctx, m == GRAPH_WIDTH / 2, "n=%u: LTTB gave %u points", n, m);
+    for (uint16_t k = 0; k < m; k++)
+      if (px[k] != (uint64_t)ref[k] * GRAPH_WIDTH / n || py[k] != raw[ref[k]])
+        wrongLTTB++;
+  }
+  BENCH_CHECK(ctx, wrongBulk == 0, "%u bulk M4 columns differ from the naive min/max", wrongBulk);
+  BENCH_CHECK(ctx, wrongStream == 0, "%u streamed M4 columns differ from bulk", wrongStream);
+  BENCH_CHECK(ctx, lostSpikes == 0, "%u columns do not show their min/max", lostSpikes);
+  BENCH_CHECK(ctx, wrongLTTB == 0, "%u LTTB points differ from the reference", wrongLTTB);
+}
@@ -0,0 +1,304 @@
+/***************************************************************************************
+ * Benchmarks for the frame export in ytGraphExport.h
+ *
+ *  - the scrolling frame of the demo with and without export, bytes per frame
+ *    against a full 4 bit sprite
+ *  - round trip: every decoded frame shows what the sprite showed, for a plain
+ *    and a ring canvas, with scrolling, a redraw of everything, a frame without
+ *    scroll and a key frame in between, a cut stream ends at the last whole frame
+ *  - benchDecodeFrames() behind the -x option turns a recorded stream into PPM files
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphExport.h"
+
+class exportCapture : public Print // the bytes of the stream
+{
+public:
+  size_t write(uint8_t c) override
+  {
+    bytes.push_back(c);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    bytes.insert(bytes.end(), buffer, buffer + size);
+    return size;
+  }
+  std::vector<uint8_t> bytes;
+};
+
+class exportCount : public Print // bytes only, for the timing
+{
+public:
+  size_t write(uint8_t) override
+  {
+    bytes++;
+    return 1;
+  }
+  size_t write(const uint8_t *, size_t size) override
+  {
+    bytes += size;
+    return size;
+  }
+  uint64_t bytes = 0;
+};
+
+class exportFile : public Print // -x: one PPM file
+{
+public:
+  exportFile(FILE *f) : _f(f) {}
+  size_t write(uint8_t c) override { return fputc(c, _f) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *buffer, size_t size) override { return fwrite(buffer, 1, size, _f); }
+
+private:
+  FILE *_f;
+};
+
+struct exportGraph // the scrolling graph of the demo, plain sprite or ring canvas
+{
+  TFT_eSprite Graph, xAxis;
+  ytGraphCanvas g, x;
+  ytGraphChannel ch[4];
+  int16_t last;
+  uint32_t xValue;
+
+  exportGraph(bool ring) : Graph(&benchTFT), xAxis(&benchTFT), g(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y), x(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y), xValue(0)
+  {
+    Graph.setColorDepth(4);
+    Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    xAxis.setColorDepth(1);
+    xAxis.createSprite(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH);
+    if (ring)
+    {
+      g.beginRing();
+      x.beginRing(CANVAS_LABEL_OVERRUN);
+    }
+    else
+    {
+      g.begin();
+      x.begin();
+    }
+    restart();
+  }
+
+  void restart()
+  {
+    ytGraphDrawGridXaxis(g, x, last);
+    for (int c = 0; c < 4; c++)
+      ch[c] = ytGraphChannel{benchChannelColor(c), GRAPH_WIDTH, GRAPH_HEIGHT};
+  }
+
+  void step(uint32_t i, int16_t samples = 1) // scrolls and draws 'samples' new samples
+  {
+    const ytGraphLayout &cfg = ytGraphLayoutDefault;
+    for (int16_t s = 0; s < samples; s++)
+    {
+      bool newDiv = (i + s) % 5 == 0;
+      if (newDiv)
+        xValue += GRAPH_X_DIV;
+      for (int c = 0; c < 4; c++)
+        ch[c].ox -= cfg.scrollStep;
+      g.scroll(-cfg.scrollStep);
+      x.scroll(-cfg.scrollStep);
+      ytGraphDrawDynamicGrid(g, x, cfg, ch[3].ox, newDiv, xValue);
+      for (int c = 0; c < 4; c++)
+        ytGraph(g, SAMPLE_COUNT, (int16_t)((i * (3 + c) + 11 * c + s) % 57), ch[c]);
+    }
+    x.push();
+    g.push();
+  }
+
+  void visible(std::vector<uint16_t> &frame) // the visible columns as the panel shows them
+  {
+    int16_t org[2];
+    g.origins(0, 0, org);
+    frame.clear();
+    for (int16_t y = 0; y < Graph.height(); y++)
+      for (int16_t px = 0; px < g.width(); px++)
+        frame.push_back(Graph.readPixel((px + org[0]) % Graph.width(), y));
+  }
+};
+
+BENCH_CASE(exportFrame) // the scrolling frame with and without export to a byte sink
+{
+  static char note[64];
+  for (int k = 0; k < 2; k++)
+  {
+    exportGraph e(true);
+    exportCount out;
+    ytGraphFrameExport ex;
+    if (k)
+      ex.begin(out, e.g);
+    uint64_t header = out.bytes;
+    benchFrames f(k ? "ring canvas + export" : "ring canvas", 4);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      f.begin();
+      e.step(i);
+      if (k)
+        ex.frame(e.g, -ytGraphLayoutDefault.scrollStep, i);
+      f.end();
+    }
+    if (k)
+    {
+      snprintf(note, sizeof(note), "%.0f bytes/frame (raw 4 bit frame %d)", (double)(out.bytes - header) / ctx.frames,
+               SPRITE_WIDTH * SPRITE_HEIGTH / 2);
+      f.extra(note);
+    }
+  }
+}
+
+BENCH_CASE(exportCheck) // decoded frames = the sprite, cut streams, PPM
+{
+  for (int ring = 0; ring < 2; ring++)
+  {
+    exportGraph e(ring);
+    exportCapture out;
+    ytGraphFrameExport ex;
+    bool begun = ex.begin(out, e.g);
+    BENCH_CHECK(ctx, begun && out.bytes.size() == EXPORT_HEADER_BYTES, "begin(): %u header bytes", (unsigned)out.bytes.size());
+
+    std::vector<std::vector<uint16_t>> shown;
+    std::vector<size_t> ends;
+    uint32_t frames = 3 * (SAMPLE_COUNT + 1), deltaBytes = 0, deltas = 0;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      int16_t dx = -ytGraphLayoutDefault.scrollStep;
+      if (i == 20) // two samples at once
+      {
+        e.step(i, 2);
+        dx *= 2;
+      }
+      else if (i == 30) // everything redrawn, the ring starts over
+      {
+        e.restart();
+        dx = 0;
+      }
+      else if (i == 40) // only a line is added, nothing scrolls
+      {
+        ytGraph(e.g, SAMPLE_COUNT / 2, 5, e.ch[0]);
+        e.g.push();
+        dx = 0;
+      }
+      else
+        e.step(i);
+      if (i == 45)
+        ex.key();
+      size_t n = ex.frame(e.g, dx, 1000 * i);
+      if (i && i != 30 && i != 45)
+      {
+        deltaBytes += n;
+        deltas++;
+      }
+      shown.emplace_back();
+      e.visible(shown.back());
+      ends.push_back(out.bytes.size());
+    }
+
+    ytGraphFrameDecoder dec;
+    bool ok = dec.begin(out.bytes.data(), out.bytes.size()) && dec.width() == e.g.width() && dec.height() == SPRITE_HEIGTH;
+    uint32_t wrong = 0, keys = 0;
+    while (ok && dec.next())
+    {
+      const std::vector<uint16_t> &s = shown[dec.frames() - 1];
+      bool same = dec.time() == 1000 * (dec.frames() - 1);
+      for (int16_t y = 0; same && y < dec.height(); y++)
+        for (int16_t x = 0; same && x < dec.width(); x++)
+          same = dec.color(x, y) == s[(size_t)y * dec.width() + x];
+      wrong += !same;
+      keys += dec.isKey();
+    }
+    BENCH_CHECK(ctx, ok && dec.frames() == frames && !wrong && keys == 2, "%s: %u of %u frames decoded, %u differ, %u key frames",
+                ring ? "ring" : "sprite", dec.frames(), frames, wrong, keys);
+
+    // a scrolling frame is a small part of a full 4 bit frame
+    uint32_t mean = deltas ? deltaBytes / deltas : 0;
+    BENCH_CHECK(ctx, mean && mean < SPRITE_WIDTH * SPRITE_HEIGTH / 2 / 4, "%s: %u bytes per scrolling frame",
+                ring ? "ring" : "sprite", mean);
+
+    // a stream cut inside a frame ends at the frame before
+    ytGraphFrameDecoder cut;
+    cut.begin(out.bytes.data(), ends[frames - 2] + 7);
+    while (cut.next())
+      ;
+    BENCH_CHECK(ctx, cut.frames() == frames - 1, "cut stream: %u frames decoded", cut.frames());
+  }
+
+  // PPM of the last frame
+  {
+    exportGraph e(false);
+    exportCapture out, picture;
+    ytGraphFrameExport ex;
+    ex.begin(out, e.g);
+    e.step(1);
+    ex.frame(e.g, -ytGraphLayoutDefault.scrollStep, 0);
+    ytGraphFrameDecoder dec;
+    dec.begin(out.bytes.data(), out.bytes.size());
+    dec.next();
+    size_t n = dec.ppm(picture);
+    char head[32];
+    int h = snprintf(head, sizeof(head), "P6\n%d %d\n255\n", SPRITE_WIDTH, SPRITE_HEIGTH);
+    bool ok = n == picture.bytes.size() && n == (size_t)h + 3 * SPRITE_WIDTH * SPRITE_HEIGTH &&
+              !memcmp(picture.bytes.data(), head, h);
+    BENCH_CHECK(ctx, ok, "ppm(): %u bytes", (unsigned)n);
+  }
+
+  // only 4 bit sprites
+  {
+    TFT_eSprite s(&benchTFT);
+    s.setColorDepth(16);
+    s.createSprite(32, 16);
+    exportCapture out;
+    ytGraphFrameExport ex;
+    BENCH_CHECK(ctx, !ex.begin(out, s, 32) && out.bytes.empty(), "begin() accepts a 16 bit sprite");
+  }
+}
+
+int benchDecodeFrames(const char *stream, const char *prefix)
+{
+  FILE *f = fopen(stream, "rb");
+  if (!f)
+  {
+    printf("cannot open %s\n", stream);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  for (size_t n; (n = fread(chunk, 1, sizeof(chunk), f)) > 0;)
+    data.insert(data.end(), chunk, chunk + n);
+  fclose(f);
+
+  ytGraphFrameDecoder dec;
+  if (!dec.begin(data.data(), data.size()))
+  {
+    printf("%s is no ytGraph frame stream\n", stream);
+    return 1;
+  }
+  while (dec.next())
+  {
+    char name[256];
+    snprintf(name, sizeof(name), "%s%05u.ppm", prefix, dec.frames() - 1);
+    FILE *out = fopen(name, "wb");
+    if (!out)
+    {
+      printf("cannot write %s\n", name);
+      return 1;
+    }
+    exportFile picture(out);
+    dec.ppm(picture);
+    fclose(out);
+  }
+  printf("%u frames of %dx%d px from %s\n", dec.frames(), dec.width(), dec.height(), stream);
+  return 0;
+}
@@ -0,0 +1,177 @@
+/***************************************************************************************
+ * Benchmarks for the compressed history in ytGraphGorilla.h
+ *
+ *  - bytes per sample for slow sensor data and for the random demo data
+ *  - decoding and drawing a full screen must fit easily into one sample interval
+ *  - every sample must come back bit exact, also across dropped blocks
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphGorilla.h"
+
+typedef ytGraphGorillaHistory<4, 1024, 16> benchGorilla;
+
+struct benchSensors // same layout as the sensors struct of the demo
+{
+  float temperature1;
+  float temperature2;
+  float temperature3;
+  int8_t humidity;
+};
+
+static void sensorSample(uint32_t i, bool demo, float *v)
+{
+  if (demo) // the random values of simulateHistBufferWrite()
+  {
+    v[0] = random(0, 200) / 10.0;
+    v[1] = random(200, 400) / 10.0;
+    v[2] = random(400, 600) / 10.0;
+    v[3] = random(0, 10);
+    return;
+  }
+  // slow temperatures with a 0.1 °C resolution, humidity in whole percent
+  for (int c = 0; c < 3; c++)
+    v[c] = lround(10 * (20 + 10 * c + 3 * sin(i * 0.002 + c) + 0.04 * random(-1, 2))) / 10.0f;
+  v[3] = lround(55 + 10 * sin(i * 0.0005));
+}
+
+BENCH_CASE(gorillaRatio) // compression of the demo sensor data
+{
+  static benchGorilla h;
+  static char text[2][80];
+  for (int demo = 0; demo < 2; demo++)
+  {
+    h.clear();
+    uint32_t t = 1000, n = 0;
+    float v[4];
+    benchFrames f(demo ? "append, random demo data" : "append, slow sensor data", 4);
+    while (h.size() == n) // until the first block is dropped
+    {
+      sensorSample(n, demo, v);
+      f.begin();
+      h.append(t, v);
+      f.end();
+      t += 1000 + (random(0, 20) == 0 ? random(-3, 4) : 0); // 1 s with a little jitter
+      n++;
+    }
+    double perSample = (double)h.bytesUsed() / h.size();
+    double ratio = (sizeof(benchSensors) + 4) / perSample; // raw struct and a timestamp
+    snprintf(text[demo], sizeof(text[demo]), "%.2f bytes/sample, %.1fx", perSample, ratio);
+    f.extra(text[demo]);
+    if (!demo)
+      BENCH_CHECK(ctx, ratio >= 5, "slow sensor data compressed only %.1fx", ratio);
+  }
+}
+
+BENCH_CASE(gorillaRedraw) // newest screen decoded on the fly and drawn, from a full history
+{
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  static benchGorilla h;
+  h.clear();
+  float v[4];
+  for (uint32_t i = 0; i < 20000; i++)
+  {
+    sensorSample(i, false, v);
+    h.append(i * 1000, v);
+  }
+
+  ytGraphChannel channels[4];
+  for (int c = 0; c < 4; c++)
+    channels[c] = ytGraphChannel{benchChannelColor(c), 0, 0};
+  auto value = [](const float *v, uint8_t c) { return (int16_t)lround(v[c]); };
+  uint64_t worst = 0;
+  {
+    benchFrames f("decode + draw one screen", 4);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      Graph.fillSprite(GRAPH_BGRND_COLOR);
+      auto start = std::chrono::steady_clock::now();
+      f.begin();
+      ytGraphDrawGorilla(Graph, h, channels, 4, value);
+      f.end();
+      uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      worst = std::max(worst, ns);
+    }
+  }
+  BENCH_CHECK(ctx, worst < SAMPLE_RATE * 1000000000ull / 10, "redraw took %.2f ms, more than 10%% of a sample interval", worst / 1e6);
+
+  // decode speed of the whole history without drawing
+  static char text[80];
+  uint32_t n = 0;
+  benchFrames f("decode whole history", 4);
+  for (uint32_t i = 0; i < std::max<uint32_t>(1, ctx.frames / 10); i++)
+  {
+    f.begin();
+    h.forEach(0, [&](uint32_t, const float *) { n++; });
+    f.end();
+  }
+  snprintf(text, sizeof(text), "%u samples", (unsigned)h.size());
+  f.extra(text);
+}
+
+BENCH_CASE(gorillaCheck) // bit exact roundtrip, timestamps with gaps, dropped blocks
+{
+  static ytGraphGorillaHistory<3, 256, 4> h;
+  std::vector<uint32_t> ts;
+  std::vector<uint32_t> bits; // all values as bit patterns, so that -0 and nan compare exact
+  h.clear();
+  uint32_t t = 0xFFFFF000; // the timestamps wrap around as well
+  const float special[6] = {0.0f, -0.0f, INFINITY, -INFINITY, NAN, 1e-40f};
+  for (uint32_t i = 0; i < 3000; i++)
+  {
+    float v[3];
+    v[0] = (float)random(-1000000, 1000000) / random(1, 1000); // random floats
+    v[1] = i % 50 < 25 ? 21.5f : 21.6f;                         // mostly unchanged
+    v[2] = special[random(0, 6)];
+    long gap = random(0, 10);
+    t += gap == 0 ? random(0, 100000) : gap == 1 ? random(0, 3000) : 1000; // large and small gaps
+    h.append(t, v);
+    ts.push_back(t);
+    for (int c = 0; c < 3; c++)
+    {
+      uint32_t u;
+      memcpy(&u, &v[c], 4);
+      bits.push_back(u);
+    }
+  }
+
+  // the history keeps the newest samples, whole blocks are dropped
+  uint32_t n = h.size();
+  BENCH_CHECK(ctx, n > 0 && n < 3000, "%u samples kept, expected some blocks to be dropped", n);
+  BENCH_CHECK(ctx, h.bytesUsed() <= 4 * 256, "%u bytes used in 4 blocks of 256", h.bytesUsed());
+
+  uint32_t first = 3000 - n;
+  for (uint32_t from : {0u, 1u, n / 2, n - 1})
+  {
+    uint32_t k = first + from, wrongTime = 0, wrongValue = 0, count = 0;
+    h.forEach(from, [&](uint32_t time, const float *v)
+              {
+                if (k < ts.size() && time != ts[k])
+                  wrongTime++;
+                for (int c = 0; c < 3 && k < ts.size(); c++)
+                {
+                  uint32_t u;
+                  memcpy(&u, &v[c], 4);
+                  if (u != bits[k * 3 + c])
+                    wrongValue++;
+                }
+                k++;
+                count++;
+              });
+    BENCH_CHECK(ctx, count == n - from, "from %u: %u samples decoded, expected %u", from, count, n - from);
+    BENCH_CHECK(ctx, wrongTime == 0, "from %u: %u timestamps differ", from, wrongTime);
+    BENCH_CHECK(ctx, wrongValue == 0, "from %u: %u values differ", from, wrongValue);
+  }
+}
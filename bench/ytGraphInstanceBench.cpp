@@ -0,0 +1,134 @@
+/***************************************************************************************
+ * Benchmarks for the graph instances and the scheduler in ytGraphInstance.h
+ *
+ *  - four graphs with different sizes, sample counts and rates on one panel,
+ *    one scheduler frame samples the due graphs and pushes their dirty regions
+ *  - a graph scrolls the same, alone or next to other graphs
+ *  - after every frame the panel shows exactly what is in the sprites
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphInstance.h"
+
+static ytGraphConfig quarterConfig(uint8_t quarter) // a 2x2 layout of small graphs on the 320x240 panel
+{
+  static const uint16_t samples[4] = {25, 20, 50, 10}, xDiv[4] = {5, 5, 10, 2};
+  ytGraphConfig cfg = ytGraphConfigDefault;
+  cfg.left = quarter & 1 ? 200 : 30; // the x axis sprites are 50 px wider than the graph, they must not overlap
+  cfg.bottom = quarter & 2 ? 200 : 90;
+  cfg.width = 100;
+  cfg.height = 60;
+  cfg.samples = samples[quarter];
+  cfg.xDiv = xDiv[quarter];
+  cfg.timeFormat = "SSMH"[quarter];
+  cfg.yDiv = 20;
+  cfg.xLabel = "";
+  cfg.yLabel = "";
+  return cfg;
+}
+
+static bool benchSource(ytGraphInstance &g, int16_t *y, void *user)
+{
+  uint32_t &n = *(uint32_t *)user;
+  for (uint8_t c = 0; c < g.channels(); c++)
+    y[c] = (int16_t)((n * (7 + c) + 13 * c) % 61);
+  n++;
+  return true;
+}
+
+static const uint32_t intervals[4] = {250, 500, 1000, 2000}; // ms
+
+BENCH_CASE(instanceFrame) // 1, 2 and 4 graphs scrolling independently, one scheduler frame per 250 ms
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  static const char *labels[3] = {"1 graph", "2 graphs", "4 graphs"};
+
+  for (int ch : ctx.channels)
+    for (int k = 0; k < 3; k++)
+    {
+      uint8_t graphs = 1 << k;
+      std::vector<ytGraphInstance *> g;
+      uint32_t state[4] = {};
+      ytGraphScheduler scheduler(benchTFT);
+      benchTFT.fillScreen(TFT_BLACK);
+      for (uint8_t i = 0; i < graphs; i++)
+      {
+        g.push_back(new ytGraphInstance(benchTFT, quarterConfig(i)));
+        g[i]->begin(colors, ch);
+        scheduler.add(*g[i], intervals[i], benchSource, &state[i]);
+      }
+      benchFrames f(labels[k], ch);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        f.begin();
+        scheduler.run(i * 250);
+        f.end();
+      }
+      for (ytGraphInstance *p : g)
+        delete p;
+    }
+}
+
+BENCH_CASE(instanceCheck) // independent timelines, panel content after the scheduler frames
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  const uint32_t frames = 400; // 100 s, several divisions of every graph
+
+  // graph 1 alone
+  ytGraphInstance alone(benchTFT, quarterConfig(1));
+  {
+    uint32_t state = 0;
+    ytGraphScheduler scheduler(benchTFT);
+    alone.begin(colors, 3);
+    scheduler.add(alone, intervals[1], benchSource, &state);
+    for (uint32_t i = 0; i < frames; i++)
+      scheduler.run(i * 250);
+  }
+
+  // the same graph next to three others, every frame must leave the panel right
+  ytGraphInstance *g[4];
+  uint32_t state[4] = {};
+  ytGraphScheduler scheduler(benchTFT);
+  benchTFT.fillScreen(TFT_BLACK);
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    g[i] = new ytGraphInstance(benchTFT, quarterConfig(i));
+    g[i]->begin(colors, 3);
+    scheduler.add(*g[i], intervals[i], benchSource, &state[i]);
+  }
+  uint32_t wrongFrames = 0;
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    scheduler.run(i * 250);
+    if (i % 37 == 0) // unwrap is expensive, every 37th frame
+      for (uint8_t k = 0; k < 4; k++)
+        if (!benchPanelShows(*g[k]))
+          wrongFrames++;
+  }
+  for (uint8_t k = 0; k < 4; k++)
+    if (!benchPanelShows(*g[k]))
+      wrongFrames++;
+  BENCH_CHECK(ctx, wrongFrames == 0, "%u times the panel differed from a graph sprite", wrongFrames);
+
+  alone.graph().unwrap();
+  alone.xAxis().unwrap();
+  BENCH_CHECK(ctx, g[1]->count() == alone.count(), "%u samples next to others, %u alone", g[1]->count(), alone.count());
+  BENCH_CHECK(ctx, benchSpritesEqual(g[1]->graph().sprite(), alone.graph().sprite()), "graph differs when other graphs scroll as well");
+  BENCH_CHECK(ctx, benchSpritesEqual(g[1]->xAxis().sprite(), alone.xAxis().sprite()), "x axis differs when other graphs scroll as well");
+  for (uint8_t k = 0; k < 4; k++)
+    delete g[k];
+}
@@ -0,0 +1,229 @@
+/***************************************************************************************
+ * Benchmarks for the x axis label cache in ytGraphLabels.h
+ *
+ *  - the scroll frames of one graph instance: frames with a new division (label)
+ *    vs. the other frames, printed labels vs. labels copied from the cache
+ *  - ytGraphFormatTime() gives the same text as the sprintf() of v0.5
+ *  - a copied label gives the same pixels as print(), also clipped at both borders
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphInstance.h"
+#include <algorithm>
+
+static void sprintfTime(char *str, int32_t t, char format) // the calcTime() of v0.5
+{
+  uint8_t sec = 0, min = 0, hour = 0, day = 0;
+  switch (format)
+  {
+  case 'S':
+    sec = t % 60, t = (t - sec) / 60;
+    min = t % 60, t = (t - min) / 60;
+    hour = t % 24, t = (t - hour) / 24;
+    day = t;
+    if (day > 0)
+      sprintf(str, "%id%ih%im%is", day, hour, min, sec);
+    else if (hour > 0)
+      sprintf(str, "%ih%im%is", hour, min, sec);
+    else if (min > 0)
+      sprintf(str, "%im%is", min, sec);
+    else
+      sprintf(str, "%is", sec);
+    break;
+  case 'M':
+    min = t % 60, t = (t - min) / 60;
+    hour = t % 24, t = (t - hour) / 24;
+    day = t;
+    if (day > 0)
+      sprintf(str, "%id%ih%im", day, hour, min);
+    else if (hour > 0)
+      sprintf(str, "%ih%im", hour, min);
+    else
+      sprintf(str, "%im", min);
+    break;
+  case 'H':
+    hour = t % 24, t = (t - hour) / 24;
+    day = t;
+    if (day > 0)
+      sprintf(str, "%id%ih", day, hour);
+    else
+      sprintf(str, "%ih", hour);
+    break;
+  default:
+    sprintf(str, "%i", t);
+    break;
+  }
+}
+
+static ytGraphConfig labelsConfig(char format) // a new division every fourth sample
+{
+  ytGraphConfig cfg = ytGraphConfigDefault;
+  cfg.left = 30;
+  cfg.bottom = 200;
+  cfg.width = 200;
+  cfg.height = 100;
+  cfg.samples = 100;
+  cfg.xDiv = 4;
+  cfg.timeFormat = format;
+  cfg.xLabel = "";
+  cfg.yLabel = "";
+  return cfg;
+}
+
+struct labelsAxis // graph and x axis ring sprites like in ytGraphInstance, scrolled without lines
+{
+  TFT_eSprite graphSprite, xAxisSprite;
+  ytGraphCanvas graph, xAxis;
+  ytGraphTimeline tl;
+  int16_t lastXGridLinePos;
+
+  explicit labelsAxis(const ytGraphLayout &cfg)
+      : graphSprite(&benchTFT), xAxisSprite(&benchTFT), graph(graphSprite, cfg.spriteX(), cfg.spriteY()),
+        xAxis(xAxisSprite, cfg.xAxisX(), cfg.xAxisY()), tl(ytGraphTimelineInit(cfg)), lastXGridLinePos(0)
+  {
+    graphSprite.setColorDepth(4);
+    xAxisSprite.setColorDepth(1);
+    graphSprite.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+    xAxisSprite.createSprite(cfg.xAxisWidth() + CANVAS_LABEL_OVERRUN, cfg.xAxisHeight());
+    graph.beginRing();
+    xAxis.beginRing(CANVAS_LABEL_OVERRUN);
+    ytGraphDrawGridXaxis(graph, xAxis, cfg, lastXGridLinePos, cfg.timeFormat);
+  }
+
+  bool step(const ytGraphLayout &cfg, uint32_t &xValue) // scrolls one sample, true if a new division is due
+  {
+    graph.scroll(-cfg.scrollStep);
+    xAxis.scroll(-cfg.scrollStep);
+    return ytGraphDynamicGridStep(tl, cfg, lastXGridLinePos, xValue);
+  }
+};
+
+BENCH_CASE(labelsFrame) // scroll frames with and without a new x axis label: printed vs. copied from the cache
+{
+  ytGraphLayout cfg(labelsConfig('S'));
+  uint32_t frames = std::max<uint32_t>(ctx.frames, 8);
+
+  for (int cached = 0; cached < 2; cached++)
+  {
+    labelsAxis a(cfg);
+    ytGraphLabelCache labels(benchTFT);
+    labels.begin(cfg);
+    benchFrames fo(cached ? "cache: frame without label" : "print: frame without label", 0);
+    benchFrames fl(cached ? "cache: frame with label" : "print: frame with label", 0);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      uint32_t xValue = 0;
+      bool newDiv = a.step(cfg, xValue);
+      benchFrames &f = newDiv ? fl : fo;
+      f.begin();
+      ytGraphDrawDynamicGrid(a.graph, a.xAxis, cfg, cfg.width - cfg.scrollStep, newDiv, xValue, cached ? &labels : nullptr);
+      if (cached && !newDiv) // like ytGraphInstance::add()
+        labels.prefetch(a.tl.lastXaxisValue + cfg.xDiv);
+      f.end();
+    }
+  }
+}
+
+static void labelsPattern(TFT_eSprite &s, uint32_t seed) // the label must keep the pixels around it
+{
+  for (int16_t y = 0; y < s.height(); y++)
+    for (int16_t x = 0; x < s.width(); x++)
+      s.drawPixel(x, y, ((x * 7 + y * 13 + seed) % 5) < 2 ? TFT_WHITE : TFT_BLACK);
+}
+
+BENCH_CASE(labelsCheck) // same text as sprintf(), same pixels as print(), the instance never renders in a label frame
+{
+  // the text of v0.5
+  {
+    char a[X_AXIS_LABEL_LENGTH + 8], b[X_AXIS_LABEL_LENGTH];
+    uint32_t bad = 0;
+    for (char format : {'S', 'M', 'H', 'D'})
+      for (int64_t t = -1000; t < 30000000; t += t < 200000 ? 1 : 7919)
+      {
+        a[0] = '-'; // a negative time is "-" and the label of its magnitude
+        sprintfTime(t < 0 ? a + 1 : a, (int32_t)(t < 0 ? -t : t), format);
+        bad += strcmp(a, ytGraphFormatTime(b, (int32_t)t, format)) != 0;
+      }
+    for (char format : {'S', 'M', 'H', 'D'})
+    {
+      sprintfTime(a, INT32_MAX, format);
+      bad += strcmp(a, ytGraphFormatTime(b, INT32_MAX, format)) != 0;
+    }
+    // 2^31 s, min or h, the days wrap at 256 like those of v0.5
+    static const char *minLabels[4] = {"-23d3h14m8s", "-108d2h8m", "-85d8h", "-2147483648"};
+    for (uint8_t i = 0; i < 4; i++)
+      bad += strcmp(minLabels[i], ytGraphFormatTime(b, INT32_MIN, "SMHD"[i])) != 0;
+    BENCH_CHECK(ctx, bad == 0, "%u labels differ from sprintf()", bad);
+  }
+
+  // a copied label has the pixels of print(), at every bit position and clipped at all borders
+  {
+    static const uint16_t colors[3][2] = {{TFT_WHITE, TFT_BLACK}, {TFT_BLACK, TFT_WHITE}, {TFT_WHITE, TFT_WHITE}};
+    for (auto &c : colors)
+    {
+      ytGraphConfig cfg = labelsConfig('S');
+      cfg.axisTextColor = c[0];
+      cfg.bgrndColor = c[1];
+      ytGraphLabelCache labels(benchTFT);
+      labels.begin(ytGraphLayout(cfg));
+      TFT_eSprite a(&benchTFT), b(&benchTFT);
+      a.setColorDepth(1);
+      a.createSprite(101, 15);
+      b.setColorDepth(1);
+      b.createSprite(101, 15);
+      b.setTextSize(1);
+      b.setTextColor(c[0], c[1]);
+      uint32_t bad = 0;
+      for (int16_t x = -90; x < 110; x += 3)
+        for (int16_t y : {-5, 0, 4, 7, 12})
+        {
+          uint32_t value = (uint32_t)(x + 200) * 977 + y;
+          labelsPattern(a, x + y);
+          labelsPattern(b, x + y);
+          labels.draw(a, x, y, value);
+          char str[X_AXIS_LABEL_LENGTH];
+          b.setCursor(x, y);
+          b.print(ytGraphFormatTime(str, value, cfg.timeFormat));
+          bad += !benchSpritesEqual(a, b);
+        }
+      BENCH_CHECK(ctx, bad == 0, "text 0x%04X on 0x%04X: %u labels differ from print()", c[0], c[1], bad);
+      BENCH_CHECK(ctx, c[0] == c[1] || labels.misses() > 0, "text 0x%04X on 0x%04X: the cache was not used", c[0], c[1]);
+    }
+  }
+
+  // the x axis of an instance equals the printed one, all labels were rendered ahead
+  for (char format : {'S', 'M', 'H'})
+  {
+    ytGraphLayout cfg(labelsConfig(format));
+    uint16_t colors[1] = {TFT_YELLOW};
+    ytGraphInstance g(benchTFT, cfg);
+    g.begin(colors, 1);
+    labelsAxis a(cfg);
+    int16_t y[1];
+    for (uint32_t i = 0; i < cfg.samples + 1u + 300; i++)
+    {
+      y[0] = (int16_t)(i % 40);
+      g.add(y);
+      uint32_t xValue = 0;
+      if (i <= cfg.samples)
+        continue;
+      bool newDiv = a.step(cfg, xValue);
+      ytGraphDrawDynamicGrid(a.graph, a.xAxis, cfg, cfg.width - cfg.scrollStep, newDiv, xValue);
+    }
+    g.xAxis().unwrap();
+    a.xAxis.unwrap();
+    BENCH_CHECK(ctx, benchSpritesEqual(g.xAxis().sprite(), a.xAxisSprite), "format %c: the x axis differs from print()", format);
+    BENCH_CHECK(ctx, g.labels().misses() == 0 && g.labels().hits() > 0, "format %c: %u labels rendered in the frame of their division",
+                format, g.labels().misses());
+  }
+}
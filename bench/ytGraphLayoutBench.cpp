@@ -0,0 +1,118 @@
+/***************************************************************************************
+ * Benchmarks for the layouts in ytGraph.h (ytGraphLayout, ytGraphStaticLayout)
+ *
+ *  - grid strip of one scroll step, steps derived from the config at every call
+ *    (like v0.5) vs. a layout computed once
+ *  - the layout steps are the same as the lround() formulas of v0.5,
+ *    invalid configurations are rejected at runtime as well
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphInstance.h"
+#include <math.h>
+
+static constexpr ytGraphConfig benchSmall = {
+    30, 90, 100, 60, 25, 1, 'S', 0, 5, 0.0, 60.0, 20,
+    TFT_ORANGE, TFT_BLACK, TFT_WHITE, TFT_LIGHTGREY, "", ""};
+
+// computed by the compiler, an invalid benchSmall does not compile
+static_assert(ytGraphStaticLayout<benchSmall>::layout.xStep == 20, "x step of the small layout");
+static_assert(ytGraphStaticLayout<benchSmall>::layout.yStep == 20, "y step of the small layout");
+static_assert(ytGraphStaticLayout<benchSmall>::layout.scrollStep == 4, "scroll step of the small layout");
+static_assert(ytGraphLayoutDefault.spriteWidth() == SPRITE_WIDTH, "sprite width of the #defines");
+
+BENCH_CASE(layoutStrip) // one grid strip per frame, like the dynamic grid while scrolling
+{
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  const ytGraphConfig &cfg = ytGraphConfigDefault;
+  int16_t oox = GRAPH_WIDTH - GRAPH_WIDTH / SAMPLE_COUNT;
+
+  benchFrames perCall("config, derived per call", 1);
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    perCall.begin();
+    ytGraphDrawGridStrip(Graph, cfg, oox, i % 5 == 0, 0); // converts to a layout at every call
+    perCall.end();
+  }
+
+  const ytGraphLayout layout(cfg);
+  benchFrames once("layout, computed once", 1);
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    once.begin();
+    ytGraphDrawGridStrip(Graph, layout, oox, i % 5 == 0, 0);
+    once.end();
+  }
+  Graph.deleteSprite();
+}
+
+BENCH_CASE(layoutCheck) // steps like v0.5, invalid configurations
+{
+  // the steps of many configurations against the formulas of v0.5
+  uint32_t wrong = 0, tested = 0;
+  static const double yMax[4] = {60.0, 100.0, 7.5, 1000.0};
+  for (uint16_t width = 60; width <= 480; width += 20)
+    for (uint16_t samples = 1; samples <= width; samples++)
+    {
+      if (width % samples)
+        continue;
+      for (uint8_t k = 0; k < 4; k++)
+      {
+        ytGraphConfig cfg = ytGraphConfigDefault;
+        cfg.width = width;
+        cfg.samples = samples;
+        cfg.yMax = yMax[k];
+        cfg.yMin = k == 3 ? -200.0 : 0.0;
+        cfg.yDiv = k == 2 ? 1 : 10;
+        ytGraphLayout l(cfg);
+        ytGraphScale s = ytGraphScaleInit(cfg.width, cfg.height, abs(cfg.xMin) + cfg.xMax(), abs(cfg.yMin) + cfg.yMax);
+        if (l.xStep != lround((cfg.width * cfg.xDiv) / (abs(cfg.xMin) + cfg.xMax())) ||
+            l.yStep != lround((cfg.height * cfg.yDiv) / (abs(cfg.yMin) + cfg.yMax)) ||
+            l.scrollStep != cfg.width / cfg.samples || l.scale.xMul != s.xMul || l.scale.yMul != s.yMul)
+          wrong++;
+        tested++;
+      }
+    }
+  BENCH_CHECK(ctx, wrong == 0, "%u of %u layouts differ from the v0.5 formulas", wrong, tested);
+
+  BENCH_CHECK(ctx, ytGraphLayoutCheck(ytGraphConfigDefault) == LAYOUT_OK, "the #define configuration is invalid");
+  BENCH_CHECK(ctx, ytGraphLayoutCheck(benchSmall) == LAYOUT_OK, "the small configuration is invalid");
+
+  struct
+  {
+    const char *what;
+    uint8_t expected;
+    void (*change)(ytGraphConfig &);
+  } invalid[] = {
+      {"no samples", LAYOUT_EMPTY, [](ytGraphConfig &c) { c.samples = 0; }},
+      {"width 100, 30 samples", LAYOUT_SAMPLES, [](ytGraphConfig &c) { c.samples = 30; }},
+      {"bottom = height", LAYOUT_POSITION, [](ytGraphConfig &c) { c.bottom = c.height; }},
+      {"left 10", LAYOUT_POSITION, [](ytGraphConfig &c) { c.left = 10; }},
+      {"x div 0", LAYOUT_X_AXIS, [](ytGraphConfig &c) { c.xDiv = 0; }},
+      {"x div < 1 px", LAYOUT_X_AXIS, [](ytGraphConfig &c) { c.width = 100; c.samples = 100; c.sampleRate = 60; c.xDiv = 1; }},
+      {"y max = min", LAYOUT_Y_AXIS, [](ytGraphConfig &c) { c.yMax = c.yMin; }},
+      {"y div 0", LAYOUT_Y_AXIS, [](ytGraphConfig &c) { c.yDiv = 0; }},
+  };
+  for (auto &t : invalid)
+  {
+    ytGraphConfig cfg = benchSmall;
+    t.change(cfg);
+    uint8_t got = ytGraphLayoutCheck(cfg);
+    BENCH_CHECK(ctx, got == t.expected, "%s: check returned %u, expected %u", t.what, got, t.expected);
+    ytGraphInstance g(benchTFT, cfg);
+    uint16_t color = TFT_RED;
+    BENCH_CHECK(ctx, !g.begin(&color, 1), "%s: begin() accepted the configuration", t.what);
+  }
+}
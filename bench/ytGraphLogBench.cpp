@@ -0,0 +1,211 @@
+/***************************************************************************************
+ * Benchmarks for the persistent sample log in ytGraphLog.h, against plain files in /tmp
+ *
+ *  - cost of one sample, written one by one vs. in batches
+ *  - restoring the newest screens after a reboot and drawing them in one push
+ *  - after a reboot exactly the flushed records come back, a torn batch is skipped
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphLog.h"
+#include "ytGraph.h"
+#include <unistd.h>
+
+struct benchRecord // same size as the sensors struct of the demo
+{
+  float temperature1;
+  float temperature2;
+  float temperature3;
+  int8_t humidity;
+};
+
+static char logDir[] = "/tmp/ytglogXXXXXX";
+
+static const char *logPrefix() // a fresh directory for each run, removed at exit
+{
+  static char prefix[64] = "";
+  if (!prefix[0])
+  {
+    snprintf(prefix, sizeof(prefix), "%s/seg", mkdtemp(logDir));
+    atexit([] { rmdir(logDir); });
+  }
+  return prefix;
+}
+
+static void clearLog(ytGraphStdioFile &file)
+{
+  for (uint8_t slot = 0; slot < 32; slot++)
+    file.erase(slot);
+}
+
+static benchRecord record(uint32_t i)
+{
+  return benchRecord{i * 0.5f, 20 + (i % 7) * 0.1f, -(float)i, (int8_t)(i & 0x7F)};
+}
+
+template <uint16_t BATCH>
+static void appendFrames(benchContext &ctx, const char *label)
+{
+  static char text[64];
+  ytGraphStdioFile file(logPrefix());
+  clearLog(file);
+  ytGraphLog<benchRecord, BATCH> log(file, 8, 4096);
+  log.begin();
+  uint32_t n = std::max<uint32_t>(BATCH, ctx.frames);
+  benchFrames f(label, 4);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    f.begin();
+    log.append(record(i));
+    f.end();
+  }
+  snprintf(text, sizeof(text), "%.3f file writes/sample", (double)log.writes() / n);
+  f.extra(text);
+  clearLog(file);
+}
+
+BENCH_CASE(logAppend) // one file write per sample vs. batches
+{
+  appendFrames<1>(ctx, "append, batch of 1");
+  appendFrames<32>(ctx, "append, batch of 32");
+}
+
+BENCH_CASE(logRestore) // newest screens back from a full log, drawn with one push
+{
+  const uint32_t screens = 4, n = screens * (SAMPLE_COUNT + 1);
+  ytGraphStdioFile file(logPrefix());
+  clearLog(file);
+  {
+    ytGraphLog<benchRecord, 32> log(file, 8, 4096);
+    log.begin();
+    for (uint32_t i = 0; i < 8 * 4096 / sizeof(benchRecord); i++) // all slots in use
+      log.append(record(i));
+    log.flush();
+  }
+
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  ytGraphRing<benchRecord, SAMPLE_COUNT + 1> ring;
+  ytGraphChannel channels[4];
+  for (int c = 0; c < 4; c++)
+    channels[c] = ytGraphChannel{benchChannelColor(c), 0, 0};
+
+  static char text[64];
+  uint32_t restored = 0;
+  benchFrames f("reboot: begin + restore + draw", 4);
+  for (uint32_t i = 0; i < std::max<uint32_t>(1, ctx.frames / 10); i++)
+  {
+    f.begin();
+    ytGraphLog<benchRecord, 32> log(file, 8, 4096);
+    log.begin();
+    ring.clear();
+    restored = log.restore(n, [&](const benchRecord &r) { ring.push(r); });
+    ytGraphDrawHistory(Graph, ring, channels, 4, [](const benchRecord &r, uint8_t c)
+                       { return (int16_t)lround(c == 3 ? r.humidity % 60 : r.temperature2 + 10 * c); });
+    f.end();
+  }
+  snprintf(text, sizeof(text), "%u records restored", (unsigned)restored);
+  f.extra(text);
+  BENCH_CHECK(ctx, restored == n, "%u records restored, expected %u", restored, n);
+  clearLog(file);
+}
+
+static bool sameRecord(const benchRecord &a, const benchRecord &b)
+{
+  return a.temperature1 == b.temperature1 && a.temperature2 == b.temperature2 && a.temperature3 == b.temperature3 &&
+         a.humidity == b.humidity; // not memcmp, the padding bytes are undefined
+}
+
+BENCH_CASE(logCheck) // restore after reboots, segment rotation, torn batches
+{
+  ytGraphStdioFile file(logPrefix());
+  clearLog(file);
+  const uint8_t slots = 4;
+  const uint32_t segment = 512;
+  uint32_t written = 0, flushed = 0; // records appended / on the file
+
+  auto check = [&](const char *when, uint32_t n, uint32_t expectedLast)
+  {
+    ytGraphLog<benchRecord, 8> log(file, slots, segment); // a reboot: nothing in RAM
+    log.begin();
+    std::vector<benchRecord> got;
+    uint32_t done = log.restore(n, [&](const benchRecord &r) { got.push_back(r); });
+    uint32_t wrong = 0;
+    for (uint32_t k = 0; k < got.size(); k++)
+      if (!sameRecord(got[k], record(expectedLast + 1 - got.size() + k)))
+        wrong++;
+    BENCH_CHECK(ctx, done == got.size() && wrong == 0, "%s: %u of %u records differ", when, wrong, (unsigned)got.size());
+    return done;
+  };
+
+  {
+    ytGraphLog<benchRecord, 8> log(file, slots, segment);
+    log.begin();
+    for (; written < 20; written++)
+      log.append(record(written));
+    flushed = 16; // two batches, four records only in RAM when the power goes
+  }
+  uint32_t done = check("first boot", 100, flushed - 1);
+  BENCH_CHECK(ctx, done == flushed, "first boot: %u records restored, expected %u", done, flushed);
+
+  // many segments later only the newest slots are left
+  {
+    ytGraphLog<benchRecord, 8> log(file, slots, segment);
+    log.begin();
+    for (written = flushed; written < 1000; written++)
+      log.append(record(written));
+    log.flush();
+    flushed = written;
+    BENCH_CHECK(ctx, log.restore(3, [](const benchRecord &) {}) == 3, "restore of 3 records");
+  }
+  done = check("after rotation", 60, flushed - 1);
+  BENCH_CHECK(ctx, done == 60, "after rotation: %u records restored, expected 60", done);
+  done = check("all slots", 100000, flushed - 1);
+  uint32_t perSegment = (segment - LOG_SEGMENT_HEADER) / (LOG_BATCH_HEADER + 8 * sizeof(benchRecord)) * 8;
+  BENCH_CHECK(ctx, done > (slots - 1) * perSegment && done <= slots * perSegment, "all slots: %u records", done);
+  for (uint8_t slot = slots; slot < 32; slot++)
+    BENCH_CHECK(ctx, file.size(slot) < 0, "slot %u used, only %u slots configured", slot, slots);
+
+  // a batch torn by a reset: only its first half reached the file
+  {
+    uint8_t torn[LOG_BATCH_HEADER + 4 * sizeof(benchRecord)] = {0xC4, 0xB7, 8, 0};
+    uint8_t slot = 0;
+    for (uint8_t s = 0; s < slots; s++) // the newest segment is the one with the most records at the end
+    {
+      benchRecord r;
+      int32_t size = file.size(s);
+      if (size > (int32_t)sizeof(benchRecord) && file.read(s, size - sizeof(benchRecord), &r, sizeof(r)) == sizeof(r) &&
+          sameRecord(r, record(flushed - 1)))
+        slot = s;
+    }
+    file.append(slot, torn, sizeof(torn));
+  }
+  done = check("torn batch", 50, flushed - 1);
+  BENCH_CHECK(ctx, done == 50, "torn batch: %u records restored, expected 50", done);
+  {
+    ytGraphLog<benchRecord, 8> log(file, slots, segment); // appends behind the torn batch must survive
+    log.begin();
+    for (; written < flushed + 8; written++)
+      log.append(record(written));
+    flushed = written;
+  }
+  done = check("after torn batch", 50, flushed - 1);
+  BENCH_CHECK(ctx, done == 50, "after torn batch: %u records restored, expected 50", done);
+
+  // an other record type is not restored
+  ytGraphLog<uint32_t, 8> other(file, slots, segment);
+  other.begin();
+  BENCH_CHECK(ctx, other.restore(10, [](const uint32_t &) {}) == 0, "records of an other size restored");
+  clearLog(file);
+}
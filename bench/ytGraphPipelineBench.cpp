@@ -0,0 +1,157 @@
+/***************************************************************************************
+ * Benchmarks for the sampling / render / transfer pipeline in ytGraphPipeline.h
+ *
+ *  - the pushes wait for the SPI transfer time (hostSpiClock), like the blocking push of the ESP32
+ *  - one sample after the other (draw + push) vs. the pipeline with its own sampling and transfer thread
+ *  - the double buffered picture is the same as the one of a single graph, a busy render stage
+ *    coalesces samples into fewer frames, a slow panel drops samples only when the queue is full
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphPipeline.h"
+
+static bool counterSource(int16_t *y, void *user) // deterministic, the n-th sample is known
+{
+  uint32_t &n = *(uint32_t *)user;
+  for (uint8_t c = 0; c < 4; c++)
+    y[c] = (int16_t)((n * (7 + c) + 13 * c) % 61);
+  n++;
+  return true;
+}
+
+static void runPipeline(ytGraphPipeline &p, uint32_t ms, uint32_t pauseMs = 0) // pauseMs: other work of loop() between two render()
+{
+  uint32_t start = ytGraphNowMs();
+  while (ytGraphNowMs() - start < ms)
+  {
+    p.render(20);
+    if (pauseMs)
+      ytGraphSleepMs(pauseMs);
+  }
+  p.end();
+}
+
+BENCH_CASE(pipelineFrame) // 500 samples/s on a 40 MHz panel
+{
+  static char text[96];
+  uint16_t colors[4];
+  for (int c = 0; c < 4; c++)
+    colors[c] = benchChannelColor(c);
+  uint32_t n = std::min<uint32_t>(ctx.frames, 300);
+  hostSpiClock = 40000000;
+
+  {
+    uint32_t state = 0;
+    int16_t y[4];
+    benchTFT.fillScreen(TFT_BLACK);
+    ytGraphInstance g(benchTFT);
+    g.begin(colors, 4);
+    benchFrames f("serial: draw + push per sample", 4);
+    uint32_t start = ytGraphNowMs();
+    for (uint32_t i = 0; i < n; i++)
+    {
+      f.begin();
+      counterSource(y, &state);
+      g.add(y);
+      g.push();
+      f.end();
+    }
+    snprintf(text, sizeof(text), "%.1f ms between two samples", (double)(ytGraphNowMs() - start) / n);
+    f.extra(text);
+  }
+
+  {
+    uint32_t state = 0, start = ytGraphNowMs();
+    benchTFT.fillScreen(TFT_BLACK);
+    ytGraphPipeline p(benchTFT);
+    p.begin(colors, 4, counterSource, 2, &state);
+    benchFrames f("pipeline: render() incl. wait", 4);
+    while (p.sampled() < n)
+    {
+      f.begin();
+      p.render(20);
+      f.end();
+    }
+    p.end();
+    snprintf(text, sizeof(text), "%.1f ms between two samples, %u frames, %u coalesced, %u dropped",
+             (double)(ytGraphNowMs() - start) / p.sampled(), p.frames(), p.coalesced(), p.dropped());
+    f.extra(text);
+  }
+  hostSpiClock = 0;
+}
+
+static bool buffersEqual(ytGraphPipeline &p)
+{
+  ytGraphInstance &a = p.buffer(0), &b = p.buffer(1);
+  a.graph().unwrap();
+  a.xAxis().unwrap();
+  b.graph().unwrap();
+  b.xAxis().unwrap();
+  return benchSpritesEqual(a.graph().sprite(), b.graph().sprite()) && benchSpritesEqual(a.xAxis().sprite(), b.xAxis().sprite());
+}
+
+BENCH_CASE(pipelineCheck) // same picture as one graph, backpressure
+{
+  uint16_t colors[4];
+  for (int c = 0; c < 4; c++)
+    colors[c] = benchChannelColor(c);
+
+  // 500 samples/s, render() runs only every 10 ms: several samples per frame, none lost
+  // (how fast the panel is depends on the sample count, the pause does not)
+  {
+    uint32_t state = 0;
+    hostSpiClock = 40000000;
+    benchTFT.fillScreen(TFT_BLACK);
+    ytGraphPipeline p(benchTFT);
+    BENCH_CHECK(ctx, p.begin(colors, 4, counterSource, 2, &state), "begin() failed");
+    runPipeline(p, 300, 10);
+    hostSpiClock = 0;
+
+    BENCH_CHECK(ctx, p.dropped() == 0 && p.drawn() == p.sampled(), "%u sampled, %u drawn, %u dropped", p.sampled(), p.drawn(), p.dropped());
+    BENCH_CHECK(ctx, p.sampled() >= 75, "only %u samples in 300 ms, the sampling was delayed", p.sampled());
+    BENCH_CHECK(ctx, p.frames() + p.coalesced() == p.drawn(), "%u frames + %u coalesced for %u samples", p.frames(), p.coalesced(), p.drawn());
+    BENCH_CHECK(ctx, p.coalesced() > 0 && p.frames() < p.sampled(), "%u frames for %u samples", p.frames(), p.sampled());
+    BENCH_CHECK(ctx, benchPanelShows(p.buffer(p.front())), "the panel differs from the last frame");
+    BENCH_CHECK(ctx, buffersEqual(p), "the buffers differ after end()");
+
+    ytGraphInstance single(benchTFT); // the same samples one by one
+    single.begin(colors, 4);
+    uint32_t n = 0;
+    int16_t y[4];
+    while (n < p.sampled())
+    {
+      counterSource(y, &n);
+      single.add(y);
+    }
+    single.graph().unwrap();
+    single.xAxis().unwrap();
+    BENCH_CHECK(ctx, benchSpritesEqual(single.graph().sprite(), p.buffer(0).graph().sprite()), "graph differs from a single graph");
+    BENCH_CHECK(ctx, benchSpritesEqual(single.xAxis().sprite(), p.buffer(0).xAxis().sprite()), "x axis differs from a single graph");
+  }
+
+  // a very slow panel (~0.3 s per frame): the queue overflows, the picture stays consistent
+  {
+    uint32_t state = 0;
+    hostSpiClock = 2000000;
+    benchTFT.fillScreen(TFT_BLACK);
+    ytGraphPipeline p(benchTFT);
+    p.begin(colors, 4, counterSource, 1, &state);
+    runPipeline(p, 400);
+    hostSpiClock = 0;
+
+    BENCH_CHECK(ctx, p.dropped() > 0, "no sample dropped with a slow panel");
+    BENCH_CHECK(ctx, p.drawn() + p.dropped() == p.sampled(), "%u sampled, %u drawn, %u dropped", p.sampled(), p.drawn(), p.dropped());
+    BENCH_CHECK(ctx, benchPanelShows(p.buffer(p.front())), "the panel differs from the last frame");
+    BENCH_CHECK(ctx, buffersEqual(p), "the buffers differ after end()");
+  }
+}
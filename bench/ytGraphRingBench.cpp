@@ -0,0 +1,138 @@
+/***************************************************************************************
+ * Benchmarks for the sample stores in ytGraphRing.h
+ *
+ *  - filling a whole history window: shiftBufferLeft() per sample vs. ring push
+ *  - SPSC queue: a producer thread pushes, the "render path" drains into the ring
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraph.h"
+#include "ytGraphRing.h"
+#include <thread>
+
+struct benchSensors // same layout as 'sensors' in main.cpp
+{
+  float temperature1;
+  float temperature2;
+  float temperature3;
+  int8_t humidity;
+};
+
+static benchSensors benchReading(uint32_t i)
+{
+  benchSensors s;
+  s.temperature1 = (float)(i % 200) / 10.0f;
+  s.temperature2 = (float)(i % 400) / 10.0f;
+  s.temperature3 = (float)(i % 600) / 10.0f;
+  s.humidity = (int8_t)(i % 100);
+  return s;
+}
+
+template <uint32_t N>
+static void benchHistoryFill(benchContext &ctx)
+{
+  static benchSensors array[N];
+  static ytGraphRing<benchSensors, N> ring;
+  uint32_t frames = std::max<uint32_t>(3, ctx.frames / 100);
+  char label[48];
+
+  snprintf(label, sizeof(label), "shiftBufferLeft() N=%u", N);
+  {
+    benchFrames f(label, 0);
+    for (uint32_t r = 0; r < frames; r++)
+    {
+      f.begin();
+      for (uint32_t i = 0; i < N; i++) // simulateHistBufferWrite(): one shift per new sample
+      {
+        for (uint32_t j = 1; j < N; j++)
+          array[j - 1] = array[j];
+        array[N - 1] = benchReading(r * N + i);
+      }
+      f.end();
+    }
+  }
+
+  snprintf(label, sizeof(label), "ytGraphRing::push() N=%u", N);
+  {
+    benchFrames f(label, 0);
+    for (uint32_t r = 0; r < frames; r++)
+    {
+      f.begin();
+      for (uint32_t i = 0; i < N; i++)
+        ring.push(benchReading(r * N + i));
+      f.end();
+    }
+  }
+
+  bool same = ring.size() == N;
+  for (uint32_t i = 0; same && i < N; i++)
+    same = ring[i].humidity == array[i].humidity && ring[i].temperature3 == array[i].temperature3;
+  BENCH_CHECK(ctx, same, "ring content differs from the shifted array (N=%u)", N);
+}
+
+BENCH_CASE(historyFill)
+{
+  benchHistoryFill<SAMPLE_COUNT + 1>(ctx);
+  benchHistoryFill<600>(ctx);
+  benchHistoryFill<3600>(ctx);
+}
+
+BENCH_CASE(ringSegments) // indexed access and the two contiguous runs agree after wrap around
+{
+  ytGraphRing<int, 7> ring;
+  for (int i = 0; i < 19; i++)
+  {
+    ring.push(i);
+    const int *a, *b;
+    uint32_t na, nb;
+    ring.segments(a, na, b, nb);
+    bool ok = na + nb == ring.size();
+    for (uint32_t k = 0; ok && k < ring.size(); k++)
+      ok = ring[k] == (k < na ? a[k] : b[k - na]) && ring[k] == i - (int)ring.size() + 1 + (int)k;
+    BENCH_CHECK(ctx, ok && ring.newest() == i, "ring order wrong after %d pushes", i + 1);
+  }
+}
+
+BENCH_CASE(spscQueue) // producer thread vs. consumer draining into the history
+{
+  static ytGraphSampleQueue<uint32_t, 256> queue;
+  static ytGraphRing<uint32_t, 3600> history;
+  const uint32_t total = std::max<uint32_t>(100000, ctx.frames * 100);
+  uint32_t expected = 0;
+  bool inOrder = true;
+
+  benchFrames f("SPSC drainInto() per call", 0);
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < total; i++)
+      while (!queue.push(i))
+        std::this_thread::yield(); // a real ISR would count a drop instead
+  });
+
+  uint32_t received = 0;
+  while (received < total)
+  {
+    if (queue.size() == 0)
+    {
+      std::this_thread::yield(); // only time drains that have work to do
+      continue;
+    }
+    f.begin();
+    uint32_t n = queue.drainInto(history);
+    f.end();
+    for (uint32_t k = history.size() > n ? history.size() - n : 0; k < history.size(); k++)
+      inOrder = inOrder && history[k] == expected++;
+    received += n;
+  }
+  producer.join();
+  BENCH_CHECK(ctx, inOrder && received == total, "SPSC queue lost or reordered samples");
+}
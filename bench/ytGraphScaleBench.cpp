@@ -0,0 +1,133 @@
+/***************************************************************************************
+ * Benchmarks and pixel checks for the fixed point transform in ytGraphScale.h
+ *
+ *  - every int16 sample and every uint16 x position is compared with the double
+ *    formula of ytGraph() v0.5, for the built configuration and a set of typical ones
+ *  - timing: double formula vs. ytGraphMapY() vs. ytGraphMapBatch()
+ *    (on the host the double FPU hides most of the gain, on the ESP32 it is emulated)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraph.h"
+
+static int16_t referenceY(uint16_t height, double yRange, int16_t y) // ytGraph() v0.5
+{
+  return abs(lround((height * y) / yRange) - height);
+}
+
+static int16_t referenceX(uint16_t width, int32_t xRange, uint16_t x) // ytGraph() v0.5, integer axis
+{
+  return lround((width * x) / xRange);
+}
+
+static uint32_t checkScale(uint16_t width, uint16_t height, int32_t xRange, double yRange)
+{
+  ytGraphScale s = ytGraphScaleInit(width, height, xRange, yRange);
+  static int16_t ys[65536], py[65536], px[65536];
+  uint32_t wrong = 0;
+
+  for (int32_t y = -32768; y <= 32767; y++)
+    ys[y + 32768] = (int16_t)y;
+  ytGraphMapBatch(s, 0, ys, px, py, 32768); // n is 16 bit, two halves
+  ytGraphMapBatch(s, 32768, ys + 32768, px + 32768, py + 32768, 32768);
+
+  for (int32_t i = 0; i < 65536; i++)
+  {
+    int16_t ref = referenceY(height, yRange, ys[i]);
+    if (ytGraphMapY(s, ys[i]) != ref || py[i] != ref)
+      wrong++;
+    int16_t refX = referenceX(width, xRange, (uint16_t)i);
+    if (ytGraphMapX(s, (uint16_t)i) != refX || px[i] != refX)
+      wrong++;
+  }
+  return wrong;
+}
+
+BENCH_CASE(scaleIdentity) // pixel identical to the v0.5 double formula
+{
+  uint32_t wrong = checkScale(GRAPH_WIDTH, GRAPH_HEIGHT, abs(GRAPH_X_AXIS_MIN) + GRAPH_X_AXIS_MAX,
+                              abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX);
+  BENCH_CHECK(ctx, wrong == 0, "%u mismatches for the built configuration", wrong);
+
+  static const uint16_t widths[] = {100, 240, 241, 320, 480};
+  static const uint16_t heights[] = {60, 100, 120, 122, 200, 240};
+  static const int32_t xRanges[] = {3, 7, 20, 60, 300, 600, 3600};
+  static const double yRanges[] = {1.0, 10.0, 45.5, 50.0, 60.0, 100.0, 127.0, 1000.0, 4096.0};
+  uint32_t configs = 0;
+  for (uint16_t w : widths)
+    for (int32_t xr : xRanges)
+    {
+      uint16_t h = heights[configs % 6];
+      double yr = yRanges[configs % 9];
+      wrong = checkScale(w, h, xr, yr);
+      BENCH_CHECK(ctx, wrong == 0, "%u mismatches for %ux%u x=%d y=%.1f", wrong, w, h, xr, yr);
+      configs++;
+    }
+  for (uint16_t h : heights)
+    for (double yr : yRanges)
+    {
+      wrong = checkScale(GRAPH_WIDTH, h, 20, yr);
+      BENCH_CHECK(ctx, wrong == 0, "%u mismatches for height %u y=%.1f", wrong, h, yr);
+    }
+}
+
+BENCH_CASE(scaleTiming) // 4096 samples per frame
+{
+  const uint16_t n = 4096;
+  static int16_t y[n], px[n], py[n];
+  for (uint16_t i = 0; i < n; i++)
+    y[i] = (int16_t)random(-10, 70);
+  const double yRange = abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX;
+  const int32_t xRange = abs(GRAPH_X_AXIS_MIN) + GRAPH_X_AXIS_MAX;
+  volatile int32_t sink = 0;
+  uint32_t frames = std::max<uint32_t>(10, ctx.frames / 10);
+
+  {
+    benchFrames f("double formula x4096", 0);
+    for (uint32_t r = 0; r < frames; r++)
+    {
+      f.begin();
+      for (uint16_t i = 0; i < n; i++)
+      {
+        py[i] = abs(lround((GRAPH_HEIGHT * y[i]) / yRange) - GRAPH_HEIGHT);
+        px[i] = lround((GRAPH_WIDTH * i) / xRange);
+      }
+      f.end();
+      sink = sink + py[r % n] + px[r % n];
+    }
+  }
+  {
+    benchFrames f("ytGraphMapX/Y() x4096", 0);
+    for (uint32_t r = 0; r < frames; r++)
+    {
+      f.begin();
+      for (uint16_t i = 0; i < n; i++)
+      {
+        py[i] = ytGraphMapY(ytGraphScaleDefault, y[i]);
+        px[i] = ytGraphMapX(ytGraphScaleDefault, i);
+      }
+      f.end();
+      sink = sink + py[r % n] + px[r % n];
+    }
+  }
+  {
+    benchFrames f("ytGraphMapBatch() x4096", 0);
+    for (uint32_t r = 0; r < frames; r++)
+    {
+      f.begin();
+      ytGraphMapBatch(ytGraphScaleDefault, 0, y, px, py, n);
+      f.end();
+      sink = sink + py[r % n] + px[r % n];
+    }
+  }
+}
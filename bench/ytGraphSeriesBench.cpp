@@ -0,0 +1,100 @@
+/***************************************************************************************
+ * Benchmarks for the series API (ytGraphSeries / ytGraphDrawHistory)
+ *
+ *  - full history redraw with one push, compare with the staticRedraw case
+ *  - the polyline must give the same pixels as one ytGraph() call per sample
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraph.h"
+
+struct benchSample16
+{
+  int16_t v[16];
+};
+
+static void fillHistory(ytGraphRing<benchSample16, SAMPLE_COUNT + 1> &ring)
+{
+  ring.clear();
+  for (uint32_t i = 0; i < ring.capacity(); i++)
+  {
+    benchSample16 s;
+    for (int c = 0; c < 16; c++)
+      s.v[c] = (int16_t)random((c * 7) % 50, (c * 7) % 50 + 10);
+    ring.push(s);
+  }
+}
+
+BENCH_CASE(historyRedraw) // drawStaticGraphBuffer() with ytGraphDrawHistory()
+{
+  TFT_eSprite Graph(&benchTFT);
+  TFT_eSprite xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+  static ytGraphRing<benchSample16, SAMPLE_COUNT + 1> ring;
+  fillHistory(ring);
+
+  for (int ch : ctx.channels)
+  {
+    std::vector<ytGraphChannel> channels(ch);
+    for (int c = 0; c < ch; c++)
+      channels[c].color = benchChannelColor(c);
+    uint32_t frames = std::max<uint32_t>(1, ctx.frames / (SAMPLE_COUNT + 1));
+    benchFrames f("ytGraphDrawHistory()", ch);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos);
+      f.begin();
+      ytGraphDrawHistory(Graph, ring, channels.data(), ch,
+                         [](const benchSample16 &s, uint8_t c) { return s.v[c]; });
+      f.end();
+    }
+  }
+}
+
+BENCH_CASE(historyPixels) // same pixels as the per sample ytGraph() loop
+{
+  TFT_eSprite a(&benchTFT), b(&benchTFT), xAxis(&benchTFT);
+  a.setColorDepth(4);
+  a.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  b.setColorDepth(4);
+  b.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+  static ytGraphRing<benchSample16, SAMPLE_COUNT + 1> ring;
+  fillHistory(ring);
+
+  ytGraphDrawGridXaxis(a, xAxis, LastXGridLinePos);
+  ytGraphDrawGridXaxis(b, xAxis, LastXGridLinePos);
+  ytGraphChannel ca[16], cb[16];
+  for (int c = 0; c < 16; c++)
+  {
+    ca[c] = ytGraphChannel{benchChannelColor(c), 0, 0};
+    cb[c] = ytGraphChannel{benchChannelColor(c), 0, ytGraphMapY(ytGraphScaleDefault, ring[0].v[c])};
+  }
+
+  ytGraphDrawHistory(a, ring, ca, 16, [](const benchSample16 &s, uint8_t c) { return s.v[c]; });
+  for (uint16_t i = 0; i < ring.size(); i++)
+    for (int c = 0; c < 16; c++)
+      ytGraph(b, i, ring[i].v[c], cb[c]);
+
+  BENCH_CHECK(ctx, benchSpritesEqual(a, b), "ytGraphDrawHistory() differs from the ytGraph() loop");
+  bool same = true;
+  for (int c = 0; c < 16; c++)
+    same = same && ca[c].ox == cb[c].ox && ca[c].oy == cb[c].oy;
+  BENCH_CHECK(ctx, same, "continuation points differ");
+}
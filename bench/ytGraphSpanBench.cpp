@@ -0,0 +1,248 @@
+/***************************************************************************************
+ * Benchmarks for the span rasterizer in ytGraphSpan.h
+ *
+ *  - one scroll step (one segment per channel) and a whole page, 3x drawLine() vs. spans
+ *  - spans are written into the sprite memory, px/f only counts the test pixels of ytGraphSpanBegin()
+ *  - stroke width, gap free columns, the drawLine() pixels lie inside the spans (+-1 row),
+ *    4 and 16 bit give the same picture, anti-aliased ends, clipping, 1 bit fallback
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphSpan.h"
+
+static int16_t spanSample(uint32_t i, int c) // odd channels jump around, even ones are flat with steps
+{
+  return (int16_t)(c & 1 ? (i * 37 + c * 11) % 61 : 20 + c + (i & 4 ? 10 : 0));
+}
+
+BENCH_CASE(spanStep) // one scroll step: a segment per channel at the right border
+{
+  TFT_eSprite Graph(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  int16_t step = GRAPH_WIDTH / SAMPLE_COUNT;
+
+  for (int ch : ctx.channels)
+  {
+    {
+      benchFrames f("3x drawLine()", ch);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        f.begin();
+        for (int c = 0; c < ch; c++)
+          ytGraphDrawSegment(Graph, GRAPH_WIDTH - step, ytGraphMapY(ytGraphScaleDefault, spanSample(i, c)), GRAPH_WIDTH,
+                             ytGraphMapY(ytGraphScaleDefault, spanSample(i + 1, c)), benchChannelColor(c));
+        f.end();
+      }
+    }
+    {
+      benchFrames f("span, 4 bit", ch);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        f.begin();
+        ytGraphSpanTarget t;
+        ytGraphSpanBegin(Graph, t);
+        for (int c = 0; c < ch; c++)
+          ytGraphSpanSegment(t, GRAPH_WIDTH - step, ytGraphMapY(ytGraphScaleDefault, spanSample(i, c)), GRAPH_WIDTH,
+                             ytGraphMapY(ytGraphScaleDefault, spanSample(i + 1, c)), ytGraphSpanPixel(Graph, t, benchChannelColor(c)));
+        f.end();
+      }
+    }
+  }
+}
+
+BENCH_CASE(spanPage) // a whole page of every channel, like a history redraw
+{
+  int16_t y[SAMPLE_COUNT + 1];
+  struct
+  {
+    const char *label;
+    uint8_t bpp;
+    bool span, aa;
+  } runs[] = {{"ytGraphSeries() 3x drawLine()", 4, false, false},
+              {"ytGraphSpanSeries(), 4 bit", 4, true, false},
+              {"ytGraphSpanSeries(), 16 bit AA", 16, true, true}};
+
+  for (int ch : ctx.channels)
+    for (auto &r : runs)
+    {
+      TFT_eSprite Graph(&benchTFT);
+      Graph.setColorDepth(r.bpp);
+      Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+      uint32_t frames = std::max<uint32_t>(1, ctx.frames / (SAMPLE_COUNT + 1));
+      benchFrames f(r.label, ch);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        Graph.fillSprite(TFT_BLACK);
+        f.begin();
+        for (int c = 0; c < ch; c++)
+        {
+          ytGraphChannel channel{benchChannelColor(c), 0, 0};
+          for (uint16_t k = 0; k <= SAMPLE_COUNT; k++)
+            y[k] = spanSample(i + k, c);
+          if (r.span)
+            ytGraphSpanSeries(Graph, channel, 0, y, SAMPLE_COUNT + 1, SPAN_WIDTH, r.aa);
+          else
+            ytGraphSeries(Graph, channel, 0, y, SAMPLE_COUNT + 1);
+        }
+        f.end();
+      }
+    }
+}
+
+static void drawPage(TFT_eSprite &Graph, uint8_t bpp, bool span, int channels, uint32_t seed)
+{
+  int16_t y[SAMPLE_COUNT + 1];
+  Graph.setColorDepth(bpp);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  Graph.fillSprite(TFT_BLACK);
+  for (int c = 0; c < channels; c++)
+  {
+    ytGraphChannel channel{benchChannelColor(c), 0, 0};
+    for (uint16_t k = 0; k <= SAMPLE_COUNT; k++)
+      y[k] = spanSample(seed + k, c);
+    if (span)
+      ytGraphSpanSeries(Graph, channel, 0, y, SAMPLE_COUNT + 1);
+    else
+      ytGraphSeries(Graph, channel, 0, y, SAMPLE_COUNT + 1);
+  }
+}
+
+BENCH_CASE(spanCheck) // width, gaps, envelope of drawLine(), 4 = 16 bit, anti-aliasing, clipping
+{
+  ytGraphSpanTarget t;
+  {
+    TFT_eSprite s4(&benchTFT), s16(&benchTFT), s1(&benchTFT);
+    s4.setColorDepth(4);
+    s4.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    s16.setColorDepth(16);
+    s16.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    s1.setColorDepth(1);
+    s1.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    BENCH_CHECK(ctx, ytGraphSpanBegin(s4, t) && t.bpp == 4, "4 bit sprite not accepted");
+    BENCH_CHECK(ctx, ytGraphSpanBegin(s16, t) && t.bpp == 16, "16 bit sprite not accepted");
+    BENCH_CHECK(ctx, !ytGraphSpanBegin(s1, t), "1 bit sprite accepted");
+  }
+
+  // stroke width of a flat line
+  for (uint8_t width = 1; width <= 5; width++)
+  {
+    TFT_eSprite s(&benchTFT);
+    s.setColorDepth(4);
+    s.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    s.fillSprite(TFT_BLACK);
+    ytGraphSpanBegin(s, t);
+    ytGraphSpanSegment(t, 10, 50, 100, 50, ytGraphSpanPixel(s, t, TFT_WHITE), width);
+    uint32_t wrong = 0;
+    for (int16_t x = 0; x < s.width(); x++)
+      for (int16_t y = 0; y < s.height(); y++)
+      {
+        bool inside = x >= 10 && x <= 100 && y >= 50 - (width - 1) / 2 && y <= 50 + width / 2;
+        if ((s.readPixel(x, y) == TFT_WHITE) != inside)
+          wrong++;
+      }
+    BENCH_CHECK(ctx, wrong == 0, "width %u: %u pixels wrong", width, wrong);
+  }
+
+  // every column is connected to the next one, the drawLine() pixels are inside the spans +-1 row
+  for (uint32_t seed = 0; seed < 20; seed++)
+  {
+    TFT_eSprite span(&benchTFT), lines(&benchTFT);
+    drawPage(span, 4, true, 1, seed);
+    drawPage(lines, 4, false, 1, seed);
+    uint32_t gaps = 0, outside = 0;
+    int16_t lastTop = -1, lastBottom = -1;
+    for (int16_t x = 0; x <= GRAPH_WIDTH; x++)
+    {
+      int16_t top = -1, bottom = -1;
+      for (int16_t y = 0; y < span.height(); y++)
+        if (span.readPixel(x, y) != TFT_BLACK)
+        {
+          if (top < 0)
+            top = y;
+          bottom = y;
+        }
+      if (top < 0 || (x > 0 && (top > lastBottom + 1 || bottom < lastTop - 1)))
+        gaps++;
+      lastTop = top, lastBottom = bottom;
+      for (int16_t y = 0; y < lines.height(); y++)
+        if (lines.readPixel(x, y) != TFT_BLACK && span.readPixel(x, y) == TFT_BLACK &&
+            span.readPixel(x, y - 1) == TFT_BLACK && span.readPixel(x, y + 1) == TFT_BLACK)
+          outside++;
+    }
+    BENCH_CHECK(ctx, gaps == 0, "seed %u: %u columns not connected", seed, gaps);
+    BENCH_CHECK(ctx, outside == 0, "seed %u: %u drawLine() pixels outside of the spans", seed, outside);
+  }
+
+  // 4 bit and 16 bit sprites give the same picture (colours of the 4 bit palette)
+  {
+    TFT_eSprite s4(&benchTFT), s16(&benchTFT);
+    drawPage(s4, 4, true, 4, 7);
+    drawPage(s16, 16, true, 4, 7);
+    uint32_t wrong = 0;
+    for (int16_t y = 0; y < s4.height(); y++)
+      for (int16_t x = 0; x < s4.width(); x++)
+        wrong += s4.readPixel(x, y) != s16.readPixel(x, y);
+    BENCH_CHECK(ctx, wrong == 0, "%u pixels differ between 4 bit and 16 bit spans", wrong);
+  }
+
+  // anti-aliased ends: partly covered pixels only next to fully covered ones
+  {
+    TFT_eSprite s(&benchTFT);
+    s.setColorDepth(16);
+    s.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    s.fillSprite(TFT_BLACK);
+    ytGraphSpanBegin(s, t);
+    ytGraphSpanSegment(t, 0, 10, 200, 80, ytGraphSpanPixel(s, t, TFT_WHITE), 3, true);
+    uint32_t partial = 0, lonely = 0;
+    for (int16_t x = 0; x <= 200; x++)
+      for (int16_t y = 0; y < s.height(); y++)
+      {
+        uint16_t c = s.readPixel(x, y);
+        if (c == TFT_BLACK || c == TFT_WHITE)
+          continue;
+        partial++;
+        if (s.readPixel(x, y - 1) != TFT_WHITE && s.readPixel(x, y + 1) != TFT_WHITE)
+          lonely++;
+      }
+    BENCH_CHECK(ctx, partial > 0, "no anti-aliased pixel");
+    BENCH_CHECK(ctx, lonely == 0, "%u anti-aliased pixels without a full pixel next to them", lonely);
+  }
+
+  // far outside of the sprite: clipped, the visible part is drawn
+  {
+    TFT_eSprite s(&benchTFT);
+    s.setColorDepth(4);
+    s.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+    s.fillSprite(TFT_BLACK);
+    ytGraphSpanBegin(s, t);
+    uint16_t white = ytGraphSpanPixel(s, t, TFT_WHITE);
+    ytGraphSpanSegment(t, -300, -3000, SPRITE_WIDTH + 300, SPRITE_HEIGTH + 3000, white, 5);
+    ytGraphSpanSegment(t, -30, 20, -1, 20, white);
+    ytGraphSpanSegment(t, SPRITE_WIDTH, 20, SPRITE_WIDTH + 30, 20, white);
+    uint32_t set = 0;
+    for (int16_t y = 0; y < s.height(); y++)
+      for (int16_t x = 0; x < s.width(); x++)
+        set += s.readPixel(x, y) == TFT_WHITE;
+    BENCH_CHECK(ctx, set > 0 && s.readPixel(0, 20) == TFT_BLACK && s.readPixel(SPRITE_WIDTH - 1, 20) == TFT_BLACK,
+                "clipping: %u pixels set", set);
+  }
+
+  // 1 bit sprite: the same as ytGraphSeries()
+  {
+    TFT_eSprite a(&benchTFT), b(&benchTFT);
+    drawPage(a, 1, true, 2, 3);
+    drawPage(b, 1, false, 2, 3);
+    BENCH_CHECK(ctx, benchSpritesEqual(a, b), "1 bit fallback differs from ytGraphSeries()");
+  }
+}
@@ -0,0 +1,161 @@
+/***************************************************************************************
+ * Benchmarks for the instrumentation in ytGraphStats.h
+ *
+ *  - the frame of a scrolling graph instance, run it with and without the build
+ *    flag YTGRAPH_STATS (pio run -e native_stats -t exec) to see the overhead
+ *  - with YTGRAPH_STATS: the histogram buckets, percentiles and dropped frames of
+ *    known latencies, every stage of a scheduler frame is counted, the binary
+ *    dump has the documented size and header, the overlay fits its text lines
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphInstance.h"
+
+static bool statsSource(ytGraphInstance &g, int16_t *y, void *user)
+{
+  uint32_t &n = *(uint32_t *)user;
+  for (uint8_t c = 0; c < g.channels(); c++)
+    y[c] = (int16_t)((n * (7 + c) + 13 * c) % 61);
+  n++;
+  return true;
+}
+
+BENCH_CASE(statsOverhead) // one scheduler frame of a scrolling graph, with or without the counters
+{
+  uint16_t colors[GRAPH_MAX_CHANNELS];
+  for (int c = 0; c < GRAPH_MAX_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+#ifdef YTGRAPH_STATS
+  static const char *label = "stats on";
+#else
+  static const char *label = "stats off";
+#endif
+  for (int ch : ctx.channels)
+  {
+    ytGraphInstance g(benchTFT, ytGraphConfigDefault);
+    g.begin(colors, ch);
+    ytGraphScheduler scheduler(benchTFT);
+    uint32_t state = 0;
+    scheduler.add(g, 1000, statsSource, &state);
+    benchFrames f(label, ch);
+    for (uint32_t i = 0; i < ctx.frames; i++)
+    {
+      f.begin();
+      scheduler.run(i * 1000);
+      f.end();
+    }
+  }
+}
+
+#ifdef YTGRAPH_STATS
+
+class statsCapture : public Print // the bytes of dump()
+{
+public:
+  size_t write(uint8_t c) override
+  {
+    bytes.push_back(c);
+    return 1;
+  }
+  using Print::write;
+  std::vector<uint8_t> bytes;
+};
+
+BENCH_CASE(statsCheck) // buckets, percentiles, dropped frames, every stage counted, dump and overlay
+{
+  uint32_t us = ytGraphStats::cyclesPerUs();
+
+  // bucket b holds [2^(b + 6), 2^(b + 7)) cycles, the last one the rest
+  bool ok = ytGraphStats::bucket(0) == 0 && ytGraphStats::bucket(127) == 0 && ytGraphStats::bucket(128) == 1 &&
+            ytGraphStats::bucket(255) == 1 && ytGraphStats::bucket(256) == 2 &&
+            ytGraphStats::bucket(0xFFFFFFFF) == STATS_BUCKETS - 1;
+  BENCH_CHECK(ctx, ok, "histogram buckets are wrong");
+
+  // 90 fast and 10 slow frames of known length, budget of 1 ms
+  ytGraphStats::reset();
+  ytGraphStats::setFrameBudget(1000);
+  for (int i = 0; i < 100; i++)
+    ytGraphStats::record(STATS_FRAME, (i % 10 == 9 ? 2500 : 100) * us); // 2.5 ms drops 2 frames
+  const ytGraphStageStats &frame = ytGraphStats::stage(STATS_FRAME);
+  ok = frame.count == 100 && frame.max == 2500 * us && ytGraphStats::dropped() == 20 &&
+       ytGraphStats::percentile(STATS_FRAME, 50) >= 100 && ytGraphStats::percentile(STATS_FRAME, 50) < 200 &&
+       ytGraphStats::percentile(STATS_FRAME, 99) >= 2500 && ytGraphStats::percentile(STATS_FRAME, 99) < 5000 &&
+       ytGraphStats::meanUs(STATS_FRAME) == 340 && ytGraphStats::maxUs(STATS_FRAME) == 2500;
+  BENCH_CHECK(ctx, ok, "frames: count %u, dropped %u, p50 %u us, p99 %u us, mean %u us", frame.count,
+              ytGraphStats::dropped(), ytGraphStats::percentile(STATS_FRAME, 50), ytGraphStats::percentile(STATS_FRAME, 99),
+              ytGraphStats::meanUs(STATS_FRAME));
+
+  // a scrolling graph: every stage of the hot path is counted
+  {
+    ytGraphStats::reset();
+    ytGraphStats::setFrameBudget(0);
+    uint16_t colors[4] = {TFT_CYAN, TFT_PINK, TFT_YELLOW, TFT_MAGENTA};
+    ytGraphInstance g(benchTFT, ytGraphConfigDefault);
+    g.begin(colors, 4);
+    ytGraphScheduler scheduler(benchTFT);
+    uint32_t state = 0;
+    scheduler.add(g, 1000, statsSource, &state);
+    uint32_t frames = 3 * (SAMPLE_COUNT + 1);
+    for (uint32_t i = 0; i < frames; i++)
+      scheduler.run(i * 1000);
+    ok = true;
+    for (uint8_t s = 0; s < STATS_STAGES; s++)
+    {
+      uint32_t sum = 0;
+      for (uint8_t b = 0; b < STATS_BUCKETS; b++)
+        sum += ytGraphStats::stage(s).hist[b];
+      ok = ok && ytGraphStats::stage(s).count > 0 && sum == ytGraphStats::stage(s).count;
+    }
+    ok = ok && ytGraphStats::stage(STATS_FRAME).count == frames && ytGraphStats::stage(STATS_LINE).count == 4 * frames &&
+         ytGraphStats::stage(STATS_PUSH).count >= 2 * frames && ytGraphStats::dropped() == 0;
+    BENCH_CHECK(ctx, ok, "stages of %u frames: ingest %u, scroll %u, grid %u, line %u, push %u, frame %u", frames,
+                ytGraphStats::stage(STATS_INGEST).count, ytGraphStats::stage(STATS_SCROLL).count,
+                ytGraphStats::stage(STATS_GRID).count, ytGraphStats::stage(STATS_LINE).count,
+                ytGraphStats::stage(STATS_PUSH).count, ytGraphStats::stage(STATS_FRAME).count);
+  }
+
+  // binary dump: header and all stages
+  {
+    statsCapture out;
+    size_t n = ytGraphStats::dump(out);
+    uint32_t header[6] = {};
+    if (out.bytes.size() >= sizeof(header))
+      memcpy(header, out.bytes.data(), sizeof(header));
+    ok = n == out.bytes.size() && n == sizeof(header) + STATS_STAGES * sizeof(ytGraphStageStats) &&
+         memcmp(out.bytes.data(), "YTST", 4) == 0 && header[1] == 1 && header[2] == STATS_STAGES &&
+         header[3] == STATS_BUCKETS && header[4] == us;
+    ytGraphStageStats line;
+    if (ok)
+      memcpy(&line, out.bytes.data() + sizeof(header) + STATS_LINE * sizeof(line), sizeof(line));
+    BENCH_CHECK(ctx, ok && line.count == ytGraphStats::stage(STATS_LINE).count, "dump(): %u bytes, wrong header or stages",
+                (unsigned)n);
+  }
+
+  // overlay: text lines inside its area, nothing drawn below
+  {
+    benchTFT.fillScreen(TFT_BLACK);
+    ytGraphStats::overlay(benchTFT, 0, 0, TFT_WHITE, TFT_NAVY);
+    bool drawn = false, below = false;
+    for (int16_t y = 0; y < 80; y++)
+      for (int16_t x = 0; x < benchTFT.width(); x++)
+      {
+        bool set = benchTFT.readPixel(x, y) != TFT_BLACK;
+        drawn = drawn || (set && y < 8 * (STATS_STAGES + 1));
+        below = below || (set && y >= 8 * (STATS_STAGES + 1));
+      }
+    BENCH_CHECK(ctx, drawn && !below, "overlay: drawn %d, below its lines %d", drawn, below);
+  }
+  ytGraphStats::reset();
+}
+
+#endif
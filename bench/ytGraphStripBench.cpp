@@ -0,0 +1,144 @@
+/***************************************************************************************
+ * Benchmarks for the strip rendering in ytGraphStrip.h
+ *
+ *  - a scrolling 440x280 graph on a 480x320 panel, 16 bit: one sprite of the whole
+ *    graph (a single tile) vs. strips of 24 and 48 columns, frame time and the
+ *    peak memory of the sprite compared with the largest free heap block
+ *  - the strips give the same pixels on the panel as one sprite of the whole graph
+ *    drawn with ytGraphDrawChannels(), for any tile width, grid position and a
+ *    wrapped channel store, and walk about samples + tiles segments per channel
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphStrip.h"
+#include <algorithm>
+
+#define STRIP_CHANNELS 4
+
+static constexpr ytGraphConfig stripConfig = { // most of a 480x320 panel
+    30, 300, 440, 280, 220, 1, 'S', 0, 20, 0.0, 60.0, 10,
+    TFT_ORANGE, TFT_BLACK, TFT_WHITE, TFT_LIGHTGREY, "", ""};
+
+typedef ytGraphChannelStore<STRIP_CHANNELS, 221> stripStore; // samples + 1 of stripConfig
+
+static int16_t stripSample(uint32_t i, int c)
+{
+  return (int16_t)(8 + 12 * c + ((i * (3 + c) + 11 * c) % 17) - 8);
+}
+
+static void stripPush(stripStore &s, uint32_t i)
+{
+  int16_t y[STRIP_CHANNELS];
+  for (int c = 0; c < STRIP_CHANNELS; c++)
+    y[c] = stripSample(i, c);
+  s.push(y);
+}
+
+BENCH_CASE(stripFrame) // one scroll frame: the whole graph in one sprite vs. strips, peak memory
+{
+  const ytGraphLayout &cfg = ytGraphStaticLayout<stripConfig>::layout;
+  static char text[3][64];
+  static const char *labels[3] = {"one sprite, 16 bit", "strips of 24, 16 bit", "strips of 48, 16 bit"};
+  static const int16_t widths[3] = {cfg.spriteWidth(), 24, 48};
+  TFT_eSPI panel(480, 320);
+  uint16_t colors[STRIP_CHANNELS];
+  for (int c = 0; c < STRIP_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+
+  for (int v = 0; v < 3; v++)
+  {
+    ytGraphStrip strip(panel);
+    if (!strip.begin(cfg, 16, widths[v]))
+    {
+      BENCH_CHECK(ctx, false, "%s: out of memory", labels[v]);
+      continue;
+    }
+    stripStore s;
+    for (uint32_t i = 0; i < s.capacity(); i++)
+      stripPush(s, i);
+    int16_t gridX = cfg.xStep;
+    uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+    benchFrames f(labels[v], STRIP_CHANNELS);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      stripPush(s, s.capacity() + i);
+      gridX -= cfg.scrollStep; // the grid moves left with the samples
+      if (gridX < 0)
+        gridX += cfg.xStep;
+      f.begin();
+      strip.draw(s, colors, gridX);
+      f.end();
+    }
+    snprintf(text[v], sizeof(text[v]), "peak %.1f KB, fits %s (largest block %.1f KB)", strip.bytes() / 1024.0,
+             strip.bytes() <= ESP.getMaxAllocHeap() ? "yes" : "no", ESP.getMaxAllocHeap() / 1024.0);
+    f.extra(text[v]);
+  }
+}
+
+BENCH_CASE(stripCheck) // same panel pixels as one sprite of the whole graph, bounded segment walk
+{
+  const ytGraphLayout &cfg = ytGraphLayoutDefault; // ytGraphDrawChannels() maps with the #define scale
+  typedef ytGraphChannelStore<STRIP_CHANNELS, SAMPLE_COUNT + 1> pageStore;
+  uint16_t colors[STRIP_CHANNELS];
+  for (int c = 0; c < STRIP_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+
+  for (uint8_t bpp : {4, 16})
+    for (int16_t tileWidth : {(int16_t)1, (int16_t)7, (int16_t)24, cfg.spriteWidth()})
+      for (int16_t gridX : {(int16_t)cfg.xStep, (int16_t)3, (int16_t)0})
+      {
+        pageStore s;
+        int16_t y[STRIP_CHANNELS];
+        for (uint32_t i = 0; i < s.capacity() + 7; i++) // wrapped, head in the middle of the ring
+        {
+          for (int c = 0; c < STRIP_CHANNELS; c++)
+            y[c] = (int16_t)(5 + 15 * c + (i * (7 + c)) % 23) - 4;
+          s.push(y);
+        }
+        bool aa = bpp == 16 && gridX == 3;
+
+        // reference: one sprite of the whole graph
+        TFT_eSprite a(&benchTFT);
+        a.setColorDepth(bpp);
+        a.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+        a.fillSprite(cfg.bgrndColor);
+        ytGraphDrawGridY(a, cfg, 0, cfg.spriteWidth());
+        for (int16_t x = gridX; x < cfg.spriteWidth(); x += cfg.xStep)
+          a.drawFastVLine(x, 0, cfg.height, cfg.gridColor);
+        ytGraphChannel ch[STRIP_CHANNELS];
+        for (int c = 0; c < STRIP_CHANNELS; c++)
+          ch[c] = {colors[c], 0, 0};
+        ytGraphDrawChannels(a, s, ch, 0, 0, s.size(), SPAN_WIDTH, aa);
+
+        ytGraphStrip strip(benchTFT);
+        BENCH_CHECK(ctx, strip.begin(cfg, bpp, tileWidth), "%u bit, tiles of %d: begin() failed", bpp, tileWidth);
+        benchTFT.fillScreen(TFT_NAVY);
+        strip.draw(s, colors, gridX, SPAN_WIDTH, aa);
+        bool same = true;
+        for (int16_t py = 0; py < a.height() && same; py++)
+          for (int16_t px = 0; px < a.width() && same; px++)
+            same = benchTFT.readPixel(cfg.spriteX() + px, cfg.spriteY() + py) == a.readPixel(px, py);
+        BENCH_CHECK(ctx, same, "%u bit, tiles of %d, grid at %d: the panel differs from one sprite", bpp, tileWidth, gridX);
+        BENCH_CHECK(ctx, strip.lastSegments() <= STRIP_CHANNELS * (s.size() + strip.tiles()),
+                    "%u bit, tiles of %d: %u segments walked for %u samples", bpp, tileWidth, strip.lastSegments(), s.size());
+      }
+
+  // the tile of the big graph is an order of magnitude smaller than its sprite
+  {
+    const ytGraphLayout &big = ytGraphStaticLayout<stripConfig>::layout;
+    ytGraphStrip strip(benchTFT);
+    strip.begin(big, 16);
+    uint32_t whole = (uint32_t)big.spriteWidth() * big.spriteHeight() * 2;
+    BENCH_CHECK(ctx, strip.bytes() * 10 <= whole, "strip %u bytes, one sprite %u bytes", strip.bytes(), whole);
+  }
+}
@@ -0,0 +1,195 @@
+/***************************************************************************************
+ * Benchmarks for the streaming statistics in ytGraphSummary.h
+ *
+ *  - one sample of 4 channels: add() in O(1) vs. a rescan of the visible window
+ *    (21 and 241 samples) for min, max, mean and standard deviation
+ *  - long random sequences (random walks, jumps, constant parts, full 16 bit
+ *    range) compared with a naive recomputation: window and since begin() stats,
+ *    EMA, for several window lengths and channel counts
+ *  - the reference marks stay right of the graph frame
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphSummary.h"
+#include <algorithm>
+#include <cmath>
+
+#define SUMMARY_BENCH_CHANNELS 4
+
+struct summaryNaive // min/max/mean/stddev of n values, two passes
+{
+  int16_t min, max;
+  double mean, stddev;
+};
+
+static summaryNaive summaryOf(const std::vector<int16_t> &v, size_t from, size_t to)
+{
+  summaryNaive r{v[from], v[from], 0.0, 0.0};
+  for (size_t i = from; i < to; i++)
+  {
+    r.min = std::min(r.min, v[i]);
+    r.max = std::max(r.max, v[i]);
+    r.mean += v[i];
+  }
+  r.mean /= (double)(to - from);
+  for (size_t i = from; i < to; i++)
+    r.stddev += (v[i] - r.mean) * (v[i] - r.mean);
+  r.stddev = std::sqrt(r.stddev / (double)(to - from));
+  return r;
+}
+
+static int16_t summaryRandom(uint32_t &seed, int16_t prev, uint32_t i, uint8_t c) // different kinds of signals
+{
+  seed = seed * 1103515245 + 12345;
+  int32_t r = (int32_t)(seed >> 8);
+  switch ((c + i / 5000) % 4)
+  {
+  case 0: // random walk
+    return (int16_t)std::max(-30000, std::min(30000, prev + r % 41 - 20));
+  case 1: // noise around a level with rare jumps
+    return (int16_t)(1000 * c + r % 21 + (r % 97 == 0 ? 500 : 0));
+  case 2: // constant
+    return (int16_t)(-123 + c);
+  default: // the whole 16 bit range
+    return (int16_t)(r & 0xFFFF);
+  }
+}
+
+BENCH_CASE(summaryFrame) // one sample of 4 channels: incremental vs. rescan of the window
+{
+  static char label[4][48];
+  uint32_t seed = 1;
+  for (int w = 0; w < 2; w++)
+  {
+    uint32_t window = w ? GRAPH_WIDTH + 1 : SAMPLE_COUNT + 1;
+    ytGraphSummary s;
+    s.begin(window, SUMMARY_BENCH_CHANNELS);
+    std::vector<int16_t> ring[SUMMARY_BENCH_CHANNELS];
+    for (int c = 0; c < SUMMARY_BENCH_CHANNELS; c++)
+      ring[c].assign(window, 0);
+    static volatile float sink; // keeps the results alive
+    for (int k = 0; k < 2; k++)
+    {
+      snprintf(label[2 * w + k], sizeof(label[0]), "%s, window %u", k ? "add()" : "rescan", window);
+      benchFrames f(label[2 * w + k], SUMMARY_BENCH_CHANNELS);
+      int16_t y[SUMMARY_BENCH_CHANNELS] = {};
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        for (int c = 0; c < SUMMARY_BENCH_CHANNELS; c++)
+          y[c] = summaryRandom(seed, y[c], i, c);
+        f.begin();
+        if (k)
+        {
+          s.add(y);
+          for (int c = 0; c < SUMMARY_BENCH_CHANNELS; c++)
+            sink += s.window(c).stddev;
+        }
+        else
+          for (int c = 0; c < SUMMARY_BENCH_CHANNELS; c++)
+          {
+            ring[c][i % window] = y[c];
+            sink += (float)summaryOf(ring[c], 0, window).stddev;
+          }
+        f.end();
+      }
+    }
+  }
+}
+
+BENCH_CASE(summaryCheck) // window, since begin() and EMA against a naive recomputation
+{
+  for (uint32_t window : {1u, 2u, (uint32_t)SAMPLE_COUNT + 1, 241u, 4096u})
+    for (uint8_t channels : {(uint8_t)1, (uint8_t)SUMMARY_BENCH_CHANNELS})
+    {
+      ytGraphSummary s;
+      bool begun = s.begin(window, channels, nullptr, 3);
+      BENCH_CHECK(ctx, begun, "window %u: begin() failed", window);
+      if (!begun)
+        continue;
+      std::vector<int16_t> v[SUMMARY_BENCH_CHANNELS];
+      double ema[SUMMARY_BENCH_CHANNELS] = {};
+      uint32_t seed = 99 + window, n = 40000, bad = 0;
+      int16_t y[SUMMARY_BENCH_CHANNELS] = {};
+      for (uint32_t i = 0; i < n && bad < 5; i++)
+      {
+        for (uint8_t c = 0; c < channels; c++)
+        {
+          y[c] = summaryRandom(seed, y[c], i, c);
+          v[c].push_back(y[c]);
+          ema[c] = i ? ema[c] + (y[c] - ema[c]) / 8.0 : y[c];
+        }
+        s.add(y);
+        if (i % 997 != 0 && i != n - 1 && i >= 3 * window) // a few checks, also while the window fills
+          continue;
+        for (uint8_t c = 0; c < channels; c++)
+        {
+          size_t from = v[c].size() > window ? v[c].size() - window : 0;
+          summaryNaive a = summaryOf(v[c], from, v[c].size()), b = summaryOf(v[c], 0, v[c].size());
+          ytGraphChannelSummary w = s.window(c), t = s.total(c);
+          // float results: relative precision of 1e-6, the EMA has a fixed point error below 2^shift / 256
+          auto near = [](double x, double ref, double tol) { return std::fabs(x - ref) <= tol + 1e-6 * std::fabs(ref); };
+          bool ok = w.count == v[c].size() - from && w.min == a.min && w.max == a.max && near(w.mean, a.mean, 1e-3) &&
+                    near(w.stddev, a.stddev, 1e-2) && t.count == v[c].size() && t.min == b.min && t.max == b.max &&
+                    near(t.mean, b.mean, 1e-3) && near(t.stddev, b.stddev, 1e-2) && near(s.ema(c), ema[c], 0.05);
+          if (!ok && bad++ < 5)
+            BENCH_CHECK(ctx, false,
+                        "window %u, sample %u, channel %u: window %d..%d %.3f+-%.3f (naive %d..%d %.3f+-%.3f), "
+                        "total %.3f+-%.3f (naive %.3f+-%.3f), ema %.3f (naive %.3f)",
+                        window, i, c, w.min, w.max, w.mean, w.stddev, a.min, a.max, a.mean, a.stddev, t.mean, t.stddev,
+                        b.mean, b.stddev, s.ema(c), ema[c]);
+        }
+      }
+    }
+
+  // the arena budget is exact, clear() starts over
+  {
+    ytGraphArena arena;
+    arena.begin(ytGraphSummary::bytes(SAMPLE_COUNT + 1, SUMMARY_BENCH_CHANNELS));
+    ytGraphSummary s;
+    bool ok = s.begin(SAMPLE_COUNT + 1, SUMMARY_BENCH_CHANNELS, &arena) && arena.stats().used == arena.stats().size;
+    int16_t y[SUMMARY_BENCH_CHANNELS] = {5, 6, 7, 8};
+    s.add(y);
+    s.clear();
+    s.add(y);
+    ok = ok && s.window(3).count == 1 && s.total(3).count == 1 && s.window(3).mean == 8.0f && s.ema(0) == 5.0f;
+    BENCH_CHECK(ctx, ok, "arena budget or clear() is wrong, used %u of %u", arena.stats().used, arena.stats().size);
+  }
+
+  // the marks stay right of the frame, inside the height of the graph
+  {
+    const ytGraphLayout &cfg = ytGraphLayoutDefault;
+    ytGraphSummary s;
+    s.begin(SAMPLE_COUNT + 1, SUMMARY_BENCH_CHANNELS);
+    int16_t y[SUMMARY_BENCH_CHANNELS] = {-500, 20, 40, 500}; // two of them outside the y axis
+    s.add(y);
+    y[1] = 30;
+    s.add(y);
+    ytGraphChannel ch[SUMMARY_BENCH_CHANNELS];
+    for (int c = 0; c < SUMMARY_BENCH_CHANNELS; c++)
+      ch[c] = {benchChannelColor(c), 0, 0};
+    benchTFT.fillScreen(TFT_NAVY);
+    ytGraphDrawSummaryMarks(benchTFT, cfg, s, ch);
+    int16_t x0 = cfg.left + cfg.width + 4, x1 = x0 + SUMMARY_BENCH_CHANNELS * SUMMARY_MARK_WIDTH;
+    bool inside = true, lit = false;
+    for (int16_t py = 0; py < benchTFT.height(); py++)
+      for (int16_t px = 0; px < benchTFT.width(); px++)
+      {
+        uint16_t color = benchTFT.readPixel(px, py);
+        bool mark = color != TFT_NAVY && color != cfg.bgrndColor && color != cfg.axisLineColor;
+        bool area = px >= x0 && px < x1 && py >= cfg.spriteY() && py <= cfg.bottom;
+        lit = lit || (mark && area);
+        inside = inside && (!mark || area);
+      }
+    BENCH_CHECK(ctx, lit && inside, "marks: drawn %d, all inside their area %d", lit, inside);
+  }
+}
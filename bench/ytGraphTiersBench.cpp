@@ -0,0 +1,159 @@
+/***************************************************************************************
+ * Benchmarks for the multi resolution history in ytGraphTiers.h
+ *
+ *  - cost of one raw sample (including the rollups)
+ *  - switching the view: drawing a tier vs. aggregating the raw data again
+ *  - every aggregate must match a naive min/max/mean over its raw samples
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphTiers.h"
+
+#define TIERS_LEN (SAMPLE_COUNT + 1)
+
+typedef ytGraphTiers<4, TIERS_LEN, TIERS_LEN, TIERS_LEN> benchTiers;
+
+static int16_t tierSample(uint32_t i, int c)
+{
+  return (int16_t)(20 + 10 * c + 8 * sin(i * 0.001 + c) + random(-3, 4));
+}
+
+BENCH_CASE(tiersAdd) // 1000 raw samples of 4 channels per frame
+{
+  static benchTiers tiers(10);
+  int16_t v[4];
+  uint32_t n = 0;
+  benchFrames f("1000 samples into 3 tiers", 4);
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    f.begin();
+    for (int k = 0; k < 1000; k++, n++)
+    {
+      for (int c = 0; c < 4; c++)
+        v[c] = (int16_t)(n + c);
+      tiers.add(v);
+    }
+    f.end();
+  }
+}
+
+BENCH_CASE(tiersSwitch) // last minute / hour / day view from the tiers vs. from the raw data
+{
+  TFT_eSprite Graph(&benchTFT), xAxis(&benchTFT);
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  int16_t LastXGridLinePos = 0;
+
+  // one day of 1 Hz data, or as many hours as the hour view shows
+  const uint32_t hours = TIERS_LEN > 24 ? TIERS_LEN : 24;
+  uint32_t n = hours * 3600;
+  static benchTiers tiers(1);
+  tiers.clear();
+  std::vector<int16_t> raw(n * 4);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    for (int c = 0; c < 4; c++)
+      raw[i * 4 + c] = tierSample(i, c);
+    tiers.add(&raw[i * 4]);
+  }
+
+  ytGraphChannel channels[4];
+  for (int c = 0; c < 4; c++)
+    channels[c] = ytGraphChannel{benchChannelColor(c), 0, 0};
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+  static const char *labels[3] = {"tier view, seconds", "tier view, minutes", "tier view, hours"};
+  for (uint8_t tier = 0; tier < 3; tier++)
+  {
+    benchFrames f(labels[tier], 4);
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos, true, benchTiers::timeFormat(tier));
+      f.begin();
+      ytGraphDrawTier(Graph, tiers, tier, channels, 4);
+      f.end();
+    }
+  }
+
+  // the same hour view, aggregated from the raw data on every switch
+  benchFrames f("raw rescan, hours", 4);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos, true, 'H');
+    f.begin();
+    for (int c = 0; c < 4; c++)
+    {
+      for (uint32_t h = 0; h < TIERS_LEN; h++)
+      {
+        ytGraphAggregate a{};
+        for (uint32_t k = (hours - TIERS_LEN + h) * 3600; k < (hours - TIERS_LEN + h + 1) * 3600; k++)
+          a.add(raw[k * 4 + c]);
+        ytGraphColumn col{a.mean(), a.min, a.max, a.mean(), 1};
+        ytGraphDrawColumn(Graph, ytGraphMapX(ytGraphScaleDefault, h), col, channels[c]);
+      }
+    }
+    Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y);
+    f.end();
+  }
+}
+
+static bool sameAggregate(const ytGraphAggregate &a, const ytGraphAggregate &b)
+{
+  return a.min == b.min && a.max == b.max && a.sum == b.sum && a.count == b.count;
+}
+
+BENCH_CASE(tiersCheck) // aggregates against a naive scan of the raw samples
+{
+  const uint16_t rate = 3;             // raw samples per second
+  const uint32_t seconds = 3 * 3600 + 125; // three hours, two minutes and a bit
+  static ytGraphTiers<4, 200, 100, 5> tiers(rate);
+  tiers.clear();
+  std::vector<int16_t> raw(seconds * rate * 4);
+  for (uint32_t i = 0; i < seconds * rate; i++)
+  {
+    for (int c = 0; c < 4; c++)
+      raw[i * 4 + c] = tierSample(i, c) * (c == 3 ? -50 : 1); // also large negative values
+    tiers.add(&raw[i * 4]);
+  }
+
+  // interval k of a tier with 'len' raw samples per interval covers raw k * len .. (k + 1) * len - 1
+  const uint32_t len[3] = {rate, 60u * rate, 3600u * rate};
+  const uint32_t total[3] = {seconds, seconds / 60, seconds / 3600};
+  uint32_t wrong = 0, wrongSize = 0;
+  for (uint8_t tier = 0; tier < 3; tier++)
+  {
+    uint32_t n = tiers.size(tier);
+    if (n != std::min<uint32_t>(total[tier], tier == 0 ? 200 : tier == 1 ? 100 : 5))
+      wrongSize++;
+    for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t k = total[tier] - n + i;
+      for (int c = 0; c < 4; c++)
+      {
+        ytGraphAggregate a{};
+        for (uint32_t r = k * len[tier]; r < (k + 1) * len[tier]; r++)
+          a.add(raw[r * 4 + c]);
+        if (!sameAggregate(a, tiers.at(tier, i).ch[c]))
+          wrong++;
+      }
+    }
+  }
+  BENCH_CHECK(ctx, wrongSize == 0, "%u tiers have the wrong number of intervals", wrongSize);
+  BENCH_CHECK(ctx, wrong == 0, "%u aggregates differ from the raw data", wrong);
+
+  ytGraphAggregate m{};
+  m.add(-3);
+  m.add(-4);
+  BENCH_CHECK(ctx, m.mean() == -4, "mean of -3/-4 is %d, expected -4 (half away from zero)", m.mean());
+}
@@ -0,0 +1,229 @@
+/***************************************************************************************
+ * Benchmarks for the timestamped samples in ytGraphTimed.h
+ *
+ *  - a late batch of a few samples: the whole page redrawn and pushed vs. merged
+ *    and only the columns around it redrawn, frame time and pixel bytes
+ *  - the visible window of a long history: linear scan vs. binary search
+ *  - merge() keeps the samples sorted like a full sort, also when it overflows
+ *  - a merged batch with the partial redraw gives the same pixels as the whole
+ *    page drawn again, a pause longer than the gap leaves the columns empty
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphTimed.h"
+#include <algorithm>
+
+#define TIMED_CHANNELS 3
+#define TIMED_PERIOD 100 // ms between two samples
+#define TIMED_HISTORY 4096
+#define TIMED_PAGE 120 // samples of one page, 2 px each on the default graph
+
+typedef ytGraphTimeSeries<TIMED_CHANNELS, 512> timedSeries;
+
+static int16_t timedSample(uint32_t t, int c)
+{
+  return (int16_t)(5 + 15 * c + ((t / TIMED_PERIOD) * (7 + c)) % 23) - 4;
+}
+
+static void timedValues(uint32_t t, int16_t *y)
+{
+  for (int c = 0; c < TIMED_CHANNELS; c++)
+    y[c] = timedSample(t, c);
+}
+
+// every sample of a page, except those with (i % 10) == 3: they arrive late
+static void timedFill(timedSeries &s, uint32_t n, bool all)
+{
+  int16_t y[TIMED_CHANNELS];
+  for (uint32_t i = 0; i < n; i++)
+    if (all || i % 10 != 3)
+    {
+      timedValues(i * TIMED_PERIOD, y);
+      s.push(i * TIMED_PERIOD, y);
+    }
+}
+
+BENCH_CASE(timedFrame) // a late batch: whole page vs. merge with partial redraw, window lookup
+{
+  const ytGraphLayout &cfg = ytGraphLayoutDefault;
+  uint16_t colors[TIMED_CHANNELS];
+  for (int c = 0; c < TIMED_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+  ytGraphTimeView v = ytGraphTimeViewInit(cfg, 0, TIMED_PAGE * TIMED_PERIOD, 3 * TIMED_PERIOD, 20 * TIMED_PERIOD);
+  static char text[2][64];
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+
+  for (int p = 0; p < 2; p++)
+  {
+    TFT_eSprite spr(&benchTFT);
+    spr.setColorDepth(4);
+    spr.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+    ytGraphCanvas canvas(spr, cfg.spriteX(), cfg.spriteY());
+    canvas.begin();
+    benchFrames f(p ? "merge, columns of the batch" : "whole page", TIMED_CHANNELS);
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+      timedSeries s;
+      timedFill(s, TIMED_PAGE + 1, false);
+      ytGraphDrawTimed(canvas, cfg, v, s, colors);
+      canvas.push();
+      // the missing samples of one 10 sample block (the bus delivered them late)
+      uint32_t block = (i * 7) % (TIMED_PAGE / 10), t[1] = {(block * 10 + 3) * TIMED_PERIOD};
+      int16_t y[TIMED_CHANNELS];
+      timedValues(t[0], y);
+      f.begin();
+      if (p)
+        ytGraphMergeTimed(canvas, cfg, v, s, colors, t, y, 1);
+      else
+      {
+        s.merge(t, y, 1);
+        ytGraphDrawTimed(canvas, cfg, v, s, colors);
+      }
+      bytes += canvas.push();
+      f.end();
+    }
+    snprintf(text[p], sizeof(text[p]), "%u pixel bytes per batch", bytes / frames);
+    f.extra(text[p]);
+  }
+
+  // the first visible sample of a long history, the window moves along
+  {
+    static ytGraphTimeSeries<1, TIMED_HISTORY> h;
+    int16_t y = 0;
+    for (uint32_t i = 0; i < TIMED_HISTORY; i++)
+      h.push(i * TIMED_PERIOD + (i * 37) % 50, &y); // jitter
+    static uint32_t found;
+    for (int b = 0; b < 2; b++)
+    {
+      benchFrames f(b ? "window lookup, binary search" : "window lookup, linear scan", 1);
+      for (uint32_t i = 0; i < ctx.frames; i++)
+      {
+        uint32_t start = (i * 997 % TIMED_HISTORY) * TIMED_PERIOD;
+        f.begin();
+        if (b)
+          found += h.lowerBound(start);
+        else
+        {
+          uint32_t k = 0;
+          while (k < h.size() && h.time(k) < start)
+            k++;
+          found += k;
+        }
+        f.end();
+      }
+    }
+  }
+}
+
+BENCH_CASE(timedCheck) // sorted merge, partial redraw = whole page, gaps, binary search
+{
+  const ytGraphLayout &cfg = ytGraphLayoutDefault;
+  uint16_t colors[TIMED_CHANNELS];
+  for (int c = 0; c < TIMED_CHANNELS; c++)
+    colors[c] = benchChannelColor(c);
+
+  // merge(): sorted, stable, the newest N survive an overflow, lowerBound() = linear scan
+  {
+    ytGraphTimeSeries<1, 64> s;
+    std::vector<uint32_t> all;
+    uint32_t seed = 12345;
+    bool ok = true;
+    for (int round = 0; round < 40 && ok; round++)
+    {
+      uint32_t t[6], k = 1 + round % 6;
+      int16_t y[6];
+      for (uint32_t i = 0; i < k; i++)
+      {
+        seed = seed * 1103515245 + 12345;
+        t[i] = round * 40 + (seed >> 16) % 120; // late ones and duplicates
+      }
+      std::sort(t, t + k);
+      for (uint32_t i = 0; i < k; i++)
+      {
+        y[i] = (int16_t)t[i];
+        all.push_back(t[i]);
+      }
+      if (k == 1)
+        s.push(t[0], y);
+      else
+        s.merge(t, y, k);
+      std::sort(all.begin(), all.end());
+      if (all.size() > s.capacity())
+        all.erase(all.begin(), all.end() - s.capacity());
+      ok = s.size() == all.size();
+      for (uint32_t i = 0; i < s.size() && ok; i++)
+        ok = s.time(i) == all[i] && s.value(0, i) == (int16_t)all[i];
+      for (uint32_t q = 0; q < 200 && ok; q += 7)
+        ok = s.lowerBound(round * 40 + q) == (uint32_t)(std::lower_bound(all.begin(), all.end(), round * 40 + q) - all.begin());
+    }
+    BENCH_CHECK(ctx, ok, "merge() or lowerBound() differ from a sorted copy (%u samples)", (unsigned)all.size());
+  }
+
+  // late batches merged with the partial redraw: the same pixels as the whole page drawn again
+  for (uint8_t bpp : {4, 16})
+    for (uint32_t start : {0u, 1234u})
+      for (uint32_t gap : {0u, 150u}) // 150: a missing sample breaks the line until it is merged
+      {
+        ytGraphTimeView v = ytGraphTimeViewInit(cfg, start, TIMED_PAGE * TIMED_PERIOD, gap, 20 * TIMED_PERIOD);
+        TFT_eSprite a(&benchTFT), b(&benchTFT);
+        a.setColorDepth(bpp);
+        b.setColorDepth(bpp);
+        a.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+        b.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+        ytGraphCanvas ca(a, cfg.spriteX(), cfg.spriteY()), cb(b, cfg.spriteX(), cfg.spriteY());
+        ca.begin();
+        cb.begin();
+        timedSeries sa, sb;
+        timedFill(sa, TIMED_PAGE + 20, false);
+        ytGraphDrawTimed(ca, cfg, v, sa, colors);
+        int16_t most = 0;
+        for (uint32_t block = 0; block < (TIMED_PAGE + 20) / 10; block += 3) // three of the late ones at once
+        {
+          uint32_t t[3], k = std::min(3u, (TIMED_PAGE + 20) / 10 - block);
+          int16_t y[3 * TIMED_CHANNELS];
+          for (uint32_t i = 0; i < k; i++)
+          {
+            t[i] = ((block + i) * 10 + 3) * TIMED_PERIOD;
+            timedValues(t[i], y + i * TIMED_CHANNELS);
+          }
+          most = std::max(most, ytGraphMergeTimed(ca, cfg, v, sa, colors, t, y, k));
+        }
+        timedFill(sb, TIMED_PAGE + 20, true);
+        ytGraphDrawTimed(cb, cfg, v, sb, colors);
+        BENCH_CHECK(ctx, benchSpritesEqual(a, b), "%u bit, start %u, gap %u: the merged page differs from a new one", bpp,
+                    start, gap);
+        BENCH_CHECK(ctx, most > 0 && most < cfg.spriteWidth() / 2, "%u bit: a batch of 3 redrew %d columns", bpp, most);
+      }
+
+  // true time position and gaps: a pause longer than the gap leaves only background and grid
+  {
+    ytGraphTimeView v = ytGraphTimeViewInit(cfg, 0, 30 * TIMED_PERIOD, 3 * TIMED_PERIOD);
+    TFT_eSprite a(&benchTFT);
+    a.setColorDepth(16);
+    a.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+    ytGraphCanvas canvas(a, cfg.spriteX(), cfg.spriteY());
+    canvas.begin();
+    ytGraphTimeSeries<1, 64> s;
+    int16_t y = 10;
+    for (uint32_t t : {0u, 100u, 200u, 300u, 1500u, 1600u, 2950u}) // two pauses, one single sample
+      s.push(t, &y);
+    uint16_t line = benchChannelColor(0);
+    ytGraphDrawTimed(canvas, cfg, v, s, &line);
+    int16_t row = ytGraphMapY(cfg.scale, y);
+    auto lit = [&](int16_t x) { return a.readPixel(x, row) == line; };
+    bool ok = lit(ytGraphTimeX(v, 150)) && lit(ytGraphTimeX(v, 1550)) && lit(ytGraphTimeX(v, 2950)) &&
+              !lit(ytGraphTimeX(v, 900)) && !lit(ytGraphTimeX(v, 2200)) && !lit(ytGraphTimeX(v, 2950) + 3);
+    BENCH_CHECK(ctx, ok, "the line is not at the time of its samples or does not break at the pauses");
+  }
+}
@@ -0,0 +1,170 @@
+/***************************************************************************************
+ * Benchmarks for the zoomable history in ytGraphZoom.h
+ *
+ *  - the columns of one pan step at three zoom levels of a 16384 sample history:
+ *    from a scan of their raw samples vs. from the min/max segment tree
+ *  - push() of one sample into the tree
+ *  - range() gives the same first/min/max/last as a scan, also over the wrap of
+ *    the ring, and a page drawn from the tree is the same as one drawn from
+ *    scanned columns
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphBench.h"
+#include "ytGraphZoom.h"
+#include <algorithm>
+
+#define ZOOM_CHANNELS 4
+#define ZOOM_SAMPLES 16384
+
+typedef ytGraphZoomTree<ZOOM_CHANNELS, ZOOM_SAMPLES> zoomHistory;
+
+static int16_t zoomSample(uint32_t n, int c)
+{
+  return (int16_t)(10 + 12 * c + ((n * (5 + c) + 7 * c) % 19) - 9 + (n % 997 == 0 ? 15 : 0)); // with rare spikes
+}
+
+static void zoomFill(zoomHistory &h, uint32_t n)
+{
+  int16_t y[ZOOM_CHANNELS];
+  for (uint32_t i = 0; i < n; i++)
+  {
+    for (int c = 0; c < ZOOM_CHANNELS; c++)
+      y[c] = zoomSample(h.next(), c);
+    h.push(y);
+  }
+}
+
+static ytGraphColumn zoomScan(const zoomHistory &h, uint8_t c, uint32_t from, uint32_t to) // the raw samples
+{
+  ytGraphColumn col{0, 0, 0, 0, 0};
+  from = std::max(from, h.oldest());
+  to = std::min(to, h.next());
+  for (uint32_t n = from; n < to; n++)
+  {
+    int16_t v = h.value(c, n);
+    if (!col.count)
+      col.first = col.min = col.max = v;
+    col.min = std::min(col.min, v);
+    col.max = std::max(col.max, v);
+    col.last = v;
+    col.count++;
+  }
+  return col;
+}
+
+static void zoomDrawScanned(TFT_eSprite &Graph, const ytGraphLayout &cfg, const zoomHistory &h, uint32_t first, uint32_t count,
+                            ytGraphChannel *ch)
+{
+  h.window(first, count);
+  const uint32_t columns = cfg.width + 1;
+  for (uint8_t c = 0; c < ZOOM_CHANNELS; c++)
+    for (uint32_t x = 0, from = first; x < columns; x++)
+    {
+      uint32_t to = first + (uint32_t)(((uint64_t)(x + 1) * count + columns - 1) / columns);
+      ytGraphDrawColumn(Graph, cfg.scale, (int16_t)x, zoomScan(h, c, from, to), ch[c]);
+      from = to;
+    }
+}
+
+BENCH_CASE(zoomFrame) // the columns of one pan step: scan of the raw samples vs. segment tree, push()
+{
+  static zoomHistory h; // 400 KB, not on the stack
+  h.clear();
+  zoomFill(h, ZOOM_SAMPLES + 1000); // wrapped
+  static const uint32_t zoom[3] = {GRAPH_WIDTH, 3600, ZOOM_SAMPLES};
+  static char label[6][48];
+  static ytGraphColumn cols[ZOOM_CHANNELS][GRAPH_WIDTH + 1]; // drawing them costs the same for both
+  const uint32_t columns = GRAPH_WIDTH + 1;
+  static volatile int32_t sink; // keeps the columns alive
+  uint32_t frames = std::max<uint32_t>(1, ctx.frames / 10);
+
+  for (int z = 0; z < 3; z++)
+    for (int t = 0; t < 2; t++)
+    {
+      snprintf(label[2 * z + t], sizeof(label[0]), "%s, %u samples", t ? "tree" : "scan", zoom[z]);
+      benchFrames f(label[2 * z + t], ZOOM_CHANNELS);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        uint32_t first = h.oldest() + (i * 97) % (ZOOM_SAMPLES - zoom[z] + 1), count = zoom[z]; // pan
+        f.begin();
+        for (uint8_t c = 0; c < ZOOM_CHANNELS; c++)
+          for (uint32_t x = 0, from = first; x < columns; x++)
+          {
+            uint32_t to = first + (uint32_t)(((uint64_t)(x + 1) * count + columns - 1) / columns);
+            cols[c][x] = t ? h.range(c, from, to) : zoomScan(h, c, from, to);
+            from = to;
+          }
+        f.end();
+        sink += cols[i % ZOOM_CHANNELS][i % columns].max;
+      }
+    }
+
+  benchFrames f("push, 4 channels", ZOOM_CHANNELS);
+  int16_t y[ZOOM_CHANNELS];
+  for (uint32_t i = 0; i < ctx.frames; i++)
+  {
+    for (int c = 0; c < ZOOM_CHANNELS; c++)
+      y[c] = zoomSample(i, c);
+    f.begin();
+    h.push(y);
+    f.end();
+  }
+}
+
+BENCH_CASE(zoomCheck) // range() = scan, the page from the tree = the page from scanned columns
+{
+  static zoomHistory h;
+  for (uint32_t fill : {37u, (uint32_t)ZOOM_SAMPLES, ZOOM_SAMPLES + 5000u})
+  {
+    h.clear();
+    zoomFill(h, fill);
+    bool ok = h.size() == std::min(fill, (uint32_t)ZOOM_SAMPLES) && h.next() == fill;
+    uint32_t seed = 777;
+    for (int q = 0; q < 2000 && ok; q++)
+    {
+      seed = seed * 1103515245 + 12345;
+      uint32_t from = h.oldest() + (seed >> 8) % (h.size() + 10), len = (seed >> 3) % (q & 1 ? 64 : h.size() + 1);
+      if (q % 500 == 0) // a few over the edges
+        from = h.oldest() - (h.oldest() ? 1 : 0);
+      uint8_t c = q % ZOOM_CHANNELS;
+      ytGraphColumn a = h.range(c, from, from + len), b = zoomScan(h, c, from, from + len);
+      ok = a.count == b.count && (!a.count || (a.first == b.first && a.min == b.min && a.max == b.max && a.last == b.last));
+    }
+    BENCH_CHECK(ctx, ok, "%u samples: range() differs from a scan", fill);
+
+    ytGraphConfig small = ytGraphConfigDefault; // e.g. a quarter of the multi graph example, other width and scale
+    small.width = 100;
+    small.height = 60;
+    small.samples = 50;
+    small.yMax = 100.0;
+    for (const ytGraphLayout &cfg : {ytGraphLayoutDefault, ytGraphLayout(small)})
+      for (uint32_t count : {5u, (uint32_t)cfg.width, 1000u, (uint32_t)ZOOM_SAMPLES})
+      {
+        TFT_eSprite a(&benchTFT), b(&benchTFT);
+        a.setColorDepth(4);
+        b.setColorDepth(4);
+        a.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+        b.createSprite(cfg.spriteWidth(), cfg.spriteHeight());
+        a.fillSprite(cfg.bgrndColor);
+        b.fillSprite(cfg.bgrndColor);
+        ytGraphChannel ca[ZOOM_CHANNELS], cb[ZOOM_CHANNELS];
+        for (int c = 0; c < ZOOM_CHANNELS; c++)
+          ca[c] = cb[c] = {benchChannelColor(c), 0, 0};
+        uint32_t first = h.next() - std::min(h.size(), count) / 2 - 3;
+        ytGraphDrawZoom(a, cfg, h, first, count, ca, ZOOM_CHANNELS, false);
+        zoomDrawScanned(b, cfg, h, first, count, cb);
+        BENCH_CHECK(ctx, benchSpritesEqual(a, b), "%u samples, width %u, zoom %u: the page from the tree differs", fill,
+                    cfg.width, count);
+      }
+  }
+}
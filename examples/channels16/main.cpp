@@ -0,0 +1,95 @@
+/***************************************************************************************
+ * ytGraph example: 16 channels in one graph
+ * Platform: Arduino / ESP
+ *
+ *  - one int16_t array per channel (ytGraphChannels.h), all channels share the ring head
+ *  - every second a new sample of all channels is pushed and the page is redrawn column by
+ *    column: the values of one x are mapped in one batch, then every channel writes its span
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphChannels.h"
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+TFT_eSprite Graph = TFT_eSprite(&TFT);
+TFT_eSprite xAxis = TFT_eSprite(&TFT);
+ytGraphCanvas GraphCanvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y);
+ytGraphCanvas xAxisCanvas(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+
+ytGraphChannelStore<16, SAMPLE_COUNT + 1> Store; // one array per channel, ~0.7 kB
+ytGraphChannel Channels[16];
+int16_t LastXGridLinePos = 0;
+unsigned long previousMillis = 0;
+
+void pushSample()
+{
+  int16_t values[16];
+  for (uint8_t c = 0; c < 16; c++)
+    values[c] = 3 * c + random(0, 8); // every channel in its own band
+  Store.push(values);
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR);
+  ytGraphDrawYaxisFrame(TFT);
+
+  Graph.setColorDepth(4); // 16 colours, one per channel
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  GraphCanvas.begin();
+  xAxisCanvas.begin();
+
+  static const uint16_t colors[16] = {TFT_CYAN, TFT_PINK, TFT_YELLOW, TFT_MAGENTA, TFT_RED, TFT_GREEN,
+                                      TFT_BLUE, TFT_ORANGE, TFT_WHITE, TFT_PURPLE, TFT_BROWN, TFT_MAROON,
+                                      TFT_DARKGREEN, TFT_NAVY, TFT_DARKGREY, TFT_LIGHTGREY};
+  for (uint8_t c = 0; c < 16; c++)
+    Channels[c] = {colors[c], 0, 0};
+  for (uint16_t i = 0; i <= SAMPLE_COUNT; i++)
+    pushSample();
+}
+
+void loop()
+{
+  unsigned long currentMillis = millis();
+  if (currentMillis - previousMillis >= 1000) // non blocking delay
+  {
+    previousMillis = currentMillis;
+    pushSample(); // the oldest sample drops out, the ring wraps
+    ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos); // refresh the grid
+    ytGraphDrawChannels(GraphCanvas, Store, Channels); // whole page, one push
+  }
+}
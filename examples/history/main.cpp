@@ -0,0 +1,139 @@
+/***************************************************************************************
+ * ytGraph example: views of a long history
+ * Platform: Arduino / ESP
+ *
+ *  - multi resolution tiers (ytGraphTiers.h): one day of 1 Hz data shown as the last
+ *    seconds, minutes and hours, drawn from the aggregates only
+ *  - zoom and pan (ytGraphZoom.h): min/max per pixel column of any sample range comes
+ *    from a segment tree, the raw samples are never scanned
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphTiers.h"
+#include "ytGraphZoom.h"
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+TFT_eSprite Graph = TFT_eSprite(&TFT);
+TFT_eSprite xAxis = TFT_eSprite(&TFT);
+ytGraphCanvas GraphCanvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y);
+ytGraphCanvas xAxisCanvas(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+
+ytGraphTiers<4, SAMPLE_COUNT + 1, SAMPLE_COUNT + 1, SAMPLE_COUNT + 1> History; // seconds, minutes and hours of all channels
+ytGraphZoomTree<4, 1024> ZoomHistory;                                          // 24 kB, min/max of any sample range
+
+ytGraphChannel Channels[4] = {{TFT_CYAN, 0, 0}, {TFT_PINK, 0, 0}, {TFT_YELLOW, 0, 0}, {TFT_MAGENTA, 0, 0}};
+int16_t LastXGridLinePos = 0;
+
+void printDemoInfoText(const char *string)
+{
+  TFT.fillRect(0, X_AXIS_UPPER_Y + X_AXIS_HEIGTH + 2, TFT.width(), TFT.height() - X_AXIS_UPPER_Y, GRAPH_BGRND_COLOR); // clear text area
+  TFT.setTextSize(1);
+  TFT.setTextColor(TFT_GREEN);
+  TFT.setTextDatum(MC_DATUM);
+  TFT.drawString(string, (int)TFT.width() / 2, (int)TFT.height() - 35, 2);
+}
+
+void drawTierViews()
+{
+  const char *text[3] = {"history tiers - seconds", "history tiers - minutes", "history tiers - hours"};
+  for (uint8_t tier = TIER_SECONDS; tier <= TIER_HOURS; tier++)
+  {
+    printDemoInfoText(text[tier]);
+    ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos, History.timeFormat(tier)); // axis in s/m/h
+    ytGraphDrawTier(GraphCanvas, History, tier, Channels, 4); // mean with min/max, no raw data needed
+    delay(3000);
+  }
+}
+
+void drawZoomViews()
+{
+  // the whole history, then zoomed in on its newest part and panned back to the oldest one
+  uint32_t count = ZoomHistory.size();
+  printDemoInfoText("zoom - whole history");
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos);
+  ytGraphDrawZoom(GraphCanvas, ytGraphLayoutDefault, ZoomHistory, ZoomHistory.oldest(), count, Channels, 4);
+  delay(2000);
+
+  printDemoInfoText("zoom - in and pan");
+  for (count /= 2; count >= SAMPLE_COUNT; count /= 2) // zoom in on the newest samples
+  {
+    ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos);
+    ytGraphDrawZoom(GraphCanvas, ytGraphLayoutDefault, ZoomHistory, ZoomHistory.next() - count, count, Channels, 4);
+    delay(500);
+  }
+  count *= 2; // the last zoom level
+  for (uint32_t first = ZoomHistory.next(); first >= ZoomHistory.oldest() + count; first -= count) // pan to the oldest
+  {
+    ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos);
+    ytGraphDrawZoom(GraphCanvas, ytGraphLayoutDefault, ZoomHistory, first - count, count, Channels, 4);
+    delay(50);
+  }
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR);
+  ytGraphDrawYaxisFrame(TFT);
+
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  GraphCanvas.begin();
+  xAxisCanvas.begin();
+
+  // simulate one day of 1 Hz data, the tiers keep only the aggregates
+  printDemoInfoText("simulating one day of samples");
+  for (uint32_t t = 0; t < 24UL * 3600; t++)
+  {
+    int16_t values[4] = {(int16_t)(15 + 5 * sin(t / 3000.0)), (int16_t)(35 + random(0, 5)),
+                         (int16_t)(50 + 5 * sin(t / 500.0)), (int16_t)(t % 3600 < 60 ? 30 : 5)};
+    History.add(values);
+  }
+
+  // and a shorter, faster signal for the zoom tree, push() is O(log n)
+  for (uint32_t t = 0; t < ZoomHistory.capacity(); t++)
+  {
+    int16_t values[4] = {(int16_t)(15 + 5 * sin(t / 100.0)), (int16_t)(35 + random(0, 5)),
+                         (int16_t)(50 + 5 * sin(t / 20.0)), (int16_t)(t % 200 < 4 ? 30 : 5)};
+    ZoomHistory.push(values);
+  }
+}
+
+void loop()
+{
+  drawTierViews();
+  drawZoomViews();
+}
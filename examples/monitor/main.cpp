@@ -0,0 +1,216 @@
+/***************************************************************************************
+ * ytGraph example: a scrolling monitor with statistics, alarms and recording
+ * Platform: Arduino / ESP
+ *
+ *  - min..max and mean of the visible samples right of the frame (ytGraphSummary.h)
+ *  - temperature3 above 55 for 3 samples is drawn as a band behind the graph (ytGraphAlarm.h)
+ *  - 'x' on the serial port starts a frame stream of the graph (ytGraphExport.h),
+ *    the bench turns it into PPM files (-x), from then on nothing else is written to the port
+ *  - build flag YTGRAPH_STATS: the stage latencies in the upper left corner,
+ *    'd' on the serial port sends them binary (ytGraphStats.h)
+ *  - every sprite and buffer comes from one arena (ytGraphArena.h) taken at startup
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphChannels.h"
+#include "ytGraphSummary.h"
+#include "ytGraphAlarm.h"
+#include "ytGraphExport.h"
+#include "ytGraphArena.h"
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+ytGraphArena Arena;                        // every sprite and graph buffer, taken from the heap once in setup()
+ytGraphSprite Graph = ytGraphSprite(&TFT); // canvas of graph, static & dynamic (grid and lines)
+ytGraphSprite xAxis = ytGraphSprite(&TFT); // canvas of scrolling x axis
+
+ytGraphCanvas GraphCanvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y); // dirty tracking, pushes only what has changed
+ytGraphCanvas xAxisCanvas(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+
+unsigned long previousMillis = 0; // non blocking delay
+ytGraphChannelStore<4, SAMPLE_COUNT + 1> SensorBuffer; // y values per channel, n+1 = because 1st data point starts at x=0 !
+ytGraphSummary Summary;                                // min, max, mean and spread of the visible samples, see setup()
+ytGraphAlarms Alarms;                                  // over-limit intervals, e.g. temperature3 above 55, see setup()
+ytGraphFrameExport Export;                             // 'x' on the serial port records the scrolling graph, see exportFrame()
+
+ytGraphChannel Channels[4] = { // line color and last drawn point of each channel,
+    {TFT_CYAN, 0, 0},          // ytGraph() keeps ox/oy up to date
+    {TFT_PINK, 0, 0},
+    {TFT_YELLOW, 0, 0},
+    {TFT_MAGENTA, 0, 0}};
+int16_t LastXGridLinePos = 0; // for dynamic scrolling - to add new gridline at proper place
+
+uint32_t arenaBytes() // the sprites, their dirty tracking and the buffers of summary, alarms and export
+{
+  return ytGraphArena::align(ytGraphSprite::bytes(SPRITE_WIDTH, SPRITE_HEIGTH, 4)) +
+         ytGraphArena::align(ytGraphSprite::bytes(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH, 1)) +
+         ytGraphCanvas::bytes(SPRITE_WIDTH) + ytGraphCanvas::bytes(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN) +
+         ytGraphSummary::bytes(SAMPLE_COUNT + 1, 4) + ytGraphAlarms::bytes(32) +
+         ytGraphFrameExport::bytes(SPRITE_WIDTH, SPRITE_HEIGTH);
+}
+
+void printFreeHeap() // for debugging issues
+{
+  if (Export.active())
+    return; // text would corrupt the frame stream
+  Serial.printf("Size:%.2fkB Free:%.2fkB Min:%.2fkB Max:%.2fkB\n",
+                ESP.getHeapSize() / 1024.0, ESP.getFreeHeap() / 1024.0,
+                ESP.getMinFreeHeap() / 1024.0, ESP.getMaxAllocHeap() / 1024.0);
+  ytGraphArenaStats s = Arena.stats();
+  Serial.printf("Arena:%.2fkB Used:%.2fkB HighWater:%.2fkB Failures:%u (last %u bytes)\n",
+                s.size / 1024.0, s.used / 1024.0, s.highWater / 1024.0, s.failures, s.lastFailed);
+}
+
+void printStats() // the stage latencies in the upper left corner, 'd' on the serial port sends them binary
+{
+#ifdef YTGRAPH_STATS
+  ytGraphStats::overlay(TFT, 0, 0, TFT_WHITE, GRAPH_BGRND_COLOR);
+  if (!Export.active() && Serial.available() && Serial.read() == 'd') // the port belongs to the frame stream
+    ytGraphStats::dump(Serial);
+#endif
+}
+
+void exportFrame() // 'x' on the serial port starts a frame stream of the graph, the bench turns it into PPM files (-x)
+{
+  if (!Export.active() && Serial.available() && Serial.peek() == 'x') // a second 'x' would send a second header
+  {
+    Serial.read();
+    Export.begin(Serial, GraphCanvas, &Arena); // from now on the port carries the binary stream
+  }
+  Export.frame(GraphCanvas, -round(GRAPH_WIDTH / SAMPLE_COUNT), millis()); // the scroll of drawDynamicGraph()
+}
+
+void pushSample(const int16_t *values) // the plain buffer, the statistics and the alarm rules
+{
+  SensorBuffer.push(values);
+  Summary.add(values);  // O(1)
+  Alarms.add(values);   // O(rules)
+}
+
+void simulateHistBufferWrite()
+{
+  static int graphVal = 0;
+  static int delta = 1;
+  for (uint16_t i = 0; i <= SAMPLE_COUNT; i++)
+  {
+    // write new data at the right end of the ring, the oldest sample drops out (O(1))
+    int16_t values[4] = {(int16_t)random(0, 20), (int16_t)random(20, 40), (int16_t)random(40, 60), (int16_t)graphVal};
+    pushSample(values);
+
+    // sabre tooth function
+    graphVal += delta;
+    if (graphVal >= GRAPH_HEIGHT)
+      delta = -1; // ramp down value
+    else if (graphVal <= 1)
+      delta = +1; // ramp up value
+  }
+}
+
+void drawStaticGraphBuffer()
+{
+  uint32_t n = Alarms.samples(), first = n > SAMPLE_COUNT + 1 ? n - (SAMPLE_COUNT + 1) : 0; // the same page as below
+  ytGraphDrawAlarms(GraphCanvas, ytGraphLayoutDefault, Alarms, first, SAMPLE_COUNT + 1); // the alarm bands, behind the grid
+  ytGraphDrawChannels(GraphCanvas, SensorBuffer, Channels); // column by column, the sprite is pushed once at the end
+  ytGraphDrawSummaryMarks(TFT, ytGraphLayoutDefault, Summary, Channels);
+}
+
+void drawDynamicGraph()
+{
+  YTGRAPH_STAGE(STATS_FRAME); // scroll, grid, lines and push of one sample (build flag YTGRAPH_STATS)
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT); // scroll one sample to the left
+
+  for (uint8_t c = 0; c < 4; c++)
+    Channels[c].ox -= scrollX; // correction of the last point in graph after scrolling to the left
+
+  GraphCanvas.scroll(-scrollX);
+  xAxisCanvas.scroll(-scrollX);
+
+  // add the latest sensor reading to the end of the buffer, the oldest one drops out
+  int16_t values[4] = {(int16_t)random(15, 25), (int16_t)random(30, 45), (int16_t)random(50, 60), (int16_t)random(0, 10)};
+  pushSample(values);
+
+  ytGraphDrawAlarmStep(GraphCanvas, ytGraphLayoutDefault, Alarms); // the bands of the new columns, behind the grid
+  ytGraphDrawDynamicGrid(GraphCanvas, xAxisCanvas, Channels[3].ox, LastXGridLinePos);
+
+  for (uint8_t c = 0; c < 4; c++)
+    ytGraph(GraphCanvas, SAMPLE_COUNT, SensorBuffer.newest(c), Channels[c]);
+
+  xAxisCanvas.push(); // no Background color, only the changed regions
+  GraphCanvas.push();
+  ytGraphDrawSummaryMarks(TFT, ytGraphLayoutDefault, Summary, Channels); // min..max and mean right of the frame
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+#ifdef YTGRAPH_STATS
+  ytGraphStats::setFrameBudget(1000000 / 60); // a frame longer than 60 fps counts as dropped
+#endif
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR);
+
+  // one block for every sprite and graph buffer, a budget failure shows up here and not as a null sprite later
+  if (!Arena.begin(arenaBytes()))
+    printFreeHeap();
+  Graph.setArena(&Arena);
+  xAxis.setArena(&Arena);
+  GraphCanvas.setArena(&Arena);
+  xAxisCanvas.setArena(&Arena);
+  Summary.begin(SAMPLE_COUNT + 1, 4, &Arena); // statistics of the samples on the screen
+  Alarms.begin(32, &Arena);                   // the last 32 alarm intervals
+  Alarms.addRule({2, ALARM_ABOVE, ALARM_BAND, 55, 2, 3, TFT_MAROON}); // temperature3 > 55 for 3 samples, ends at 53
+
+  // prepare sprites for graph
+  Graph.setColorDepth(4);                          // max 16 graph lines with different colors
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH); // height = width at M5Stack (landscape mode!)
+  xAxis.setColorDepth(1);                          // save some kBytes, only 2 axis text colors available...
+  xAxis.createSprite(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH);
+  GraphCanvas.beginRing();                         // scrolling moves only the ring head, no pixels
+  xAxisCanvas.beginRing(CANVAS_LABEL_OVERRUN);     // labels may run over the right border
+
+  ytGraphDrawYaxisFrame(TFT);                                       // draw the y axis and the frame once
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos); // draw the grid
+  simulateHistBufferWrite();                                        // one page of demo data
+  drawStaticGraphBuffer();                                          // draw the stored data into the graph once
+}
+
+void loop()
+{
+  unsigned long currentMillis = millis();
+  if (currentMillis - previousMillis >= 1000) // non blocking delay
+  {
+    previousMillis = currentMillis;
+    drawDynamicGraph();
+    exportFrame();
+    printStats();
+  }
+}
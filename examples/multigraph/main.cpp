@@ -0,0 +1,112 @@
+/***************************************************************************************
+ * ytGraph example: four independent graphs on one screen
+ * Platform: Arduino / ESP
+ *
+ *  - every graph (ytGraphInstance.h) has its own size, sample count, time base and rate,
+ *    the lower left one scales its y axis to the samples (ytGraphAutoscale.h)
+ *  - ytGraphScheduler samples every due graph and pushes all changes in one SPI transaction
+ *  - sprites and buffers of all graphs come from one arena (ytGraphArena.h) taken at startup
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphInstance.h"
+#include "ytGraphArena.h"
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+ytGraphArena Arena; // every sprite and graph buffer, taken from the heap once in setup()
+ytGraphScheduler Scheduler(TFT);
+ytGraphInstance *Graphs[4];
+
+void printArena() // a budget failure shows up here and not as a null sprite later
+{
+  ytGraphArenaStats s = Arena.stats();
+  Serial.printf("Arena:%.2fkB Used:%.2fkB HighWater:%.2fkB Failures:%u (last %u bytes)\n",
+                s.size / 1024.0, s.used / 1024.0, s.highWater / 1024.0, s.failures, s.lastFailed);
+}
+
+bool randomSource(ytGraphInstance &g, int16_t *y, void *) // simulated sensors of the small graphs
+{
+  for (uint8_t c = 0; c < g.channels(); c++)
+    y[c] = random(10 + 15 * c, 25 + 15 * c);
+  return true;
+}
+
+ytGraphConfig multiGraphConfig(uint8_t i) // 2 x 2 graphs, the x axes are 50 px wider than the graphs
+{
+  static const uint16_t samples[4] = {25, 20, 50, 10}, xDiv[4] = {5, 5, 10, 2};
+  ytGraphConfig cfg = ytGraphConfigDefault;
+  cfg.left = i & 1 ? 200 : 30;
+  cfg.bottom = i & 2 ? 200 : 90;
+  cfg.width = 100;
+  cfg.height = 60;
+  cfg.samples = samples[i];
+  cfg.xDiv = xDiv[i];
+  cfg.yDiv = 20;
+  cfg.timeFormat = "SSMH"[i];
+  cfg.xLabel = "";
+  cfg.yLabel = "";
+  return cfg;
+}
+
+uint8_t multiGraphScale(uint8_t i) // lower left: y axis follows the samples
+{
+  return i == 2 ? GRAPH_SCALE_AUTO : GRAPH_SCALE_FIXED;
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR);
+
+  static const uint32_t interval[4] = {250, 500, 1000, 2000}; // ms
+  static const uint16_t colors[2] = {TFT_CYAN, TFT_YELLOW};
+  uint32_t bytes = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    bytes += ytGraphInstance::arenaBytes(ytGraphLayout(multiGraphConfig(i)), 2, multiGraphScale(i));
+  if (!Arena.begin(bytes))
+    printArena();
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    Graphs[i] = new ytGraphInstance(TFT, multiGraphConfig(i));
+    Graphs[i]->setArena(&Arena);
+    if (!Graphs[i]->begin(colors, 2, multiGraphScale(i)))
+      printArena(); // the arena is too small, nothing of this graph was allocated
+    Scheduler.add(*Graphs[i], interval[i], randomSource);
+  }
+}
+
+void loop()
+{
+  Scheduler.run(millis()); // one frame updates all due graphs and pushes them together
+}
@@ -0,0 +1,148 @@
+/***************************************************************************************
+ * ytGraph example: a scrolling graph whose history survives a reboot
+ * Platform: Arduino / ESP
+ *
+ *  - every sample goes into a compressed history in RAM (ytGraphGorilla.h) and into
+ *    an append-only log in flash (ytGraphLog.h), one flash write per 32 samples
+ *  - on boot the newest screens are restored from the log, the first boot simulates them
+ *  - the static page is drawn from the compressed history, decoded on the fly
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphGorilla.h"
+#include "ytGraphLog.h"
+#include <SPIFFS.h>
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+TFT_eSprite Graph = TFT_eSprite(&TFT);
+TFT_eSprite xAxis = TFT_eSprite(&TFT);
+ytGraphCanvas GraphCanvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y);
+ytGraphCanvas xAxisCanvas(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+
+struct sensors
+{
+  float temperature1;
+  float temperature2;
+  float temperature3;
+  int8_t humidity;
+};
+ytGraphGorillaHistory<4, 512, 8> CompressedHistory; // 4 kB, ~1200 samples of slow sensor data instead of ~200
+uint32_t SampleTime = 0;                            // timestamp of the samples in CompressedHistory
+ytGraphFSFile LogFile(SPIFFS, "/ytg");              // segment files /ytg00.log ... /ytg07.log
+ytGraphLog<sensors, 32> SampleLog(LogFile);         // survives a reboot, one flash write per 32 samples
+#define RESTORE_SCREENS 4                           // screens of history restored on boot
+
+ytGraphChannel Channels[4] = {{TFT_CYAN, 0, 0}, {TFT_PINK, 0, 0}, {TFT_YELLOW, 0, 0}, {TFT_MAGENTA, 0, 0}};
+int16_t LastXGridLinePos = 0;
+unsigned long previousMillis = 0;
+
+void compressSample(const sensors &s) // appends one sample to the compressed history
+{
+  float v[4] = {s.temperature1, s.temperature2, s.temperature3, (float)s.humidity};
+  CompressedHistory.append(SampleTime, v);
+  SampleTime += SAMPLE_RATE;
+}
+
+void simulateHistory() // first boot: one screen of demo data
+{
+  for (uint16_t i = 0; i <= SAMPLE_COUNT; i++)
+  {
+    sensors sample;
+    sample.temperature1 = random(0, 200) / 10.0;
+    sample.temperature2 = random(200, 400) / 10.0;
+    sample.temperature3 = random(400, 600) / 10.0;
+    sample.humidity = i % GRAPH_HEIGHT;
+    compressSample(sample);
+    SampleLog.append(sample);
+  }
+}
+
+void drawDynamicGraph()
+{
+  int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT); // scroll one sample to the left
+  for (uint8_t c = 0; c < 4; c++)
+    Channels[c].ox -= scrollX;
+  GraphCanvas.scroll(-scrollX);
+  xAxisCanvas.scroll(-scrollX);
+  ytGraphDrawDynamicGrid(GraphCanvas, xAxisCanvas, Channels[3].ox, LastXGridLinePos);
+
+  sensors reading;
+  reading.temperature1 = lround(random(15, 25));
+  reading.temperature2 = lround(random(30, 45));
+  reading.temperature3 = lround(random(50, 60));
+  reading.humidity = random(0, 10);
+  compressSample(reading);
+  SampleLog.append(reading); // written to the flash when the batch is full
+
+  ytGraph(GraphCanvas, SAMPLE_COUNT, lround(reading.temperature1), Channels[0]);
+  ytGraph(GraphCanvas, SAMPLE_COUNT, lround(reading.temperature2), Channels[1]);
+  ytGraph(GraphCanvas, SAMPLE_COUNT, lround(reading.temperature3), Channels[2]);
+  ytGraph(GraphCanvas, SAMPLE_COUNT, reading.humidity, Channels[3]);
+  xAxisCanvas.push();
+  GraphCanvas.push();
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR);
+  ytGraphDrawYaxisFrame(TFT);
+
+  Graph.setColorDepth(4);
+  Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH);
+  xAxis.setColorDepth(1);
+  xAxis.createSprite(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH);
+  GraphCanvas.beginRing();
+  xAxisCanvas.beginRing(CANVAS_LABEL_OVERRUN);
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos);
+
+  SPIFFS.begin(true); // formats the partition on the first boot
+  SampleLog.begin();   // finds the newest segment of the last run
+  if (SampleLog.restore(RESTORE_SCREENS * (SAMPLE_COUNT + 1), compressSample) == 0) // the history of the last run
+    simulateHistory();
+
+  // every channel is drawn as one polyline, decoded from the compressed history on the fly
+  ytGraphDrawGorilla(GraphCanvas, CompressedHistory, Channels, 4, [](const float *v, uint8_t c)
+                     { return (int16_t)lround(v[c]); });
+}
+
+void loop()
+{
+  unsigned long currentMillis = millis();
+  if (currentMillis - previousMillis >= 1000) // non blocking delay
+  {
+    previousMillis = currentMillis;
+    drawDynamicGraph();
+  }
+}
@@ -0,0 +1,78 @@
+/***************************************************************************************
+ * ytGraph example: sampling, drawing and sending in parallel
+ * Platform: Arduino / ESP32
+ *
+ *  - a sampling task on core 0 reads the sensors at 10 Hz (ytGraphPipeline.h)
+ *  - loop() on core 1 draws the samples into one of two graph buffers
+ *  - a transfer task on core 0 sends the other buffer to the panel
+ *  - while a frame is sent, the new samples go into the next one (coalesced)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include <Arduino.h>
+#include "ytGraph.h"
+#include "ytGraphPipeline.h"
+
+#ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
+#include <M5Stack.h>  // compiles with the M5Stack variant of TFT_eSPI () library
+#else                 //
+#include <TFT_eSPI.h> // and the original library as well
+#endif
+
+#ifdef useM5STACK
+M5Display &TFT = M5.Lcd;
+#else
+TFT_eSPI TFT = TFT_eSPI();
+#endif
+
+ytGraphPipeline Pipeline(TFT);
+unsigned long previousMillis = 0;
+
+bool pipelineSource(int16_t *y, void *) // simulated sensors, runs in the sampling task
+{
+  y[0] = random(15, 25);
+  y[1] = random(30, 45);
+  y[2] = random(50, 60);
+  y[3] = random(0, 10);
+  return true;
+}
+
+void setup()
+{
+#ifdef useM5STACK // only if using M5Stack
+  M5.begin();
+  M5.Power.begin();
+#endif
+
+  Serial.begin(115200);
+
+  TFT.begin();
+  TFT.setRotation(1); // landscape mode for M5Stack
+  TFT.fillScreen(GRAPH_BGRND_COLOR); // before begin(), the panel belongs to the transfer task then
+
+  static const uint16_t colors[4] = {TFT_CYAN, TFT_PINK, TFT_YELLOW, TFT_MAGENTA};
+  if (!Pipeline.begin(colors, 4, pipelineSource, 100)) // a sample every 100 ms
+    Serial.println("pipeline: no memory for the graph buffers");
+}
+
+void loop()
+{
+  Pipeline.render(50); // waits up to 50 ms for new samples, draws them and hands the frame over
+
+  unsigned long currentMillis = millis();
+  if (currentMillis - previousMillis >= 10000) // non blocking delay
+  {
+    previousMillis = currentMillis;
+    Serial.printf("pipeline: %u samples, %u frames, %u coalesced, %u dropped\n",
+                  Pipeline.sampled(), Pipeline.frames(), Pipeline.coalesced(), Pipeline.dropped());
+  }
+}
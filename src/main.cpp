@@ -1,23 +1,26 @@
 #define __FILENAME__ (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__)
 
 /***************************************************************************************
- * A small demo for the ytGraph function set 
- * Platform: Arduino / ESP 
- * 
+ * A small demo for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
  * Armin Pressler 2021
  * https://github.com/ArminPP/ytGraph
- * 
- * 
- * 
+ *
+ *
+ *
  * MIT License
- * 
+ *
  * Changelog:
  * v0.5   initial version (28-Feb-2021)
+ * v0.6   ring buffer, canvas and series API, the other features have their own sketches in examples/
 ****************************************************************************************/
 
 #include <version.h>
 #include <Arduino.h>
 #include "ytGraph.h"
+#include "ytGraphRing.h"
+#include "ytGraphCanvas.h"
 #include "ytG_logo.h"
 
 #ifdef useM5STACK     // define 'useM5STACK' is located in ytGraph.h
@@ -35,6 +38,10 @@ TFT_eSPI TFT = TFT_eSPI();
 TFT_eSprite Graph = TFT_eSprite(&TFT); // canvas of graph, static & dynamic (grid and lines)
 TFT_eSprite xAxis = TFT_eSprite(&TFT); // canvas of scrolling x axis
 
+ytGraphCanvas GraphCanvas(Graph, SPRITE_LEFT_X, SPRITE_UPPER_Y); // dirty tracking, pushes only what has changed
+ytGraphCanvas xAxisCanvas(xAxis, X_AXIS_LEFT_X, X_AXIS_UPPER_Y);
+ytGraphHwScroll HwScroll{}; // optional hardware scroll of the panel, see setup()
+
 unsigned long previousMillis = 0; // non blocking delay
 struct sensors
 {
@@ -43,16 +50,13 @@ struct sensors
   float temperature3;
   int8_t humidity;
 };
-sensors SensorBuffer[SAMPLE_COUNT + 1] = {0}; // n+1 = because 1st data point starts at x=0 !
-
-int16_t oy1 = 0; // static, local or global var to store the last y position in graph
-int16_t oy2 = 0; // is need after each drawing of the historical buffer!
-int16_t oy3 = 0;
-int16_t oy4 = 0;
-int16_t ox1 = 0; // for each new drwaing of historical data, x axis starts at zero
-int16_t ox2 = 0;
-int16_t ox3 = 0;
-int16_t ox4 = 0;
+ytGraphRing<sensors, SAMPLE_COUNT + 1> SensorBuffer; // n+1 = because 1st data point starts at x=0 !
+
+ytGraphChannel Channels[4] = { // line color and last drawn point of each channel,
+    {TFT_CYAN, 0, 0},          // ytGraph() keeps ox/oy up to date
+    {TFT_PINK, 0, 0},
+    {TFT_YELLOW, 0, 0},
+    {TFT_MAGENTA, 0, 0}};
 int16_t LastXGridLinePos = 0; // for dynamic scrolling - to add new gridline at proper place
 
 char *getAllFreeHeap()
@@ -87,79 +91,70 @@ void printDemoInfoText(const char *string)
   TFT.drawString(string, (int)TFT.width() / 2, (int)TFT.height() - 35 + 1, 2);
 }
 
-void drawStaticGraphBuffer()
+int16_t sensorValue(const sensors &s, uint8_t channel) // y value of one channel
 {
-  // starting old value on y axis is 1st value from SensorBuffer (for optical reasons)
-  oy1 = abs(lround((GRAPH_HEIGHT * SensorBuffer[0].temperature1) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)) - GRAPH_HEIGHT);
-  oy2 = abs(lround((GRAPH_HEIGHT * SensorBuffer[0].temperature2) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)) - GRAPH_HEIGHT);
-  oy3 = abs(lround((GRAPH_HEIGHT * SensorBuffer[0].temperature3) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)) - GRAPH_HEIGHT);
-  oy4 = abs(lround((GRAPH_HEIGHT * SensorBuffer[0].humidity) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)) - GRAPH_HEIGHT);
-
-  ox1 = 0; // for each new drwaing of historical data, x axis starts at zero!
-  ox2 = 0;
-  ox3 = 0;
-  ox4 = 0;
-  for (int8_t i = 0; i <= SAMPLE_COUNT; i++) // SAMPLE_COUNT = +1
+  switch (channel)
   {
-    ytGraph(Graph, i, lround(SensorBuffer[i].temperature1), TFT_CYAN, ox1, oy1);
-    ytGraph(Graph, i, lround(SensorBuffer[i].temperature2), TFT_PINK, ox2, oy2);
-    ytGraph(Graph, i, lround(SensorBuffer[i].temperature3), TFT_YELLOW, ox3, oy3);
-    ytGraph(Graph, i, SensorBuffer[i].humidity, TFT_MAGENTA, ox4, oy4);
-
-    Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // left upper position
+  case 0:
+    return lround(s.temperature1);
+  case 1:
+    return lround(s.temperature2);
+  case 2:
+    return lround(s.temperature3);
+  default:
+    return s.humidity;
   }
 }
 
+void drawStaticGraphBuffer()
+{
+  // every channel is drawn as one polyline from the ring (x axis starts at zero),
+  // and the sprite is pushed only once at the end
+  ytGraphDrawHistory(GraphCanvas, SensorBuffer, Channels, 4, sensorValue);
+}
+
 void drawDynamicGraph()
 {
   int16_t scrollX = round(GRAPH_WIDTH / SAMPLE_COUNT); // scroll one sample to the left
 
-  ox1 -= scrollX; // correction of the last point in graph after scrolling to the left
-  ox2 -= scrollX;
-  ox3 -= scrollX;
-  ox4 -= scrollX;
+  for (uint8_t c = 0; c < 4; c++)
+    Channels[c].ox -= scrollX; // correction of the last point in graph after scrolling to the left
 
-  Graph.scroll(-scrollX);
-  xAxis.scroll(-scrollX);
+  GraphCanvas.scroll(-scrollX);
+  xAxisCanvas.scroll(-scrollX);
+  if (HwScroll.tft)
+    ytGraphHwScrollBy(HwScroll, -scrollX); // the panel moves the old picture itself
 
-  ytGraphDrawDynamicGrid(Graph, xAxis, ox4, LastXGridLinePos);
+  ytGraphDrawDynamicGrid(GraphCanvas, xAxisCanvas, Channels[3].ox, LastXGridLinePos);
 
-  // add to the the end of the buffer the latest sensor reading
-  SensorBuffer[SAMPLE_COUNT].temperature1 = lround(random(15, 25));
-  SensorBuffer[SAMPLE_COUNT].temperature2 = lround(random(30, 45));
-  SensorBuffer[SAMPLE_COUNT].temperature3 = lround(random(50, 60));
-  SensorBuffer[SAMPLE_COUNT].humidity = random(0, 10);
+  // add the latest sensor reading to the end of the buffer, the oldest one drops out (O(1))
+  sensors reading;
+  reading.temperature1 = lround(random(15, 25));
+  reading.temperature2 = lround(random(30, 45));
+  reading.temperature3 = lround(random(50, 60));
+  reading.humidity = random(0, 10);
+  SensorBuffer.push(reading);
 
-  ytGraph(Graph, SAMPLE_COUNT, SensorBuffer[SAMPLE_COUNT].temperature1, TFT_CYAN, ox1, oy1);
-  ytGraph(Graph, SAMPLE_COUNT, SensorBuffer[SAMPLE_COUNT].temperature2, TFT_PINK, ox2, oy2);
-  ytGraph(Graph, SAMPLE_COUNT, SensorBuffer[SAMPLE_COUNT].temperature3, TFT_YELLOW, ox3, oy3);
-  ytGraph(Graph, SAMPLE_COUNT, SensorBuffer[SAMPLE_COUNT].humidity, TFT_MAGENTA, ox4, oy4);
+  for (uint8_t c = 0; c < 4; c++)
+    ytGraph(GraphCanvas, SAMPLE_COUNT, sensorValue(SensorBuffer.newest(), c), Channels[c]);
 
-  xAxis.pushSprite(X_AXIS_LEFT_X, X_AXIS_UPPER_Y); // no Background color
-  Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // left upper position
-}
-
-void shiftBufferLeft()
-{
-  for (int8_t i = 1; i <= SAMPLE_COUNT; i++)
-  {
-    SensorBuffer[i - 1] = SensorBuffer[i];
-  }
+  xAxisCanvas.push(); // no Background color, only the changed regions
+  GraphCanvas.push();
 }
 
 void simulateHistBufferWrite()
 {
   static int graphVal = 0;
   static int delta = 1;
-  for (uint8_t i = 0; i <= SAMPLE_COUNT; i++)
+  for (uint16_t i = 0; i <= SAMPLE_COUNT; i++)
   {
-    shiftBufferLeft(); // shift the whole array one position to the left
-
-    // write new data at the right end of the array
-    SensorBuffer[SAMPLE_COUNT].humidity = graphVal; // triangle demo data
-    SensorBuffer[SAMPLE_COUNT].temperature1 = random(0, 200) / 10.0;
-    SensorBuffer[SAMPLE_COUNT].temperature2 = random(200, 400) / 10.0;
-    SensorBuffer[SAMPLE_COUNT].temperature3 = random(400, 600) / 10.0;
+    // write new data at the right end of the ring, the oldest sample drops out (O(1))
+    sensors sample;
+    sample.humidity = graphVal; // triangle demo data
+    sample.temperature1 = random(0, 200) / 10.0;
+    sample.temperature2 = random(200, 400) / 10.0;
+    sample.temperature3 = random(400, 600) / 10.0;
+    SensorBuffer.push(sample);
 
     // sabre tooth function
     graphVal += delta;
@@ -172,30 +167,26 @@ void simulateHistBufferWrite()
 
 void drawUnbuffered()
 {
-  ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos); // refresh the grid
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos); // refresh the grid
 
   // if using this function only, there is no need
-  // to make the oy/ox variables global or static!
-  oy1 = 0; // for each new drawing of unbuffered data, y axis starts at zero!
-  oy2 = 0;
-  oy3 = 0;
-  oy4 = 0;
-
-  ox1 = 0; // for each new drawing of unbuffered data, x axis starts at zero!
-  ox2 = 0;
-  ox3 = 0;
-  ox4 = 0;
+  // to make the channels global or static!
+  for (uint8_t c = 0; c < 4; c++)
+  {
+    Channels[c].ox = 0; // for each new drawing of unbuffered data, x axis starts at zero!
+    Channels[c].oy = 0; // and y axis starts at zero
+  }
 
   // draw one full diagramm page for demo purposes
   // for endless drawing, repeat the whole function
   for (int8_t i = 0; i <= SAMPLE_COUNT; i++) // SAMPLE_COUNT = +1
   {
-    ytGraph(Graph, i, lround(random(0, 200) / 10.0), TFT_CYAN, ox1, oy1);
-    ytGraph(Graph, i, lround(random(200, 400) / 10.0), TFT_PINK, ox2, oy2);
-    ytGraph(Graph, i, lround(random(400, 600) / 10.0), TFT_YELLOW, ox3, oy3);
-    ytGraph(Graph, i, lround(random(100, 300) / 10.0), TFT_MAGENTA, ox4, oy4);
+    ytGraph(GraphCanvas, i, lround(random(0, 200) / 10.0), Channels[0]);
+    ytGraph(GraphCanvas, i, lround(random(200, 400) / 10.0), Channels[1]);
+    ytGraph(GraphCanvas, i, lround(random(400, 600) / 10.0), Channels[2]);
+    ytGraph(GraphCanvas, i, lround(random(100, 300) / 10.0), Channels[3]);
     delay(200);                                      // only to slow down drawing a little bit
-    Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // draw flicker free
+    GraphCanvas.push();                              // draw flicker free, only the new line segments
   }
 }
 
@@ -242,7 +233,15 @@ void setup()
   Graph.setColorDepth(4);                          // max 16 graph lines with different colors
   Graph.createSprite(SPRITE_WIDTH, SPRITE_HEIGTH); // height = width at M5Stack (landscape mode!)
   xAxis.setColorDepth(1);                          // save some kBytes, only 2 axis text colors available...
-  xAxis.createSprite(X_AXIS_WIDTH, X_AXIS_HEIGTH);
+  xAxis.createSprite(X_AXIS_WIDTH + CANVAS_LABEL_OVERRUN, X_AXIS_HEIGTH);
+  GraphCanvas.beginRing();                         // scrolling moves only the ring head, no pixels
+  xAxisCanvas.beginRing(CANVAS_LABEL_OVERRUN);     // labels may run over the right border
+
+  // optional: the panel scrolls the graph itself, only the new strip is sent over SPI
+  // NOTE: this moves everything inside the screen columns of the graph (e.g. the info text)
+  // ytGraphHwScrollBegin(HwScroll, TFT, SPRITE_LEFT_X, SPRITE_WIDTH, TFT.width());
+  // GraphCanvas.setHwScroll(&HwScroll);
+  // xAxisCanvas.setHwScroll(&HwScroll);
 
   // draw demo with 4 channels and no buffer, e.g. could be used for life data
   // no scrolling - graph must be redrawed at the end of the last data point
@@ -250,7 +249,7 @@ void setup()
   printDemoInfoText("draw 4 channels - no scrolling");
   delay(2000);
   ytGraphDrawYaxisFrame(TFT);                           // draw the y axis and the frame once
-  ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos); // draw the grid
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos); // draw the grid
   drawUnbuffered();                                     // draw the lines of 4 channels
   printDemoInfoText("draw it one more time ;-)");            //
   delay(500);                                           //
@@ -263,11 +262,11 @@ void setup()
   printDemoInfoText("4 channels historical - no scrolling");
   delay(2000);
   ytGraphDrawYaxisFrame(TFT);                           // draw the y axis and the frame once
-  ytGraphDrawGridXaxis(Graph, xAxis, LastXGridLinePos); // draw the grid
+  ytGraphDrawGridXaxis(GraphCanvas, xAxisCanvas, LastXGridLinePos); // draw the grid
 
-  memset(SensorBuffer, 0.0, sizeof(SensorBuffer)); // clear buffer array
-  simulateHistBufferWrite();                       // prepare the historic demo data
-  drawStaticGraphBuffer();                         // draw the stored data into the graph once
+  SensorBuffer.clear();      // clear buffer array
+  simulateHistBufferWrite(); // prepare the historic demo data
+  drawStaticGraphBuffer();   // draw the stored data into the graph once
 
   printDemoInfoText("4 channels infinite - scrolling flicker free");
   delay(2000);
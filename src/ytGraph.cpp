@@ -22,9 +22,20 @@
 
 #include "ytGraph.h"
 
-char *calcTime(int32_t t); // internal helper to calculate the relative time on x-axis
+static ytGraphTimeline timelineDefault = ytGraphTimelineInit(ytGraphLayoutDefault); // the timeline of the #define functions
 
-void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t &LastXGridLinePos)
+ytGraphTimeline ytGraphTimelineInit(const ytGraphLayout &cfg)
+{
+  return ytGraphTimeline{(uint32_t)cfg.xMax(), 0, false};
+}
+
+void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t &LastXGridLinePos, bool push, char timeFormat)
+{
+  ytGraphDrawGridXaxis(Graph, xAxis, ytGraphLayoutDefault, LastXGridLinePos, push, timeFormat);
+}
+
+void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, const ytGraphLayout &cfg, int16_t &LastXGridLinePos,
+                          bool push, char timeFormat)
 {
   double i;
   int16_t gTemp;
@@ -32,219 +43,376 @@ void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t &LastX
 
   LastXGridLinePos = 0;
 
-  Graph.fillSprite(GRAPH_BGRND_COLOR);
-  xAxis.fillSprite(GRAPH_BGRND_COLOR);
+  Graph.fillSprite(cfg.bgrndColor);
+  xAxis.fillSprite(cfg.bgrndColor);
   xAxis.setTextSize(1);
-  xAxis.setTextColor(GRAPH_AXIS_TEXT_COLOR, GRAPH_BGRND_COLOR);
+  xAxis.setTextColor(cfg.axisTextColor, cfg.bgrndColor);
 
-  step = lround((GRAPH_HEIGHT * GRAPH_Y_DIV) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)); // Scale y axis according to height of graph
-  gTemp = GRAPH_HEIGHT;                                                                     // helper to paint axis
-  // draw x axis & x grid lines
-  for (i = GRAPH_Y_AXIS_MIN; i <= GRAPH_Y_AXIS_MAX; i += GRAPH_Y_DIV)
-  {
-    if (i == 0)
-    {
-      Graph.drawFastHLine(0, gTemp, GRAPH_WIDTH, GRAPH_AXIS_LINE_COLOR);
-      Graph.drawFastHLine(0, gTemp + 1, GRAPH_WIDTH, GRAPH_AXIS_LINE_COLOR);
-    }
-    else
-    {
-      Graph.drawFastHLine(0, gTemp, GRAPH_WIDTH, GRAPH_GRID_COLOR);
-    }
-    gTemp -= step; // calculate new position of grid line
-    if (gTemp < 0) // due to round errors at variable 'step', correction to zero
-      gTemp = 0;
-  }
+  ytGraphDrawGridY(Graph, cfg, 0, cfg.width); // draw x axis & x grid lines
 
-  step = lround((GRAPH_WIDTH * GRAPH_X_DIV) / (abs(GRAPH_X_AXIS_MIN) + (SAMPLE_COUNT * SAMPLE_RATE))); // scale x axis according to width of graph
+  step = cfg.xStep; // scale x axis according to width of graph
   gTemp = 0;
   // helper to paint axis
   // draw y grid lines & x scale numbers
-  for (i = GRAPH_X_AXIS_MIN; i <= GRAPH_X_AXIS_MAX; i += GRAPH_X_DIV)
+  for (i = cfg.xMin; i <= cfg.xMax(); i += cfg.xDiv)
   {
     if (i == 0) // draw zero
     {
     }
-    else if (i > (GRAPH_X_AXIS_MAX - GRAPH_X_DIV)) // draw the last grid line
+    else if (i > (cfg.xMax() - cfg.xDiv)) // draw the last grid line
     {
-      Graph.drawFastVLine(gTemp, GRAPH_HEIGHT - GRAPH_HEIGHT, GRAPH_HEIGHT, GRAPH_GRID_COLOR);
+      Graph.drawFastVLine(gTemp, 0, cfg.height, cfg.gridColor);
       LastXGridLinePos = gTemp;
     }
     else
     {
-      Graph.drawFastVLine(gTemp, GRAPH_HEIGHT - GRAPH_HEIGHT, GRAPH_HEIGHT, GRAPH_GRID_COLOR);
+      Graph.drawFastVLine(gTemp, 0, cfg.height, cfg.gridColor);
     }
     // draw xaxis division values
-    xAxis.setCursor(gTemp + 5, (X_AXIS_HEIGTH - 8)); // vertically aligned
-    xAxis.print(calcTime((int)i));                   // helper to calculate the relative time on x-axis
-    gTemp += step;                                   // calculate new position of grid line
+    char str[X_AXIS_LABEL_LENGTH];
+    xAxis.setCursor(gTemp + 5, (cfg.xAxisHeight() - 8));       // vertically aligned
+    xAxis.print(ytGraphFormatTime(str, (int)i, timeFormat)); // helper to calculate the relative time on x-axis
+    gTemp += step;                                            // calculate new position of grid line
   }
 
-  xAxis.pushSprite(X_AXIS_LEFT_X, X_AXIS_UPPER_Y, GRAPH_BGRND_COLOR); //, GRAPH_BGRND_COLOR
-  Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y, GRAPH_BGRND_COLOR); // left upper position
+  if (!push)
+    return;
+  xAxis.pushSprite(cfg.xAxisX(), cfg.xAxisY(), cfg.bgrndColor);
+  Graph.pushSprite(cfg.spriteX(), cfg.spriteY(), cfg.bgrndColor); // left upper position
 }
 
-void ytGraphDrawDynamicGrid(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t oox, int16_t &LastGridLineXPos)
+void ytGraphDrawGridY(TFT_eSprite &Graph, const ytGraphLayout &cfg, int16_t x, int16_t w)
 {
-  static uint32_t lastXaxisValue = GRAPH_X_AXIS_MAX;
-
   double i;
-  int16_t gTemp; // helper events to draw the dif lines
-  double step;   // step is the width between two div lines in px
+  int16_t gTemp;
+  double step;
 
-  step = lround((GRAPH_HEIGHT * GRAPH_Y_DIV) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)); // Scale y axis according to height of graph
-  gTemp = GRAPH_HEIGHT;                                                                     // helper to paint axis
-  // draw x axis & x grid lines
-  for (i = GRAPH_Y_AXIS_MIN; i <= GRAPH_Y_AXIS_MAX; i += GRAPH_Y_DIV)
+  step = cfg.yStep;   // Scale y axis according to height of graph
+  gTemp = cfg.height; // helper to paint axis
+  for (i = cfg.yMin; i <= cfg.yMax; i += cfg.yDiv)
   {
     if (i == 0)
     {
-      Graph.drawFastHLine(oox, gTemp, SAMPLE_COUNT, GRAPH_AXIS_LINE_COLOR);
-      Graph.drawFastHLine(oox, gTemp + 1, SAMPLE_COUNT, GRAPH_AXIS_LINE_COLOR);
+      Graph.drawFastHLine(x, gTemp, w, cfg.axisLineColor);
+      Graph.drawFastHLine(x, gTemp + 1, w, cfg.axisLineColor);
     }
     else
     {
-      Graph.drawFastHLine(oox, gTemp, SAMPLE_COUNT, GRAPH_GRID_COLOR);
+      Graph.drawFastHLine(x, gTemp, w, cfg.gridColor);
     }
     gTemp -= step; // calculate new position of grid line
     if (gTemp < 0) // due to round errors at variable 'step', correction to zero
       gTemp = 0;
   }
+}
 
-  step = lround((GRAPH_WIDTH * GRAPH_X_DIV) / (abs(GRAPH_X_AXIS_MIN) + GRAPH_X_AXIS_MAX)); // scale x division according to width of graph
-  gTemp = round(GRAPH_WIDTH / SAMPLE_COUNT);                                               // scroll one sample to the left
-  int16_t correction = (GRAPH_WIDTH - LastGridLineXPos);                                   // correction, if lastXGridline is not on the end of the frame
-  static uint16_t xScrollCount = correction;                                               // static is OK, because of only one timeline for all graphs!
+bool ytGraphDynamicGridStep(int16_t LastGridLineXPos, uint32_t &xValue)
+{
+  return ytGraphDynamicGridStep(timelineDefault, ytGraphLayoutDefault, LastGridLineXPos, xValue);
+}
 
-  xScrollCount += gTemp;
-  if (xScrollCount >= step)
-  {
-    Graph.drawFastVLine(GRAPH_WIDTH, 0, GRAPH_HEIGHT, GRAPH_GRID_COLOR);
-    xScrollCount = correction; // restart with correction value
+bool ytGraphDynamicGridStep(ytGraphTimeline &tl, const ytGraphLayout &cfg, int16_t LastGridLineXPos, uint32_t &xValue)
+{
+  double step; // step is the width between two div lines in px
+  int16_t gTemp;
 
-    // draw xaxis division values
-    xAxis.setCursor(GRAPH_WIDTH + 5, (X_AXIS_HEIGTH - 8)); // vertically aligned
-    lastXaxisValue += GRAPH_X_DIV;                         // increment with division value
-    xAxis.print(calcTime(lastXaxisValue));
+  step = cfg.xStep;                                    // scale x division according to width of graph
+  gTemp = cfg.scrollStep;                              // scroll one sample to the left
+  int16_t correction = (cfg.width - LastGridLineXPos); // correction, if lastXGridline is not on the end of the frame
+  if (!tl.started)
+  {
+    tl.xScrollCount = correction;
+    tl.started = true;
   }
+
+  tl.xScrollCount += gTemp;
+  if (tl.xScrollCount < step)
+    return false;
+
+  tl.xScrollCount = correction;    // restart with correction value
+  tl.lastXaxisValue += cfg.xDiv;   // increment with division value
+  xValue = tl.lastXaxisValue;
+  return true;
+}
+
+void ytGraphDrawGridStrip(TFT_eSprite &Graph, int16_t oox, bool newDiv, int16_t xOrg)
+{
+  ytGraphDrawGridStrip(Graph, ytGraphLayoutDefault, oox, newDiv, xOrg);
+}
+
+void ytGraphDrawGridStrip(TFT_eSprite &Graph, const ytGraphLayout &cfg, int16_t oox, bool newDiv, int16_t xOrg)
+{
+  // the sprite clips at its right border anyway, clipping here keeps ring sprites exact
+  int16_t w = cfg.spriteWidth() - oox < cfg.samples ? cfg.spriteWidth() - oox : cfg.samples;
+
+  ytGraphDrawGridY(Graph, cfg, oox + xOrg, w); // draw x axis & x grid lines
+
+  if (newDiv)
+    Graph.drawFastVLine(cfg.width + xOrg, 0, cfg.height, cfg.gridColor);
+}
+
+void ytGraphDrawXaxisLabel(TFT_eSprite &xAxis, uint32_t xValue, int16_t xOrg)
+{
+  ytGraphDrawXaxisLabel(xAxis, ytGraphLayoutDefault, xValue, xOrg);
+}
+
+void ytGraphDrawXaxisLabel(TFT_eSprite &xAxis, const ytGraphLayout &cfg, uint32_t xValue, int16_t xOrg)
+{
+  // draw xaxis division values
+  char str[X_AXIS_LABEL_LENGTH];
+  xAxis.setCursor(cfg.width + 5 + xOrg, (cfg.xAxisHeight() - 8)); // vertically aligned
+  xAxis.print(ytGraphFormatTime(str, xValue, cfg.timeFormat));
+}
+
+void ytGraphDrawDynamicGrid(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t oox, int16_t &LastGridLineXPos)
+{
+  YTGRAPH_STAGE(STATS_GRID);
+  uint32_t xValue;
+  bool newDiv = ytGraphDynamicGridStep(LastGridLineXPos, xValue);
+
+  ytGraphDrawGridStrip(Graph, oox, newDiv, 0);
+  if (newDiv)
+    ytGraphDrawXaxisLabel(xAxis, xValue, 0);
 }
 
 void ytGraphDrawYaxisFrame(M5Display &d)
+{
+  ytGraphDrawYaxisFrame(d, ytGraphLayoutDefault);
+}
+
+void ytGraphDrawYaxisLabels(TFT_eSPI &d, const ytGraphLayout &cfg, bool clear)
 {
   double i;
   int16_t gTemp;
   double step;
 
+  if (clear) // the old numbers, between the left border of the numbers and the y axis
+    d.fillRect(cfg.left - 20, cfg.bottom - cfg.height - 4, 18, cfg.height + 12, cfg.bgrndColor);
   d.setTextSize(1);
-  d.setTextColor(GRAPH_AXIS_TEXT_COLOR, GRAPH_BGRND_COLOR);
+  d.setTextColor(cfg.axisTextColor, cfg.bgrndColor);
 
-  // draw main Y axis
-  d.drawFastVLine(GRAPH_X_LEFT_POS - 1, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT,
-                  GRAPH_HEIGHT + 2, GRAPH_AXIS_LINE_COLOR); // drawing from top to bottom
-  d.drawFastVLine(GRAPH_X_LEFT_POS - 2, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT,
-                  GRAPH_HEIGHT + 2, GRAPH_AXIS_LINE_COLOR); // 1-2 px left from grid/sprite
-
-  // draw right frame line
-  d.drawFastVLine(GRAPH_X_LEFT_POS + GRAPH_WIDTH + 1, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT - 2,
-                  GRAPH_HEIGHT + 4, GRAPH_GRID_COLOR); // drawing from top to bottom 1px right from grid/sprite
-  d.drawFastVLine(GRAPH_X_LEFT_POS + GRAPH_WIDTH + 2, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT - 2,
-                  GRAPH_HEIGHT + 4, GRAPH_GRID_COLOR);
-
-  // draw upper frame line
-  d.drawFastHLine(GRAPH_X_LEFT_POS - 2, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT - 1,
-                  GRAPH_WIDTH + 4, GRAPH_GRID_COLOR);
-  d.drawFastHLine(GRAPH_X_LEFT_POS - 2, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT - 2,
-                  GRAPH_WIDTH + 4, GRAPH_GRID_COLOR);
-
-  // draw y scale numbers
-  step = lround((GRAPH_HEIGHT * GRAPH_Y_DIV) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)); // Scale y axis according to height of graph
-  gTemp = GRAPH_Y_BOTTOM_POS;                                                               // helper to paint axis
-  for (i = GRAPH_Y_AXIS_MIN; i <= GRAPH_Y_AXIS_MAX; i += GRAPH_Y_DIV)
+  step = cfg.yStep;   // Scale y axis according to height of graph
+  gTemp = cfg.bottom; // helper to paint axis
+  for (i = cfg.yMin; i <= cfg.yMax; i += cfg.yDiv)
   {
-    d.setCursor(GRAPH_X_LEFT_POS - 20, gTemp - 4);
+    d.setCursor(cfg.left - 20, gTemp - 4);
     d.println(i, 0); // only integer
 
     gTemp -= step; // calculate new position of grid line
     if (gTemp < 0) // due to round errors at variable 'step', correction to zero
       gTemp = 0;
   }
+}
+
+void ytGraphDrawYaxisFrame(TFT_eSPI &d, const ytGraphLayout &cfg)
+{
+  d.setTextSize(1);
+  d.setTextColor(cfg.axisTextColor, cfg.bgrndColor);
+
+  // draw main Y axis
+  d.drawFastVLine(cfg.left - 1, cfg.bottom - cfg.height,
+                  cfg.height + 2, cfg.axisLineColor); // drawing from top to bottom
+  d.drawFastVLine(cfg.left - 2, cfg.bottom - cfg.height,
+                  cfg.height + 2, cfg.axisLineColor); // 1-2 px left from grid/sprite
+
+  // draw right frame line
+  d.drawFastVLine(cfg.left + cfg.width + 1, cfg.bottom - cfg.height - 2,
+                  cfg.height + 4, cfg.gridColor); // drawing from top to bottom 1px right from grid/sprite
+  d.drawFastVLine(cfg.left + cfg.width + 2, cfg.bottom - cfg.height - 2,
+                  cfg.height + 4, cfg.gridColor);
+
+  // draw upper frame line
+  d.drawFastHLine(cfg.left - 2, cfg.bottom - cfg.height - 1,
+                  cfg.width + 4, cfg.gridColor);
+  d.drawFastHLine(cfg.left - 2, cfg.bottom - cfg.height - 2,
+                  cfg.width + 4, cfg.gridColor);
+
+  ytGraphDrawYaxisLabels(d, cfg, false); // draw y scale numbers
 
   // x-axis unit label
-  d.setTextColor(GRAPH_AXIS_LINE_COLOR, GRAPH_BGRND_COLOR);
-  d.setCursor(GRAPH_X_LEFT_POS + GRAPH_WIDTH + 6, GRAPH_Y_BOTTOM_POS - 5);
-  d.println(GRAPH_X_AXIS_LABEL);
+  d.setTextColor(cfg.axisLineColor, cfg.bgrndColor);
+  d.setCursor(cfg.left + cfg.width + 6, cfg.bottom - 5);
+  d.println(cfg.xLabel);
   // y-axis unit label
-  d.setCursor(2, GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT - 15);
-  d.println(GRAPH_Y_AXIS_LABEL);
+  d.setCursor(2, cfg.bottom - cfg.height - 15);
+  d.println(cfg.yLabel);
 }
 
-void ytGraph(TFT_eSprite &Graph, uint16_t x, int16_t y, uint16_t LineColor, int16_t &ox, int16_t &oy)
+// one 3px thick line segment between two sprite positions
+void ytGraphDrawSegment(TFT_eSprite &Graph, int16_t ox, int16_t oy, int16_t x, int16_t y, uint16_t LineColor)
 {
-  y = abs(lround((GRAPH_HEIGHT * y) / (abs(GRAPH_Y_AXIS_MIN) + GRAPH_Y_AXIS_MAX)) - GRAPH_HEIGHT); // calculate y position in sprite and flip
-  x = lround((GRAPH_WIDTH * x) / (abs(GRAPH_X_AXIS_MIN) + GRAPH_X_AXIS_MAX));                      // calculate x position in sprite
-
   Graph.drawLine(ox, oy, x, y, LineColor);
   Graph.drawLine(ox, oy + 1, x, y + 1, LineColor);
   Graph.drawLine(ox, oy - 1, x, y - 1, LineColor);
+}
+
+void ytGraph(TFT_eSprite &Graph, uint16_t x, int16_t y, uint16_t LineColor, int16_t &ox, int16_t &oy)
+{
+  YTGRAPH_STAGE(STATS_LINE);
+  y = ytGraphMapY(ytGraphScaleDefault, y); // calculate y position in sprite and flip (fixed point)
+  x = ytGraphMapX(ytGraphScaleDefault, x); // calculate x position in sprite
+
+  ytGraphDrawSegment(Graph, ox, oy, x, y, LineColor);
 
   ox = x; // store the latest x position for next drawing event
   oy = y; // store the latest y position for next drawing event
 }
 
-char *calcTime(int32_t t) // helper to calculate the relative time on x-axis
+void ytGraph(TFT_eSprite &Graph, uint16_t x, int16_t y, ytGraphChannel &ch)
+{
+  ytGraph(Graph, x, y, ch.color, ch.ox, ch.oy);
+}
+
+void ytGraphSeries(TFT_eSprite &Graph, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n)
+{
+  ytGraphSeries(Graph, ytGraphScaleDefault, ch, firstX, y, n);
+}
+
+void ytGraphSeries(TFT_eSprite &Graph, const ytGraphScale &s, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n)
+{
+  int16_t px[32], py[32];
+  for (uint16_t i = 0; i < n; i += 32)
+  {
+    uint16_t len = (n - i) < 32 ? (n - i) : 32;
+    ytGraphMapBatch(s, firstX + i, y + i, px, py, len); // whole chunk in one go
+
+    if (firstX + i == 0) // new page, the line starts at the first sample
+    {
+      ch.ox = px[0];
+      ch.oy = py[0];
+    }
+    for (uint16_t k = 0; k < len; k++)
+    {
+      ytGraphDrawSegment(Graph, ch.ox, ch.oy, px[k], py[k], ch.color);
+      ch.ox = px[k];
+      ch.oy = py[k];
+    }
+  }
+}
+
+void ytGraphDrawColumn(TFT_eSprite &Graph, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch)
+{
+  ytGraphDrawColumn(Graph, ytGraphScaleDefault, px, col, ch);
+}
+
+void ytGraphDrawColumn(TFT_eSprite &Graph, const ytGraphScale &s, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch)
+{
+  if (col.count == 0) // no data, the line goes on over the gap
+    return;
+  int16_t first = ytGraphMapY(s, col.first);
+  int16_t top = ytGraphMapY(s, col.max); // y is flipped, max is on top
+  int16_t bottom = ytGraphMapY(s, col.min);
+
+  if (px == 0) // new page, the line starts at this column
+  {
+    ch.ox = px;
+    ch.oy = first;
+  }
+  ytGraphDrawSegment(Graph, ch.ox, ch.oy, px, first, ch.color);
+  if (bottom > top)
+    Graph.drawFastVLine(px, top - 1, bottom - top + 3, ch.color);
+
+  ch.ox = px;
+  ch.oy = ytGraphMapY(s, col.last);
+}
+
+void ytGraphDrawColumns(TFT_eSprite &Graph, ytGraphChannel &ch, int16_t firstPx, const ytGraphColumn *col, uint16_t n)
+{
+  for (uint16_t i = 0; i < n; i++)
+    ytGraphDrawColumn(Graph, firstPx + i, col[i], ch);
+}
+
+void ytGraphDrawPoints(TFT_eSprite &Graph, ytGraphChannel &ch, const uint16_t *px, const int16_t *y, uint16_t n)
+{
+  for (uint16_t i = 0; i < n; i++)
+  {
+    int16_t py = ytGraphMapY(ytGraphScaleDefault, y[i]);
+    if (i == 0 && px[0] == 0) // new page, the line starts at the first point
+    {
+      ch.ox = px[0];
+      ch.oy = py;
+    }
+    ytGraphDrawSegment(Graph, ch.ox, ch.oy, px[i], py, ch.color);
+    ch.ox = px[i];
+    ch.oy = py;
+  }
+}
+
+static char *appendNumber(char *p, uint32_t v) // decimal digits of v, no sprintf
+{
+  char digits[10];
+  uint8_t n = 0;
+  do
+  {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (n)
+    *p++ = digits[--n];
+  return p;
+}
+
+static char *appendPart(char *p, uint8_t v, char unit) // e.g. "12m"
+{
+  p = appendNumber(p, v);
+  *p++ = unit;
+  return p;
+}
+
+char *ytGraphFormatTime(char *str, int32_t t, char format) // helper to calculate the relative time on x-axis
 {
   uint8_t sec = 0, min = 0, hour = 0, day = 0; // to format time value (from nnn sec to dhms...)
-  static char str[20]{};                       // returns the formated time value
+  char *p = str;
+
+  // a negative time is "-" and the label of its magnitude, the math runs unsigned (also INT32_MIN)
+  uint32_t m = t < 0 ? 0u - (uint32_t)t : (uint32_t)t;
+  if (t < 0)
+    *p++ = '-';
 
-  switch (SAMPLE_TIME_FORMAT) // time base to format (s->min->h->d ...)
+  switch (format) // time base to format (s->min->h->d ...)
   {
   case 'S': // base is seconds
-    sec = t % 60;
-    t = (t - sec) / 60;
-    min = t % 60;
-    t = (t - min) / 60;
-    hour = t % 24;
-    t = (t - hour) / 24;
-    day = t;
+    sec = m % 60;
+    m /= 60;
+    min = m % 60;
+    m /= 60;
+    hour = m % 24;
+    day = m / 24;
 
     if (day > 0)
-      sprintf(str, "%id%ih%im%is", day, hour, min, sec);
-    else if (hour > 0)
-      sprintf(str, "%ih%im%is", hour, min, sec);
-    else if (min > 0)
-      sprintf(str, "%im%is", min, sec);
-    else if (sec >= 0) // >= to draw the initial zero for the 1st time
-      sprintf(str, "%is", sec);
+      p = appendPart(p, day, 'd');
+    if (day > 0 || hour > 0)
+      p = appendPart(p, hour, 'h');
+    if (day > 0 || hour > 0 || min > 0)
+      p = appendPart(p, min, 'm');
+    p = appendPart(p, sec, 's'); // also the initial zero
     break;
   case 'M': // base is minutes
-    min = t % 60;
-    t = (t - min) / 60;
-    hour = t % 24;
-    t = (t - hour) / 24;
-    day = t;
+    min = m % 60;
+    m /= 60;
+    hour = m % 24;
+    day = m / 24;
 
     if (day > 0)
-      sprintf(str, "%id%ih%im", day, hour, min);
-    else if (hour > 0)
-      sprintf(str, "%ih%im", hour, min);
-    else if (min >= 0) // >= to draw the initial zero for the 1st time
-      sprintf(str, "%im", min);
+      p = appendPart(p, day, 'd');
+    if (day > 0 || hour > 0)
+      p = appendPart(p, hour, 'h');
+    p = appendPart(p, min, 'm');
     break;
   case 'H': // base is hours
-    hour = t % 24;
-    t = (t - hour) / 24;
-    day = t;
+    hour = m % 24;
+    day = m / 24;
 
     if (day > 0)
-      sprintf(str, "%id%ih", day, hour);
-    else if (hour >= 0) // >= to draw the initial zero for the 1st time
-      sprintf(str, "%ih", hour);
+      p = appendPart(p, day, 'd');
+    p = appendPart(p, hour, 'h');
     break;
 
-  default:
-    sprintf(str, "%i", t); // add new x axis value - unformatted
+  default: // add new x axis value - unformatted
+    p = appendNumber(p, m);
     break;
   }
 
+  *p = 0;
   return str;
-}
\ No newline at end of file
+}
@@ -24,14 +24,25 @@
 #include <TFT_eSPI.h>
 #endif
 
+#include "ytGraphScale.h"
+#include "ytGraphStats.h"
+#include "ytGraphRing.h"
+#include "ytGraphDecimate.h"
+
+#ifndef SAMPLE_COUNT            // build flags may override the sample count (see native envs in platformio.ini)
 #define SAMPLE_COUNT 20        // how many samples in one graph
+#endif
 #define SAMPLE_RATE 1          // interval in time format below
 #define SAMPLE_TIME_FORMAT 'S' // time base to format time in S_econds/M_inutes/H_ours/D_ays/...
 
 #define GRAPH_X_LEFT_POS 40                           // uint - lower left x position
 #define GRAPH_Y_BOTTOM_POS 150                        // uint - lower left y position MUST BE LARGER THAN GRAPH_HEIGHT!
+#ifndef GRAPH_WIDTH
 #define GRAPH_WIDTH 240                               // uint - only axis to axis, without axis/div description in sprite frame
+#endif
+#ifndef GRAPH_HEIGHT
 #define GRAPH_HEIGHT 120                              // uint - only axis to axis, without axis/div description in sprite frame
+#endif
 #define GRAPH_X_AXIS_MIN 0                            // int  - should be >= 0 (Time is positive!)
 #define GRAPH_X_AXIS_MAX (SAMPLE_COUNT * SAMPLE_RATE) // end of axis is (num of samples * sample rate)
 #define GRAPH_X_DIV 5                                 // uint - division of x axis (time)
@@ -41,13 +52,14 @@
 
 #define SPRITE_LEFT_X GRAPH_X_LEFT_POS                     // this is the "real" position of the graph
 #define SPRITE_UPPER_Y (GRAPH_Y_BOTTOM_POS - GRAPH_HEIGHT) // this is the "real" position of the graph
-#define SPRITE_WIDTH GRAPH_WIDTH + 1                       // x Grid
-#define SPRITE_HEIGTH GRAPH_HEIGHT + 2                     // y Grid & x-axis
+#define SPRITE_WIDTH (GRAPH_WIDTH + 1)                     // x Grid
+#define SPRITE_HEIGTH (GRAPH_HEIGHT + 2)                   // y Grid & x-axis
 
-#define X_AXIS_WIDTH SPRITE_WIDTH + 50 // Axis width is larger than sprite
+#define X_AXIS_WIDTH (SPRITE_WIDTH + 50) // Axis width is larger than sprite
 #define X_AXIS_HEIGTH 15
-#define X_AXIS_LEFT_X GRAPH_X_LEFT_POS - 10
-#define X_AXIS_UPPER_Y GRAPH_Y_BOTTOM_POS + 4
+#define X_AXIS_LEFT_X (GRAPH_X_LEFT_POS - 10)
+#define X_AXIS_UPPER_Y (GRAPH_Y_BOTTOM_POS + 4)
+#define X_AXIS_LABEL_LENGTH 20 // chars of a x axis label incl. 0, the longest one is "-255d23h59m59s"
 
 #define GRAPH_AXIS_LINE_COLOR TFT_ORANGE
 #define GRAPH_BGRND_COLOR TFT_BLACK
@@ -57,11 +69,235 @@
 #define GRAPH_X_AXIS_LABEL "Time"    // (x)time axis caption
 #define GRAPH_Y_AXIS_LABEL "Celsius" // y axis caption
 
+struct ytGraphConfig // geometry, axes and colors of one graph, the #defines above are ytGraphConfigDefault
+{
+  int16_t left;        // GRAPH_X_LEFT_POS
+  int16_t bottom;      // GRAPH_Y_BOTTOM_POS
+  uint16_t width;      // GRAPH_WIDTH
+  uint16_t height;     // GRAPH_HEIGHT
+  uint16_t samples;    // SAMPLE_COUNT
+  uint16_t sampleRate; // SAMPLE_RATE
+  char timeFormat;     // SAMPLE_TIME_FORMAT
+  int32_t xMin;        // GRAPH_X_AXIS_MIN, the end of the x axis is samples * sampleRate
+  uint16_t xDiv;       // GRAPH_X_DIV
+  double yMin;         // GRAPH_Y_AXIS_MIN
+  double yMax;         // GRAPH_Y_AXIS_MAX
+  uint16_t yDiv;       // GRAPH_Y_DIV
+  uint16_t axisLineColor;
+  uint16_t bgrndColor;
+  uint16_t axisTextColor;
+  uint16_t gridColor;
+  const char *xLabel;
+  const char *yLabel;
+
+  // the derived positions, same as the SPRITE_ and X_AXIS_ #defines
+  constexpr int32_t xMax() const { return (int32_t)samples * sampleRate; }
+  constexpr int32_t xRange() const { return (xMin < 0 ? -xMin : xMin) + xMax(); } // abs(min) + max, like v0.5
+  constexpr double yRange() const { return (yMin < 0 ? -yMin : yMin) + yMax; }
+  constexpr int16_t spriteX() const { return left; }
+  constexpr int16_t spriteY() const { return bottom - height; }
+  constexpr int16_t spriteWidth() const { return width + 1; }
+  constexpr int16_t spriteHeight() const { return height + 2; }
+  constexpr int16_t xAxisX() const { return left - 10; }
+  constexpr int16_t xAxisY() const { return bottom + 4; }
+  constexpr int16_t xAxisWidth() const { return spriteWidth() + 50; }
+  constexpr int16_t xAxisHeight() const { return X_AXIS_HEIGTH; }
+};
+
+inline constexpr ytGraphConfig ytGraphConfigDefault = {
+    GRAPH_X_LEFT_POS, GRAPH_Y_BOTTOM_POS, GRAPH_WIDTH, GRAPH_HEIGHT,
+    SAMPLE_COUNT, SAMPLE_RATE, SAMPLE_TIME_FORMAT,
+    GRAPH_X_AXIS_MIN, GRAPH_X_DIV, GRAPH_Y_AXIS_MIN, GRAPH_Y_AXIS_MAX, GRAPH_Y_DIV,
+    GRAPH_AXIS_LINE_COLOR, GRAPH_BGRND_COLOR, GRAPH_AXIS_TEXT_COLOR, GRAPH_GRID_COLOR,
+    GRAPH_X_AXIS_LABEL, GRAPH_Y_AXIS_LABEL};
+
+// result of ytGraphLayoutCheck()
+#define LAYOUT_OK 0
+#define LAYOUT_EMPTY 1    // width, height, samples or sample rate is 0
+#define LAYOUT_SAMPLES 2  // width is no multiple of samples, the grid would drift against the line while scrolling
+#define LAYOUT_POSITION 3 // left < 20 or bottom <= height, the y scale or the sprite would leave the panel
+#define LAYOUT_X_AXIS 4   // xMin < 0, xDiv = 0 or less than 1 px between two x divisions
+#define LAYOUT_Y_AXIS 5   // yMax <= yMin, yDiv = 0 or less than 1 px between two y divisions
+
+constexpr int16_t ytGraphRound(double v) // lround() for constant expressions
+{
+  return v < 0 ? -(int16_t)(-v + 0.5) : (int16_t)(v + 0.5);
+}
+
+// px between two divisions, the same rounding as the v0.5 grid loops
+constexpr int16_t ytGraphXStep(const ytGraphConfig &cfg)
+{
+  return cfg.xRange() > 0 ? (int16_t)((cfg.width * cfg.xDiv) / cfg.xRange()) : 0;
+}
+
+constexpr int16_t ytGraphYStep(const ytGraphConfig &cfg)
+{
+  return cfg.yRange() > 0 ? ytGraphRound((cfg.height * cfg.yDiv) / cfg.yRange()) : 0;
+}
+
+constexpr uint8_t ytGraphLayoutCheck(const ytGraphConfig &cfg)
+{
+  return !cfg.width || !cfg.height || !cfg.samples || !cfg.sampleRate ? LAYOUT_EMPTY
+         : cfg.width % cfg.samples                                   ? LAYOUT_SAMPLES
+         : cfg.left < 20 || cfg.bottom <= cfg.height                 ? LAYOUT_POSITION
+         : cfg.xMin < 0 || !cfg.xDiv || ytGraphXStep(cfg) < 1         ? LAYOUT_X_AXIS
+         : cfg.yMax <= cfg.yMin || !cfg.yDiv || ytGraphYStep(cfg) < 1 ? LAYOUT_Y_AXIS
+                                                                     : LAYOUT_OK;
+}
+
+// a configuration with everything the drawing functions derive from it, computed once
+// all drawing functions take a layout, a ytGraphConfig converts at the call (runtime variant)
+struct ytGraphLayout : ytGraphConfig
+{
+  int16_t xStep;      // px between two x divisions
+  int16_t yStep;      // px between two y divisions
+  int16_t scrollStep; // px per sample
+  ytGraphScale scale; // sample -> sprite pixel
+
+  constexpr ytGraphLayout(const ytGraphConfig &cfg)
+      : ytGraphConfig(cfg), xStep(ytGraphXStep(cfg)), yStep(ytGraphYStep(cfg)),
+        scrollStep(cfg.samples ? cfg.width / cfg.samples : 0),
+        scale(ytGraphScaleInit(cfg.width, cfg.height, cfg.xRange(), cfg.yRange()))
+  {
+  }
+};
+
+// the layout of a constant configuration, computed by the compiler and checked with static_assert:
+//   constexpr ytGraphConfig small = {...};
+//   ytGraphInstance g(TFT, ytGraphStaticLayout<small>::layout);
+template <const ytGraphConfig &CFG>
+struct ytGraphStaticLayout
+{
+  static_assert(ytGraphLayoutCheck(CFG) != LAYOUT_EMPTY, "ytGraph: width, height, samples and sample rate must not be 0");
+  static_assert(ytGraphLayoutCheck(CFG) != LAYOUT_SAMPLES, "ytGraph: the graph width must be a multiple of the sample count");
+  static_assert(ytGraphLayoutCheck(CFG) != LAYOUT_POSITION, "ytGraph: left must be >= 20 and bottom larger than the height");
+  static_assert(ytGraphLayoutCheck(CFG) != LAYOUT_X_AXIS, "ytGraph: x axis min < 0 or x divisions narrower than 1 px");
+  static_assert(ytGraphLayoutCheck(CFG) != LAYOUT_Y_AXIS, "ytGraph: y axis max <= min or y divisions narrower than 1 px");
+
+  static constexpr ytGraphLayout layout{CFG};
+};
+
+inline constexpr const ytGraphLayout &ytGraphLayoutDefault = ytGraphStaticLayout<ytGraphConfigDefault>::layout; // the #defines
+inline constexpr ytGraphScale ytGraphScaleDefault = ytGraphLayoutDefault.scale; // sample -> sprite pixel transform of the #define configuration
+
+struct ytGraphTimeline // scroll state of the dynamic x axis, one per graph
+{
+  uint32_t lastXaxisValue; // label of the newest division
+  uint16_t xScrollCount;   // px scrolled since the last division
+  bool started;
+};
+
+ytGraphTimeline ytGraphTimelineInit(const ytGraphLayout &cfg);
+
 void ytGraphDrawYaxisFrame(M5Display &d);
-void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t &LastXGridLinePos);
+void ytGraphDrawYaxisFrame(TFT_eSPI &d, const ytGraphLayout &cfg);
+// only the y scale numbers (part of the frame), clear = erase the old numbers first (e.g. after a rescale)
+void ytGraphDrawYaxisLabels(TFT_eSPI &d, const ytGraphLayout &cfg, bool clear);
+// timeFormat labels the x axis in S_econds/M_inutes/H_ours/D_ays, e.g. for the views of ytGraphTiers
+void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t &LastXGridLinePos, bool push = true,
+                          char timeFormat = SAMPLE_TIME_FORMAT);
+void ytGraphDrawGridXaxis(TFT_eSprite &Graph, TFT_eSprite &xAxis, const ytGraphLayout &cfg, int16_t &LastXGridLinePos,
+                          bool push, char timeFormat);
 
+// x axis label of t: S_econds/M_inutes/H_ours as e.g. "1h5m0s", any other format unformatted
+// a negative t is "-" and the label of its magnitude, e.g. "-1h5m0s"
+// no sprintf and no shared buffer, str needs X_AXIS_LABEL_LENGTH chars, returns str
+char *ytGraphFormatTime(char *str, int32_t t, char format = SAMPLE_TIME_FORMAT);
+
+// the horizontal grid lines and the x axis (y = 0) over the sprite columns x .. x + w - 1
+void ytGraphDrawGridY(TFT_eSprite &Graph, const ytGraphLayout &cfg, int16_t x, int16_t w);
+
+// uses one timeline for all graphs, see ytGraphInstance for independent graphs
 void ytGraphDrawDynamicGrid(TFT_eSprite &Graph, TFT_eSprite &xAxis, int16_t oox, int16_t &LastXGridLinePos);
 
+// the parts of ytGraphDrawDynamicGrid(), xOrg shifts all columns (used for ring sprites)
+bool ytGraphDynamicGridStep(int16_t LastXGridLinePos, uint32_t &xValue); // true if a new division is due, xValue = its label
+void ytGraphDrawGridStrip(TFT_eSprite &Graph, int16_t oox, bool newDiv, int16_t xOrg = 0);
+void ytGraphDrawXaxisLabel(TFT_eSprite &xAxis, uint32_t xValue, int16_t xOrg = 0);
+bool ytGraphDynamicGridStep(ytGraphTimeline &tl, const ytGraphLayout &cfg, int16_t LastXGridLinePos, uint32_t &xValue);
+void ytGraphDrawGridStrip(TFT_eSprite &Graph, const ytGraphLayout &cfg, int16_t oox, bool newDiv, int16_t xOrg);
+void ytGraphDrawXaxisLabel(TFT_eSprite &xAxis, const ytGraphLayout &cfg, uint32_t xValue, int16_t xOrg);
+
 void ytGraph(TFT_eSprite &Graph, uint16_t x, int16_t y, uint16_t LineColor, int16_t &ox, int16_t &oy);
+void ytGraphDrawSegment(TFT_eSprite &Graph, int16_t ox, int16_t oy, int16_t x, int16_t y, uint16_t LineColor); // 3px thick line
+
+struct ytGraphChannel // line color and continuation point of one channel
+{
+  uint16_t color;
+  int16_t ox; // last drawn point in sprite pixels
+  int16_t oy;
+};
+
+void ytGraph(TFT_eSprite &Graph, uint16_t x, int16_t y, ytGraphChannel &ch);
+
+// draws n samples at x = firstX, firstX + 1, ... as one polyline, no push
+// at firstX = 0 the line starts at the first sample (new page), otherwise at ch.ox/ch.oy
+void ytGraphSeries(TFT_eSprite &Graph, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n);
+void ytGraphSeries(TFT_eSprite &Graph, const ytGraphScale &s, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n);
+
+// draws one decimated column at pixel column px: a line from the last point to 'first'
+// and a vertical span from min to max (3 px like the lines), continues at 'last'
+// at px = 0 the line starts at the column (new page)
+void ytGraphDrawColumn(TFT_eSprite &Graph, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch);
+void ytGraphDrawColumn(TFT_eSprite &Graph, const ytGraphScale &s, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch);
+void ytGraphDrawColumns(TFT_eSprite &Graph, ytGraphChannel &ch, int16_t firstPx, const ytGraphColumn *col, uint16_t n);
+
+// draws points with pixel x (e.g. from ytGraphLTTB()) and sample y as one polyline
+// at px[0] = 0 the line starts at the first point (new page)
+void ytGraphDrawPoints(TFT_eSprite &Graph, ytGraphChannel &ch, const uint16_t *px, const int16_t *y, uint16_t n);
+
+// same for a ring store, value(sample) returns the y value of this channel
+template <typename T, uint32_t N, typename Value>
+void ytGraphSeries(TFT_eSprite &Graph, ytGraphChannel &ch, const ytGraphRing<T, N> &ring, Value value)
+{
+  int16_t y[32]; // map and draw in small chunks, no heap
+  for (uint32_t i = 0; i < ring.size(); i += 32)
+  {
+    uint16_t n = ring.size() - i < 32 ? ring.size() - i : 32;
+    for (uint16_t k = 0; k < n; k++)
+      y[k] = value(ring[i + k]);
+    ytGraphSeries(Graph, ch, i, y, n);
+  }
+}
+
+// all channels of a ring store, sample by sample like the ytGraph() loop, so the same channel
+// stays on top where lines cross. value(sample, channel) returns the y value of a channel
+template <typename T, uint32_t N, typename Value>
+void ytGraphSeries(TFT_eSprite &Graph, ytGraphChannel *ch, uint8_t channels, const ytGraphRing<T, N> &ring, Value value)
+{
+  int16_t y[32], px[256], py[256]; // a chunk of samples of every channel, no heap
+  uint16_t chunk = channels > 8 ? 256 / channels : 32;
+  for (uint32_t i = 0; i < ring.size(); i += chunk)
+  {
+    uint16_t n = ring.size() - i < chunk ? ring.size() - i : chunk;
+    for (uint8_t c = 0; c < channels; c++)
+    {
+      for (uint16_t k = 0; k < n; k++)
+        y[k] = value(ring[i + k], c);
+      ytGraphMapBatch(ytGraphScaleDefault, i, y, px + c * n, py + c * n, n);
+      if (i == 0) // new page, the line starts at the first sample
+      {
+        ch[c].ox = px[c * n];
+        ch[c].oy = py[c * n];
+      }
+    }
+    for (uint16_t k = 0; k < n; k++)
+      for (uint8_t c = 0; c < channels; c++)
+      {
+        ytGraphDrawSegment(Graph, ch[c].ox, ch[c].oy, px[c * n + k], py[c * n + k], ch[c].color);
+        ch[c].ox = px[c * n + k];
+        ch[c].oy = py[c * n + k];
+      }
+  }
+}
+
+// redraws the whole history of all channels and pushes the sprite only once
+// value(sample, channel) returns the y value of a channel
+template <typename T, uint32_t N, typename Value>
+void ytGraphDrawHistory(TFT_eSprite &Graph, const ytGraphRing<T, N> &ring, ytGraphChannel *ch, uint8_t channels, Value value)
+{
+  ytGraphSeries(Graph, ch, channels, ring, value);
+  Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // left upper position
+}
 
 #endif
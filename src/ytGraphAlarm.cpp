@@ -0,0 +1,280 @@
+/***************************************************************************************
+ * Threshold alarms for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphAlarm.h"
+#include "ytGraphSpan.h"
+
+ytGraphAlarms::ytGraphAlarms()
+    : _iv(nullptr), _capacity(0), _size(0), _next(0), _samples(0), _dropped(0), _rules(0), _raised(0), _arena(nullptr)
+{
+  clear();
+}
+
+bool ytGraphAlarms::begin(uint16_t intervals, ytGraphArena *arena)
+{
+  end();
+  if (!intervals)
+    return false;
+  _arena = arena;
+  _iv = (ytGraphAlarmInterval *)ytGraphAlloc(_arena, intervals * sizeof(ytGraphAlarmInterval));
+  if (!_iv)
+    return false;
+  _capacity = intervals;
+  clear();
+  return true;
+}
+
+void ytGraphAlarms::end()
+{
+  ytGraphFree(_arena, _iv);
+  _iv = nullptr;
+  _capacity = 0;
+  _size = 0;
+}
+
+void ytGraphAlarms::clear()
+{
+  _size = 0;
+  _next = 0;
+  _samples = 0;
+  _dropped = 0;
+  _raised = 0;
+  for (uint8_t r = 0; r < ALARM_RULES; r++)
+    _state[r] = state{0, 0, false, false};
+}
+
+int8_t ytGraphAlarms::addRule(const ytGraphAlarmRule &rule)
+{
+  if (_rules == ALARM_RULES)
+    return -1;
+  _rule[_rules] = rule;
+  _state[_rules] = state{0, 0, false, false};
+  return _rules++;
+}
+
+const ytGraphAlarmInterval &ytGraphAlarms::operator[](uint16_t i) const
+{
+  return _iv[(_next - _size + i) % _capacity];
+}
+
+void ytGraphAlarms::add(const int16_t *y)
+{
+  uint32_t n = _samples++;
+  _raised = 0;
+  if (!_iv)
+    return;
+  for (uint8_t r = 0; r < _rules; r++)
+  {
+    const ytGraphAlarmRule &rule = _rule[r];
+    state &s = _state[r];
+    int32_t v = y[rule.channel];
+    bool above = rule.type == ALARM_ABOVE;
+
+    if (!s.beyond && (above ? v > rule.limit : v < rule.limit))
+    {
+      s.beyond = true;
+      s.run = n;
+    }
+    else if (s.beyond && (above ? v <= (int32_t)rule.limit - rule.hysteresis : v >= (int32_t)rule.limit + rule.hysteresis))
+    {
+      s.beyond = false;
+      if (s.active && _next - s.open <= _size) // not pushed out of the ring yet
+        _iv[s.open % _capacity].end = n;
+      s.active = false;
+    }
+
+    if (s.beyond && !s.active && n - s.run + 1 >= (rule.minDuration ? rule.minDuration : 1))
+    {
+      // raised: the interval starts at the first sample beyond the limit
+      if (_size == _capacity)
+        _dropped++;
+      else
+        _size++;
+      s.open = _next++;
+      _iv[s.open % _capacity] = ytGraphAlarmInterval{s.run, ALARM_OPEN, r};
+      s.active = true;
+      _raised |= 1 << r;
+    }
+  }
+}
+
+/***************************************************************************************
+ * drawing
+****************************************************************************************/
+
+static int16_t alarmX(const ytGraphLayout &cfg, uint32_t count, int32_t n) // column of the n-th sample of the page
+{
+  return count > 1 ? (int16_t)(n * cfg.width / (int32_t)(count - 1)) : 0;
+}
+
+// columns of the samples [start, end) inside the page [first, first + count), false if none of them is visible
+static bool alarmColumns(const ytGraphLayout &cfg, uint32_t first, uint32_t count, uint32_t start, uint32_t end,
+                         int16_t &x0, int16_t &x1)
+{
+  int32_t s = (int32_t)(start - first), e = end == ALARM_OPEN ? (int32_t)count : (int32_t)(end - first);
+  if (s < 0)
+    s = 0;
+  if (e > (int32_t)count)
+    e = count;
+  if (s >= e)
+    return false;
+  x0 = s ? alarmX(cfg, count, s - 1) + 1 : 0; // sample s covers the columns right of sample s - 1
+  x1 = alarmX(cfg, count, e - 1);
+  return x0 <= x1;
+}
+
+static void alarmRows(const ytGraphLayout &cfg, const ytGraphAlarmRule &rule, int16_t &y0, int16_t &y1)
+{
+  int16_t y = ytGraphMapY(cfg.scale, rule.limit);
+  y = y < 0 ? 0 : y > cfg.height ? cfg.height : y;
+  if (rule.type == ALARM_ABOVE)
+  {
+    y0 = 0;
+    y1 = rule.style == ALARM_MARK ? ALARM_MARK_HEIGHT - 1 : y - 1;
+  }
+  else
+  {
+    y0 = rule.style == ALARM_MARK ? cfg.height - ALARM_MARK_HEIGHT : y + 1;
+    y1 = cfg.height - 1; // the x axis stays
+  }
+}
+
+// fill: the whole rectangle, otherwise only the background and the n colours 'over' (the zones of other rules),
+// the grid and the lines stay on top
+static void alarmPaint(TFT_eSprite &Graph, const ytGraphLayout &cfg, uint16_t color, int16_t x0, int16_t x1, int16_t y0, int16_t y1,
+                       bool fill, const uint16_t *over = nullptr, uint8_t n = 0)
+{
+  if (fill)
+  {
+    Graph.fillRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1, color);
+    return;
+  }
+  if (x0 < 0)
+    x0 = 0;
+  if (x1 >= Graph.width())
+    x1 = Graph.width() - 1;
+  if (y0 < 0)
+    y0 = 0;
+  if (y1 >= Graph.height())
+    y1 = Graph.height() - 1;
+
+  // 4 and 16 bit sprites row by row in their pixel memory (see ytGraphSpan.h), compared as stored values
+  ytGraphSpanTarget t;
+  if (ytGraphSpanBegin(Graph, t))
+  {
+    uint16_t pixel = ytGraphSpanPixel(Graph, t, color), under[ALARM_RULES + 1];
+    under[0] = ytGraphSpanPixel(Graph, t, cfg.bgrndColor);
+    for (uint8_t i = 0; i < n; i++)
+      under[i + 1] = ytGraphSpanPixel(Graph, t, over[i]);
+    for (int16_t y = y0; y <= y1; y++)
+    {
+      uint8_t *row = t.img + y * t.stride;
+      for (int16_t x = x0; x <= x1; x++)
+      {
+        uint8_t shift = x & 1 ? 0 : 4; // even x in the high nibble
+        uint16_t v = t.bpp == 4 ? (row[x >> 1] >> shift) & 0x0F : ((uint16_t *)row)[x];
+        uint8_t i = 0;
+        while (i <= n && v != under[i])
+          i++;
+        if (i > n)
+          continue;
+        if (t.bpp == 4)
+          row[x >> 1] = (row[x >> 1] & ~(0x0F << shift)) | pixel << shift;
+        else
+          ((uint16_t *)row)[x] = pixel;
+      }
+    }
+    return;
+  }
+
+  for (int16_t x = x0; x <= x1; x++) // e.g. a 1 bit sprite
+    for (int16_t y = y0; y <= y1; y++)
+    {
+      uint16_t c = Graph.readPixel(x, y);
+      bool under = c == cfg.bgrndColor;
+      for (uint8_t i = 0; i < n && !under; i++)
+        under = c == over[i];
+      if (under)
+        Graph.drawPixel(x, y, color);
+    }
+}
+
+void ytGraphDrawAlarms(TFT_eSprite &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a, uint32_t first, uint32_t count,
+                       int16_t xOrg)
+{
+  // rule by rule, where two zones overlap the first rule stays on top (like ytGraphDrawAlarmStep())
+  for (uint8_t r = 0; r < a.rules(); r++)
+  {
+    int16_t x0, x1, y0, y1;
+    alarmRows(cfg, a.rule(r), y0, y1);
+    for (uint16_t i = 0; i < a.size(); i++)
+      if (a[i].rule == r && alarmColumns(cfg, first, count, a[i].start, a[i].end, x0, x1))
+        alarmPaint(Graph, cfg, a.rule(r).color, x0 + xOrg, x1 + xOrg, y0, y1, false);
+  }
+}
+
+void ytGraphDrawAlarms(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a, uint32_t first, uint32_t count)
+{
+  for (uint8_t r = 0; r < a.rules(); r++)
+  {
+    int16_t x0, x1, y0, y1, org[2];
+    alarmRows(cfg, a.rule(r), y0, y1);
+    for (uint16_t i = 0; i < a.size(); i++)
+    {
+      if (a[i].rule != r || !alarmColumns(cfg, first, count, a[i].start, a[i].end, x0, x1))
+        continue;
+      for (uint8_t k = 0, n = Graph.origins(x0, x1, org); k < n; k++)
+        alarmPaint(Graph.sprite(), cfg, a.rule(r).color, x0 + org[k], x1 + org[k], y0, y1, false);
+      Graph.markDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+    }
+  }
+}
+
+void ytGraphDrawAlarmStep(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a)
+{
+  if (!a.samples())
+    return;
+  uint32_t n = a.samples() - 1, first = n - cfg.samples, count = cfg.samples + 1; // the page, newest sample at cfg.width
+  int16_t x0, x1, y0, y1, org[2];
+
+  // the new columns are empty after scroll(): the last rule first, so the first one stays on top
+  for (int8_t r = a.rules() - 1; r >= 0; r--)
+  {
+    if (!a.active(r))
+      continue;
+    alarmRows(cfg, a.rule(r), y0, y1);
+    alarmColumns(cfg, first, count, n, n + 1, x0, x1);
+    for (uint8_t k = 0, m = Graph.origins(x0, x1, org); k < m; k++)
+      alarmPaint(Graph.sprite(), cfg, a.rule(r).color, x0 + org[k], x1 + org[k], y0, y1, true);
+    Graph.markDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+  }
+
+  // raised after the minimum duration: the samples before this one are on the screen already,
+  // painted behind the grid and lines but over the zones of the rules after this one
+  uint16_t after[ALARM_RULES];
+  for (uint16_t i = 0; a.raised() && i < a.size(); i++)
+  {
+    const ytGraphAlarmInterval &iv = a[i];
+    if (!(a.raised() & (1 << iv.rule)) || iv.end != ALARM_OPEN || !alarmColumns(cfg, first, count, iv.start, n, x0, x1))
+      continue;
+    uint8_t m = 0;
+    for (uint8_t r = iv.rule + 1; r < a.rules(); r++)
+      after[m++] = a.rule(r).color;
+    alarmRows(cfg, a.rule(iv.rule), y0, y1);
+    for (uint8_t k = 0, o = Graph.origins(x0, x1, org); k < o; k++)
+      alarmPaint(Graph.sprite(), cfg, a.rule(iv.rule).color, x0 + org[k], x1 + org[k], y0, y1, false, after, m);
+    Graph.markDirty(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+  }
+}
@@ -0,0 +1,117 @@
+/***************************************************************************************
+ * Threshold alarms for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - per channel rules: above or below a limit, with hysteresis and a minimum
+ *    duration in samples, evaluated in O(rules) when a sample is added
+ *  - every alarm is kept as one interval [start, end) of sample numbers in a small
+ *    ring, a redraw of the history paints them in O(intervals), no buffer is rescanned
+ *  - bands shade the zone beyond the limit, marks are a bar at the top or bottom edge
+ *  - the scrolling graph paints only the new columns of each frame, an alarm raised
+ *    after its minimum duration paints its older columns behind the grid and lines
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_ALARM_h
+#define YTGRAPH_ALARM_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphCanvas.h"
+
+#define ALARM_RULES 8          // rules of one ytGraphAlarms
+#define ALARM_ABOVE 0          // alarm while y > limit
+#define ALARM_BELOW 1          // alarm while y < limit
+#define ALARM_BAND 0           // shades the graph from the limit to the edge
+#define ALARM_MARK 1           // bar of ALARM_MARK_HEIGHT px at the top (above) or bottom (below) edge
+#define ALARM_MARK_HEIGHT 3
+#define ALARM_OPEN 0xFFFFFFFF // end of an interval that is still active
+
+struct ytGraphAlarmRule
+{
+  uint8_t channel;
+  uint8_t type;         // ALARM_ABOVE or ALARM_BELOW
+  uint8_t style;        // ALARM_BAND or ALARM_MARK
+  int16_t limit;
+  int16_t hysteresis;   // the alarm ends at limit - hysteresis (above) or limit + hysteresis (below)
+  uint16_t minDuration; // samples beyond the limit before the alarm is raised, 0 and 1 = at once
+  uint16_t color;
+};
+
+struct ytGraphAlarmInterval
+{
+  uint32_t start; // first sample beyond the limit (the raise is back-dated over the minimum duration)
+  uint32_t end;   // first sample back inside, ALARM_OPEN while active
+  uint8_t rule;
+};
+
+class ytGraphAlarms
+{
+public:
+  ytGraphAlarms();
+  ~ytGraphAlarms() { end(); }
+
+  // intervals: the ring of alarm intervals, the oldest one is dropped when it is full, arena = nullptr: from the heap
+  bool begin(uint16_t intervals, ytGraphArena *arena = nullptr);
+  void end();
+  static uint32_t bytes(uint16_t intervals) { return ytGraphArena::align(intervals * sizeof(ytGraphAlarmInterval)); } // of begin()
+  void clear(); // intervals and state, the rules stay
+
+  int8_t addRule(const ytGraphAlarmRule &rule); // index of the rule, -1 if there are ALARM_RULES already
+  const ytGraphAlarmRule &rule(uint8_t r) const { return _rule[r]; }
+  uint8_t rules() const { return _rules; }
+
+  void add(const int16_t *y); // one sample of every channel, O(rules)
+
+  uint32_t samples() const { return _samples; }              // added since begin() or clear(), the next sample number
+  bool active(uint8_t r) const { return _state[r].active; }
+  uint8_t raised() const { return _raised; }                 // rules raised by the last add(), one bit per rule
+  uint16_t size() const { return _size; }                    // intervals in the ring
+  const ytGraphAlarmInterval &operator[](uint16_t i) const;  // 0 = oldest
+  uint32_t dropped() const { return _dropped; }              // intervals pushed out of the ring
+
+private:
+  struct state
+  {
+    uint32_t run;   // first sample of the current run beyond the limit
+    uint32_t open;  // interval number of the active alarm
+    bool beyond;    // beyond the limit, with hysteresis
+    bool active;    // raised
+  };
+
+  ytGraphAlarmInterval *_iv;
+  uint16_t _capacity;
+  uint16_t _size;
+  uint32_t _next; // interval number of the next one, ring slot = number % capacity
+  uint32_t _samples;
+  uint32_t _dropped;
+  uint8_t _rules;
+  uint8_t _raised;
+  ytGraphArena *_arena;
+  ytGraphAlarmRule _rule[ALARM_RULES];
+  state _state[ALARM_RULES];
+};
+
+// the alarms of the samples [first, first + count) with sample 'first' at column 0 and 'count' samples over
+// the width (SAMPLE_COUNT + 1 = one page), sample n covers the columns right of sample n - 1 up to its own
+// only background pixels are painted, call it after the grid and before or after the lines, O(intervals)
+// where the zones of two rules overlap the rule added first stays on top
+void ytGraphDrawAlarms(TFT_eSprite &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a, uint32_t first, uint32_t count,
+                       int16_t xOrg = 0);
+void ytGraphDrawAlarms(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a, uint32_t first, uint32_t count);
+
+// scrolling graph, the newest sample at column cfg.width: fills the new columns of every active alarm,
+// call it after add() and scroll(), before the grid and lines. An alarm raised by this sample paints its
+// older columns behind what is drawn there. Same picture as ytGraphDrawAlarms() of the page
+void ytGraphDrawAlarmStep(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphAlarms &a);
+
+#endif
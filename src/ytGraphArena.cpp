@@ -0,0 +1,167 @@
+/***************************************************************************************
+ * Memory arena for the sprites and buffers of the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphArena.h"
+#include "ytGraphSpan.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool ytGraphArena::begin(uint32_t bytes)
+{
+  end();
+  bytes = align(bytes);
+  _mem = (uint8_t *)malloc(bytes ? bytes : ARENA_ALIGN);
+  if (!_mem)
+  {
+    _failures++;
+    _lastFailed = bytes;
+    return false;
+  }
+  _size = bytes;
+  _used = _highWater = 0;
+  return true;
+}
+
+void ytGraphArena::end()
+{
+  free(_mem);
+  _mem = nullptr;
+  _size = _used = 0;
+}
+
+bool ytGraphArena::fits(uint32_t bytes)
+{
+  if (_mem && bytes <= _size - _used)
+    return true;
+  _failures++;
+  _lastFailed = bytes;
+  return false;
+}
+
+void *ytGraphArena::alloc(uint32_t bytes)
+{
+  bytes = align(bytes);
+  if (!fits(bytes))
+    return nullptr;
+  uint8_t *p = _mem + _used;
+  _used += bytes;
+  if (_used > _highWater)
+    _highWater = _used;
+  memset(p, 0, bytes); // like calloc(), a reset block holds the old content
+  return p;
+}
+
+void ytGraphArena::reset(uint32_t mark)
+{
+  if (mark < _used)
+    _used = mark;
+  _resets++;
+}
+
+void *ytGraphAlloc(ytGraphArena *arena, uint32_t bytes)
+{
+  return arena ? arena->alloc(bytes) : malloc(bytes);
+}
+
+void ytGraphFree(ytGraphArena *arena, void *p)
+{
+  if (!arena)
+    free(p);
+}
+
+uint32_t ytGraphSprite::bytes(int16_t w, int16_t h, uint8_t bpp)
+{
+  // the sizes of callocSprite() of TFT_eSPI 2.3 for one frame, incl. its spare element
+  if (w < 1 || h < 1)
+    return 0;
+  if (bpp == 1)
+    return (uint32_t)((w + 7) & 0xFFF8) * h / 8 + 1;
+  if (bpp == 4)
+    return (uint32_t)((w + 1) & 0xFFFE) * h / 2 + 1;
+  if (bpp == 8)
+    return (uint32_t)w * h + 1;
+  return (uint32_t)w * h * 2 + 2;
+}
+
+// a few test pixels must land in mem where TFT_eSPI keeps them, the block is zeroed again
+static bool spriteProbe(TFT_eSprite &Graph, uint8_t *mem, uint8_t bpp, int16_t stride)
+{
+  if (Graph.getPointer() != mem)
+    return false;
+  if (bpp == 4 || bpp == 16)
+  {
+    ytGraphSpanTarget t;
+    return ytGraphSpanBegin(Graph, t) && t.stride == stride; // restores the corner itself
+  }
+  if (Graph.width() < 2 || Graph.height() < 2)
+    return false;
+  Graph.drawPixel(0, 0, TFT_WHITE);
+  Graph.drawPixel(1, 0, TFT_WHITE);
+  Graph.drawPixel(0, 1, TFT_WHITE);
+  bool ok = bpp == 1 ? mem[0] == 0xC0 && mem[stride] == 0x80 : mem[0] && mem[1] && mem[stride];
+  mem[0] = mem[1] = mem[stride] = 0;
+  return ok;
+}
+
+void *ytGraphSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
+{
+  if (!_arena || frames > 1) // the arena holds one frame, a double buffered sprite takes the heap
+    return TFT_eSprite::createSprite(w, h, frames);
+  if (_created)
+    return _img8;
+
+  // one frame, the members as TFT_eSprite::createSprite() sets them
+  uint32_t mark = _arena->mark();
+  uint8_t *mem = (uint8_t *)_arena->alloc(bytes(w, h, _bpp));
+  if (!mem)
+    return nullptr;
+  _iwidth = _dwidth = w;
+  _iheight = _dheight = h;
+  _bitwidth = (w + 7) & 0xFFF8;
+  if (_bpp == 1)
+    _iwidth = _bitwidth; // 1 bit rows are whole bytes
+  else if (_bpp == 4)
+    _iwidth = (w + 1) & 0xFFFE; // two pixels per byte, rows start on a byte
+  _img8 = _img4 = mem;
+  _img = (uint16_t *)mem;
+  _img8_1 = _img8_2 = nullptr; // TFT_eSprite::deleteSprite() frees _img8_1, so it must not see the arena
+  _created = true;             // createPalette() does nothing before
+  if (_bpp == 4)
+    createPalette((uint16_t *)nullptr, 16); // the default palette
+  setScrollRect(0, 0, _dwidth, _dheight, TFT_BLACK);
+  _inArena = true;
+
+  // another version of the library keeps other members, then the sprite comes from the heap
+  int16_t stride = _bpp == 16 ? w * 2 : _bpp == 4 ? _iwidth / 2 : _bpp == 1 ? _bitwidth / 8 : w;
+  if (!spriteProbe(*this, mem, _bpp, stride))
+  {
+    deleteSprite();
+    _arena->reset(mark);
+    return TFT_eSprite::createSprite(w, h, frames);
+  }
+  return _img8;
+}
+
+void ytGraphSprite::deleteSprite()
+{
+  if (_inArena) // the pixels go back with ytGraphArena::reset()
+  {
+    _created = false;
+    _img8 = _img4 = nullptr;
+    _img = nullptr;
+    _inArena = false;
+  }
+  TFT_eSprite::deleteSprite(); // heap pixels (or only the palette)
+}
@@ -0,0 +1,100 @@
+/***************************************************************************************
+ * Memory arena for the sprites and buffers of the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - one block is taken from the heap at startup, every graph allocation (sprite
+ *    pixels, dirty columns, sample rings, label strips) is cut from it
+ *  - nothing is freed one by one: reset() on a screen change makes everything
+ *    after a mark() free again, so creating and deleting sprites over and over no
+ *    longer breaks the heap into pieces (the MaxAllocHeap of printFreeHeap() in main.cpp)
+ *  - the classes take an optional arena (setArena(), nullptr = heap as before),
+ *    ytGraphInstance::arenaBytes() gives the budget of a graph, begin() checks it
+ *    before the first allocation, so a graph that does not fit fails as a whole
+ *  - stats(): size, use, high-water mark and the requests that did not fit
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_ARENA_h
+#define YTGRAPH_ARENA_h
+
+#include "ytGraph.h"
+
+#define ARENA_ALIGN 4 // bytes, every allocation starts on a 32 bit word
+
+struct ytGraphArenaStats
+{
+  uint32_t size;       // bytes of the arena
+  uint32_t used;       // bytes in use
+  uint32_t highWater;  // most bytes in use since begin()
+  uint32_t failures;   // requests (and budget checks) that did not fit
+  uint32_t lastFailed; // bytes of the last one
+  uint32_t resets;
+};
+
+class ytGraphArena
+{
+public:
+  ytGraphArena() : _mem(nullptr), _size(0), _used(0), _highWater(0), _failures(0), _lastFailed(0), _resets(0) {}
+  ~ytGraphArena() { end(); }
+
+  bool begin(uint32_t bytes); // takes the block from the heap (once, at startup), false if out of memory
+  void end();
+
+  void *alloc(uint32_t bytes); // aligned and zeroed, nullptr (and counted as failure) if it does not fit
+  bool fits(uint32_t bytes);   // budget check before a group of allocations, counted as failure if not
+
+  // screen change: everything allocated after mark is free again (0 = everything)
+  // the objects that use this memory must be ended before
+  uint32_t mark() const { return _used; }
+  void reset(uint32_t mark = 0);
+
+  uint32_t available() const { return _size - _used; }
+  ytGraphArenaStats stats() const { return ytGraphArenaStats{_size, _used, _highWater, _failures, _lastFailed, _resets}; }
+
+  static constexpr uint32_t align(uint32_t bytes) { return (bytes + ARENA_ALIGN - 1) & ~(uint32_t)(ARENA_ALIGN - 1); }
+
+private:
+  uint8_t *_mem;
+  uint32_t _size, _used, _highWater;
+  uint32_t _failures, _lastFailed, _resets;
+};
+
+// from the arena or, without one, from the heap, the way all ytGraph classes allocate
+void *ytGraphAlloc(ytGraphArena *arena, uint32_t bytes);
+void ytGraphFree(ytGraphArena *arena, void *p); // only heap memory is freed, arena memory waits for reset()
+
+// a sprite whose pixel memory can come from an arena, otherwise the same as TFT_eSprite
+// createSprite() sets the members of TFT_eSprite the way TFT_eSPI 2.3 does (M5Stack 0.3.1 carries a copy
+// of that sprite class), test pixels check the layout of the new sprite. If they do not land in the arena
+// memory (another library version) or frames > 1, the sprite is taken from the heap with TFT_eSprite::createSprite()
+// TFT_eSprite::deleteSprite() through a TFT_eSprite & is safe, it frees only the palette of an arena sprite,
+// frameBuffer() must not be used on it
+class ytGraphSprite : public TFT_eSprite
+{
+public:
+  explicit ytGraphSprite(TFT_eSPI *tft) : TFT_eSprite(tft), _arena(nullptr), _inArena(false) {}
+  ~ytGraphSprite() { deleteSprite(); }
+
+  void setArena(ytGraphArena *arena) { _arena = arena; } // for the next createSprite(), nullptr = heap
+  void *createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+  void deleteSprite();
+  bool inArena() const { return _inArena; } // false after the fall back to the heap
+
+  // pixel memory createSprite() takes for a sprite of w x h with bpp bits (one frame)
+  static uint32_t bytes(int16_t w, int16_t h, uint8_t bpp);
+
+private:
+  ytGraphArena *_arena;
+  bool _inArena;
+};
+
+#endif
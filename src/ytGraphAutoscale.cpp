@@ -0,0 +1,291 @@
+/***************************************************************************************
+ * Auto scaled y axis for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphAutoscale.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define AUTOSCALE_MARGIN 8 // the new range keeps 1/8 of the span (at least 1) free above and below the samples
+
+bool ytGraphMinMax::begin(uint32_t window, ytGraphArena *arena)
+{
+  end();
+  _arena = arena;
+  _lo = (item *)ytGraphAlloc(_arena, 2 * window * sizeof(item)); // one block for both deques
+  if (!_lo)
+    return false;
+  _hi = _lo + window;
+  _window = window;
+  clear();
+  return true;
+}
+
+void ytGraphMinMax::end()
+{
+  ytGraphFree(_arena, _lo);
+  _lo = _hi = nullptr;
+  _window = 0;
+}
+
+void ytGraphMinMax::clear()
+{
+  _seq = 0;
+  _loFirst = _loCount = _hiFirst = _hiCount = 0;
+}
+
+void ytGraphMinMax::add(item *q, uint32_t &first, uint32_t &count, int16_t v, bool lower)
+{
+  // the oldest value left the window
+  while (count && _seq - q[first].seq >= _window)
+  {
+    if (++first == _window)
+      first = 0;
+    count--;
+  }
+  // values that can never be the min (max) again: the new one is newer and at least as low (high)
+  while (count)
+  {
+    uint32_t back = first + count - 1;
+    if (back >= _window)
+      back -= _window;
+    if (lower ? q[back].v < v : q[back].v > v)
+      break;
+    count--;
+  }
+  uint32_t slot = first + count;
+  if (slot >= _window)
+    slot -= _window;
+  q[slot] = item{_seq, v};
+  count++;
+}
+
+void ytGraphMinMax::push(int16_t lo, int16_t hi)
+{
+  if (!_window)
+    return;
+  add(_lo, _loFirst, _loCount, lo, true);
+  add(_hi, _hiFirst, _hiCount, hi, false);
+  _seq++;
+}
+
+ytGraphYRange ytGraphNiceRange(int16_t lo, int16_t hi, uint8_t divs)
+{
+  static const uint8_t mantissa[3] = {1, 2, 5};
+  if (hi < lo)
+  {
+    int16_t t = lo;
+    lo = hi, hi = t;
+  }
+  if (!divs)
+    divs = 1;
+  for (int32_t decade = 1; decade <= 10000; decade *= 10)
+    for (uint8_t m : mantissa)
+    {
+      int32_t div = m * decade;
+      int32_t a = lo / div - (lo % div < 0 ? 1 : 0); // rounded down
+      int32_t b = hi / div + (hi % div > 0 ? 1 : 0); // rounded up
+      if (a == b)
+        b++;
+      if (b - a <= divs && a * div >= INT16_MIN && b * div <= INT16_MAX)
+        return ytGraphYRange{(int16_t)(a * div), (int16_t)(b * div), (uint16_t)div};
+    }
+  return ytGraphYRange{-30000, 30000, 10000}; // the whole int16_t range
+}
+
+static ytGraphYRange autoscaleTarget(int16_t lo, int16_t hi)
+{
+  int32_t margin = ((int32_t)hi - lo) / AUTOSCALE_MARGIN;
+  if (margin < 1)
+    margin = 1;
+  int32_t a = lo - margin, b = hi + margin;
+  return ytGraphNiceRange(a < INT16_MIN ? INT16_MIN : a, b > INT16_MAX ? INT16_MAX : b);
+}
+
+bool ytGraphAutoRange(ytGraphYRange &r, int16_t lo, int16_t hi)
+{
+  if (lo < r.min || hi > r.max) // grows at once
+  {
+    r = autoscaleTarget(lo, hi);
+    return true;
+  }
+  if (((int32_t)hi - lo) * AUTOSCALE_SHRINK >= (int32_t)r.max - r.min) // still uses enough of the axis
+    return false;
+  ytGraphYRange n = autoscaleTarget(lo, hi);
+  if (n.min == r.min && n.max == r.max && n.div == r.div)
+    return false;
+  r = n;
+  return true;
+}
+
+ytGraphLayout ytGraphLayoutRange(const ytGraphConfig &cfg, const ytGraphYRange &r)
+{
+  ytGraphConfig c = cfg;
+  c.yMin = r.min;
+  c.yMax = r.max;
+  c.yDiv = r.div;
+  ytGraphLayout l(c);
+  // the span is max - min here, v0.5 counts abs(min) + max (the axis starts at 0 or below)
+  double span = (double)r.max - r.min;
+  l.yStep = ytGraphRound(c.height * c.yDiv / span);
+  l.scale = ytGraphScaleInit(c.width, c.height, c.xRange(), span, r.min);
+  return l;
+}
+
+ytGraphAutoscale::ytGraphAutoscale()
+    : _y(nullptr), _grid(nullptr), _n(0), _width(0), _head(0), _count(0), _channels(0), _arena(nullptr), _range{0, 0, 1}, _rescales(0),
+      _scrolled(false)
+{
+}
+
+uint32_t ytGraphAutoscale::bytes(const ytGraphLayout &cfg, uint8_t channels)
+{
+  uint32_t n = cfg.samples + 1;
+  return ytGraphArena::align((channels ? channels : 1) * n * sizeof(int16_t)) + ytGraphArena::align(cfg.width + 1) +
+         ytGraphMinMax::bytes(n);
+}
+
+bool ytGraphAutoscale::begin(const ytGraphLayout &cfg, uint8_t channels, ytGraphArena *arena)
+{
+  end();
+  _arena = arena;
+  _n = cfg.samples + 1; // n+1 = because 1st data point starts at x=0 !
+  _width = cfg.width;
+  _channels = channels;
+  _y = (int16_t *)ytGraphAlloc(_arena, (channels ? channels : 1) * _n * sizeof(int16_t));
+  _grid = (uint8_t *)ytGraphAlloc(_arena, _width + 1);
+  if (!_y || !_grid || !_window.begin(_n, _arena))
+  {
+    end();
+    return false;
+  }
+  clear(cfg);
+  return true;
+}
+
+void ytGraphAutoscale::end()
+{
+  ytGraphFree(_arena, _y);
+  ytGraphFree(_arena, _grid);
+  _y = nullptr;
+  _grid = nullptr;
+  _window.end();
+}
+
+void ytGraphAutoscale::clear(const ytGraphLayout &cfg)
+{
+  _head = _count = 0;
+  _window.clear();
+  _range = ytGraphYRange{(int16_t)cfg.yMin, (int16_t)cfg.yMax, cfg.yDiv};
+  _rescales = 0;
+  _scrolled = false;
+  if (!_grid)
+    return;
+
+  // the same columns as the loop of ytGraphDrawGridXaxis()
+  memset(_grid, 0, _width + 1);
+  int16_t gTemp = 0;
+  for (double i = cfg.xMin; i <= cfg.xMax(); i += cfg.xDiv)
+  {
+    if (i != 0 && gTemp >= 0 && gTemp <= _width)
+      _grid[gTemp] = 1;
+    gTemp += cfg.xStep;
+  }
+}
+
+bool ytGraphAutoscale::add(const int16_t *y)
+{
+  if (!_y || !_channels)
+    return false;
+  int16_t lo = y[0], hi = y[0];
+  for (uint8_t c = 0; c < _channels; c++)
+  {
+    _y[c * _n + _head] = y[c];
+    if (y[c] < lo)
+      lo = y[c];
+    if (y[c] > hi)
+      hi = y[c];
+  }
+  if (++_head == _n)
+    _head = 0;
+  if (_count < _n)
+    _count++;
+
+  _window.push(lo, hi); // the window has the length of a page, min/max of the visible samples
+  if (!ytGraphAutoRange(_range, _window.min(), _window.max()))
+    return false;
+  _rescales++;
+  return true;
+}
+
+void ytGraphAutoscale::scroll(int16_t dx, bool newDiv)
+{
+  if (!_grid)
+    return;
+  int16_t shift = -dx, cols = _width + 1;
+  if (shift >= cols)
+    memset(_grid, 0, cols);
+  else if (shift > 0)
+  {
+    memmove(_grid, _grid + shift, cols - shift);
+    memset(_grid + cols - shift, 0, shift);
+  }
+  if (newDiv)
+    _grid[_width] = 1; // ytGraphDrawGridStrip() draws the new division at the right border
+  _scrolled = true;
+}
+
+int16_t ytGraphAutoscale::value(uint8_t channel, uint16_t i) const
+{
+  uint16_t s = _head + _n - _count + i; // always < 2n
+  if (s >= _n)
+    s -= _n;
+  return _y[channel * _n + s];
+}
+
+void ytGraphAutoscale::redraw(TFT_eSprite &Graph, const ytGraphLayout &cfg, ytGraphChannel *ch)
+{
+  Graph.fillSprite(cfg.bgrndColor);
+  // after scrolling the grid strips have reached the last sprite column too
+  ytGraphDrawGridY(Graph, cfg, 0, _scrolled ? cfg.spriteWidth() : cfg.width);
+  for (int16_t x = 0; x <= _width; x++)
+    if (_grid[x])
+      Graph.drawFastVLine(x, 0, cfg.height, cfg.gridColor);
+
+  // sample by sample like ytGraphInstance::add(), the values of a chunk mapped in one batch per channel
+  int16_t v[32], px[32], py[AUTOSCALE_CHANNELS][32];
+  uint8_t channels = _channels < AUTOSCALE_CHANNELS ? _channels : AUTOSCALE_CHANNELS;
+  for (uint16_t i = 0; i < _count; i += 32)
+  {
+    uint16_t len = _count - i < 32 ? _count - i : 32;
+    for (uint8_t c = 0; c < channels; c++)
+    {
+      for (uint16_t k = 0; k < len; k++)
+        v[k] = value(c, i + k);
+      ytGraphMapBatch(cfg.scale, i, v, c ? nullptr : px, py[c], len);
+    }
+    for (uint16_t k = 0; k < len; k++)
+      for (uint8_t c = 0; c < channels; c++)
+      {
+        if (i + k == 0) // the line starts at the first sample
+        {
+          ch[c].ox = px[0];
+          ch[c].oy = py[c][0];
+        }
+        ytGraphDrawSegment(Graph, ch[c].ox, ch[c].oy, px[k], py[c][k], ch[c].color);
+        ch[c].ox = px[k];
+        ch[c].oy = py[c][k];
+      }
+  }
+}
@@ -0,0 +1,121 @@
+/***************************************************************************************
+ * Auto scaled y axis for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - ytGraphMinMax keeps min and max of the visible samples with two monotonic
+ *    deques, amortized O(1) per sample instead of scanning the page
+ *  - ytGraphNiceRange() picks the y range and a 1, 2, 5 * 10^n division
+ *  - hysteresis: the axis grows at once when a sample leaves it, but shrinks only
+ *    when the visible samples use less than 1/AUTOSCALE_SHRINK of it
+ *  - ytGraphAutoscale stores the visible samples (one ring per channel), on a rescale
+ *    the grid and all lines are redrawn from them in one batch, the x axis and its
+ *    scroll state stay as they are (see ytGraphInstance, GRAPH_SCALE_AUTO)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_AUTOSCALE_h
+#define YTGRAPH_AUTOSCALE_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+
+#define AUTOSCALE_DIVS 6   // at most this many y divisions
+#define AUTOSCALE_SHRINK 3 // the axis shrinks only if the visible samples use less than 1/3 of it
+#define AUTOSCALE_CHANNELS 16 // channels redrawn after a rescale
+
+class ytGraphMinMax // min and max over the last 'window' samples
+{
+public:
+  ytGraphMinMax() : _lo(nullptr), _hi(nullptr), _window(0), _arena(nullptr) { clear(); }
+  ~ytGraphMinMax() { end(); }
+
+  bool begin(uint32_t window, ytGraphArena *arena = nullptr); // allocates both deques (window entries each)
+  void end();
+  static uint32_t bytes(uint32_t window) { return ytGraphArena::align(2 * window * sizeof(item)); } // of begin()
+  void clear();
+
+  void push(int16_t lo, int16_t hi); // the lowest and the highest value of one sample (e.g. over all channels)
+  int16_t min() const { return _lo[_loFirst].v; } // only if !empty()
+  int16_t max() const { return _hi[_hiFirst].v; }
+  bool empty() const { return _loCount == 0; }
+
+private:
+  struct item
+  {
+    uint32_t seq; // sample number
+    int16_t v;
+  };
+
+  void add(item *q, uint32_t &first, uint32_t &count, int16_t v, bool lower);
+
+  item *_lo, *_hi; // ring buffers: values increasing (min) and decreasing (max) from the front
+  uint32_t _window;
+  ytGraphArena *_arena;
+  uint32_t _seq;
+  uint32_t _loFirst, _loCount, _hiFirst, _hiCount;
+};
+
+struct ytGraphYRange
+{
+  int16_t min;
+  int16_t max;
+  uint16_t div; // 1, 2, 5, 10, 20, ...
+};
+
+// the smallest range with a 1, 2, 5 * 10^n division that holds lo..hi in at most divs divisions
+ytGraphYRange ytGraphNiceRange(int16_t lo, int16_t hi, uint8_t divs = AUTOSCALE_DIVS);
+
+// true (and r changed) if lo..hi leaves r or uses less than 1/AUTOSCALE_SHRINK of it
+bool ytGraphAutoRange(ytGraphYRange &r, int16_t lo, int16_t hi);
+
+// the layout of cfg with the y axis r: the bottom line is r.min (also for r.min > 0)
+ytGraphLayout ytGraphLayoutRange(const ytGraphConfig &cfg, const ytGraphYRange &r);
+
+class ytGraphAutoscale // the visible samples of one graph, their min/max and the vertical grid
+{
+public:
+  ytGraphAutoscale();
+  ~ytGraphAutoscale() { end(); }
+
+  // allocates samples + 1 values per channel (up to 16), arena = nullptr: from the heap
+  bool begin(const ytGraphLayout &cfg, uint8_t channels, ytGraphArena *arena = nullptr);
+  void end();
+  static uint32_t bytes(const ytGraphLayout &cfg, uint8_t channels); // of begin()
+  void clear(const ytGraphLayout &cfg); // empty page, the vertical grid of ytGraphDrawGridXaxis(), r = cfg
+
+  bool add(const int16_t *y);           // stores one sample, true if the y range has changed
+  void scroll(int16_t dx, bool newDiv); // the vertical grid lines move with the graph (dx < 0)
+
+  // grid and every stored sample with the layout of range(), ch gets the last points
+  void redraw(TFT_eSprite &Graph, const ytGraphLayout &cfg, ytGraphChannel *ch);
+
+  const ytGraphYRange &range() const { return _range; }
+  uint32_t rescales() const { return _rescales; }
+  uint16_t size() const { return _count; }
+  int16_t value(uint8_t channel, uint16_t i) const; // 0 = oldest visible sample
+
+private:
+  int16_t *_y;      // channels * _n values, channel by channel, shared head
+  uint8_t *_grid;   // 1 = vertical grid line in this sprite column
+  uint16_t _n;      // samples + 1
+  uint16_t _width;  // graph width in px, the grid has width + 1 columns
+  uint16_t _head;
+  uint16_t _count;
+  uint8_t _channels;
+  ytGraphArena *_arena;
+  ytGraphMinMax _window;
+  ytGraphYRange _range;
+  uint32_t _rescales;
+  bool _scrolled; // the grid strips have reached the last sprite column
+};
+
+#endif
@@ -0,0 +1,479 @@
+/***************************************************************************************
+ * Sprite wrapper with dirty tracking for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphCanvas.h"
+#include "ytGraphSpan.h"
+
+#define ILI9341_VSCRDEF 0x33  // vertical scrolling definition
+#define ILI9341_VSCRSADD 0x37 // vertical scrolling start address
+#define ILI9341_NORON 0x13    // normal display mode, ends scrolling
+
+/***************************************************************************************
+ * hardware scroll
+ * in landscape mode the panel memory lines are the screen columns, so the
+ * "vertical" scroll of the ILI9341 moves the picture horizontally
+****************************************************************************************/
+
+static void writeCommand16(TFT_eSPI *tft, uint8_t cmd, const uint16_t *args, uint8_t n)
+{
+  tft->writecommand(cmd);
+  for (uint8_t i = 0; i < n; i++)
+  {
+    tft->writedata(args[i] >> 8);
+    tft->writedata(args[i] & 0xFF);
+  }
+}
+
+void ytGraphHwScrollBegin(ytGraphHwScroll &hs, TFT_eSPI &tft, int16_t bandX, int16_t bandW, int16_t panelWidth)
+{
+  hs.tft = &tft;
+  hs.bandX = bandX;
+  hs.bandW = bandW;
+  hs.offset = 0;
+
+  uint16_t def[3] = {(uint16_t)bandX, (uint16_t)bandW, (uint16_t)(panelWidth - bandX - bandW)}; // fixed left, scroll, fixed right
+  writeCommand16(hs.tft, ILI9341_VSCRDEF, def, 3);
+  uint16_t start = bandX;
+  writeCommand16(hs.tft, ILI9341_VSCRSADD, &start, 1);
+}
+
+void ytGraphHwScrollBy(ytGraphHwScroll &hs, int16_t dx)
+{
+  if (!hs.tft || hs.bandW <= 0)
+    return;
+  int32_t o = (hs.offset - dx) % hs.bandW;
+  hs.offset = o < 0 ? o + hs.bandW : o;
+  uint16_t start = hs.bandX + hs.offset;
+  writeCommand16(hs.tft, ILI9341_VSCRSADD, &start, 1);
+}
+
+void ytGraphHwScrollEnd(ytGraphHwScroll &hs)
+{
+  if (!hs.tft)
+    return;
+  uint16_t start = hs.bandX;
+  writeCommand16(hs.tft, ILI9341_VSCRSADD, &start, 1);
+  hs.tft->writecommand(ILI9341_NORON);
+  hs.offset = 0;
+  hs.tft = nullptr;
+}
+
+int16_t ytGraphHwScrollMapX(const ytGraphHwScroll &hs, int16_t screenX)
+{
+  if (screenX < hs.bandX || screenX >= hs.bandX + hs.bandW)
+    return screenX; // fixed area
+  int16_t m = screenX - hs.bandX + hs.offset;
+  if (m >= hs.bandW)
+    m -= hs.bandW;
+  return hs.bandX + m;
+}
+
+/***************************************************************************************
+ * canvas
+****************************************************************************************/
+
+ytGraphCanvas::ytGraphCanvas(TFT_eSprite &sprite, int16_t screenX, int16_t screenY)
+    : _spr(sprite), _hs(nullptr), _arena(nullptr), _x(screenX), _y(screenY), _w(0), _h(0), _ring(false), _period(0), _head(0),
+      _bg(GRAPH_BGRND_COLOR), _top(nullptr), _bottom(nullptr), _lastBytes(0), _lastRegions(0)
+{
+}
+
+ytGraphCanvas::~ytGraphCanvas()
+{
+  ytGraphFree(_arena, _top);
+}
+
+bool ytGraphCanvas::begin()
+{
+  ytGraphFree(_arena, _top);
+  _ring = false;
+  _period = _spr.width();
+  _head = 0;
+  _w = _spr.width();
+  _h = _spr.height();
+  _top = (int16_t *)ytGraphAlloc(_arena, 2 * _w * sizeof(int16_t)); // one block for both arrays
+  if (!_top)
+  {
+    _w = _h = 0;
+    return false;
+  }
+  _bottom = _top + _w;
+  markAll(); // the panel content is unknown
+  return true;
+}
+
+bool ytGraphCanvas::beginRing(int16_t hidden)
+{
+  if (hidden < 0 || hidden >= _spr.width() || !begin())
+    return false;
+  _ring = true;
+  _w -= hidden; // the bookkeeping arrays keep their size, only the visible part is used
+  _bottom = _top + _w;
+  markAll();
+  return true;
+}
+
+uint8_t ytGraphCanvas::origins(int16_t x0, int16_t x1, int16_t *org) const
+{
+  // column x is stored at _head + x, wrapped into the sprite
+  uint8_t n = 0;
+  if (x0 + _head < _period)
+    org[n++] = _head; // the unwrapped part
+  if (_head && x1 + _head >= _period)
+    org[n++] = _head - _period; // the wrapped part
+  return n;
+}
+
+void ytGraphCanvas::unwrap()
+{
+  if (!_head)
+    return;
+
+  // rotate every row left by _head with three reversals, no extra memory
+  // 4 and 16 bit sprites in their pixel memory (see ytGraphSpan.h), other depths pixel by pixel
+  ytGraphSpanTarget t;
+  bool direct = ytGraphSpanBegin(_spr, t);
+  auto reverse = [&](int16_t y, int16_t a, int16_t b)
+  {
+    if (direct && t.bpp == 16)
+    {
+      uint16_t *row = (uint16_t *)(t.img + y * t.stride);
+      for (; a < b; a++, b--)
+      {
+        uint16_t v = row[a];
+        row[a] = row[b];
+        row[b] = v;
+      }
+    }
+    else if (direct)
+    {
+      uint8_t *row = t.img + y * t.stride;
+      for (; a < b; a++, b--)
+      {
+        uint8_t sa = a & 1 ? 0 : 4, sb = b & 1 ? 0 : 4; // even x in the high nibble
+        uint8_t va = (row[a >> 1] >> sa) & 0x0F, vb = (row[b >> 1] >> sb) & 0x0F;
+        row[a >> 1] = (row[a >> 1] & ~(0x0F << sa)) | vb << sa;
+        row[b >> 1] = (row[b >> 1] & ~(0x0F << sb)) | va << sb;
+      }
+    }
+    else
+      for (; a < b; a++, b--)
+      {
+        uint16_t ca = _spr.readPixel(a, y), cb = _spr.readPixel(b, y);
+        _spr.drawPixel(a, y, cb);
+        _spr.drawPixel(b, y, ca);
+      }
+  };
+  for (int16_t y = 0; y < _h; y++)
+  {
+    reverse(y, 0, _head - 1);
+    reverse(y, _head, _period - 1);
+    reverse(y, 0, _period - 1);
+  }
+  _head = 0;
+}
+
+void ytGraphCanvas::restart()
+{
+  _head = 0;
+}
+
+void ytGraphCanvas::fillColumns(int16_t x, int16_t w)
+{
+  int16_t org[2];
+  for (uint8_t i = 0, n = origins(x, x + w - 1, org); i < n; i++)
+    _spr.fillRect(x + org[i], 0, w, _h, _bg);
+}
+
+void ytGraphCanvas::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (x < 0)
+    w += x, x = 0;
+  if (y < 0)
+    h += y, y = 0;
+  if (x + w > _w)
+    w = _w - x;
+  if (y + h > _h)
+    h = _h - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  for (int16_t i = x; i < x + w; i++)
+  {
+    if (y < _top[i])
+      _top[i] = y;
+    if (y + h - 1 > _bottom[i])
+      _bottom[i] = y + h - 1;
+  }
+}
+
+void ytGraphCanvas::markAll()
+{
+  for (int16_t i = 0; i < _w; i++)
+  {
+    _top[i] = 0;
+    _bottom[i] = _h - 1;
+  }
+}
+
+void ytGraphCanvas::markClean()
+{
+  for (int16_t i = 0; i < _w; i++)
+  {
+    _top[i] = _h;
+    _bottom[i] = -1;
+  }
+}
+
+void ytGraphCanvas::scroll(int16_t dx)
+{
+  YTGRAPH_STAGE(STATS_SCROLL);
+  if (!_ring)
+    _spr.scroll(dx);
+  else if (dx <= -_w || dx >= _w)
+    _spr.fillSprite(_bg);
+  else if (dx)
+  {
+    // move the head instead of the pixels, then clear what has been scrolled in
+    int16_t h = (_head - dx) % _period;
+    _head = h < 0 ? h + _period : h;
+    if (dx < 0)
+      fillColumns(_w + dx, _period - _w - dx); // new columns at the right end and the hidden ones
+    else
+    {
+      fillColumns(0, dx);
+      fillColumns(_w, _period - _w);
+    }
+  }
+
+  // column x now shows what was in column x - dx. it is still valid on the panel only if
+  // the panel shifted it as well (both screen columns inside the scroll band) and it was clean
+  for (int16_t k = 0; k < _w; k++)
+  {
+    int16_t x = dx > 0 ? _w - 1 - k : k; // read before overwrite
+    int16_t src = x - dx;
+    int16_t sx = _x + x;
+    bool shifted = _hs && src >= 0 && src < _w &&
+                   sx >= _hs->bandX && sx < _hs->bandX + _hs->bandW &&
+                   sx - dx >= _hs->bandX && sx - dx < _hs->bandX + _hs->bandW;
+    if (shifted)
+    {
+      _top[x] = _top[src];
+      _bottom[x] = _bottom[src];
+    }
+    else
+    {
+      _top[x] = 0;
+      _bottom[x] = _h - 1;
+    }
+  }
+}
+
+uint32_t ytGraphCanvas::push()
+{
+  YTGRAPH_STAGE(STATS_PUSH);
+  _lastBytes = 0;
+  _lastRegions = 0;
+
+  int16_t x = 0;
+  while (x < _w)
+  {
+    if (_top[x] > _bottom[x])
+    {
+      x++;
+      continue;
+    }
+
+    // grow the region over dirty columns and small clean gaps
+    int16_t x0 = x, x1 = x;
+    int16_t top = _top[x], bottom = _bottom[x];
+    for (int16_t c = x + 1; c < _w && c - x1 <= CANVAS_MERGE_GAP; c++)
+    {
+      if (_top[c] > _bottom[c])
+        continue;
+      x1 = c;
+      if (_top[c] < top)
+        top = _top[c];
+      if (_bottom[c] > bottom)
+        bottom = _bottom[c];
+    }
+    pushRect(x0, top, x1 - x0 + 1, bottom - top + 1);
+    x = x1 + 1;
+  }
+
+  markClean();
+  return _lastBytes;
+}
+
+void ytGraphCanvas::pushRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (!_hs)
+  {
+    if (x == 0 && y == 0 && w == _period && h == _h && !_head)
+    {
+      _spr.pushSprite(_x, _y); // whole sprite, one transfer
+      _lastBytes += (uint32_t)w * h * 2;
+      _lastRegions++;
+    }
+    else
+      pushSpan(_x + x, x, y, w, h);
+    return;
+  }
+
+  // split into the parts left of, inside and right of the scroll band
+  int16_t bandL = _hs->bandX - _x, bandR = _hs->bandX + _hs->bandW - _x; // band in sprite columns
+  int16_t end = x + w;
+  if (x < bandL)
+  {
+    int16_t e = end < bandL ? end : bandL;
+    pushSpan(_x + x, x, y, e - x, h);
+    x = e;
+  }
+  if (x < end && x < bandR)
+  {
+    int16_t e = end < bandR ? end : bandR;
+    pushMapped(x, y, e - x, h);
+    x = e;
+  }
+  if (x < end)
+    pushSpan(_x + x, x, y, end - x, h);
+}
+
+void ytGraphCanvas::pushMapped(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  // the band is a ring in panel memory, a region may wrap around its end
+  int16_t m = ytGraphHwScrollMapX(*_hs, _x + x);
+  int16_t room = _hs->bandX + _hs->bandW - m;
+  int16_t first = w < room ? w : room;
+  pushSpan(m, x, y, first, h);
+  if (first < w)
+    pushSpan(_hs->bandX, x + first, y, w - first, h);
+}
+
+void ytGraphCanvas::pushSpan(int16_t tx, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  // columns x .. x + w - 1 to screen column tx, in ring mode they may wrap around the sprite end
+  int16_t p = _head + x;
+  if (p >= _period)
+    p -= _period;
+  int16_t first = w < _period - p ? w : _period - p;
+  _spr.pushSprite(tx, _y + y, p, y, first, h);
+  _lastRegions++;
+  if (first < w)
+  {
+    _spr.pushSprite(tx + first, _y + y, 0, y, w - first, h);
+    _lastRegions++;
+  }
+  _lastBytes += (uint32_t)w * h * 2;
+}
+
+/***************************************************************************************
+ * ytGraph functions drawing into a canvas
+****************************************************************************************/
+
+void ytGraph(ytGraphCanvas &Graph, uint16_t x, int16_t y, ytGraphChannel &ch)
+{
+  ytGraph(Graph, ytGraphScaleDefault, x, y, ch);
+}
+
+void ytGraph(ytGraphCanvas &Graph, const ytGraphScale &s, uint16_t x, int16_t y, ytGraphChannel &ch)
+{
+  YTGRAPH_STAGE(STATS_LINE);
+  int16_t ox = ch.ox, oy = ch.oy;
+  int16_t px = ytGraphMapX(s, x), py = ytGraphMapY(s, y);
+
+  int16_t x0 = ox < px ? ox : px, x1 = ox < px ? px : ox;
+  int16_t y0 = oy < py ? oy : py, y1 = oy < py ? py : oy;
+  int16_t org[2];
+  for (uint8_t i = 0, n = Graph.origins(x0, x1, org); i < n; i++)
+    ytGraphDrawSegment(Graph.sprite(), ox + org[i], oy, px + org[i], py, ch.color);
+  ch.ox = px;
+  ch.oy = py;
+
+  Graph.markDirty(x0, y0 - 1, x1 - x0 + 1, y1 - y0 + 3); // 3 px thick line
+}
+
+void ytGraphDrawColumn(ytGraphCanvas &Graph, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch)
+{
+  if (col.count == 0)
+    return;
+  int16_t first = ytGraphMapY(ytGraphScaleDefault, col.first);
+  int16_t top = ytGraphMapY(ytGraphScaleDefault, col.max), bottom = ytGraphMapY(ytGraphScaleDefault, col.min);
+  int16_t ox = px == 0 ? px : ch.ox, oy = px == 0 ? first : ch.oy; // new page at px = 0
+
+  int16_t x0 = ox < px ? ox : px;
+  int16_t org[2];
+  for (uint8_t i = 0, n = Graph.origins(x0, px, org); i < n; i++)
+  {
+    ytGraphDrawSegment(Graph.sprite(), ox + org[i], oy, px + org[i], first, ch.color);
+    if (bottom > top)
+      Graph.sprite().drawFastVLine(px + org[i], top - 1, bottom - top + 3, ch.color);
+  }
+  ch.ox = px;
+  ch.oy = ytGraphMapY(ytGraphScaleDefault, col.last);
+
+  int16_t y0 = oy < top ? oy : top, y1 = oy > bottom ? oy : bottom; // the span covers first, min and max
+  Graph.markDirty(x0, y0 - 1, px - x0 + 1, y1 - y0 + 3);
+}
+
+void ytGraphDrawGridXaxis(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t &LastXGridLinePos, char timeFormat)
+{
+  ytGraphDrawGridXaxis(Graph, xAxis, ytGraphLayoutDefault, LastXGridLinePos, timeFormat);
+}
+
+void ytGraphDrawGridXaxis(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, const ytGraphLayout &cfg, int16_t &LastXGridLinePos, char timeFormat)
+{
+  Graph.restart(); // everything is redrawn, the rings start over
+  xAxis.restart();
+  ytGraphDrawGridXaxis(Graph.sprite(), xAxis.sprite(), cfg, LastXGridLinePos, false, timeFormat);
+  Graph.markAll();
+  xAxis.markAll();
+  xAxis.push();
+  Graph.push();
+}
+
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t oox, int16_t &LastXGridLinePos)
+{
+  uint32_t xValue;
+  bool newDiv = ytGraphDynamicGridStep(LastXGridLinePos, xValue);
+  ytGraphDrawDynamicGrid(Graph, xAxis, oox, newDiv, xValue);
+}
+
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t oox, bool newDiv, uint32_t xValue)
+{
+  ytGraphDrawDynamicGrid(Graph, xAxis, ytGraphLayoutDefault, oox, newDiv, xValue);
+}
+
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, const ytGraphLayout &cfg, int16_t oox, bool newDiv, uint32_t xValue,
+                            ytGraphLabelCache *labels)
+{
+  YTGRAPH_STAGE(STATS_GRID);
+  // horizontal grid from oox on, new vertical grid line at the right end, new label right of it
+  int16_t x0 = oox < cfg.width ? oox : cfg.width;
+  int16_t x1 = oox + cfg.samples > cfg.width + 1 ? oox + cfg.samples : cfg.width + 1;
+  int16_t org[2];
+  for (uint8_t i = 0, n = Graph.origins(x0, x1 - 1, org); i < n; i++)
+    ytGraphDrawGridStrip(Graph.sprite(), cfg, oox, newDiv, org[i]);
+  Graph.markDirty(x0, 0, x1 - x0, cfg.spriteHeight());
+
+  if (!newDiv)
+    return;
+  for (uint8_t i = 0, n = xAxis.origins(cfg.width, xAxis.sprite().width() - 1, org); i < n; i++)
+    if (labels)
+      labels->draw(xAxis.sprite(), cfg.width + 5 + org[i], cfg.xAxisHeight() - 8, xValue); // like ytGraphDrawXaxisLabel()
+    else
+      ytGraphDrawXaxisLabel(xAxis.sprite(), cfg, xValue, org[i]);
+  xAxis.markDirty(cfg.width, 0, xAxis.width() - cfg.width, cfg.xAxisHeight());
+}
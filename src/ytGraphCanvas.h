@@ -0,0 +1,132 @@
+/***************************************************************************************
+ * Sprite wrapper with dirty tracking for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - remembers per sprite column which rows changed since the last push
+ *  - push() sends only the dirty regions instead of the whole sprite
+ *  - optional hardware scroll: the panel shifts a band of screen columns itself
+ *    (ILI9341 "vertical" scroll, which runs horizontally in landscape mode),
+ *    then only the newly exposed strip and the touched columns are sent
+ *  - optional ring mode: the sprite is a ring in x, scroll() only moves the head
+ *    column instead of every pixel, drawing goes to the wrapped columns and a
+ *    push of the whole width is split into (at most) two transfers
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_CANVAS_h
+#define YTGRAPH_CANVAS_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphLabels.h"
+
+#define CANVAS_MERGE_GAP 4 // clean columns between two dirty ones that are sent anyway (saves a window setup)
+#define CANVAS_LABEL_OVERRUN 72 // hidden ring columns of the x axis: the longest ytGraphFormatTime() label
+                                // starts at GRAPH_WIDTH + 5 and runs about 70 px over the sprite border
+
+struct ytGraphHwScroll // hardware scrolled band of screen columns
+{
+  TFT_eSPI *tft;
+  int16_t bandX;  // first screen column of the scroll area
+  int16_t bandW;  // number of columns in the scroll area
+  int16_t offset; // panel memory column shown at bandX, relative to bandX
+};
+
+// defines the scroll area on the panel (landscape), panelWidth is the width of the screen
+void ytGraphHwScrollBegin(ytGraphHwScroll &hs, TFT_eSPI &tft, int16_t bandX, int16_t bandW, int16_t panelWidth);
+void ytGraphHwScrollBy(ytGraphHwScroll &hs, int16_t dx); // moves the band content dx columns (negative = to the left)
+void ytGraphHwScrollEnd(ytGraphHwScroll &hs);            // back to normal addressing, the content is NOT restored
+int16_t ytGraphHwScrollMapX(const ytGraphHwScroll &hs, int16_t screenX); // panel memory column of a screen column
+
+class ytGraphCanvas
+{
+public:
+  ytGraphCanvas(TFT_eSprite &sprite, int16_t screenX, int16_t screenY);
+  ~ytGraphCanvas();
+
+  bool begin(); // call after createSprite(), allocates the column bookkeeping
+  // same, but the sprite is used as a ring in x. The last 'hidden' sprite columns are never
+  // shown, they take what is drawn over the right border (text) until it is scrolled away
+  bool beginRing(int16_t hidden = 0);
+  void setHwScroll(ytGraphHwScroll *hs) { _hs = hs; } // nullptr = software scroll only
+  void setBackground(uint16_t color) { _bg = color; }  // fills the scrolled in ring columns, GRAPH_BGRND_COLOR by default
+  void setArena(ytGraphArena *arena) { _arena = arena; } // for the column bookkeeping of begin(), nullptr = heap
+  static uint32_t bytes(int16_t spriteWidth) { return ytGraphArena::align(2 * spriteWidth * sizeof(int16_t)); } // of begin()
+
+  TFT_eSprite &sprite() { return _spr; }
+  int16_t screenX() const { return _x; }
+  int16_t screenY() const { return _y; }
+  int16_t width() const { return _w; } // visible columns
+
+  // x offsets to draw the sprite columns x0..x1 into the ring (one in normal mode)
+  // draw the same thing once per offset, the sprite clips away what does not belong there
+  uint8_t origins(int16_t x0, int16_t x1, int16_t *org) const;
+  void unwrap(); // rotates the ring back to head 0, afterwards plain sprite drawing works again
+
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h); // sprite coordinates
+  void markAll();
+  void markClean(); // the panel shows the sprite content (e.g. after a full pushSprite())
+
+  // like TFT_eSprite::scroll(dx), columns the panel did not shift itself become dirty
+  // with hardware scroll call ytGraphHwScrollBy() once per frame for all canvases
+  // in ring mode no pixel is moved, the scrolled in columns are filled with GRAPH_BGRND_COLOR
+  void scroll(int16_t dx);
+  void restart(); // ring mode: next drawing starts at head 0 (the caller redraws everything)
+
+  uint32_t push(); // sends the dirty regions, returns the number of pixel bytes
+
+  uint32_t lastPushBytes() const { return _lastBytes; }     // pixel bytes of the last push()
+  uint16_t lastPushRegions() const { return _lastRegions; } // window transfers of the last push()
+
+private:
+  void pushRect(int16_t x, int16_t y, int16_t w, int16_t h);
+  void pushMapped(int16_t x, int16_t y, int16_t w, int16_t h);
+  void pushSpan(int16_t tx, int16_t x, int16_t y, int16_t w, int16_t h);
+  void fillColumns(int16_t x, int16_t w);
+
+  TFT_eSprite &_spr;
+  ytGraphHwScroll *_hs;
+  ytGraphArena *_arena;
+  int16_t _x, _y;       // screen position of the sprite
+  int16_t _w, _h;       // visible sprite size
+  bool _ring;
+  int16_t _period;      // ring mode: sprite width incl. hidden columns
+  int16_t _head;        // ring mode: sprite column of visible column 0
+  uint16_t _bg;
+  int16_t *_top;        // first dirty row per column, _top > _bottom = clean
+  int16_t *_bottom;     // last dirty row per column
+  uint32_t _lastBytes;
+  uint16_t _lastRegions;
+};
+
+void ytGraph(ytGraphCanvas &Graph, uint16_t x, int16_t y, ytGraphChannel &ch);
+void ytGraph(ytGraphCanvas &Graph, const ytGraphScale &s, uint16_t x, int16_t y, ytGraphChannel &ch);
+void ytGraphDrawColumn(ytGraphCanvas &Graph, int16_t px, const ytGraphColumn &col, ytGraphChannel &ch);
+void ytGraphDrawGridXaxis(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t &LastXGridLinePos, char timeFormat = SAMPLE_TIME_FORMAT);
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t oox, int16_t &LastXGridLinePos);
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, int16_t oox, bool newDiv, uint32_t xValue); // drawing part only
+// the same for any configuration (see ytGraphInstance)
+void ytGraphDrawGridXaxis(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, const ytGraphLayout &cfg, int16_t &LastXGridLinePos, char timeFormat);
+// labels: the new x axis label is copied from the cache instead of printed (nullptr = print)
+void ytGraphDrawDynamicGrid(ytGraphCanvas &Graph, ytGraphCanvas &xAxis, const ytGraphLayout &cfg, int16_t oox, bool newDiv, uint32_t xValue,
+                            ytGraphLabelCache *labels = nullptr);
+
+template <typename T, uint32_t N, typename Value>
+void ytGraphDrawHistory(ytGraphCanvas &Graph, const ytGraphRing<T, N> &ring, ytGraphChannel *ch, uint8_t channels, Value value)
+{
+  Graph.unwrap(); // the series is drawn with plain sprite coordinates
+  ytGraphSeries(Graph.sprite(), ch, channels, ring, value);
+  Graph.markAll();
+  Graph.push();
+}
+
+#endif
@@ -0,0 +1,122 @@
+/***************************************************************************************
+ * Channel store (structure of arrays) for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - one contiguous int16_t history per channel instead of one struct per sample
+ *    with mixed float/int8_t fields, all channels share the ring head
+ *  - the render pass reads the channels column by column (ytGraphSpanChannels()):
+ *    all values of one x are mapped in one batch, then every channel writes its
+ *    span into the same sprite column while it is in cache
+ *  - up to 16 channels (SPAN_CHANNELS), the colours of a 4 bit sprite
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_CHANNELS_h
+#define YTGRAPH_CHANNELS_h
+
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphSpan.h"
+
+template <uint8_t C, uint32_t N>
+class ytGraphChannelStore
+{
+  static_assert(C > 0 && C <= SPAN_CHANNELS, "ytGraphChannelStore holds 1 to 16 channels");
+  static_assert(N > 0, "ytGraphChannelStore needs at least one slot");
+
+public:
+  ytGraphChannelStore() : _head(0), _count(0), _y{} {}
+
+  void clear()
+  {
+    _head = 0;
+    _count = 0;
+  }
+
+  void push(const int16_t *y) // one sample of every channel, overwrites the oldest one if full
+  {
+    YTGRAPH_STAGE(STATS_INGEST);
+    for (uint8_t c = 0; c < C; c++)
+      _y[c][_head] = y[c];
+    if (++_head == N)
+      _head = 0;
+    if (_count < N)
+      _count++;
+  }
+
+  int16_t value(uint8_t channel, uint32_t i) const { return _y[channel][slot(i)]; } // 0 = oldest
+  int16_t newest(uint8_t channel) const { return _y[channel][_head ? _head - 1 : N - 1]; }
+  void column(uint32_t i, int16_t *y) const // all channels of sample i
+  {
+    uint32_t s = slot(i);
+    for (uint8_t c = 0; c < C; c++)
+      y[c] = _y[c][s];
+  }
+
+  // samples first..first + n - 1 of every channel as (at most) two contiguous runs, oldest first
+  // rows[c] points to the first run of channel c, the second one starts at row(c)
+  uint32_t runs(uint32_t first, uint32_t n, const int16_t **rows, uint32_t &firstLen) const
+  {
+    uint32_t start = slot(first);
+    firstLen = start + n <= N ? n : N - start;
+    for (uint8_t c = 0; c < C; c++)
+      rows[c] = &_y[c][start];
+    return n - firstLen;
+  }
+  const int16_t *row(uint8_t channel) const { return _y[channel]; }
+
+  uint32_t size() const { return _count; }
+  static constexpr uint32_t capacity() { return N; }
+  static constexpr uint8_t channels() { return C; }
+  bool full() const { return _count == N; }
+  bool empty() const { return _count == 0; }
+
+private:
+  uint32_t slot(uint32_t i) const
+  {
+    uint32_t s = _head + N - _count + i; // always < 2N, no division in the hot path
+    if (s >= N)
+      s -= N;
+    return s;
+  }
+
+  uint32_t _head;  // next write position
+  uint32_t _count; // number of valid samples
+  int16_t _y[C][N];
+};
+
+// draws samples first..first + n - 1 of all channels at x = firstX, firstX + 1, ... column by column, no push
+// at firstX = 0 the lines start at the first sample (new page), otherwise at ch[c].ox/ch[c].oy
+template <uint8_t C, uint32_t N>
+void ytGraphDrawChannels(TFT_eSprite &Graph, const ytGraphChannelStore<C, N> &s, ytGraphChannel *ch, uint16_t firstX,
+                         uint32_t first, uint32_t n, uint8_t width = SPAN_WIDTH, bool aa = false)
+{
+  const int16_t *rows[C], *rows2[C];
+  uint32_t len;
+  uint32_t rest = s.runs(first, n, rows, len);
+  for (uint8_t c = 0; c < C; c++)
+    rows2[c] = s.row(c);
+  ytGraphSpanChannels(Graph, ch, C, firstX, rows, len, rows2, rest, width, aa); // one pass over the seam of the ring
+}
+
+// redraws the whole history of all channels and pushes the sprite only once
+template <uint8_t C, uint32_t N>
+void ytGraphDrawChannels(ytGraphCanvas &Graph, const ytGraphChannelStore<C, N> &s, ytGraphChannel *ch,
+                         uint8_t width = SPAN_WIDTH, bool aa = false)
+{
+  Graph.unwrap(); // drawn with plain sprite coordinates
+  ytGraphDrawChannels(Graph.sprite(), s, ch, 0, 0, s.size(), width, aa);
+  Graph.markAll();
+  Graph.push();
+}
+
+#endif
@@ -0,0 +1,89 @@
+/***************************************************************************************
+ * Decimation of high rate signals for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphDecimate.h"
+
+uint16_t ytGraphDecimateM4(const int16_t *in, uint32_t n, ytGraphColumn *out, uint16_t columns)
+{
+  ytGraphDecimator d(n, columns);
+  uint16_t k = 0;
+  for (uint32_t i = 0; i < n && k < columns; i++)
+    if (d.add(in[i]))
+      out[k++] = d.column();
+  if (k < columns && d.flush())
+    out[k++] = d.column();
+  return k;
+}
+
+uint16_t ytGraphLTTB(const int16_t *in, uint32_t n, uint16_t *px, int16_t *y, uint16_t points, uint16_t columns)
+{
+  if (n <= points || points < 3) // nothing to reduce (or no room for a middle bucket)
+  {
+    uint32_t m = n < points ? n : points;
+    for (uint32_t i = 0; i < m; i++)
+    {
+      uint32_t s = (m < n && m > 1) ? (uint32_t)((uint64_t)i * (n - 1) / (m - 1)) : i;
+      px[i] = (uint64_t)s * columns / n;
+      y[i] = in[s];
+    }
+    return m;
+  }
+
+  // the first and the last sample are kept, the rest is split into points - 2 buckets
+  // of all candidates in a bucket the one with the largest triangle area between the
+  // point chosen before and the average of the next bucket wins
+  uint32_t a = 0; // chosen point of the bucket before
+  px[0] = 0;
+  y[0] = in[0];
+  uint32_t buckets = points - 2;
+  for (uint32_t b = 0; b < buckets; b++)
+  {
+    uint32_t start = 1 + (uint64_t)b * (n - 2) / buckets;
+    uint32_t end = 1 + (uint64_t)(b + 1) * (n - 2) / buckets; // exclusive
+    uint32_t nextEnd = 1 + (uint64_t)(b + 2) * (n - 2) / buckets;
+    if (b + 1 == buckets)
+      nextEnd = n; // the last "bucket" is the last sample
+
+    // average of the next bucket, kept as sums to stay in integers
+    int64_t cnt = nextEnd - end, sumX = 0, sumY = 0;
+    for (uint32_t i = end; i < nextEnd; i++)
+    {
+      sumX += i;
+      sumY += in[i];
+    }
+
+    // area * 2 * cnt = |(ax - bx) * (cy - ay) - (ax - cx) * (by - ay)| * cnt
+    int64_t ax = a, ay = in[a];
+    int64_t best = -1;
+    uint32_t pick = start;
+    for (uint32_t i = start; i < end; i++)
+    {
+      int64_t area = (ax - (int64_t)i) * (sumY - ay * cnt) - (ax * cnt - sumX) * (in[i] - ay);
+      if (area < 0)
+        area = -area;
+      if (area > best)
+      {
+        best = area;
+        pick = i;
+      }
+    }
+    a = pick;
+    px[b + 1] = (uint64_t)pick * columns / n;
+    y[b + 1] = in[pick];
+  }
+  px[points - 1] = (uint64_t)(n - 1) * columns / n;
+  y[points - 1] = in[n - 1];
+  return points;
+}
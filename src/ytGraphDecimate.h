@@ -0,0 +1,104 @@
+/***************************************************************************************
+ * Decimation of high rate signals for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - M4: any number of raw samples per pixel column is reduced to
+ *    first/min/max/last, so spikes are never lost and the drawing cost
+ *    depends on the graph width, not on the sample rate
+ *  - streaming (one sample at a time) or in bulk from an array
+ *  - LTTB (largest triangle three buckets) as alternative, gives a smooth
+ *    polyline of a fixed number of points instead of min/max spans
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_DECIMATE_h
+#define YTGRAPH_DECIMATE_h
+
+#include <stdint.h>
+
+struct ytGraphColumn // all raw samples of one pixel column
+{
+  int16_t first; // value where the line comes in
+  int16_t min;
+  int16_t max;
+  int16_t last;   // value where the line goes on to the next column
+  uint16_t count; // number of raw samples, 0 = empty column
+};
+
+// streaming M4 reduction: 'samples' raw samples are spread evenly over 'columns' pixel columns
+// (e.g. 100 Hz for 60 s on 240 px = 6000 / 240), fractional ratios alternate the column size
+class ytGraphDecimator
+{
+public:
+  ytGraphDecimator(uint32_t samples = 1, uint16_t columns = 1) { setRatio(samples, columns); }
+
+  void setRatio(uint32_t samples, uint16_t columns)
+  {
+    _samples = samples ? samples : 1;
+    _columns = columns ? columns : 1;
+    reset();
+  }
+
+  void reset()
+  {
+    _acc = 0;
+    _cur.count = 0;
+  }
+
+  bool add(int16_t v) // true if a column is complete, read it with column()
+  {
+    if (_cur.count == 0)
+      _cur.first = _cur.min = _cur.max = v;
+    else if (v < _cur.min)
+      _cur.min = v;
+    else if (v > _cur.max)
+      _cur.max = v;
+    _cur.last = v;
+    _cur.count++;
+
+    _acc += _columns;
+    if (_acc < _samples)
+      return false;
+    _acc -= _samples;
+    _done = _cur;
+    _cur.count = 0;
+    return true;
+  }
+
+  bool flush() // completes a partly filled column, false if there is none
+  {
+    if (_cur.count == 0)
+      return false;
+    _done = _cur;
+    reset();
+    return true;
+  }
+
+  const ytGraphColumn &column() const { return _done; }
+
+private:
+  uint32_t _samples;
+  uint16_t _columns;
+  uint32_t _acc; // Bresenham style column boundary
+  ytGraphColumn _cur{};
+  ytGraphColumn _done{};
+};
+
+// bulk M4: n raw samples to 'columns' columns, returns the number of columns written
+uint16_t ytGraphDecimateM4(const int16_t *in, uint32_t n, ytGraphColumn *out, uint16_t columns);
+
+// LTTB: picks 'points' of the n raw samples (always the first and the last one)
+// px gets the pixel column of each point (index * columns / n), y its raw value
+// returns the number of points written (n if n <= points)
+uint16_t ytGraphLTTB(const int16_t *in, uint32_t n, uint16_t *px, int16_t *y, uint16_t points, uint16_t columns);
+
+#endif
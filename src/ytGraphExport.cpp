@@ -0,0 +1,361 @@
+/***************************************************************************************
+ * Frame export for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphExport.h"
+#include "ytGraphSpan.h"
+
+/***************************************************************************************
+ * encoder
+****************************************************************************************/
+
+ytGraphFrameExport::ytGraphFrameExport()
+    : _out(nullptr), _arena(nullptr), _ref(nullptr), _changed(nullptr), _w(0), _h(0), _colBytes(0), _key(true), _frames(0),
+      _lastColumns(0), _lastSpans(0), _written(0), _n(0)
+{
+}
+
+uint32_t ytGraphFrameExport::bytes(int16_t width, int16_t height)
+{
+  return ytGraphArena::align((uint32_t)width * ((height + 1) / 2) + (width + 7) / 8);
+}
+
+bool ytGraphFrameExport::begin(Print &out, TFT_eSprite &Graph, int16_t width, ytGraphArena *arena)
+{
+  end();
+  if (Graph.getColorDepth() != 4 || width <= 0 || width > Graph.width())
+    return false;
+  _arena = arena;
+  _w = width;
+  _h = Graph.height();
+  _colBytes = (_h + 1) / 2;
+  _ref = (uint8_t *)ytGraphAlloc(_arena, bytes(_w, _h)); // one block for the frame and the column bits
+  if (!_ref)
+    return false;
+  _changed = _ref + (uint32_t)_w * _colBytes;
+  _out = &out;
+  _key = true;
+  _frames = 0;
+
+  _n = 0;
+  _written = 0;
+  const char *magic = "YTFX";
+  for (uint8_t i = 0; i < 4; i++)
+    put(magic[i]);
+  put(EXPORT_VERSION);
+  put(_w & 0xFF);
+  put(_w >> 8);
+  put(_h & 0xFF);
+  put(_h >> 8);
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    uint16_t c = Graph.getPaletteColor(i);
+    put(c & 0xFF);
+    put(c >> 8);
+  }
+  flush();
+  return true;
+}
+
+void ytGraphFrameExport::end()
+{
+  ytGraphFree(_arena, _ref);
+  _ref = nullptr;
+  _changed = nullptr;
+  _out = nullptr;
+}
+
+void ytGraphFrameExport::put(uint8_t b)
+{
+  _buf[_n++] = b;
+  if (_n == sizeof(_buf))
+    flush();
+}
+
+void ytGraphFrameExport::flush()
+{
+  if (_n)
+    _written += _out->write(_buf, _n);
+  _n = 0;
+}
+
+size_t ytGraphFrameExport::frame(TFT_eSprite &Graph, int16_t dx, uint32_t time)
+{
+  return encode(Graph, 0, Graph.width(), dx, time);
+}
+
+size_t ytGraphFrameExport::frame(ytGraphCanvas &Graph, int16_t dx, uint32_t time)
+{
+  int16_t org[2];
+  Graph.origins(0, 0, org); // visible column 0 is stored at the ring head
+  return encode(Graph.sprite(), org[0], Graph.sprite().width(), dx, time);
+}
+
+size_t ytGraphFrameExport::encode(TFT_eSprite &Graph, int16_t head, int16_t period, int16_t dx, uint32_t time)
+{
+  ytGraphSpanTarget t;
+  if (!_ref || !ytGraphSpanBegin(Graph, t) || t.bpp != 4 || t.height < _h || period < _w)
+    return 0;
+  bool key = _key || !_frames;
+  int32_t cb = _colBytes;
+
+  // move the last frame like the panel content, the scrolled in columns start as index 0
+  if (!key && dx)
+  {
+    if (dx <= -_w || dx >= _w)
+      memset(_ref, 0, _w * cb);
+    else if (dx < 0)
+    {
+      memmove(_ref, _ref - dx * cb, (_w + dx) * cb);
+      memset(_ref + (_w + dx) * cb, 0, -dx * cb);
+    }
+    else
+    {
+      memmove(_ref + dx * cb, _ref, (_w - dx) * cb);
+      memset(_ref, 0, dx * cb);
+    }
+  }
+
+  // compare column by column, the last frame takes the new content
+  uint16_t columns = 0, spans = 0;
+  bool last = false;
+  for (int16_t x = 0; x < _w; x++)
+  {
+    int16_t sx = head + x < period ? head + x : head + x - period;
+    const uint8_t *p = t.img + (sx >> 1);
+    uint8_t shift = sx & 1 ? 0 : 4; // even x in the high nibble
+    uint8_t *r = _ref + x * cb;
+    bool diff = key;
+    for (int16_t y = 0; y < _h; y += 2, r++)
+    {
+      uint8_t hi = (p[y * t.stride] >> shift) & 0x0F;
+      uint8_t lo = y + 1 < _h ? (p[(y + 1) * t.stride] >> shift) & 0x0F : 0;
+      uint8_t b = hi << 4 | lo;
+      if (b != *r)
+      {
+        *r = b;
+        diff = true;
+      }
+    }
+    if (diff)
+      _changed[x >> 3] |= 1 << (x & 7);
+    else
+      _changed[x >> 3] &= ~(1 << (x & 7));
+    columns += diff;
+    spans += diff && !last;
+    last = diff;
+  }
+
+  _n = 0;
+  _written = 0;
+  put(key ? EXPORT_KEY : EXPORT_DELTA);
+  for (uint8_t i = 0; i < 4; i++)
+    put(time >> (8 * i));
+  put((uint16_t)dx & 0xFF);
+  put((uint16_t)dx >> 8);
+  put(spans & 0xFF);
+  put(spans >> 8);
+
+  for (int16_t x0 = 0; x0 < _w;)
+  {
+    if (!(_changed[x0 >> 3] & (1 << (x0 & 7))))
+    {
+      x0++;
+      continue;
+    }
+    int16_t x1 = x0;
+    while (x1 + 1 < _w && (_changed[(x1 + 1) >> 3] & (1 << ((x1 + 1) & 7))))
+      x1++;
+    int16_t w = x1 - x0 + 1;
+    put(x0 & 0xFF);
+    put(x0 >> 8);
+    put(w & 0xFF);
+    put(w >> 8);
+
+    // runs over the pixels of the span, column by column
+    uint8_t run = 0, idx = 0;
+    auto emit = [&]()
+    {
+      if (run <= 15)
+        put((run - 1) << 4 | idx);
+      else
+      {
+        put(0xF0 | idx);
+        put(run - 16);
+      }
+    };
+    for (int16_t x = x0; x <= x1; x++)
+    {
+      const uint8_t *r = _ref + x * cb;
+      for (int16_t y = 0; y < _h; y++)
+      {
+        uint8_t v = y & 1 ? r[y >> 1] & 0x0F : r[y >> 1] >> 4;
+        if (run && (v != idx || run == 255))
+        {
+          emit();
+          run = 0;
+        }
+        idx = v;
+        run++;
+      }
+    }
+    emit();
+    x0 = x1 + 1;
+  }
+  flush();
+
+  _key = false;
+  _frames++;
+  _lastColumns = columns;
+  _lastSpans = spans;
+  return _written;
+}
+
+/***************************************************************************************
+ * decoder
+****************************************************************************************/
+
+ytGraphFrameDecoder::ytGraphFrameDecoder()
+    : _data(nullptr), _size(0), _pos(0), _arena(nullptr), _img(nullptr), _w(0), _h(0), _palette{}, _frames(0), _time(0), _isKey(false)
+{
+}
+
+bool ytGraphFrameDecoder::read(size_t n, uint32_t &v) // n bytes, little endian
+{
+  if (_pos + n > _size)
+    return false;
+  v = 0;
+  for (size_t i = 0; i < n; i++)
+    v |= (uint32_t)_data[_pos++] << (8 * i);
+  return true;
+}
+
+bool ytGraphFrameDecoder::begin(const uint8_t *data, size_t size, ytGraphArena *arena)
+{
+  end();
+  _data = data;
+  _size = size;
+  _pos = 0;
+  _frames = 0;
+  if (size < EXPORT_HEADER_BYTES || memcmp(data, "YTFX", 4) || data[4] != EXPORT_VERSION)
+    return false;
+  _pos = 5;
+  uint32_t w = 0, h = 0, c = 0;
+  read(2, w);
+  read(2, h);
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    read(2, c);
+    _palette[i] = c;
+  }
+  if (!w || !h || w > 0x7FFF || h > 0x7FFF)
+    return false;
+  _arena = arena;
+  _img = (uint8_t *)ytGraphAlloc(_arena, w * h);
+  if (!_img)
+    return false;
+  _w = w;
+  _h = h;
+  memset(_img, 0, w * h);
+  return true;
+}
+
+void ytGraphFrameDecoder::end()
+{
+  ytGraphFree(_arena, _img);
+  _img = nullptr;
+  _w = _h = 0;
+}
+
+bool ytGraphFrameDecoder::next()
+{
+  uint32_t tag, time, dx, spans;
+  if (!_img || !read(1, tag) || (tag != EXPORT_KEY && tag != EXPORT_DELTA) || !read(4, time) || !read(2, dx) || !read(2, spans))
+    return false;
+  _isKey = tag == EXPORT_KEY;
+  _time = time;
+
+  // move the last frame, the scrolled in columns start as index 0
+  int16_t d = (int16_t)dx;
+  if (_isKey || d <= -_w || d >= _w)
+    memset(_img, 0, (int32_t)_w * _h);
+  else if (d)
+    for (int16_t y = 0; y < _h; y++)
+    {
+      uint8_t *row = _img + (int32_t)y * _w;
+      if (d < 0)
+      {
+        memmove(row, row - d, _w + d);
+        memset(row + _w + d, 0, -d);
+      }
+      else
+      {
+        memmove(row + d, row, _w - d);
+        memset(row, 0, d);
+      }
+    }
+
+  for (uint32_t s = 0; s < spans; s++)
+  {
+    uint32_t x0, w;
+    if (!read(2, x0) || !read(2, w) || !w || x0 + w > (uint32_t)_w)
+      return false;
+    uint32_t total = w * _h, p = 0;
+    while (p < total)
+    {
+      uint32_t b, extra;
+      if (!read(1, b))
+        return false;
+      uint32_t run = (b >> 4) + 1;
+      if (run == 16)
+      {
+        if (!read(1, extra))
+          return false;
+        run += extra;
+      }
+      if (p + run > total)
+        return false;
+      for (; run; run--, p++) // column by column
+        _img[(p % _h) * _w + x0 + p / _h] = b & 0x0F;
+    }
+  }
+  _frames++;
+  return true;
+}
+
+size_t ytGraphFrameDecoder::ppm(Print &out) const
+{
+  if (!_img)
+    return 0;
+  size_t n = out.print("P6\n");
+  n += out.print((int)_w);
+  n += out.print(' ');
+  n += out.print((int)_h);
+  n += out.print("\n255\n");
+  uint8_t rgb[3 * 64];
+  for (int16_t y = 0; y < _h; y++)
+    for (int16_t x = 0; x < _w; x += 64)
+    {
+      uint8_t k = 0;
+      for (int16_t i = x; i < _w && i < x + 64; i++)
+      {
+        uint16_t c = color(i, y);
+        rgb[k++] = ((c >> 11) & 0x1F) * 255 / 31;
+        rgb[k++] = ((c >> 5) & 0x3F) * 255 / 63;
+        rgb[k++] = (c & 0x1F) * 255 / 31;
+      }
+      n += out.write(rgb, k);
+    }
+  return n;
+}
@@ -0,0 +1,128 @@
+/***************************************************************************************
+ * Frame export for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - records what a 4 bit graph sprite shows, frame by frame, as a compact byte
+ *    stream on any Print (Serial, a flash file, stdout on the host)
+ *  - every frame is a delta against the last one: the scroll offset, then only the
+ *    columns that changed after scrolling, run length encoded column by column
+ *  - the encoder keeps the last frame column by column (4 bit packed), so scrolling
+ *    is a memmove and finding a changed column a memcmp: bounded time per frame
+ *  - ytGraphFrameDecoder rebuilds the frames from the stream (e.g. on the host,
+ *    see the -x option of the benchmark) and writes them as PPM pictures
+ *
+ * stream (little endian):
+ *   header  "YTFX", version (1 byte), width (2), height (2), 16 palette colours (2 each, 565)
+ *   frame   EXPORT_KEY or EXPORT_DELTA (1), time (4), dx (2), number of spans (2), spans
+ *   span    first column (2), columns (2), runs over the pixels of these columns (top to bottom,
+ *           left to right): one byte = run length - 1 (high nibble) and palette index (low nibble),
+ *           high nibble 15: run length = 16 + the next byte
+ *   a delta frame moves the last frame by dx columns (negative = to the left) and fills the
+ *   scrolled in columns with index 0 before the spans are applied, a key frame starts from index 0
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_EXPORT_h
+#define YTGRAPH_EXPORT_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphCanvas.h"
+
+#define EXPORT_VERSION 1
+#define EXPORT_KEY 'K'   // frame with every column
+#define EXPORT_DELTA 'F' // frame with the changed columns only
+#define EXPORT_HEADER_BYTES 41
+#define EXPORT_FRAME_BYTES 9
+
+class ytGraphFrameExport
+{
+public:
+  ytGraphFrameExport();
+  ~ytGraphFrameExport() { end(); }
+
+  // writes the stream header with the palette of the sprite, width = visible columns (e.g. of a ring canvas)
+  // false if the sprite is no 4 bit sprite or there is no memory, arena = nullptr: from the heap
+  bool begin(Print &out, TFT_eSprite &Graph, int16_t width, ytGraphArena *arena = nullptr);
+  bool begin(Print &out, ytGraphCanvas &Graph, ytGraphArena *arena = nullptr) { return begin(out, Graph.sprite(), Graph.width(), arena); }
+  void end();
+  static uint32_t bytes(int16_t width, int16_t height); // of begin()
+
+  void key() { _key = true; } // the next frame is sent complete, e.g. for a receiver that starts late
+
+  // one frame, call it after drawing: dx = the scroll since the last frame, time e.g. millis()
+  // returns the bytes written
+  size_t frame(TFT_eSprite &Graph, int16_t dx, uint32_t time);
+  size_t frame(ytGraphCanvas &Graph, int16_t dx, uint32_t time); // the visible columns, also in ring mode
+
+  bool active() const { return _out != nullptr; } // between begin() and end(), the Print carries the stream only
+  uint32_t frames() const { return _frames; }
+  uint16_t lastColumns() const { return _lastColumns; } // changed columns of the last frame
+  uint16_t lastSpans() const { return _lastSpans; }
+
+private:
+  size_t encode(TFT_eSprite &Graph, int16_t head, int16_t period, int16_t dx, uint32_t time);
+  void put(uint8_t b);
+  void flush();
+
+  Print *_out;
+  ytGraphArena *_arena;
+  uint8_t *_ref;     // the last frame, column by column, two rows per byte
+  uint8_t *_changed; // one bit per column
+  int16_t _w, _h;
+  int16_t _colBytes;
+  bool _key;
+  uint32_t _frames;
+  uint16_t _lastColumns;
+  uint16_t _lastSpans;
+  size_t _written;
+  uint8_t _buf[64]; // bytes to the Print in chunks
+  uint8_t _n;
+};
+
+class ytGraphFrameDecoder
+{
+public:
+  ytGraphFrameDecoder();
+  ~ytGraphFrameDecoder() { end(); }
+
+  // data = the whole stream, false if the header is wrong or there is no memory for one frame
+  bool begin(const uint8_t *data, size_t size, ytGraphArena *arena = nullptr);
+  void end();
+
+  bool next(); // decodes the next frame, false at the end of the stream or at a broken frame
+
+  int16_t width() const { return _w; }
+  int16_t height() const { return _h; }
+  uint32_t frames() const { return _frames; }
+  uint32_t time() const { return _time; } // of the current frame
+  bool isKey() const { return _isKey; }
+  uint8_t index(int16_t x, int16_t y) const { return _img[(int32_t)y * _w + x]; }
+  uint16_t color(int16_t x, int16_t y) const { return _palette[index(x, y)]; }
+
+  size_t ppm(Print &out) const; // the current frame as binary PPM (P6)
+
+private:
+  bool read(size_t n, uint32_t &v);
+
+  const uint8_t *_data;
+  size_t _size, _pos;
+  ytGraphArena *_arena;
+  uint8_t *_img; // palette index per pixel, row by row
+  int16_t _w, _h;
+  uint16_t _palette[16];
+  uint32_t _frames;
+  uint32_t _time;
+  bool _isKey;
+};
+
+#endif
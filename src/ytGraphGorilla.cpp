@@ -0,0 +1,191 @@
+/***************************************************************************************
+ * Compressed sample history for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphGorilla.h"
+
+#define GORILLA_WORST_TIME 36 // '1111' + 32 bit delta of delta
+#define GORILLA_WORST_VALUE 43 // '11' + 5 bit leading zeros + 5 bit length + 32 bit
+
+static inline uint32_t floatBits(float f)
+{
+  uint32_t u;
+  memcpy(&u, &f, 4);
+  return u;
+}
+
+static inline float bitsFloat(uint32_t u)
+{
+  float f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+void ytGraphGorillaBlock::begin(uint8_t *buf, uint16_t bytes, uint8_t channels)
+{
+  _buf = buf;
+  _bytes = bytes;
+  _channels = channels < GORILLA_MAX_CHANNELS ? channels : GORILLA_MAX_CHANNELS;
+  clear();
+}
+
+void ytGraphGorillaBlock::clear()
+{
+  memset(_buf, 0, _bytes); // write() only sets bits
+  _bits = 0;
+  _count = 0;
+  _firstTime = _t = 0;
+  _delta = 0;
+}
+
+void ytGraphGorillaBlock::write(uint32_t value, uint8_t n)
+{
+  while (n)
+  {
+    uint8_t free = 8 - (_bits & 7);
+    uint8_t take = n < free ? n : free;
+    _buf[_bits >> 3] |= ((value >> (n - take)) & ((1u << take) - 1)) << (free - take);
+    _bits += take;
+    n -= take;
+  }
+}
+
+bool ytGraphGorillaBlock::append(uint32_t t, const float *v)
+{
+  if (_bits + GORILLA_WORST_TIME + (uint32_t)_channels * GORILLA_WORST_VALUE > (uint32_t)_bytes * 8)
+    return false;
+
+  if (_count == 0) // the first sample is stored as it is
+  {
+    write(t, 32);
+    _firstTime = t;
+    for (uint8_t c = 0; c < _channels; c++)
+    {
+      _v[c] = floatBits(v[c]);
+      _lead[c] = 0xFF; // no window yet
+      write(_v[c], 32);
+    }
+  }
+  else
+  {
+    // timestamp: delta of delta, regular intervals cost one bit
+    int32_t delta = (int32_t)(t - _t);
+    int32_t dod = delta - _delta;
+    _delta = delta;
+    if (dod == 0)
+      write(0, 1);
+    else if (dod >= -64 && dod <= 63)
+      write(0x2, 2), write(dod, 7);
+    else if (dod >= -256 && dod <= 255)
+      write(0x6, 3), write(dod, 9);
+    else if (dod >= -2048 && dod <= 2047)
+      write(0xE, 4), write(dod, 12);
+    else
+      write(0xF, 4), write(dod, 32);
+
+    // values: XOR with the value before, only the meaningful bits are stored
+    for (uint8_t c = 0; c < _channels; c++)
+    {
+      uint32_t u = floatBits(v[c]);
+      uint32_t x = u ^ _v[c];
+      _v[c] = u;
+      if (x == 0)
+      {
+        write(0, 1);
+        continue;
+      }
+      uint8_t lead = __builtin_clz(x), trail = __builtin_ctz(x);
+      if (_lead[c] != 0xFF && lead >= _lead[c] && trail >= _trail[c]) // fits into the window before
+      {
+        write(0x2, 2);
+        write(x >> _trail[c], 32 - _lead[c] - _trail[c]);
+      }
+      else
+      {
+        uint8_t len = 32 - lead - trail;
+        write(0x3, 2);
+        write(lead, 5);
+        write(len - 1, 5);
+        write(x >> trail, len);
+        _lead[c] = lead;
+        _trail[c] = trail;
+      }
+    }
+  }
+  _t = t;
+  _count++;
+  return true;
+}
+
+ytGraphGorillaBlock::Reader::Reader(const ytGraphGorillaBlock &b)
+    : _b(b), _in(b._buf), _left(b._count), _t(0), _delta(0)
+{
+}
+
+static inline int32_t signExtend(uint32_t v, uint8_t n)
+{
+  return n == 32 ? (int32_t)v : (int32_t)(v << (32 - n)) >> (32 - n);
+}
+
+bool ytGraphGorillaBlock::Reader::next(uint32_t &t, float *v)
+{
+  if (!_left)
+    return false;
+
+  if (_left == _b._count) // first sample
+  {
+    _t = _in.read(32);
+    for (uint8_t c = 0; c < _b._channels; c++)
+    {
+      _v[c] = _in.read(32);
+      _lead[c] = 0;
+      _len[c] = 0;
+    }
+  }
+  else
+  {
+    int32_t dod = 0;
+    if (_in.bit())
+    {
+      if (!_in.bit())
+        dod = signExtend(_in.read(7), 7);
+      else if (!_in.bit())
+        dod = signExtend(_in.read(9), 9);
+      else if (!_in.bit())
+        dod = signExtend(_in.read(12), 12);
+      else
+        dod = (int32_t)_in.read(32);
+    }
+    _delta += dod;
+    _t += _delta;
+
+    for (uint8_t c = 0; c < _b._channels; c++)
+    {
+      if (!_in.bit())
+        continue; // same value
+      if (_in.bit()) // new window
+      {
+        _lead[c] = _in.read(5);
+        _len[c] = _in.read(5) + 1;
+      }
+      _v[c] ^= _in.read(_len[c]) << (32 - _lead[c] - _len[c]);
+    }
+  }
+
+  t = _t;
+  for (uint8_t c = 0; c < _b._channels; c++)
+    v[c] = bitsFloat(_v[c]);
+  _left--;
+  return true;
+}
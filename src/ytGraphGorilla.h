@@ -0,0 +1,217 @@
+/***************************************************************************************
+ * Compressed sample history for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - Gorilla style time series blocks (Facebook's in-memory TSDB, VLDB 2015):
+ *    timestamps as delta of delta, float values XOR'ed with the value before
+ *  - a regular timestamp costs 1 bit, an unchanged value 1 bit
+ *  - streaming append, forward decoding while drawing (no decode buffer)
+ *  - ytGraphGorillaHistory keeps a ring of blocks, the oldest block is dropped
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_GORILLA_h
+#define YTGRAPH_GORILLA_h
+
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+
+#define GORILLA_MAX_CHANNELS 16
+
+class ytGraphBitReader // MSB first
+{
+public:
+  ytGraphBitReader(const uint8_t *buf = nullptr) : _buf(buf), _pos(0) {}
+
+  uint32_t read(uint8_t n) // n = 1..32
+  {
+    uint32_t v = 0;
+    while (n)
+    {
+      uint8_t free = 8 - (_pos & 7);
+      uint8_t take = n < free ? n : free;
+      uint8_t b = _buf[_pos >> 3] >> (free - take);
+      v = (v << take) | (b & ((1u << take) - 1));
+      _pos += take;
+      n -= take;
+    }
+    return v;
+  }
+
+  bool bit() { return (_buf[_pos >> 3] >> (7 - (_pos++ & 7))) & 1; }
+
+  uint32_t position() const { return _pos; }
+
+private:
+  const uint8_t *_buf;
+  uint32_t _pos; // in bits
+};
+
+// one block of samples with all channels, the memory comes from the caller
+class ytGraphGorillaBlock
+{
+public:
+  void begin(uint8_t *buf, uint16_t bytes, uint8_t channels);
+  void clear();
+
+  bool append(uint32_t t, const float *v); // false if the block is full, the sample is not stored then
+
+  uint16_t count() const { return _count; }
+  uint16_t bytesUsed() const { return (_bits + 7) >> 3; }
+  uint8_t channels() const { return _channels; }
+  uint32_t firstTime() const { return _firstTime; }
+
+  class Reader // decodes the samples in order, oldest first
+  {
+  public:
+    Reader(const ytGraphGorillaBlock &b);
+    bool next(uint32_t &t, float *v); // false at the end of the block
+
+  private:
+    const ytGraphGorillaBlock &_b;
+    ytGraphBitReader _in;
+    uint16_t _left;
+    uint32_t _t;
+    int32_t _delta;
+    uint32_t _v[GORILLA_MAX_CHANNELS];
+    uint8_t _lead[GORILLA_MAX_CHANNELS], _len[GORILLA_MAX_CHANNELS];
+  };
+
+  Reader reader() const { return Reader(*this); }
+
+private:
+  void write(uint32_t value, uint8_t n);
+
+  uint8_t *_buf;
+  uint16_t _bytes;
+  uint8_t _channels;
+  uint32_t _bits; // write position
+  uint16_t _count;
+  uint32_t _firstTime, _t;
+  int32_t _delta;
+  uint32_t _v[GORILLA_MAX_CHANNELS]; // last value as bits
+  uint8_t _lead[GORILLA_MAX_CHANNELS], _trail[GORILLA_MAX_CHANNELS];
+};
+
+// C channels in B blocks of BYTES bytes each, when all blocks are full the oldest one is reused
+template <uint8_t C, uint16_t BYTES, uint8_t B>
+class ytGraphGorillaHistory
+{
+public:
+  ytGraphGorillaHistory() { clear(); }
+
+  void clear()
+  {
+    for (uint8_t i = 0; i < B; i++)
+      _block[i].begin(_mem[i], BYTES, C);
+    _first = 0;
+    _used = 1;
+  }
+
+  void append(uint32_t t, const float *v)
+  {
+    if (_block[newest()].append(t, v))
+      return;
+    if (_used < B) // next empty block
+      _used++;
+    else // drop the oldest block
+    {
+      _block[_first].clear();
+      _first = (_first + 1) % B;
+    }
+    _block[newest()].append(t, v);
+  }
+
+  uint32_t size() const // samples in all blocks
+  {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < _used; i++)
+      n += _block[(_first + i) % B].count();
+    return n;
+  }
+
+  uint32_t bytesUsed() const
+  {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < _used; i++)
+      n += _block[(_first + i) % B].bytesUsed();
+    return n;
+  }
+
+  // calls f(t, v) for the samples from index 'from' on (0 = oldest), whole blocks before are skipped
+  template <typename F>
+  void forEach(uint32_t from, F f) const
+  {
+    uint32_t t;
+    float v[C];
+    for (uint8_t i = 0; i < _used; i++)
+    {
+      const ytGraphGorillaBlock &b = _block[(_first + i) % B];
+      if (from >= b.count())
+      {
+        from -= b.count();
+        continue;
+      }
+      ytGraphGorillaBlock::Reader r = b.reader();
+      while (r.next(t, v))
+      {
+        if (from)
+          from--;
+        else
+          f(t, (const float *)v);
+      }
+    }
+  }
+
+private:
+  uint8_t newest() const { return (_first + _used - 1) % B; }
+
+  uint8_t _mem[B][BYTES];
+  ytGraphGorillaBlock _block[B];
+  uint8_t _first, _used;
+};
+
+// draws the newest SAMPLE_COUNT + 1 samples, decoded on the fly, and pushes the sprite once
+// value(v, channel) returns the y value of a channel from the decoded floats
+template <uint8_t C, uint16_t BYTES, uint8_t B, typename Value>
+void ytGraphDrawGorilla(TFT_eSprite &Graph, const ytGraphGorillaHistory<C, BYTES, B> &h, ytGraphChannel *ch, uint8_t channels, Value value, bool push = true)
+{
+  uint32_t n = h.size(), from = n > SAMPLE_COUNT + 1 ? n - (SAMPLE_COUNT + 1) : 0;
+  int16_t y[C][32]; // draw in small chunks, like the ring version of ytGraphSeries()
+  uint16_t k = 0, x = 0;
+  h.forEach(from, [&](uint32_t, const float *v)
+            {
+              for (uint8_t c = 0; c < channels && c < C; c++)
+                y[c][k] = value(v, c);
+              if (++k < 32)
+                return;
+              for (uint8_t c = 0; c < channels && c < C; c++)
+                ytGraphSeries(Graph, ch[c], x, y[c], k);
+              x += k;
+              k = 0;
+            });
+  for (uint8_t c = 0; c < channels && c < C && k; c++)
+    ytGraphSeries(Graph, ch[c], x, y[c], k);
+  if (push)
+    Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // left upper position
+}
+
+template <uint8_t C, uint16_t BYTES, uint8_t B, typename Value>
+void ytGraphDrawGorilla(ytGraphCanvas &Graph, const ytGraphGorillaHistory<C, BYTES, B> &h, ytGraphChannel *ch, uint8_t channels, Value value)
+{
+  Graph.unwrap(); // drawn with plain sprite coordinates
+  ytGraphDrawGorilla(Graph.sprite(), h, ch, channels, value, false);
+  Graph.markAll();
+  Graph.push();
+}
+
+#endif
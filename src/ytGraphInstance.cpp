@@ -0,0 +1,202 @@
+/***************************************************************************************
+ * Graph instances and a frame scheduler for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphInstance.h"
+
+ytGraphInstance::ytGraphInstance(TFT_eSPI &tft, const ytGraphLayout &cfg)
+    : _tft(tft), _cfg(cfg), _arena(nullptr), _graphSprite(&tft), _xAxisSprite(&tft),
+      _graph(_graphSprite, cfg.spriteX(), cfg.spriteY()), _xAxis(_xAxisSprite, cfg.xAxisX(), cfg.xAxisY()),
+      _timeline(ytGraphTimelineInit(cfg)), _lastXGridLinePos(0), _ch(), _channels(0), _count(0),
+      _scale(GRAPH_SCALE_FIXED), _labels(tft)
+{
+}
+
+uint32_t ytGraphInstance::arenaBytes(const ytGraphLayout &cfg, uint8_t channels, uint8_t scale)
+{
+  int16_t xAxisWidth = cfg.xAxisWidth() + CANVAS_LABEL_OVERRUN;
+  uint32_t bytes = ytGraphArena::align(ytGraphSprite::bytes(cfg.spriteWidth(), cfg.spriteHeight(), 4)) +
+                   ytGraphArena::align(ytGraphSprite::bytes(xAxisWidth, cfg.xAxisHeight(), 1)) +
+                   ytGraphCanvas::bytes(cfg.spriteWidth()) + ytGraphCanvas::bytes(xAxisWidth) + ytGraphLabelCache::bytes();
+  if (scale == GRAPH_SCALE_AUTO)
+    bytes += ytGraphAutoscale::bytes(cfg, channels < GRAPH_MAX_CHANNELS ? channels : GRAPH_MAX_CHANNELS);
+  return bytes;
+}
+
+bool ytGraphInstance::begin(const uint16_t *colors, uint8_t channels, uint8_t scale)
+{
+  if (ytGraphLayoutCheck(_cfg) != LAYOUT_OK) // a runtime config is checked here, a static layout by the compiler
+    return false;
+  if (_arena && !_arena->fits(arenaBytes(_cfg, channels, scale))) // fails as a whole, not with half a graph
+    return false;
+  _channels = channels < GRAPH_MAX_CHANNELS ? channels : GRAPH_MAX_CHANNELS;
+  for (uint8_t c = 0; c < _channels; c++)
+    _ch[c] = ytGraphChannel{colors[c], 0, 0};
+
+  _graphSprite.setArena(_arena);
+  _xAxisSprite.setArena(_arena);
+  _graph.setArena(_arena);
+  _xAxis.setArena(_arena);
+  _graphSprite.setColorDepth(4); // max 16 graph lines with different colors
+  _xAxisSprite.setColorDepth(1); // only 2 axis text colors
+  if (!_graphSprite.createSprite(_cfg.spriteWidth(), _cfg.spriteHeight()) ||
+      !_xAxisSprite.createSprite(_cfg.xAxisWidth() + CANVAS_LABEL_OVERRUN, _cfg.xAxisHeight()))
+  {
+    end();
+    return false;
+  }
+  _graph.setBackground(_cfg.bgrndColor);
+  _xAxis.setBackground(_cfg.bgrndColor);
+  if (!_graph.beginRing() || !_xAxis.beginRing(CANVAS_LABEL_OVERRUN))
+  {
+    end();
+    return false;
+  }
+  _scale = scale;
+  if ((_scale == GRAPH_SCALE_AUTO && !_autoscale.begin(_cfg, _channels, _arena)) || !_labels.begin(_cfg, _arena))
+  {
+    end();
+    return false;
+  }
+  drawFrame();
+  clear();
+  return true;
+}
+
+void ytGraphInstance::end()
+{
+  _graphSprite.deleteSprite();
+  _xAxisSprite.deleteSprite();
+  _autoscale.end();
+  _labels.end();
+}
+
+void ytGraphInstance::drawFrame()
+{
+  ytGraphDrawYaxisFrame(_tft, _cfg);
+}
+
+void ytGraphInstance::clear()
+{
+  ytGraphDrawGridXaxis(_graph, _xAxis, _cfg, _lastXGridLinePos, _cfg.timeFormat);
+  _timeline = ytGraphTimelineInit(_cfg);
+  _count = 0;
+  if (_scale == GRAPH_SCALE_AUTO)
+    _autoscale.clear(_cfg);
+}
+
+void ytGraphInstance::add(const int16_t *y)
+{
+  // a new y range: the lines are not drawn sample by sample, the whole page is redrawn at the end
+  YTGRAPH_STATS_START(ingest);
+  bool rescale = _scale == GRAPH_SCALE_AUTO && _autoscale.add(y);
+  YTGRAPH_STATS_RECORD(STATS_INGEST, ingest);
+  if (rescale)
+    _cfg = ytGraphLayoutRange(_cfg, _autoscale.range());
+
+  if (_count <= _cfg.samples) // the page is filled first
+  {
+    for (uint8_t c = 0; c < _channels && !rescale; c++)
+    {
+      if (_count == 0) // the line starts at the first sample
+      {
+        _ch[c].ox = ytGraphMapX(_cfg.scale, 0);
+        _ch[c].oy = ytGraphMapY(_cfg.scale, y[c]);
+      }
+      ytGraph(_graph, _cfg.scale, _count, y[c], _ch[c]);
+    }
+    _count++;
+    _labels.prefetch(_timeline.lastXaxisValue + _cfg.xDiv); // the first labels are ready before the graph scrolls
+    if (rescale)
+      redraw();
+    return;
+  }
+
+  int16_t scrollX = _cfg.scrollStep; // scroll one sample to the left
+  for (uint8_t c = 0; c < _channels; c++)
+    _ch[c].ox -= scrollX; // correction of the last point after scrolling to the left
+  _graph.scroll(-scrollX);
+  _xAxis.scroll(-scrollX);
+
+  uint32_t xValue = 0;
+  bool newDiv = ytGraphDynamicGridStep(_timeline, _cfg, _lastXGridLinePos, xValue);
+  ytGraphDrawDynamicGrid(_graph, _xAxis, _cfg, _channels ? _ch[_channels - 1].ox : _cfg.width - scrollX, newDiv, xValue,
+                         &_labels);
+  if (!newDiv) // one label per frame without a new division, the frame with a new division only copies its label
+    _labels.prefetch(_timeline.lastXaxisValue + _cfg.xDiv);
+  if (_scale == GRAPH_SCALE_AUTO)
+    _autoscale.scroll(-scrollX, newDiv);
+
+  for (uint8_t c = 0; c < _channels && !rescale; c++)
+    ytGraph(_graph, _cfg.scale, _cfg.samples, y[c], _ch[c]);
+  _count++;
+  if (rescale)
+    redraw();
+}
+
+void ytGraphInstance::redraw()
+{
+  _graph.unwrap(); // drawn with plain sprite coordinates
+  _autoscale.redraw(_graph.sprite(), _cfg, _ch);
+  _graph.markAll();
+  ytGraphDrawYaxisLabels(_tft, _cfg, true); // the numbers are drawn directly on the panel, like the frame
+}
+
+uint32_t ytGraphInstance::push()
+{
+  return _xAxis.push() + _graph.push();
+}
+
+bool ytGraphScheduler::add(ytGraphInstance &g, uint32_t intervalMs, ytGraphSource source, void *user)
+{
+  if (_n >= SCHEDULER_MAX_GRAPHS)
+    return false;
+  _e[_n++] = entry{&g, intervalMs, 0, false, source, user};
+  return true;
+}
+
+uint8_t ytGraphScheduler::run(uint32_t nowMs)
+{
+  YTGRAPH_STATS_START(frame);
+  // 1st pass: draw every due graph into its sprites
+  bool updated[SCHEDULER_MAX_GRAPHS] = {};
+  uint8_t n = 0;
+  int16_t y[GRAPH_MAX_CHANNELS];
+  for (uint8_t i = 0; i < _n; i++)
+  {
+    entry &e = _e[i];
+    if (e.started && (int32_t)(nowMs - e.next) < 0)
+      continue;
+    // keep the rhythm, but do not try to catch up after a long stall
+    e.next = e.started && (int32_t)(nowMs - e.next) < (int32_t)e.interval ? e.next + e.interval : nowMs + e.interval;
+    e.started = true;
+    if (!e.source(*e.g, y, e.user))
+      continue;
+    e.g->add(y);
+    updated[i] = true;
+    n++;
+  }
+
+  // 2nd pass: all dirty regions in one SPI transaction
+  _lastBytes = 0;
+  if (!n)
+    return 0;
+  _tft.startWrite();
+  for (uint8_t i = 0; i < _n; i++)
+    if (updated[i])
+      _lastBytes += _e[i].g->push();
+  _tft.endWrite();
+  YTGRAPH_STATS_RECORD(STATS_FRAME, frame); // only frames that drew something
+  return n;
+}
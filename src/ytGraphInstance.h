@@ -0,0 +1,130 @@
+/***************************************************************************************
+ * Graph instances and a frame scheduler for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - ytGraphInstance owns its layout, sprites, scroll state (timeline)
+ *    and the continuation points of its channels
+ *  - the layout is a runtime ytGraphConfig or ytGraphStaticLayout<cfg>::layout,
+ *    computed and checked by the compiler, both use the same drawing functions
+ *  - several instances scroll independently on one panel, each with its own
+ *    size, position, sample count and time base
+ *  - ytGraphScheduler samples every due graph in one pass and then pushes all
+ *    dirty regions inside one SPI transaction
+ *  - the x axis labels are rendered ahead into a ytGraphLabelCache and copied in
+ *  - GRAPH_SCALE_AUTO: the y axis follows the visible samples (see ytGraphAutoscale.h)
+ *  - setArena(): sprites and buffers come from a ytGraphArena, begin() checks the
+ *    budget (arenaBytes()) before the first allocation
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_INSTANCE_h
+#define YTGRAPH_INSTANCE_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphAutoscale.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphLabels.h"
+
+#define GRAPH_MAX_CHANNELS 16 // the graph sprite has 4 bit colors
+#define SCHEDULER_MAX_GRAPHS 8
+
+// y axis of a graph instance
+#define GRAPH_SCALE_FIXED 0 // yMin .. yMax of the layout
+#define GRAPH_SCALE_AUTO 1  // min .. max of the visible samples, redrawn on a change
+
+class ytGraphInstance
+{
+public:
+  ytGraphInstance(TFT_eSPI &tft, const ytGraphLayout &layout = ytGraphLayoutDefault);
+
+  // creates the sprites (ring mode), draws the frame and the grid
+  // false if out of memory or the layout is invalid (see ytGraphLayoutCheck())
+  // with an arena nothing is allocated if arenaBytes() does not fit (see the arena stats)
+  bool begin(const uint16_t *colors, uint8_t channels, uint8_t scale = GRAPH_SCALE_FIXED);
+  void end(); // frees the sprites, arena memory waits for ytGraphArena::reset()
+
+  void setArena(ytGraphArena *arena) { _arena = arena; } // for the next begin(), nullptr = heap
+  // the arena memory begin() takes for this layout, e.g. to size the arena at startup
+  static uint32_t arenaBytes(const ytGraphLayout &cfg, uint8_t channels, uint8_t scale = GRAPH_SCALE_FIXED);
+
+  void drawFrame(); // y axis, frame and captions, directly on the panel
+  void clear();     // grid and x axis from the start, the next sample is drawn at x = 0 (keeps an auto y range)
+
+  // one sample of all channels: the first samples + 1 fill the page, then the graph scrolls
+  // only draws into the sprites, push() (or the scheduler) sends the changes
+  void add(const int16_t *y);
+  uint32_t push(); // sends the dirty regions of the graph and the x axis, returns the pixel bytes
+
+  const ytGraphLayout &config() const { return _cfg; }
+  ytGraphCanvas &graph() { return _graph; }
+  ytGraphCanvas &xAxis() { return _xAxis; }
+  ytGraphChannel &channel(uint8_t c) { return _ch[c]; }
+  uint8_t channels() const { return _channels; }
+  uint32_t count() const { return _count; } // samples added since clear()
+  bool autoScale() const { return _scale == GRAPH_SCALE_AUTO; }
+  uint32_t rescales() const { return _autoscale.rescales(); } // y range changes since clear()
+  const ytGraphLabelCache &labels() const { return _labels; }
+
+private:
+  void redraw(); // grid and lines with the new y range of _autoscale
+
+  TFT_eSPI &_tft;
+  ytGraphLayout _cfg;
+  ytGraphArena *_arena;
+  ytGraphSprite _graphSprite, _xAxisSprite;
+  ytGraphCanvas _graph, _xAxis;
+  ytGraphTimeline _timeline;
+  int16_t _lastXGridLinePos;
+  ytGraphChannel _ch[GRAPH_MAX_CHANNELS];
+  uint8_t _channels;
+  uint32_t _count;
+  uint8_t _scale;
+  ytGraphAutoscale _autoscale; // only used with GRAPH_SCALE_AUTO
+  ytGraphLabelCache _labels;
+};
+
+// fills y[] with one sample of every channel of the graph, false = nothing new this time
+typedef bool (*ytGraphSource)(ytGraphInstance &g, int16_t *y, void *user);
+
+class ytGraphScheduler
+{
+public:
+  explicit ytGraphScheduler(TFT_eSPI &tft) : _tft(tft), _n(0), _lastBytes(0) {}
+
+  // the graph is sampled every intervalMs, false if SCHEDULER_MAX_GRAPHS are in use
+  bool add(ytGraphInstance &g, uint32_t intervalMs, ytGraphSource source, void *user = nullptr);
+
+  // one frame: every due graph gets its sample, then all changes are pushed together
+  // call it as often as possible (e.g. from loop()), returns the number of updated graphs
+  uint8_t run(uint32_t nowMs);
+
+  uint32_t lastPushBytes() const { return _lastBytes; }
+
+private:
+  struct entry
+  {
+    ytGraphInstance *g;
+    uint32_t interval;
+    uint32_t next; // millis() of the next sample
+    bool started;  // the first run() samples at once
+    ytGraphSource source;
+    void *user;
+  };
+
+  TFT_eSPI &_tft;
+  entry _e[SCHEDULER_MAX_GRAPHS];
+  uint8_t _n;
+  uint32_t _lastBytes;
+};
+
+#endif
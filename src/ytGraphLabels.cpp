@@ -0,0 +1,156 @@
+/***************************************************************************************
+ * Pre-rendered x axis labels for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphLabels.h"
+#include <string.h>
+
+static_assert((LABEL_CACHE_SLOTS & (LABEL_CACHE_SLOTS - 1)) == 0, "LABEL_CACHE_SLOTS must be a power of 2");
+
+// 1 bit sprite memory as TFT_eSPI lays it out: rows padded to full bytes, the leftmost pixel in the MSB
+// a few test pixels at the upper left corner must land there, then the corner is restored
+static uint8_t *labelsBitmap(TFT_eSprite &s, uint16_t &stride)
+{
+  uint8_t *img = (uint8_t *)s.getPointer();
+  if (s.getColorDepth() != 1 || !img || s.width() < 2 || s.height() < 2)
+    return nullptr;
+  stride = (s.width() + 7) >> 3;
+  uint8_t save0 = img[0], save1 = img[stride];
+  s.drawPixel(0, 0, TFT_BLACK);
+  s.drawPixel(1, 0, TFT_WHITE);
+  s.drawPixel(0, 1, TFT_WHITE);
+  bool ok = (img[0] & 0xC0) == 0x40 && (img[stride] & 0x80) == 0x80;
+  img[0] = save0;
+  img[stride] = save1;
+  return ok ? img : nullptr;
+}
+
+ytGraphLabelCache::ytGraphLabelCache(TFT_eSPI &tft)
+    : _strip(&tft), _img(nullptr), _stride(0), _value(), _len(), _step(1), _format(SAMPLE_TIME_FORMAT),
+      _fg(GRAPH_AXIS_TEXT_COLOR), _bg(GRAPH_BGRND_COLOR), _hits(0), _misses(0)
+{
+}
+
+bool ytGraphLabelCache::begin(const ytGraphLayout &cfg, ytGraphArena *arena)
+{
+  end();
+  _strip.setArena(arena);
+  _step = cfg.xDiv ? cfg.xDiv : 1;
+  _format = cfg.timeFormat;
+  _fg = cfg.axisTextColor;
+  _bg = cfg.bgrndColor;
+  _strip.setColorDepth(1);
+  if (!_strip.createSprite(LABEL_CACHE_WIDTH, LABEL_CACHE_HEIGHT * LABEL_CACHE_SLOTS))
+    return false;
+  _img = labelsBitmap(_strip, _stride);
+  _strip.setTextSize(1);
+  _strip.setTextColor(_fg, _bg);
+  clear();
+  return true;
+}
+
+void ytGraphLabelCache::end()
+{
+  _strip.deleteSprite();
+  _img = nullptr;
+}
+
+void ytGraphLabelCache::clear()
+{
+  for (uint8_t i = 0; i < LABEL_CACHE_SLOTS; i++)
+    _len[i] = 0;
+  _hits = _misses = 0;
+}
+
+bool ytGraphLabelCache::cached(uint32_t value) const
+{
+  uint8_t i = slot(value);
+  return _len[i] && _value[i] == value;
+}
+
+void ytGraphLabelCache::render(uint32_t value)
+{
+  char str[X_AXIS_LABEL_LENGTH];
+  uint8_t i = slot(value);
+  ytGraphFormatTime(str, value, _format);
+  _strip.setCursor(0, i * LABEL_CACHE_HEIGHT);
+  _strip.print(str); // fills the background of every char, draw() copies only these columns
+  _value[i] = value;
+  _len[i] = strlen(str);
+}
+
+void ytGraphLabelCache::prefetch(uint32_t next)
+{
+  if (!_img)
+    return;
+  for (uint8_t k = 0; k < LABEL_CACHE_SLOTS; k++, next += _step)
+    if (!cached(next))
+    {
+      render(next);
+      return;
+    }
+}
+
+void ytGraphLabelCache::print(TFT_eSprite &xAxis, int16_t x, int16_t y, uint32_t value)
+{
+  char str[X_AXIS_LABEL_LENGTH];
+  xAxis.setCursor(x, y);
+  xAxis.print(ytGraphFormatTime(str, value, _format));
+}
+
+void ytGraphLabelCache::draw(TFT_eSprite &xAxis, int16_t x, int16_t y, uint32_t value)
+{
+  uint16_t stride;
+  uint8_t *dst = _img && _fg != _bg ? labelsBitmap(xAxis, stride) : nullptr; // _fg == _bg: print() draws no background
+  if (!dst)
+  {
+    print(xAxis, x, y, value);
+    return;
+  }
+  if (cached(value))
+    _hits++;
+  else
+  {
+    _misses++;
+    render(value);
+  }
+
+  // one byte of the strip after the other, shifted to the bit position of x and clipped like drawPixel()
+  uint8_t i = slot(value);
+  int16_t w = _len[i] * 6, width = xAxis.width(), height = xAxis.height();
+  for (int16_t row = 0; row < LABEL_CACHE_HEIGHT; row++)
+  {
+    int16_t dy = y + row;
+    if (dy < 0 || dy >= height)
+      continue;
+    const uint8_t *src = _img + (i * LABEL_CACHE_HEIGHT + row) * _stride;
+    uint8_t *line = dst + dy * stride;
+    for (int16_t sx = 0; sx < w; sx += 8)
+    {
+      int16_t dx = x + sx;
+      int16_t n = w - sx < 8 ? w - sx : 8;
+      int16_t lo = dx < 0 ? -dx : 0, hi = width - dx < n ? width - dx : n; // visible bits lo .. hi - 1
+      if (lo >= hi)
+        continue;
+      uint8_t mask = (0xFF >> lo) & (0xFF << (8 - hi));
+      uint8_t bits = src[sx >> 3] & mask;
+      int16_t shift = dx & 7, b = dx >> 3; // for dx < 0 only byte b + 1 (columns 0 .. 7) is visible
+      if (b >= 0)
+        line[b] = (line[b] & ~(mask >> shift)) | (bits >> shift);
+      uint8_t mask1 = shift ? (uint8_t)(mask << (8 - shift)) : 0;
+      if (mask1)
+        line[b + 1] = (line[b + 1] & ~mask1) | (uint8_t)(bits << (8 - shift));
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/***************************************************************************************
+ * Pre-rendered x axis labels for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - the label of a division is formatted (ytGraphFormatTime(), no sprintf) and
+ *    rendered once into a small 1 bit strip, then copied into the x axis sprite
+ *    byte by byte instead of drawing every glyph again
+ *  - prefetch() renders the labels of the next divisions ahead, one per frame
+ *    without a new division, so the frame that adds a grid line only copies its
+ *    label and costs about the same as any other frame
+ *  - direct mapped: division n of the timeline lives in slot n % LABEL_CACHE_SLOTS
+ *  - the x axis sprite must have 1 bit (like in ytGraphInstance), other depths
+ *    and a memory layout that does not match fall back to print()
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_LABELS_h
+#define YTGRAPH_LABELS_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+
+#define LABEL_CACHE_SLOTS 4                             // labels rendered ahead, a power of 2
+#define LABEL_CACHE_WIDTH ((X_AXIS_LABEL_LENGTH - 1) * 6) // px of the longest label, 6 px per char (text size 1)
+#define LABEL_CACHE_HEIGHT 8                            // px of one text line
+
+class ytGraphLabelCache
+{
+public:
+  explicit ytGraphLabelCache(TFT_eSPI &tft);
+  ~ytGraphLabelCache() { end(); }
+
+  // creates the strip, text and background colour, time format and division of cfg, false if out of memory
+  bool begin(const ytGraphLayout &cfg, ytGraphArena *arena = nullptr);
+  void end();
+  static uint32_t bytes() { return ytGraphArena::align(ytGraphSprite::bytes(LABEL_CACHE_WIDTH, LABEL_CACHE_HEIGHT * LABEL_CACHE_SLOTS, 1)); }
+  void clear(); // forgets all labels
+
+  // renders the first of the labels next, next + xDiv, ... that is not cached yet (at most one per call)
+  // call it in the frames without a new division with the value of the next division
+  void prefetch(uint32_t next);
+
+  // the label of value with its upper left corner at x/y of xAxis, same pixels as print()
+  void draw(TFT_eSprite &xAxis, int16_t x, int16_t y, uint32_t value);
+
+  uint32_t hits() const { return _hits; }     // draw() found the label
+  uint32_t misses() const { return _misses; } // draw() had to render it
+
+private:
+  uint8_t slot(uint32_t value) const { return (value / _step) & (LABEL_CACHE_SLOTS - 1); }
+  bool cached(uint32_t value) const;
+  void render(uint32_t value);
+  void print(TFT_eSprite &xAxis, int16_t x, int16_t y, uint32_t value); // the fallback
+
+  ytGraphSprite _strip; // LABEL_CACHE_SLOTS text lines of 1 bit
+  uint8_t *_img;      // pixel memory of the strip, nullptr = not usable
+  uint16_t _stride;   // bytes per row of the strip
+  uint32_t _value[LABEL_CACHE_SLOTS];
+  uint8_t _len[LABEL_CACHE_SLOTS]; // chars, 0 = empty slot
+  uint16_t _step;                  // xDiv
+  char _format;
+  uint16_t _fg, _bg;
+  uint32_t _hits, _misses;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/***************************************************************************************
+ * Persistent sample log for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphLog.h"
+
+uint32_t ytGraphCRC32(const void *data, uint32_t len, uint32_t crc)
+{
+  static const uint32_t table[16] = { // one nibble at a time, small enough for the flash of any MCU
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+      0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  const uint8_t *p = (const uint8_t *)data;
+  crc = ~crc;
+  while (len--)
+  {
+    crc = table[(crc ^ *p) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (*p++ >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+const char *ytGraphStdioFile::path(uint8_t slot)
+{
+  snprintf(_path, sizeof(_path), "%s%02u.log", _prefix, slot);
+  return _path;
+}
+
+int32_t ytGraphStdioFile::size(uint8_t slot)
+{
+  FILE *f = fopen(path(slot), "rb");
+  if (!f)
+    return -1;
+  fseek(f, 0, SEEK_END);
+  int32_t n = ftell(f);
+  fclose(f);
+  return n;
+}
+
+bool ytGraphStdioFile::append(uint8_t slot, const void *data, uint16_t len)
+{
+  FILE *f = fopen(path(slot), "ab");
+  if (!f)
+    return false;
+  bool ok = fwrite(data, 1, len, f) == len;
+  return fclose(f) == 0 && ok; // closed after every batch, a reset loses at most the batch in RAM
+}
+
+uint16_t ytGraphStdioFile::read(uint8_t slot, uint32_t offset, void *data, uint16_t len)
+{
+  FILE *f = fopen(path(slot), "rb");
+  if (!f)
+    return 0;
+  uint16_t n = fseek(f, offset, SEEK_SET) == 0 ? fread(data, 1, len, f) : 0;
+  fclose(f);
+  return n;
+}
+
+bool ytGraphStdioFile::erase(uint8_t slot)
+{
+  return remove(path(slot)) == 0 || size(slot) < 0;
+}
+
+#ifdef ARDUINO
+const char *ytGraphFSFile::path(uint8_t slot)
+{
+  snprintf(_path, sizeof(_path), "%s%02u.log", _prefix, slot);
+  return _path;
+}
+
+int32_t ytGraphFSFile::size(uint8_t slot)
+{
+  if (!_fs.exists(path(slot)))
+    return -1;
+  File f = _fs.open(_path, FILE_READ);
+  if (!f)
+    return -1;
+  int32_t n = f.size();
+  f.close();
+  return n;
+}
+
+bool ytGraphFSFile::append(uint8_t slot, const void *data, uint16_t len)
+{
+  File f = _fs.open(path(slot), FILE_APPEND);
+  if (!f)
+    return false;
+  bool ok = f.write((const uint8_t *)data, len) == len;
+  f.close();
+  return ok;
+}
+
+uint16_t ytGraphFSFile::read(uint8_t slot, uint32_t offset, void *data, uint16_t len)
+{
+  File f = _fs.open(path(slot), FILE_READ);
+  if (!f)
+    return 0;
+  uint16_t n = f.seek(offset) ? f.read((uint8_t *)data, len) : 0;
+  f.close();
+  return n;
+}
+
+bool ytGraphFSFile::erase(uint8_t slot)
+{
+  return !_fs.exists(path(slot)) || _fs.remove(_path);
+}
+#endif
+
+ytGraphLogStore::ytGraphLogStore(ytGraphLogFile &file, uint16_t recordSize, uint8_t slots, uint32_t segmentBytes)
+    : _file(file), _recordSize(recordSize), _slots(slots ? slots : 1), _segmentBytes(segmentBytes), _seq(0), _size(0), _writes(0)
+{
+}
+
+bool ytGraphLogStore::segmentSeq(uint8_t slot, uint32_t &seq)
+{
+  uint32_t h[3]; // magic, sequence number, record size
+  if (_file.read(slot, 0, h, LOG_SEGMENT_HEADER) != LOG_SEGMENT_HEADER)
+    return false;
+  seq = h[1];
+  return h[0] == LOG_SEGMENT_MAGIC && h[2] == _recordSize; // an other record type is not restored
+}
+
+uint32_t ytGraphLogStore::records(uint32_t seq, int32_t *valid)
+{
+  uint8_t slot = seq % _slots;
+  int32_t end = _file.size(slot);
+  uint32_t pos = LOG_SEGMENT_HEADER, n = 0;
+  uint8_t h[LOG_BATCH_HEADER];
+  while (pos + LOG_BATCH_HEADER <= (uint32_t)end && _file.read(slot, pos, h, LOG_BATCH_HEADER) == LOG_BATCH_HEADER)
+  {
+    uint16_t magic, count;
+    memcpy(&magic, h, 2);
+    memcpy(&count, h + 2, 2);
+    if (magic != LOG_BATCH_MAGIC || pos + LOG_BATCH_HEADER + (uint32_t)count * _recordSize > (uint32_t)end)
+      break;
+    pos += LOG_BATCH_HEADER + (uint32_t)count * _recordSize;
+    n += count;
+  }
+  if (valid)
+    *valid = pos;
+  return n;
+}
+
+bool ytGraphLogStore::open(uint32_t seq)
+{
+  uint8_t slot = seq % _slots;
+  uint32_t h[3] = {LOG_SEGMENT_MAGIC, seq, _recordSize};
+  _seq = seq;
+  _size = LOG_SEGMENT_HEADER;
+  _writes++;
+  return _file.erase(slot) && _file.append(slot, h, LOG_SEGMENT_HEADER);
+}
+
+bool ytGraphLogStore::begin()
+{
+  bool found = false;
+  uint32_t seq;
+  for (uint8_t slot = 0; slot < _slots; slot++)
+    if (segmentSeq(slot, seq) && seq % _slots == slot && (!found || seq > _seq))
+    {
+      _seq = seq;
+      found = true;
+    }
+  _writes = 0;
+  if (!found) // empty or foreign file system, start with segment 0
+    return open(0);
+
+  int32_t valid;
+  records(_seq, &valid);
+  if (valid != _file.size(_seq % _slots)) // a torn batch at the end, never append behind it
+    return open(_seq + 1);
+  _size = valid;
+  return true;
+}
+
+bool ytGraphLogStore::writeBatch(uint8_t *buf, uint16_t count)
+{
+  uint32_t bytes = (uint32_t)count * _recordSize;
+  if (_size > LOG_SEGMENT_HEADER && _size + LOG_BATCH_HEADER + bytes > _segmentBytes)
+    if (!open(_seq + 1)) // the segment is full, the oldest slot is erased
+      return false;
+
+  uint16_t magic = LOG_BATCH_MAGIC;
+  uint32_t crc = ytGraphCRC32(buf + LOG_BATCH_HEADER, bytes);
+  memcpy(buf, &magic, 2);
+  memcpy(buf + 2, &count, 2);
+  memcpy(buf + 4, &crc, 4);
+  _writes++;
+  if (!_file.append(_seq % _slots, buf, LOG_BATCH_HEADER + bytes))
+    return false;
+  _size += LOG_BATCH_HEADER + bytes;
+  return true;
+}
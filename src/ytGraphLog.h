@@ -0,0 +1,231 @@
+/***************************************************************************************
+ * Persistent sample log for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - append-only segment files in flash (LittleFS / SPIFFS), a fixed number of slots
+ *  - samples are collected in RAM and written in batches, not one flash write per sample
+ *  - every batch has a CRC, a batch torn by a reset is detected and skipped
+ *  - the oldest segment is erased when the slots are used up, no file is ever rewritten
+ *  - restore() reads only the newest segments back after a reboot
+ *  - the file layer is an interface, ytGraphStdioFile runs on Linux for the benchmarks
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_LOG_h
+#define YTGRAPH_LOG_h
+
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <FS.h>
+#endif
+
+#define LOG_SEGMENT_MAGIC 0x4C477479 // "ytGL"
+#define LOG_BATCH_MAGIC 0xB7C4
+#define LOG_SEGMENT_HEADER 12 // magic, sequence number, record size
+#define LOG_BATCH_HEADER 8    // magic, record count, CRC32 of the records
+
+// the file layer of ytGraphLog: a few numbered segment files that are only appended to
+class ytGraphLogFile
+{
+public:
+  virtual ~ytGraphLogFile() {}
+  virtual int32_t size(uint8_t slot) = 0;                                     // -1 if there is no file
+  virtual bool append(uint8_t slot, const void *data, uint16_t len) = 0;      // one write call
+  virtual uint16_t read(uint8_t slot, uint32_t offset, void *data, uint16_t len) = 0; // bytes read
+  virtual bool erase(uint8_t slot) = 0;
+};
+
+// plain C files, "<prefix><slot>.log" - Linux, and the VFS of the ESP32 (e.g. prefix "/littlefs/ytg")
+class ytGraphStdioFile : public ytGraphLogFile
+{
+public:
+  explicit ytGraphStdioFile(const char *prefix) : _prefix(prefix) {}
+  int32_t size(uint8_t slot) override;
+  bool append(uint8_t slot, const void *data, uint16_t len) override;
+  uint16_t read(uint8_t slot, uint32_t offset, void *data, uint16_t len) override;
+  bool erase(uint8_t slot) override;
+
+private:
+  const char *path(uint8_t slot);
+  const char *_prefix;
+  char _path[64];
+};
+
+#ifdef ARDUINO
+// Arduino file system (SPIFFS, LittleFS, SD), "<prefix><slot>.log" e.g. prefix "/ytg"
+class ytGraphFSFile : public ytGraphLogFile
+{
+public:
+  ytGraphFSFile(fs::FS &fs, const char *prefix) : _fs(fs), _prefix(prefix) {}
+  int32_t size(uint8_t slot) override;
+  bool append(uint8_t slot, const void *data, uint16_t len) override;
+  uint16_t read(uint8_t slot, uint32_t offset, void *data, uint16_t len) override;
+  bool erase(uint8_t slot) override;
+
+private:
+  const char *path(uint8_t slot);
+  fs::FS &_fs;
+  const char *_prefix;
+  char _path[64];
+};
+#endif
+
+uint32_t ytGraphCRC32(const void *data, uint32_t len, uint32_t crc = 0);
+
+// the record independent part of the log: segments, batches and the scan on startup
+class ytGraphLogStore
+{
+public:
+  ytGraphLogStore(ytGraphLogFile &file, uint16_t recordSize, uint8_t slots, uint32_t segmentBytes);
+
+  bool begin(); // finds the newest segment, a segment with a torn batch is closed
+
+  // writes count records (and the batch header in front of them) with one append
+  // buf holds LOG_BATCH_HEADER free bytes and then the records
+  bool writeBatch(uint8_t *buf, uint16_t count);
+
+  // calls f(records, count) for the newest n records, oldest first, one call per batch
+  // buf must hold a whole batch of maxBatch records
+  template <typename F>
+  uint32_t restore(uint32_t n, uint8_t *buf, uint16_t maxBatch, F f);
+
+  uint32_t writes() const { return _writes; } // append calls since begin()
+  uint32_t sequence() const { return _seq; }
+
+private:
+  uint32_t records(uint32_t seq, int32_t *valid = nullptr); // records in the segment, header walk only
+  bool open(uint32_t seq);                                  // erases the slot and writes the segment header
+  bool segmentSeq(uint8_t slot, uint32_t &seq);
+
+  ytGraphLogFile &_file;
+  uint16_t _recordSize;
+  uint8_t _slots;
+  uint32_t _segmentBytes;
+  uint32_t _seq, _size; // newest segment and its length
+  uint32_t _writes;
+};
+
+template <typename F>
+uint32_t ytGraphLogStore::restore(uint32_t n, uint8_t *buf, uint16_t maxBatch, F f)
+{
+  // count backwards over the newest segments until n records are found
+  uint32_t have = 0, seq = _seq, oldest = _seq;
+  for (uint8_t i = 0; i < _slots && have < n; i++, seq--)
+  {
+    uint32_t s;
+    if (!segmentSeq(seq % _slots, s) || s != seq)
+      break;
+    have += records(seq);
+    oldest = seq;
+    if (seq == 0)
+      break;
+  }
+  uint32_t skip = have > n ? have - n : 0, done = 0;
+
+  // and read them forward
+  for (seq = oldest; have && seq <= _seq; seq++)
+  {
+    uint8_t slot = seq % _slots;
+    int32_t end = _file.size(slot);
+    uint32_t pos = LOG_SEGMENT_HEADER;
+    while (pos + LOG_BATCH_HEADER <= (uint32_t)end)
+    {
+      uint16_t magic, count;
+      uint32_t crc;
+      if (_file.read(slot, pos, buf, LOG_BATCH_HEADER) != LOG_BATCH_HEADER)
+        break;
+      memcpy(&magic, buf, 2);
+      memcpy(&count, buf + 2, 2);
+      memcpy(&crc, buf + 4, 4);
+      uint32_t bytes = (uint32_t)count * _recordSize;
+      if (magic != LOG_BATCH_MAGIC || count > maxBatch || pos + LOG_BATCH_HEADER + bytes > (uint32_t)end)
+        break;
+      pos += LOG_BATCH_HEADER + bytes;
+      if (skip >= count) // the whole batch is older than the n records
+      {
+        skip -= count;
+        continue;
+      }
+      if (_file.read(slot, pos - bytes, buf, bytes) != bytes || ytGraphCRC32(buf, bytes) != crc)
+        break; // torn or damaged, the rest of the segment is not trusted
+      f(buf + skip * _recordSize, count - skip);
+      done += count - skip;
+      skip = 0;
+    }
+  }
+  return done;
+}
+
+// T records, BATCH of them are collected in RAM before one flash write
+// T must be trivially copyable, the bytes go to the file as they are
+template <typename T, uint16_t BATCH>
+class ytGraphLog
+{
+public:
+  ytGraphLog(ytGraphLogFile &file, uint8_t slots = 8, uint32_t segmentBytes = 4096)
+      : _store(file, sizeof(T), slots, segmentBytes), _fill(0) {}
+
+  bool begin() { return _store.begin(); }
+
+  void append(const T &r)
+  {
+    memcpy(_buf + LOG_BATCH_HEADER + _fill * sizeof(T), &r, sizeof(T));
+    if (++_fill == BATCH)
+      flush();
+  }
+
+  bool flush() // e.g. before a planned restart
+  {
+    if (_fill == 0)
+      return true;
+    bool ok = _store.writeBatch(_buf, _fill);
+    _fill = 0;
+    return ok;
+  }
+
+  // calls f(const T &) for the newest n records, oldest first (the ones still in RAM included)
+  template <typename F>
+  uint32_t restore(uint32_t n, F f)
+  {
+    uint16_t fill = _fill; // the read buffer is the batch buffer, keep the pending records
+    uint8_t pending[BATCH * sizeof(T) + 1];
+    memcpy(pending, _buf + LOG_BATCH_HEADER, fill * sizeof(T));
+    uint32_t fromFile = n > fill ? n - fill : 0, done;
+    done = _store.restore(fromFile, _buf, BATCH, [&](const uint8_t *r, uint16_t count)
+                          {
+                            T t;
+                            for (uint16_t i = 0; i < count; i++)
+                            {
+                              memcpy(&t, r + i * sizeof(T), sizeof(T));
+                              f((const T &)t);
+                            }
+                          });
+    T t;
+    for (uint16_t i = (n < fill ? fill - n : 0); i < fill; i++, done++)
+    {
+      memcpy(&t, pending + i * sizeof(T), sizeof(T));
+      f((const T &)t);
+    }
+    memcpy(_buf + LOG_BATCH_HEADER, pending, fill * sizeof(T));
+    return done;
+  }
+
+  uint16_t pending() const { return _fill; }
+  uint32_t writes() const { return _store.writes(); }
+
+private:
+  ytGraphLogStore _store;
+  uint16_t _fill;
+  uint8_t _buf[LOG_BATCH_HEADER + BATCH * sizeof(T)];
+};
+
+#endif
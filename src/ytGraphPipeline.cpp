@@ -0,0 +1,149 @@
+/***************************************************************************************
+ * Sampling / render / transfer pipeline for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphPipeline.h"
+#include <string.h>
+
+ytGraphPipeline::ytGraphPipeline(TFT_eSPI &tft, const ytGraphLayout &layout)
+    : _tft(tft), _g{{tft, layout}, {tft, layout}}, _lagCount(0), _back(0), _front(1), _pending(false),
+      _acquire(nullptr), _user(nullptr), _interval(0), _sampling(false), _transferring(false), _busy(false),
+      _sampled(0), _dropped(0), _lastBytes(0), _drawn(0), _frames(0), _coalesced(0), _lastTime(0)
+{
+}
+
+bool ytGraphPipeline::begin(const uint16_t *colors, uint8_t channels, ytGraphAcquire acquire, uint32_t intervalMs, void *user)
+{
+  if (!_g[0].begin(colors, channels) || !_g[1].begin(colors, channels))
+  {
+    _g[0].end();
+    return false;
+  }
+  _g[_front].push(); // the empty grid, both buffers are the same now
+
+  _acquire = acquire;
+  _user = user;
+  _interval = intervalMs ? intervalMs : 1;
+  _lagCount = 0;
+  _pending = false;
+  _sampling = _transferring = true;
+  if (!_sender.start(transfer, this, "ytGraphTransfer", PIPELINE_TRANSFER_CORE) ||
+      !_sampler.start(sampling, this, "ytGraphSampling", PIPELINE_SAMPLING_CORE, THREAD_PRIORITY + 1)) // keeps its rhythm
+  {
+    end();
+    return false;
+  }
+  return true;
+}
+
+void ytGraphPipeline::end()
+{
+  if (!_sender.running())
+    return;
+  _sampling = false;
+  _sampler.join();
+
+  while (_queue.size() || _pending) // the last samples still go to the panel
+    render(10);
+  _transferring = false;
+  _go.give();
+  _sender.join();
+}
+
+uint32_t ytGraphPipeline::render(uint32_t timeoutMs)
+{
+  bool idle = !_busy.load(std::memory_order_acquire);
+  if ((!_queue.size() || _lagCount == PIPELINE_LAG) && !(_pending && idle)) // nothing to draw or to send
+  {
+    _wake.take(timeoutMs);
+    idle = !_busy.load(std::memory_order_acquire);
+  }
+
+  uint32_t n = 0;
+  ytGraphPipelineSample s;
+  while (_lagCount < PIPELINE_LAG && _queue.pop(s)) // everything queued goes into one frame
+  {
+    _g[_back].add(s.y);
+    memcpy(_lag[_lagCount++], s.y, sizeof(s.y));
+    _lastTime = s.timeMs;
+    if (_pending)
+      _coalesced++;
+    _pending = true;
+    n++;
+  }
+  _drawn += n;
+
+  if (_pending && (idle || !_busy.load(std::memory_order_acquire)))
+    handOver();
+  return n;
+}
+
+void ytGraphPipeline::handOver()
+{
+  _front = _back;
+  _busy.store(true, std::memory_order_release);
+  _go.give();
+  _frames++;
+
+  // while the transfer task sends, the other buffer draws the samples it has missed
+  _back ^= 1;
+  for (uint8_t i = 0; i < _lagCount; i++)
+    _g[_back].add(_lag[i]);
+  _lagCount = 0;
+  _pending = false;
+}
+
+void ytGraphPipeline::sampling(void *self)
+{
+  ytGraphPipeline &p = *(ytGraphPipeline *)self;
+  uint32_t next = ytGraphNowMs();
+  while (p._sampling.load(std::memory_order_relaxed))
+  {
+    ytGraphPipelineSample s;
+    s.timeMs = ytGraphNowMs();
+    if (p._acquire(s.y, p._user))
+    {
+      p._sampled.fetch_add(1, std::memory_order_relaxed);
+      if (!p._queue.push(s))
+        p._dropped.fetch_add(1, std::memory_order_relaxed);
+      p._wake.give();
+    }
+
+    next += p._interval;
+    int32_t wait = (int32_t)(next - ytGraphNowMs());
+    if (wait > 0)
+      ytGraphSleepMs(wait);
+    else if (-wait > (int32_t)p._interval) // do not try to catch up after a long stall
+      next = ytGraphNowMs();
+  }
+}
+
+void ytGraphPipeline::transfer(void *self)
+{
+  ytGraphPipeline &p = *(ytGraphPipeline *)self;
+  for (;;)
+  {
+    p._go.take(100);
+    if (p._busy.load(std::memory_order_acquire))
+    {
+      p._tft.startWrite();
+      p._lastBytes.store(p._g[p._front].push(), std::memory_order_relaxed);
+      p._tft.endWrite();
+      p._busy.store(false, std::memory_order_release);
+      p._wake.give();
+    }
+    else if (!p._transferring.load(std::memory_order_acquire))
+      return;
+  }
+}
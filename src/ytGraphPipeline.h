@@ -0,0 +1,108 @@
+/***************************************************************************************
+ * Sampling / render / transfer pipeline for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - a sampling task reads the sensors at a fixed interval and stamps the samples,
+ *    a slow push does not delay it, the samples go through a lock-free queue
+ *  - the render stage draws into one of two graph buffers (ytGraphInstance)
+ *    while the transfer task sends the other one to the panel
+ *  - backpressure: samples that arrive while the transfer is busy are coalesced
+ *    into the next frame, a full queue drops samples (counted)
+ *  - the idle buffer catches up with the samples it has missed by drawing them again,
+ *    no pixel memory is copied between the buffers
+ *  - tasks and signals come from ytGraphThread.h: FreeRTOS on the ESP32, std::thread on the host
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_PIPELINE_h
+#define YTGRAPH_PIPELINE_h
+
+#include "ytGraphInstance.h"
+#include "ytGraphRing.h"
+#include "ytGraphThread.h"
+
+#define PIPELINE_QUEUE 32        // samples between the sampling task and the render stage (power of 2)
+#define PIPELINE_LAG 32          // samples the idle buffer may miss, then the render stage waits for the transfer
+#define PIPELINE_SAMPLING_CORE 0 // the render stage runs in loop() on core 1
+#define PIPELINE_TRANSFER_CORE 0
+
+struct ytGraphPipelineSample
+{
+  uint32_t timeMs; // taken by the sampling task
+  int16_t y[GRAPH_MAX_CHANNELS];
+};
+
+// fills y[] with one sample of every channel, runs in the sampling task, false = nothing new this time
+typedef bool (*ytGraphAcquire)(int16_t *y, void *user);
+
+class ytGraphPipeline
+{
+public:
+  ytGraphPipeline(TFT_eSPI &tft, const ytGraphLayout &layout = ytGraphLayoutDefault);
+  ~ytGraphPipeline() { end(); }
+
+  // creates both buffers, draws the frame and starts the sampling and the transfer task
+  // false if out of memory, the layout is invalid or a task could not be started
+  bool begin(const uint16_t *colors, uint8_t channels, ytGraphAcquire acquire, uint32_t intervalMs, void *user = nullptr);
+
+  // stops the sampling, draws and sends what is still queued, then stops the transfer task
+  void end();
+
+  void setArena(ytGraphArena *arena) // both buffers, before begin()
+  {
+    _g[0].setArena(arena);
+    _g[1].setArena(arena);
+  }
+
+  // the render stage, always from the same task (e.g. loop()): waits up to timeoutMs for work,
+  // draws the queued samples into the idle buffer and hands it over if the transfer task is free
+  // returns the number of samples drawn
+  uint32_t render(uint32_t timeoutMs);
+
+  uint32_t sampled() const { return _sampled.load(std::memory_order_relaxed); } // taken by the sampling task
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); } // lost, the queue was full
+  uint32_t drawn() const { return _drawn; }                                     // by the render stage
+  uint32_t frames() const { return _frames; }                                   // handed to the transfer task
+  uint32_t coalesced() const { return _coalesced; }                             // samples without a frame of their own
+  uint32_t lastSampleTime() const { return _lastTime; }                         // timeMs of the newest drawn sample
+  uint32_t lastPushBytes() const { return _lastBytes.load(std::memory_order_relaxed); } // of the last frame
+
+  ytGraphInstance &buffer(uint8_t i) { return _g[i]; }
+  uint8_t front() const { return _front; } // the buffer that was sent last
+
+private:
+  static void sampling(void *self);
+  static void transfer(void *self);
+  void handOver();
+
+  TFT_eSPI &_tft;
+  ytGraphInstance _g[2];
+  ytGraphSampleQueue<ytGraphPipelineSample, PIPELINE_QUEUE> _queue;
+  int16_t _lag[PIPELINE_LAG][GRAPH_MAX_CHANNELS]; // drawn into the back buffer, missing in the front buffer
+  uint8_t _lagCount;
+  uint8_t _back;  // render stage draws here
+  uint8_t _front; // transfer task sends this one
+  bool _pending;  // the back buffer has samples that were not sent
+
+  ytGraphAcquire _acquire;
+  void *_user;
+  uint32_t _interval;
+  ytGraphThread _sampler, _sender;
+  ytGraphSignal _wake; // render stage: new sample or transfer done
+  ytGraphSignal _go;   // transfer task: a frame is ready
+  std::atomic<bool> _sampling, _transferring, _busy;
+
+  std::atomic<uint32_t> _sampled, _dropped, _lastBytes;
+  uint32_t _drawn, _frames, _coalesced, _lastTime;
+};
+
+#endif
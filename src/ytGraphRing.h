@@ -0,0 +1,135 @@
+/***************************************************************************************
+ * Fixed size sample stores for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - ytGraphRing:        circular history, O(1) push, index 0 is the oldest sample
+ *  - ytGraphSampleQueue: lock-free single producer / single consumer queue, an ISR or
+ *                        sensor task pushes, the render path drains it into the ring
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_RING_h
+#define YTGRAPH_RING_h
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint32_t N>
+class ytGraphRing
+{
+  static_assert(N > 0, "ytGraphRing needs at least one slot");
+
+public:
+  ytGraphRing() : _head(0), _count(0), _buf{} {}
+
+  void clear()
+  {
+    _head = 0;
+    _count = 0;
+  }
+
+  void push(const T &sample) // overwrites the oldest sample if the ring is full
+  {
+    _buf[_head] = sample;
+    if (++_head == N)
+      _head = 0;
+    if (_count < N)
+      _count++;
+  }
+
+  T &operator[](uint32_t i) { return _buf[slot(i)]; } // 0 = oldest, size() - 1 = newest
+  const T &operator[](uint32_t i) const { return _buf[slot(i)]; }
+
+  T &newest() { return _buf[_head ? _head - 1 : N - 1]; }
+  const T &newest() const { return _buf[_head ? _head - 1 : N - 1]; }
+  T &oldest() { return _buf[slot(0)]; }
+
+  uint32_t size() const { return _count; }
+  static constexpr uint32_t capacity() { return N; }
+  bool full() const { return _count == N; }
+  bool empty() const { return _count == 0; }
+
+  // the stored samples as (at most) two contiguous runs, oldest first
+  uint32_t segments(const T *&first, uint32_t &firstLen, const T *&second, uint32_t &secondLen) const
+  {
+    uint32_t start = slot(0);
+    first = &_buf[start];
+    firstLen = (start + _count <= N) ? _count : N - start;
+    second = &_buf[0];
+    secondLen = _count - firstLen;
+    return secondLen ? 2 : (firstLen ? 1 : 0);
+  }
+
+private:
+  uint32_t slot(uint32_t i) const
+  {
+    uint32_t s = _head + N - _count + i; // always < 2N, no division in the hot path
+    if (s >= N)
+      s -= N;
+    return s;
+  }
+
+  uint32_t _head;  // next write position
+  uint32_t _count; // number of valid samples
+  T _buf[N];
+};
+
+template <typename T, uint32_t N>
+class ytGraphSampleQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ytGraphSampleQueue size must be a power of 2");
+
+public:
+  ytGraphSampleQueue() : _head(0), _tail(0) {}
+
+  bool push(const T &sample) // producer side only, false if the consumer lags behind
+  {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == N)
+      return false;
+    _buf[head & (N - 1)] = sample;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &sample) // consumer side only
+  {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire))
+      return false;
+    sample = _buf[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <uint32_t M>
+  uint32_t drainInto(ytGraphRing<T, M> &ring) // consumer side, moves everything queued into the history
+  {
+    uint32_t n = 0;
+    T sample;
+    while (pop(sample))
+    {
+      ring.push(sample);
+      n++;
+    }
+    return n;
+  }
+
+  uint32_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> _head; // free running write counter
+  std::atomic<uint32_t> _tail; // free running read counter
+  T _buf[N];
+};
+
+#endif
@@ -0,0 +1,37 @@
+/***************************************************************************************
+ * Fixed point coordinate transform for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphScale.h"
+
+void ytGraphMapBatch(const ytGraphScale &s, uint16_t firstX, const int16_t *y, int16_t *px, int16_t *py, uint16_t n)
+{
+  // branch free loop bodies, so the compiler can vectorize them on the host
+  const uint64_t half = (uint64_t)1 << (s.yShift - 1);
+  for (uint16_t i = 0; i < n; i++)
+  {
+    int32_t v = (int32_t)y[i] - s.yOffset;
+    int32_t sign = v >> 31; // 0 or -1
+    uint32_t a = (uint32_t)((v ^ sign) - sign);
+    int32_t r = (int32_t)(((uint64_t)a * s.yMul + half) >> s.yShift);
+    r = ((r ^ sign) - sign) - s.height;
+    int32_t m = r >> 31;
+    py[i] = (int16_t)((r ^ m) - m);
+  }
+  if (px)
+  {
+    for (uint16_t i = 0; i < n; i++)
+      px[i] = (int16_t)(((uint64_t)(uint16_t)(firstX + i) * s.xMul) >> s.xShift);
+  }
+}
@@ -0,0 +1,79 @@
+/***************************************************************************************
+ * Fixed point coordinate transform for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - the scale factors are calculated once per graph configuration
+ *  - mapping a sample is one 32x32->64 bit multiply and a shift, no double math
+ *    (the ESP32 has no double FPU, every double division is emulated in software)
+ *  - gives the same pixels as the double formula in ytGraph() v0.5
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_SCALE_h
+#define YTGRAPH_SCALE_h
+
+#include <stdint.h>
+
+struct ytGraphScale
+{
+  uint32_t xMul;   // width / x range as fixed point number
+  uint8_t xShift;  // number of fraction bits of xMul
+  uint32_t yMul;   // height / y range as fixed point number
+  uint8_t yShift;  // number of fraction bits of yMul
+  int16_t height;  // y is flipped around the height of the graph
+  int16_t yOffset; // sample value at the bottom line, 0 = v0.5 (the y axis starts at 0)
+};
+
+// helper: factor as 32 bit fixed point number with as many fraction bits as possible
+// rounded up, so exact results (and .5 ties) are never missed by the truncating shift
+constexpr void ytGraphScaleFactor(double factor, uint32_t &mul, uint8_t &shift)
+{
+  shift = 1;
+  while (shift < 62 && factor * (double)((uint64_t)1 << (shift + 1)) < 4294967295.0)
+    shift++;
+  double m = factor * (double)((uint64_t)1 << shift);
+  mul = (uint32_t)m;
+  if (mul < m) // ceil() is not constexpr
+    mul++;
+}
+
+// width/height: graph size in px (axis to axis), xRange/yRange: axis span (min is added as abs(min), like v0.5)
+// yOffset is subtracted from every sample first (e.g. the lower end of an auto scaled axis)
+// constexpr, the scale of a constant configuration is computed by the compiler
+constexpr ytGraphScale ytGraphScaleInit(uint16_t width, uint16_t height, int32_t xRange, double yRange, int16_t yOffset = 0)
+{
+  ytGraphScale s{};
+  ytGraphScaleFactor(xRange > 0 ? (double)width / xRange : 0.0, s.xMul, s.xShift);
+  ytGraphScaleFactor(yRange > 0.0 ? height / yRange : 0.0, s.yMul, s.yShift);
+  s.height = height;
+  s.yOffset = yOffset;
+  return s;
+}
+
+inline int16_t ytGraphMapX(const ytGraphScale &s, uint16_t x) // x = width * x / xRange (integer division)
+{
+  return (int16_t)(((uint64_t)x * s.xMul) >> s.xShift);
+}
+
+inline int16_t ytGraphMapY(const ytGraphScale &s, int16_t y) // y = |lround(height * (y - yOffset) / yRange) - height|
+{
+  int32_t v = (int32_t)y - s.yOffset;
+  uint32_t a = v < 0 ? -v : v;
+  int32_t r = (int32_t)(((uint64_t)a * s.yMul + ((uint64_t)1 << (s.yShift - 1))) >> s.yShift); // round half away from zero
+  r = (v < 0 ? -r : r) - s.height;
+  return (int16_t)(r < 0 ? -r : r);
+}
+
+// maps n samples (x = firstX, firstX + 1, ...) to sprite pixels in one go, px may be nullptr
+void ytGraphMapBatch(const ytGraphScale &s, uint16_t firstX, const int16_t *y, int16_t *px, int16_t *py, uint16_t n);
+
+#endif
@@ -0,0 +1,395 @@
+/***************************************************************************************
+ * Span rasterizer for the lines of the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphSpan.h"
+#include <string.h>
+
+#define SPAN_FIX 8 // fraction bits of the y positions (8 bits keep y * 256 in int32 for any int16 y)
+#define SPAN_ONE (1 << SPAN_FIX)
+
+bool ytGraphSpanBegin(TFT_eSprite &Graph, ytGraphSpanTarget &t)
+{
+  t.bpp = Graph.getColorDepth();
+  t.img = (uint8_t *)Graph.getPointer();
+  t.width = Graph.width();
+  t.height = Graph.height();
+  if (!t.img || t.width < 2 || t.height < 2)
+    return false;
+
+  // a few test pixels at the upper left corner must land where expected, then the corner is restored
+  bool ok = false;
+  if (t.bpp == 4)
+  {
+    t.stride = (t.width + 1) / 2; // rows start on a byte
+    uint8_t save0 = t.img[0], save1 = t.img[t.stride];
+    Graph.drawPixel(0, 0, TFT_BLACK);
+    uint8_t black = t.img[0] >> 4;
+    Graph.drawPixel(0, 0, TFT_WHITE);
+    uint8_t white = t.img[0] >> 4;
+    Graph.drawPixel(1, 0, TFT_WHITE);
+    Graph.drawPixel(0, 1, TFT_WHITE);
+    ok = black != white && (t.img[0] & 0x0F) == white && (t.img[t.stride] >> 4) == white;
+    t.img[0] = save0;
+    t.img[t.stride] = save1;
+  }
+  else if (t.bpp == 16)
+  {
+    t.stride = t.width * 2;
+    uint16_t *row0 = (uint16_t *)t.img, *row1 = (uint16_t *)(t.img + t.stride);
+    uint16_t save0 = row0[0], save1 = row0[1], save2 = row1[0];
+    Graph.drawPixel(0, 0, 0x1234);
+    Graph.drawPixel(1, 0, 0x5678);
+    Graph.drawPixel(0, 1, 0x9ABC);
+    ok = row0[0] == 0x3412 && row0[1] == 0x7856 && row1[0] == 0xBC9A; // byte swapped
+    row0[0] = save0;
+    row0[1] = save1;
+    row1[0] = save2;
+  }
+  return ok;
+}
+
+uint16_t ytGraphSpanPixel(TFT_eSprite &Graph, const ytGraphSpanTarget &t, uint16_t color)
+{
+  // the sprite converts the colour itself, so the palette of the library is used
+  if (t.bpp == 4)
+  {
+    uint8_t save = t.img[0];
+    Graph.drawPixel(0, 0, color);
+    uint16_t index = t.img[0] >> 4;
+    t.img[0] = save;
+    return index;
+  }
+  return (uint16_t)((color >> 8) | (color << 8));
+}
+
+static uint16_t blend(uint16_t bg, uint16_t fg, int32_t a) // byte swapped 565 colours, a = 0..SPAN_ONE
+{
+  bg = (bg >> 8) | (bg << 8);
+  fg = (fg >> 8) | (fg << 8);
+  int32_t r = (bg >> 11) + ((((fg >> 11) - (bg >> 11)) * a) >> SPAN_FIX);
+  int32_t g = ((bg >> 5) & 0x3F) + (((((fg >> 5) & 0x3F) - ((bg >> 5) & 0x3F)) * a) >> SPAN_FIX);
+  int32_t b = (bg & 0x1F) + ((((fg & 0x1F) - (bg & 0x1F)) * a) >> SPAN_FIX);
+  uint16_t c = (uint16_t)((r << 11) | (g << 5) | b);
+  return (c >> 8) | (c << 8);
+}
+
+// rows top..bottom of one column, already clipped
+static inline void span4(const ytGraphSpanTarget &t, int16_t x, int16_t top, int16_t bottom, uint8_t index)
+{
+  uint8_t *p = t.img + top * t.stride + (x >> 1);
+  uint8_t keep = (x & 1) ? 0xF0 : 0x0F;
+  uint8_t value = (x & 1) ? index : (uint8_t)(index << 4);
+  for (int16_t y = top; y <= bottom; y++, p += t.stride)
+    *p = (*p & keep) | value;
+}
+
+static inline void span16(const ytGraphSpanTarget &t, int16_t x, int16_t top, int16_t bottom, uint16_t pixel)
+{
+  uint8_t *p = t.img + top * t.stride + x * 2;
+  for (int16_t y = top; y <= bottom; y++, p += t.stride)
+    *(uint16_t *)p = pixel;
+}
+
+struct spanLine // one segment with x0 <= x1, y in fixed point
+{
+  int16_t x0, x1;
+  int32_t y0, y1;
+  int32_t slope; // y per column
+};
+
+static inline void spanLineInit(spanLine &l, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+  if (x1 < x0) // tolerate a segment drawn backwards
+  {
+    int16_t x = x0, y = y0;
+    x0 = x1, y0 = y1, x1 = x, y1 = y;
+  }
+  l.x0 = x0;
+  l.x1 = x1;
+  l.y0 = (int32_t)y0 * SPAN_ONE;
+  l.y1 = (int32_t)y1 * SPAN_ONE;
+  l.slope = x1 > x0 ? (l.y1 - l.y0) / (x1 - x0) : 0;
+}
+
+// whole pixels: width rows around the rounded ends of the segment in column x, clipped to the sprite
+static inline bool spanRows(const ytGraphSpanTarget &t, const spanLine &l, int16_t x, uint8_t width, int16_t &top, int16_t &bottom)
+{
+  if (x < l.x0 || x > l.x1)
+    return false;
+
+  // the line crosses the column between its left and right border (or the end points)
+  int32_t c = l.y0 + l.slope * (x - l.x0);
+  int32_t a = x == l.x0 ? l.y0 : c - l.slope / 2;
+  int32_t b = x == l.x1 ? l.y1 : c + l.slope / 2;
+  int32_t lo = a < b ? a : b, hi = a < b ? b : a;
+  int32_t t0 = ((lo + SPAN_ONE / 2) >> SPAN_FIX) - (width - 1) / 2;
+  int32_t b0 = ((hi + SPAN_ONE / 2) >> SPAN_FIX) + width / 2;
+  if (t0 < 0)
+    t0 = 0;
+  if (b0 >= t.height)
+    b0 = t.height - 1;
+  top = (int16_t)t0;
+  bottom = (int16_t)b0;
+  return t0 <= b0;
+}
+
+// anti-aliased: the stroke covers [lo - width / 2, hi + width / 2], row y covers [y - 0.5, y + 0.5]
+static inline void spanColumnAA(const ytGraphSpanTarget &t, const spanLine &l, int16_t x, uint16_t pixel, uint8_t width)
+{
+  if (x < l.x0 || x > l.x1)
+    return;
+
+  int32_t c = l.y0 + l.slope * (x - l.x0);
+  int32_t a = x == l.x0 ? l.y0 : c - l.slope / 2;
+  int32_t b = x == l.x1 ? l.y1 : c + l.slope / 2;
+  int32_t lo = a < b ? a : b, hi = a < b ? b : a;
+  int32_t top = lo - width * SPAN_ONE / 2, bottom = hi + width * SPAN_ONE / 2;
+  int32_t first = (top + SPAN_ONE / 2) >> SPAN_FIX, last = (bottom + SPAN_ONE / 2 - 1) >> SPAN_FIX;
+  if (first < 0)
+    first = 0;
+  if (last >= t.height)
+    last = t.height - 1;
+  for (int32_t y = first; y <= last; y++)
+  {
+    int32_t rowTop = y * SPAN_ONE - SPAN_ONE / 2, rowBottom = rowTop + SPAN_ONE;
+    int32_t cover = (bottom < rowBottom ? bottom : rowBottom) - (top > rowTop ? top : rowTop);
+    uint16_t *p = (uint16_t *)(t.img + y * t.stride + x * 2);
+    if (cover >= SPAN_ONE)
+      *p = pixel;
+    else if (cover > 0)
+      *p = blend(*p, pixel, cover);
+  }
+}
+
+// the span of one segment in column x (inside the sprite)
+static inline void spanColumn(const ytGraphSpanTarget &t, const spanLine &l, int16_t x, uint16_t pixel, uint8_t width, bool aa)
+{
+  int16_t top, bottom;
+  if (aa)
+    spanColumnAA(t, l, x, pixel, width);
+  else if (spanRows(t, l, x, width, top, bottom))
+  {
+    if (t.bpp == 4)
+      span4(t, x, top, bottom, pixel);
+    else
+      span16(t, x, top, bottom, pixel);
+  }
+}
+
+void ytGraphSpanSegment(const ytGraphSpanTarget &t, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t pixel,
+                        uint8_t width, bool aa)
+{
+  spanLine l;
+  spanLineInit(l, x0, y0, x1, y1);
+  if (l.x1 < 0 || l.x0 >= t.width || !width)
+    return;
+
+  int16_t from = l.x0 < 0 ? 0 : l.x0, to = l.x1 < t.width ? l.x1 : t.width - 1;
+  aa = aa && t.bpp == 16;
+  for (int16_t x = from; x <= to; x++)
+    spanColumn(t, l, x, pixel, width, aa);
+}
+
+void ytGraphSpanSeries(TFT_eSprite &Graph, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n,
+                       uint8_t width, bool aa)
+{
+  ytGraphSpanTarget t;
+  if (!ytGraphSpanBegin(Graph, t))
+  {
+    ytGraphSeries(Graph, ch, firstX, y, n); // e.g. a 1 bit sprite
+    return;
+  }
+  uint16_t pixel = ytGraphSpanPixel(Graph, t, ch.color);
+
+  int16_t px[32], py[32];
+  for (uint16_t i = 0; i < n; i += 32)
+  {
+    uint16_t len = (n - i) < 32 ? (n - i) : 32;
+    ytGraphMapBatch(ytGraphScaleDefault, firstX + i, y + i, px, py, len);
+
+    if (firstX + i == 0) // new page, the line starts at the first sample
+    {
+      ch.ox = px[0];
+      ch.oy = py[0];
+    }
+    for (uint16_t k = 0; k < len; k++)
+    {
+      ytGraphSpanSegment(t, ch.ox, ch.oy, px[k], py[k], pixel, width, aa);
+      ch.ox = px[k];
+      ch.oy = py[k];
+    }
+  }
+}
+
+struct spanLines // the segments of all channels between two samples, they share the x range
+{
+  int16_t x0, x1;
+  int32_t y0[SPAN_CHANNELS], y1[SPAN_CHANNELS], slope[SPAN_CHANNELS]; // structure of arrays
+};
+
+static void spanLinesInit(spanLines &l, int16_t x0, int16_t x1, const int16_t *y0, const int16_t *y1, uint8_t channels)
+{
+  l.x0 = x0;
+  l.x1 = x1;
+  for (uint8_t c = 0; c < channels; c++)
+  {
+    l.y0[c] = (int32_t)y0[c] * SPAN_ONE;
+    l.y1[c] = (int32_t)y1[c] * SPAN_ONE;
+    l.slope[c] = x1 > x0 ? (l.y1[c] - l.y0[c]) / (x1 - x0) : 0;
+  }
+}
+
+// the same as spanRows() for every channel in one branch free loop, the compiler vectorizes it
+static inline void spanLinesRows(const ytGraphSpanTarget &t, const spanLines &l, int16_t x, uint8_t width, uint8_t channels,
+                                 int16_t *top, int16_t *bottom)
+{
+  int32_t dx = x - l.x0, up = (width - 1) / 2, down = width / 2;
+  bool first = x == l.x0, last = x == l.x1;
+  for (uint8_t c = 0; c < channels; c++)
+  {
+    int32_t m = l.y0[c] + l.slope[c] * dx;
+    int32_t a = first ? l.y0[c] : m - l.slope[c] / 2;
+    int32_t b = last ? l.y1[c] : m + l.slope[c] / 2;
+    int32_t t0 = (((a < b ? a : b) + SPAN_ONE / 2) >> SPAN_FIX) - up;
+    int32_t b0 = (((a < b ? b : a) + SPAN_ONE / 2) >> SPAN_FIX) + down;
+    top[c] = (int16_t)(t0 < 0 ? 0 : t0);
+    bottom[c] = (int16_t)(b0 >= t.height ? t.height - 1 : b0);
+  }
+}
+
+static inline void spanLinesColumn(const ytGraphSpanTarget &t, const spanLines &l, uint8_t c, int16_t x, int16_t top,
+                                   int16_t bottom, uint16_t pixel, uint8_t width, bool aa)
+{
+  if (aa)
+  {
+    spanLine one{l.x0, l.x1, l.y0[c], l.y1[c], l.slope[c]};
+    spanColumnAA(t, one, x, pixel, width);
+  }
+  else if (top <= bottom)
+  {
+    if (t.bpp == 4)
+      span4(t, x, top, bottom, pixel);
+    else
+      span16(t, x, top, bottom, pixel);
+  }
+}
+
+static void spanMapColumn(const int16_t *const *rows, uint16_t n, const int16_t *const *rows2, uint8_t channels, uint16_t k,
+                          uint16_t x, int16_t *py)
+{
+  int16_t v[SPAN_CHANNELS]; // the values of all channels at one x, mapped in one batch
+  for (uint8_t c = 0; c < channels; c++)
+    v[c] = k < n ? rows[c][k] : rows2[c][k - n];
+  ytGraphMapBatch(ytGraphScaleDefault, x, v, nullptr, py, channels);
+}
+
+void ytGraphSpanChannels(TFT_eSprite &Graph, ytGraphChannel *ch, uint8_t channels, uint16_t firstX,
+                         const int16_t *const *rows, uint16_t n, uint8_t width, bool aa)
+{
+  ytGraphSpanChannels(Graph, ch, channels, firstX, rows, n, nullptr, 0, width, aa);
+}
+
+void ytGraphSpanChannels(TFT_eSprite &Graph, ytGraphChannel *ch, uint8_t channels, uint16_t firstX,
+                         const int16_t *const *rows, uint16_t n1, const int16_t *const *rows2, uint16_t n2, uint8_t width, bool aa)
+{
+  if (channels > SPAN_CHANNELS)
+    channels = SPAN_CHANNELS;
+  ytGraphSpanTarget t;
+  if (!ytGraphSpanBegin(Graph, t))
+  {
+    for (uint8_t c = 0; c < channels; c++)
+    {
+      ytGraphSeries(Graph, ch[c], firstX, rows[c], n1);
+      if (n2)
+        ytGraphSeries(Graph, ch[c], firstX + n1, rows2[c], n2);
+    }
+    return;
+  }
+  uint16_t n = n1 + n2;
+  if (!n || !channels || !width)
+    return;
+  aa = aa && t.bpp == 16;
+
+  uint16_t pixel[SPAN_CHANNELS];
+  for (uint8_t c = 0; c < channels; c++)
+    pixel[c] = ytGraphSpanPixel(Graph, t, ch[c].color);
+
+  int16_t px = ytGraphMapX(ytGraphScaleDefault, firstX), oy[SPAN_CHANNELS], py[SPAN_CHANNELS];
+  spanMapColumn(rows, n1, rows2, channels, 0, firstX, py);
+  bool joined = true; // all channels continue at the same x (they do if they are always drawn together)
+  for (uint8_t c = 0; c < channels; c++)
+  {
+    if (firstX == 0) // new page, the line starts at the first sample
+    {
+      ch[c].ox = px;
+      ch[c].oy = py[c];
+    }
+    joined = joined && ch[c].ox == ch[0].ox;
+    oy[c] = ch[c].oy;
+  }
+  if (!joined || ch[0].ox > px)
+  {
+    // first segment channel by channel, from then on they share x
+    for (uint8_t c = 0; c < channels; c++)
+    {
+      ytGraphSpanSegment(t, ch[c].ox, ch[c].oy, px, py[c], pixel[c], width, aa);
+      ch[c].ox = px;
+      ch[c].oy = oy[c] = py[c];
+    }
+  }
+
+  spanLines lines[2]; // segments of this sample and of the next one
+  int16_t top[2][SPAN_CHANNELS], bottom[2][SPAN_CHANNELS];
+  spanLinesInit(lines[0], ch[0].ox, px, oy, py, channels);
+  int16_t from = ch[0].ox;
+  uint8_t cur = 0;
+  for (uint16_t k = 0; k < n; k++, cur ^= 1)
+  {
+    bool more = k + 1 < n;
+    int16_t to = px;
+    if (more)
+    {
+      memcpy(oy, py, channels * sizeof(int16_t));
+      px = ytGraphMapX(ytGraphScaleDefault, firstX + k + 1);
+      spanMapColumn(rows, n1, rows2, channels, k + 1, firstX + k + 1, py);
+      spanLinesInit(lines[cur ^ 1], to, px, oy, py, channels);
+    }
+
+    // column by column, every channel while the column is in cache
+    // the column where two segments meet gets both of a channel before the next channel,
+    // so the picture is the same as channel by channel
+    int16_t x = from < 0 ? 0 : from, last = to < t.width ? to : t.width - 1;
+    for (; x <= last; x++)
+    {
+      bool meet = more && x == to;
+      spanLinesRows(t, lines[cur], x, width, channels, top[0], bottom[0]);
+      if (meet)
+        spanLinesRows(t, lines[cur ^ 1], x, width, channels, top[1], bottom[1]);
+      for (uint8_t c = 0; c < channels; c++)
+      {
+        spanLinesColumn(t, lines[cur], c, x, top[0][c], bottom[0][c], pixel[c], width, aa);
+        if (meet)
+          spanLinesColumn(t, lines[cur ^ 1], c, x, top[1][c], bottom[1][c], pixel[c], width, aa);
+      }
+    }
+    from = to + 1;
+  }
+
+  for (uint8_t c = 0; c < channels; c++)
+  {
+    ch[c].ox = px;
+    ch[c].oy = py[c];
+  }
+}
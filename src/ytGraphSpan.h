@@ -0,0 +1,70 @@
+/***************************************************************************************
+ * Span rasterizer for the lines of the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - a line segment of a time series goes from left to right (monotone x), so it is
+ *    drawn column by column as one vertical span per column, of any stroke width
+ *  - the pixels are written straight into the memory of the sprite: packed 4 bit
+ *    palette indices (two pixels per byte, even x in the high nibble) or byte swapped
+ *    16 bit colours, the same layout TFT_eSPI uses
+ *  - on 16 bit sprites the upper and lower end of every span can be anti-aliased
+ *  - ytGraphSpanBegin() checks the memory layout once with a few test pixels,
+ *    if it does not match (or the sprite has 1 bit) use ytGraphSeries() instead
+ *  - ytGraphSpanChannels() draws up to 16 channels column by column: the values of
+ *    all channels at one x are mapped in one batch, then every channel writes its
+ *    span into the same sprite column (see ytGraphChannels.h)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_SPAN_h
+#define YTGRAPH_SPAN_h
+
+#include "ytGraph.h"
+
+#define SPAN_WIDTH 3     // stroke width in px, like the 3 lines of ytGraphDrawSegment()
+#define SPAN_CHANNELS 16 // channels of one ytGraphSpanChannels() pass, the colours of a 4 bit sprite
+
+struct ytGraphSpanTarget // the pixel memory of a 4 or 16 bit sprite
+{
+  uint8_t *img;
+  int16_t width; // visible size
+  int16_t height;
+  int16_t stride; // bytes per row
+  uint8_t bpp;
+};
+
+// false if the sprite has no 4 or 16 bit memory in the expected layout
+bool ytGraphSpanBegin(TFT_eSprite &Graph, ytGraphSpanTarget &t);
+
+// the value the sprite stores for a colour: 4 bit palette index or byte swapped 565 colour
+uint16_t ytGraphSpanPixel(TFT_eSprite &Graph, const ytGraphSpanTarget &t, uint16_t color);
+
+// one segment from (x0, y0) to (x1, y1) with x0 <= x1, clipped to the sprite
+// pixel comes from ytGraphSpanPixel(), aa blends the upper and lower end of the spans (16 bit only)
+void ytGraphSpanSegment(const ytGraphSpanTarget &t, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t pixel,
+                        uint8_t width = SPAN_WIDTH, bool aa = false);
+
+// same as ytGraphSeries(), but with the span rasterizer, falls back to ytGraphSeries() if the sprite does not fit
+// at firstX = 0 the line starts at the first sample (new page), otherwise at ch.ox/ch.oy
+void ytGraphSpanSeries(TFT_eSprite &Graph, ytGraphChannel &ch, uint16_t firstX, const int16_t *y, uint16_t n,
+                       uint8_t width = SPAN_WIDTH, bool aa = false);
+
+// the same for several channels at once, column by column, same pixels as ytGraphSpanSeries() per channel
+// rows[c][k] is the value of channel c at x = firstX + k, ch[c] keeps colour and last point of channel c
+void ytGraphSpanChannels(TFT_eSprite &Graph, ytGraphChannel *ch, uint8_t channels, uint16_t firstX,
+                         const int16_t *const *rows, uint16_t n, uint8_t width = SPAN_WIDTH, bool aa = false);
+// two runs in one pass, e.g. of a ring store that wraps: rows[c][0..n1 - 1] at firstX, then rows2[c][0..n2 - 1]
+void ytGraphSpanChannels(TFT_eSprite &Graph, ytGraphChannel *ch, uint8_t channels, uint16_t firstX,
+                         const int16_t *const *rows, uint16_t n1, const int16_t *const *rows2, uint16_t n2,
+                         uint8_t width = SPAN_WIDTH, bool aa = false);
+
+#endif
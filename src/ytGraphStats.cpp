@@ -0,0 +1,118 @@
+/***************************************************************************************
+ * Hot path instrumentation for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraph.h"
+
+#ifdef YTGRAPH_STATS
+
+ytGraphStageStats ytGraphStats::_stage[STATS_STAGES];
+uint32_t ytGraphStats::_budget = 0;
+uint32_t ytGraphStats::_dropped = 0;
+
+void ytGraphStats::reset()
+{
+  memset(_stage, 0, sizeof(_stage));
+  _dropped = 0;
+}
+
+uint32_t ytGraphStats::cyclesPerUs()
+{
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  return mhz ? mhz : 1;
+}
+
+uint32_t ytGraphStats::percentile(uint8_t stage, uint8_t pct)
+{
+  const ytGraphStageStats &s = _stage[stage];
+  if (!s.count)
+    return 0;
+  uint32_t need = (uint32_t)(((uint64_t)s.count * pct + 99) / 100), sum = 0;
+  for (uint8_t b = 0; b < STATS_BUCKETS; b++)
+  {
+    sum += s.hist[b];
+    if (sum >= need && sum)
+      return b == STATS_BUCKETS - 1 ? maxUs(stage) : (((uint32_t)1 << (b + 7)) - 1) / cyclesPerUs();
+  }
+  return maxUs(stage);
+}
+
+uint32_t ytGraphStats::meanUs(uint8_t stage)
+{
+  const ytGraphStageStats &s = _stage[stage];
+  return s.count ? (uint32_t)(s.total / s.count / cyclesPerUs()) : 0;
+}
+
+const char *ytGraphStats::name(uint8_t stage)
+{
+  static const char *names[STATS_STAGES] = {"ingt", "scrl", "grid", "line", "push", "frme"};
+  return stage < STATS_STAGES ? names[stage] : "?";
+}
+
+static char *appendText(char *p, const char *text)
+{
+  while (*text)
+    *p++ = *text++;
+  return p;
+}
+
+static char *appendNumber(char *p, const char *label, uint32_t v) // e.g. " p50 12", no sprintf
+{
+  p = appendText(p, label);
+  char digits[10];
+  uint8_t n = 0;
+  do
+  {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (n)
+    *p++ = digits[--n];
+  return p;
+}
+
+void ytGraphStats::overlay(TFT_eSPI &tft, int16_t x, int16_t y, uint16_t color, uint16_t bg)
+{
+  char line[64];
+  tft.setTextSize(1);
+  tft.setTextColor(color, bg);
+  tft.setTextDatum(TL_DATUM);
+  for (uint8_t s = 0; s <= STATS_STAGES; s++, y += 8)
+  {
+    char *p = line;
+    if (s < STATS_STAGES)
+    {
+      p = appendText(p, name(s));
+      p = appendNumber(p, " p50 ", percentile(s, 50));
+      p = appendNumber(p, " p99 ", percentile(s, 99));
+      p = appendNumber(p, " max ", maxUs(s));
+      p = appendText(p, " us");
+    }
+    else
+      p = appendNumber(p, "dropped ", _dropped);
+    while (p < line + 40) // overwrites a longer line of the last overlay
+      *p++ = ' ';
+    *p = 0;
+    tft.drawString(line, x, y, 1);
+  }
+}
+
+size_t ytGraphStats::dump(Print &out)
+{
+  uint32_t header[6] = {0x54535459, 1, STATS_STAGES, STATS_BUCKETS, cyclesPerUs(), _dropped}; // "YTST"
+  size_t n = out.write((const uint8_t *)header, sizeof(header));
+  return n + out.write((const uint8_t *)_stage, sizeof(_stage));
+}
+
+#endif
@@ -0,0 +1,130 @@
+/***************************************************************************************
+ * Hot path instrumentation for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - build flag YTGRAPH_STATS (e.g. build_flags = -D YTGRAPH_STATS in platformio.ini),
+ *    without it the macros are empty and nothing of this file is compiled
+ *  - the cycle counter (ESP.getCycleCount(), a steady clock on the host) is read
+ *    around every stage: sample ingest, scroll, grid update, line, push and frame
+ *  - every stage feeds a histogram of STATS_BUCKETS log2 buckets, count, sum and max,
+ *    no division and no allocation in the hot path
+ *  - a frame longer than the frame budget counts the frame slots it dropped
+ *  - query with stage() / percentile(), show with overlay(), send with dump()
+ *  - the counters are not locked, it is safe because every stage is written by one
+ *    thread only. In ytGraphPipeline the transfer task writes the push stage
+ *    (ytGraphCanvas::push()), the render stage writes all others (ingest through
+ *    ytGraphInstance::add()), the sampling task writes none
+ *  - overlay(), dump(), stage() and percentile() read without a lock, also from the
+ *    other core, the numbers of a stage may be one update apart
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_STATS_h
+#define YTGRAPH_STATS_h
+
+#ifdef YTGRAPH_STATS
+
+#include <Arduino.h>
+
+class TFT_eSPI;
+
+#define STATS_INGEST 0 // a sample is stored (channel store, auto scale)
+#define STATS_SCROLL 1 // ytGraphCanvas::scroll()
+#define STATS_GRID 2   // ytGraphDrawDynamicGrid()
+#define STATS_LINE 3   // ytGraph(), one segment
+#define STATS_PUSH 4   // ytGraphCanvas::push()
+#define STATS_FRAME 5  // one frame of drawDynamicGraph() or ytGraphScheduler::run()
+#define STATS_STAGES 6
+
+#define STATS_BUCKETS 20 // bucket 0: < 128 cycles, bucket b: < 2^(b + 7) cycles, the last one takes the rest
+
+struct ytGraphStageStats
+{
+  uint32_t count;
+  uint32_t max;   // cycles
+  uint64_t total; // cycles
+  uint32_t hist[STATS_BUCKETS];
+};
+
+class ytGraphStats
+{
+public:
+  static uint32_t now() { return ESP.getCycleCount(); }
+
+  static void record(uint8_t stage, uint32_t cycles)
+  {
+    ytGraphStageStats &s = _stage[stage];
+    s.count++;
+    s.total += cycles;
+    if (cycles > s.max)
+      s.max = cycles;
+    s.hist[bucket(cycles)]++;
+    if (stage == STATS_FRAME && _budget && cycles > _budget)
+      _dropped += (cycles - 1) / _budget; // the frame slots it ran into
+  }
+
+  static void setFrameBudget(uint32_t us) { _budget = us * cyclesPerUs(); } // 0 = no dropped frames
+  static void reset();
+
+  static const ytGraphStageStats &stage(uint8_t stage) { return _stage[stage]; }
+  static uint32_t dropped() { return _dropped; }
+  static uint32_t cyclesPerUs();
+  static uint32_t percentile(uint8_t stage, uint8_t pct); // upper end of the bucket in us
+  static uint32_t meanUs(uint8_t stage);
+  static uint32_t maxUs(uint8_t stage) { return _stage[stage].max / cyclesPerUs(); }
+  static const char *name(uint8_t stage); // 4 letters
+
+  // one line per stage ("line  p50 12 p99 40 max 51 us") and the dropped frames, text size 1, no sprintf
+  static void overlay(TFT_eSPI &tft, int16_t x, int16_t y, uint16_t color, uint16_t bg);
+
+  // binary: "YTST", version, STATS_STAGES, STATS_BUCKETS, cycles per us, dropped (uint32 each),
+  // then ytGraphStageStats of every stage, little endian as in memory, returns the bytes written
+  static size_t dump(Print &out);
+
+  static uint8_t bucket(uint32_t cycles)
+  {
+    if (cycles < 128)
+      return 0;
+    uint8_t b = 31 - __builtin_clz(cycles) - 6;
+    return b < STATS_BUCKETS ? b : STATS_BUCKETS - 1;
+  }
+
+private:
+  static ytGraphStageStats _stage[STATS_STAGES];
+  static uint32_t _budget; // cycles per frame
+  static uint32_t _dropped;
+};
+
+class ytGraphStageTimer // records the cycles of its scope
+{
+public:
+  explicit ytGraphStageTimer(uint8_t stage) : _stage(stage), _start(ytGraphStats::now()) {}
+  ~ytGraphStageTimer() { ytGraphStats::record(_stage, ytGraphStats::now() - _start); }
+
+private:
+  uint8_t _stage;
+  uint32_t _start;
+};
+
+#define YTGRAPH_STAGE(stage) ytGraphStageTimer ytGraphStageScope(stage)              // the rest of the scope
+#define YTGRAPH_STATS_START(start) uint32_t start = ytGraphStats::now()              // explicit begin ...
+#define YTGRAPH_STATS_RECORD(stage, start) ytGraphStats::record(stage, ytGraphStats::now() - start) // ... and end
+
+#else
+
+#define YTGRAPH_STAGE(stage)
+#define YTGRAPH_STATS_START(start)
+#define YTGRAPH_STATS_RECORD(stage, start)
+
+#endif
+
+#endif
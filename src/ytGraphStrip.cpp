@@ -0,0 +1,108 @@
+/***************************************************************************************
+ * Strip rendering for large panels on the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphStrip.h"
+
+ytGraphStrip::ytGraphStrip(TFT_eSPI &tft)
+    : _tile(&tft), _cfg(ytGraphLayoutDefault), _t(), _tileWidth(0), _bytes(0), _tiles(0), _segments(0)
+{
+}
+
+bool ytGraphStrip::begin(const ytGraphLayout &cfg, uint8_t bpp, int16_t tileWidth, ytGraphArena *arena)
+{
+  end();
+  _tile.setArena(arena);
+  _cfg = cfg;
+  // at least 2 columns for ytGraphSpanBegin(), at most the whole graph
+  _tileWidth = tileWidth < 2 ? 2 : tileWidth > cfg.spriteWidth() ? cfg.spriteWidth() : tileWidth;
+  _tile.setColorDepth(bpp == 4 ? 4 : 16);
+  if (!_tile.createSprite(_tileWidth, cfg.spriteHeight()))
+    return false;
+  if (!ytGraphSpanBegin(_tile, _t))
+  {
+    end();
+    return false;
+  }
+  _bytes = (uint32_t)_t.stride * _t.height;
+  _tiles = (cfg.spriteWidth() + _tileWidth - 1) / _tileWidth;
+  return true;
+}
+
+void ytGraphStrip::end()
+{
+  _tile.deleteSprite();
+  _t.img = nullptr;
+  _bytes = 0;
+  _tiles = 0;
+}
+
+void ytGraphStrip::grid(int16_t x0, int16_t w, int16_t gridX)
+{
+  ytGraphDrawGridY(_tile, _cfg, 0, w); // the same rows in every tile
+  if (_cfg.xStep < 1)
+    return;
+  int16_t x = gridX;
+  if (x < x0) // the first vertical line inside the tile
+    x += (x0 - x + _cfg.xStep - 1) / _cfg.xStep * _cfg.xStep;
+  for (; x < x0 + w; x += _cfg.xStep)
+    _tile.drawFastVLine(x - x0, 0, _cfg.height, _cfg.gridColor);
+}
+
+uint32_t ytGraphStrip::render(const source &src, const uint16_t *colors, int16_t gridX, uint8_t width, bool aa)
+{
+  _segments = 0;
+  if (!_t.img)
+    return 0;
+  uint8_t channels = src.channels < SPAN_CHANNELS ? src.channels : SPAN_CHANNELS;
+  uint16_t pixel[SPAN_CHANNELS];
+  for (uint8_t c = 0; c < channels; c++)
+    pixel[c] = ytGraphSpanPixel(_tile, _t, colors[c]);
+  aa = aa && _t.bpp == 16;
+
+  const ytGraphScale &s = _cfg.scale;
+  int16_t total = _cfg.spriteWidth(), h = _tile.height();
+  uint32_t first = 0; // first sample at or right of the tile, only moves forward
+  uint32_t bytes = 0;
+  for (int16_t x0 = 0; x0 < total; x0 += _tileWidth)
+  {
+    int16_t w = total - x0 < _tileWidth ? total - x0 : _tileWidth;
+    _tile.fillSprite(_cfg.bgrndColor);
+    grid(x0, w, gridX);
+
+    while (first < src.n && ytGraphMapX(s, first) < x0)
+      first++;
+    // segment k runs from sample k - 1 to sample k (segment 0 is the first point alone)
+    // the first one in the tile ends at 'first', the last one starts inside the tile
+    for (uint8_t c = 0; c < channels && first < src.n; c++)
+    {
+      uint32_t k = first ? first - 1 : 0;
+      int16_t ox = ytGraphMapX(s, k) - x0, oy = ytGraphMapY(s, src.value(c, k));
+      for (k = first; k < src.n; k++)
+      {
+        int16_t px = ytGraphMapX(s, k) - x0, py = ytGraphMapY(s, src.value(c, k));
+        ytGraphSpanSegment(_t, ox, oy, px, py, pixel[c], width, aa); // clipped to the tile
+        _segments++;
+        if (px >= w) // the next segment starts right of the tile
+          break;
+        ox = px;
+        oy = py;
+      }
+    }
+
+    _tile.pushSprite(_cfg.spriteX() + x0, _cfg.spriteY(), 0, 0, w, h);
+    bytes += (uint32_t)w * h * 2;
+  }
+  return bytes;
+}
@@ -0,0 +1,95 @@
+/***************************************************************************************
+ * Strip rendering for large panels on the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - the plot is not kept in one sprite of the whole graph (a 480x320 panel with
+ *    16 bit colours needs about 300 KB, more than the largest free block of the
+ *    ESP32 heap, see getMaxAllocHeap() in main.cpp), it is rasterized tile by tile
+ *    into one small sprite of STRIP_WIDTH columns that is pushed and reused
+ *  - the tiles are strips of sprite columns: the samples are ordered by x, so the
+ *    segments that cross a tile are one contiguous run, every tile walks only them
+ *    (plus the one that crosses its left border), a frame walks about
+ *    samples + tiles segments instead of samples * tiles
+ *  - every frame redraws grid and lines of the whole page, the price of the lower
+ *    memory is CPU time, not pixel bytes (the strips are sent once each)
+ *  - the lines are drawn with the span rasterizer, same pixels as ytGraphDrawChannels()
+ *    into a sprite of the whole graph
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_STRIP_h
+#define YTGRAPH_STRIP_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphChannels.h"
+#include "ytGraphSpan.h"
+
+#define STRIP_WIDTH 24 // sprite columns of one tile
+
+class ytGraphStrip
+{
+public:
+  explicit ytGraphStrip(TFT_eSPI &tft);
+  ~ytGraphStrip() { end(); }
+
+  // creates the tile sprite (tileWidth x the sprite height of cfg) with 4 or 16 bit
+  // false if out of memory or the span rasterizer cannot use the sprite, arena = nullptr: from the heap
+  bool begin(const ytGraphLayout &cfg, uint8_t bpp = 16, int16_t tileWidth = STRIP_WIDTH, ytGraphArena *arena = nullptr);
+  void end();
+
+  // grid and lines of all channels of s (sample 0 at x = 0), tile by tile, every tile is pushed
+  // gridX: sprite column of the first vertical grid line, the next ones follow every xStep
+  // (cfg.xStep on a new page, move it left with the samples while scrolling)
+  // returns the pixel bytes sent
+  template <uint8_t C, uint32_t N>
+  uint32_t draw(const ytGraphChannelStore<C, N> &s, const uint16_t *colors, int16_t gridX, uint8_t width = SPAN_WIDTH,
+                bool aa = false)
+  {
+    source src;
+    src.channels = C;
+    src.n = s.size();
+    s.runs(0, src.n, src.rows, src.split);
+    for (uint8_t c = 0; c < C; c++)
+      src.wrap[c] = s.row(c);
+    return render(src, colors, gridX, width, aa);
+  }
+
+  uint32_t bytes() const { return _bytes; }            // pixel memory of the tile sprite, the peak of this mode
+  uint16_t tiles() const { return _tiles; }            // tiles of one frame
+  uint32_t lastSegments() const { return _segments; } // segments walked by the last draw(), all channels
+
+private:
+  struct source // the samples of all channels as two runs, like ytGraphChannelStore::runs()
+  {
+    const int16_t *rows[SPAN_CHANNELS]; // first run
+    const int16_t *wrap[SPAN_CHANNELS]; // second run, starts at sample 'split'
+    uint32_t split;
+    uint32_t n;
+    uint8_t channels;
+
+    int16_t value(uint8_t c, uint32_t i) const { return i < split ? rows[c][i] : wrap[c][i - split]; }
+  };
+
+  uint32_t render(const source &src, const uint16_t *colors, int16_t gridX, uint8_t width, bool aa);
+  void grid(int16_t x0, int16_t w, int16_t gridX);
+
+  ytGraphSprite _tile;
+  ytGraphLayout _cfg;
+  ytGraphSpanTarget _t;
+  int16_t _tileWidth;
+  uint32_t _bytes;
+  uint16_t _tiles;
+  uint32_t _segments;
+};
+
+#endif
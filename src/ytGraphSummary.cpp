@@ -0,0 +1,235 @@
+/***************************************************************************************
+ * Streaming per channel statistics for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphSummary.h"
+#include <math.h>
+
+ytGraphSummary::ytGraphSummary()
+    : _ring(nullptr), _window(0), _head(0), _count(0), _channels(0), _emaShift(SUMMARY_EMA_SHIFT), _arena(nullptr)
+{
+  clear();
+}
+
+bool ytGraphSummary::begin(uint32_t window, uint8_t channels, ytGraphArena *arena, uint8_t emaShift)
+{
+  end();
+  if (!window || window > 65535)
+    return false;
+  _arena = arena;
+  _channels = channels < SUMMARY_CHANNELS ? channels : SUMMARY_CHANNELS;
+  if (arena && !arena->fits(bytes(window, _channels))) // nothing is taken if it does not fit
+    return false;
+  _ring = (int16_t *)ytGraphAlloc(_arena, (uint32_t)_channels * window * sizeof(int16_t));
+  if (!_ring)
+    return false;
+  for (uint8_t c = 0; c < _channels; c++)
+    if (!_minMax[c].begin(window, arena))
+    {
+      end();
+      return false;
+    }
+  _window = window;
+  _emaShift = emaShift < 16 ? emaShift : 15;
+  clear();
+  return true;
+}
+
+void ytGraphSummary::end()
+{
+  for (uint8_t c = 0; c < SUMMARY_CHANNELS; c++)
+    _minMax[c].end();
+  ytGraphFree(_arena, _ring);
+  _ring = nullptr;
+  _window = 0;
+}
+
+uint32_t ytGraphSummary::bytes(uint32_t window, uint8_t channels)
+{
+  if (channels > SUMMARY_CHANNELS)
+    channels = SUMMARY_CHANNELS;
+  return ytGraphArena::align((uint32_t)channels * window * sizeof(int16_t)) + channels * ytGraphMinMax::bytes(window);
+}
+
+void ytGraphSummary::clear()
+{
+  _head = 0;
+  _count = 0;
+  for (uint8_t c = 0; c < SUMMARY_CHANNELS; c++)
+  {
+    _minMax[c].clear();
+    _ch[c] = channel{0, 0, 0.0, 0.0, 0, 0, 0, 0};
+  }
+}
+
+void ytGraphSummary::add(const int16_t *y)
+{
+  if (!_ring)
+    return;
+  for (uint8_t c = 0; c < _channels; c++)
+  {
+    channel &s = _ch[c];
+    int16_t v = y[c];
+    int16_t &slot = _ring[(uint32_t)c * _window + _head];
+
+    // window: the oldest value leaves, the new one takes its slot
+    if (_count == _window)
+    {
+      s.sum -= slot;
+      s.sumSq -= (uint64_t)((int32_t)slot * slot);
+    }
+    slot = v;
+    s.sum += v;
+    s.sumSq += (uint64_t)((int32_t)v * v);
+    _minMax[c].push(v, v);
+
+    // since begin(): Welford
+    s.n++;
+    double d = v - s.mean;
+    s.mean += d / s.n;
+    s.m2 += d * (v - s.mean);
+    if (s.n == 1 || v < s.min)
+      s.min = v;
+    if (s.n == 1 || v > s.max)
+      s.max = v;
+
+    // EMA, starts at the first value
+    int32_t fix = (int32_t)v * 256;
+    s.ema = s.n == 1 ? fix : s.ema + ((fix - s.ema) >> _emaShift);
+  }
+  if (++_head == _window)
+    _head = 0;
+  if (_count < _window)
+    _count++;
+}
+
+ytGraphChannelSummary ytGraphSummary::window(uint8_t channel) const
+{
+  ytGraphChannelSummary r{0, 0, 0, 0.0f, 0.0f};
+  if (channel >= _channels || !_count)
+    return r;
+  const struct channel &s = _ch[channel];
+  r.count = _count;
+  r.min = _minMax[channel].min();
+  r.max = _minMax[channel].max();
+  r.mean = (float)((double)s.sum / _count);
+  // n * sum(x^2) - sum(x)^2 is exact in 64 bit for 65535 samples of 16 bit
+  uint64_t var = (uint64_t)_count * s.sumSq - (uint64_t)(s.sum * s.sum);
+  r.stddev = (float)(sqrt((double)var) / _count);
+  return r;
+}
+
+ytGraphChannelSummary ytGraphSummary::total(uint8_t channel) const
+{
+  ytGraphChannelSummary r{0, 0, 0, 0.0f, 0.0f};
+  if (channel >= _channels || !_ch[channel].n)
+    return r;
+  const struct channel &s = _ch[channel];
+  r.count = s.n;
+  r.min = s.min;
+  r.max = s.max;
+  r.mean = (float)s.mean;
+  r.stddev = (float)sqrt(s.m2 / s.n);
+  return r;
+}
+
+static int16_t markY(const ytGraphLayout &cfg, float v) // panel row of a value, inside the graph
+{
+  int16_t y = ytGraphMapY(cfg.scale, (int16_t)lroundf(v < -32768.0f ? -32768.0f : v > 32767.0f ? 32767.0f : v));
+  y = y < 0 ? 0 : y > cfg.height ? cfg.height : y;
+  return cfg.spriteY() + y;
+}
+
+void ytGraphDrawSummaryMarks(TFT_eSPI &d, const ytGraphLayout &cfg, const ytGraphSummary &s, const ytGraphChannel *ch)
+{
+  int16_t x = cfg.left + cfg.width + 4; // right of the frame lines
+  d.fillRect(x, cfg.spriteY() - 1, s.channels() * SUMMARY_MARK_WIDTH, cfg.height + 3, cfg.bgrndColor);
+  for (uint8_t c = 0; c < s.channels(); c++, x += SUMMARY_MARK_WIDTH)
+  {
+    ytGraphChannelSummary w = s.window(c);
+    if (!w.count)
+      continue;
+    int16_t top = markY(cfg, w.max), bottom = markY(cfg, w.min); // y is flipped
+    d.drawFastVLine(x + 1, top, bottom - top + 1, ch[c].color);
+    int16_t mean = markY(cfg, w.mean);
+    d.drawFastHLine(x, mean - 1, SUMMARY_MARK_WIDTH - 1, ch[c].color);
+    d.drawFastHLine(x, mean, SUMMARY_MARK_WIDTH - 1, ch[c].color);
+  }
+
+  // the x axis caption shares the lower right corner
+  d.setTextSize(1);
+  d.setTextColor(cfg.axisLineColor, cfg.bgrndColor);
+  d.setCursor(cfg.left + cfg.width + 6, cfg.bottom - 5);
+  d.print(cfg.xLabel);
+}
+
+static char *appendInt(char *p, int32_t v)
+{
+  if (v < 0)
+  {
+    *p++ = '-';
+    v = -v;
+  }
+  char digits[10];
+  uint8_t n = 0;
+  do
+  {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (n)
+    *p++ = digits[--n];
+  return p;
+}
+
+static char *appendFixed1(char *p, float v) // one decimal, rounded
+{
+  int32_t t = (int32_t)lroundf(v * 10.0f);
+  if (t < 0)
+  {
+    *p++ = '-';
+    t = -t;
+  }
+  p = appendInt(p, t / 10);
+  *p++ = '.';
+  *p++ = '0' + t % 10;
+  return p;
+}
+
+void ytGraphDrawSummaryLegend(TFT_eSPI &d, int16_t x, int16_t y, const ytGraphSummary &s, const ytGraphChannel *ch,
+                              uint16_t bg)
+{
+  char line[48];
+  d.setTextSize(1);
+  d.setTextDatum(TL_DATUM);
+  for (uint8_t c = 0; c < s.channels(); c++, y += 8)
+  {
+    ytGraphChannelSummary w = s.window(c);
+    char *p = appendFixed1(line, w.mean);
+    *p++ = ' ';
+    *p++ = '+';
+    *p++ = '-';
+    p = appendFixed1(p, w.stddev);
+    *p++ = ' ';
+    p = appendInt(p, w.min);
+    *p++ = '.';
+    *p++ = '.';
+    p = appendInt(p, w.max);
+    while (p < line + 24) // overwrites a longer line of the last legend
+      *p++ = ' ';
+    *p = 0;
+    d.setTextColor(ch[c].color, bg);
+    d.drawString(line, x, y, 1);
+  }
+}
@@ -0,0 +1,99 @@
+/***************************************************************************************
+ * Streaming per channel statistics for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - min, max, mean, standard deviation and EMA of every channel, over the visible
+ *    window and since begin(), updated in O(1) per sample in the ingest path
+ *  - window: exact integer sum and sum of squares, the value that leaves the window
+ *    is subtracted again (no drift), min/max with the deques of ytGraphMinMax
+ *  - since begin(): Welford's running mean and M2 in double, stable for any length
+ *  - EMA as 24.8 fixed point number, alpha = 1 / 2^emaShift
+ *  - the mean and its spread can be drawn as reference marks right of the graph
+ *    frame (next to the y axis) or as a text legend, no history is scanned
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_SUMMARY_h
+#define YTGRAPH_SUMMARY_h
+
+#include "ytGraph.h"
+#include "ytGraphArena.h"
+#include "ytGraphAutoscale.h"
+
+#define SUMMARY_CHANNELS 16 // channels of one ytGraphSummary
+#define SUMMARY_EMA_SHIFT 3 // EMA alpha = 1/8
+#define SUMMARY_MARK_WIDTH 4 // px per channel of ytGraphDrawSummaryMarks()
+
+struct ytGraphChannelSummary // one channel, over the window or since begin()
+{
+  uint32_t count; // 0: the other fields are 0
+  int16_t min;
+  int16_t max;
+  float mean;
+  float stddev; // population standard deviation (divided by count)
+};
+
+class ytGraphSummary
+{
+public:
+  ytGraphSummary();
+  ~ytGraphSummary() { end(); }
+
+  // window: samples of the visible page (e.g. SAMPLE_COUNT + 1, at most 65535), arena = nullptr: from the heap
+  bool begin(uint32_t window, uint8_t channels, ytGraphArena *arena = nullptr, uint8_t emaShift = SUMMARY_EMA_SHIFT);
+  void end();
+  static uint32_t bytes(uint32_t window, uint8_t channels); // of begin()
+  void clear(); // window and since begin()
+
+  void add(const int16_t *y); // one sample of every channel
+
+  ytGraphChannelSummary window(uint8_t channel) const; // the last window samples
+  ytGraphChannelSummary total(uint8_t channel) const;  // since begin() or clear()
+  float ema(uint8_t channel) const { return _ch[channel].ema / 256.0f; }
+
+  uint8_t channels() const { return _channels; }
+  uint32_t windowSize() const { return _window; }
+
+private:
+  struct channel
+  {
+    int64_t sum; // window
+    uint64_t sumSq;
+    double mean; // since begin(), Welford
+    double m2;
+    uint32_t n;
+    int16_t min;
+    int16_t max;
+    int32_t ema; // 24.8 fixed point
+  };
+
+  int16_t *_ring; // window values of every channel, channel by channel, shared head
+  uint32_t _window;
+  uint32_t _head;
+  uint32_t _count;
+  uint8_t _channels;
+  uint8_t _emaShift;
+  ytGraphArena *_arena;
+  ytGraphMinMax _minMax[SUMMARY_CHANNELS];
+  channel _ch[SUMMARY_CHANNELS];
+};
+
+// mean of the window as a tick and min..max as a vertical line, one column of SUMMARY_MARK_WIDTH px per
+// channel right of the graph frame, directly on the panel (clears its area first)
+void ytGraphDrawSummaryMarks(TFT_eSPI &d, const ytGraphLayout &cfg, const ytGraphSummary &s, const ytGraphChannel *ch);
+
+// one text line per channel at x/y (text size 1, 8 px per line) in the channel colour, no sprintf:
+// "21.3 +-1.2 19..24" = mean, standard deviation, min..max of the window
+void ytGraphDrawSummaryLegend(TFT_eSPI &d, int16_t x, int16_t y, const ytGraphSummary &s, const ytGraphChannel *ch,
+                              uint16_t bg);
+
+#endif
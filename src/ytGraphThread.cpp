@@ -0,0 +1,152 @@
+/***************************************************************************************
+ * Threading layer for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphThread.h"
+
+#ifdef ARDUINO
+
+ytGraphThread::ytGraphThread() : _running(false), _body(nullptr), _arg(nullptr), _done(xSemaphoreCreateBinary())
+{
+}
+
+ytGraphThread::~ytGraphThread()
+{
+  join();
+  vSemaphoreDelete(_done);
+}
+
+void ytGraphThread::task(void *self)
+{
+  ytGraphThread *t = (ytGraphThread *)self;
+  t->_body(t->_arg);
+  xSemaphoreGive(t->_done);
+  vTaskDelete(NULL); // a FreeRTOS task must not return
+}
+
+bool ytGraphThread::start(ytGraphThreadBody body, void *arg, const char *name, uint8_t core, uint8_t priority)
+{
+  if (_running || !_done)
+    return false;
+  _body = body;
+  _arg = arg;
+  _running = xTaskCreatePinnedToCore(task, name, THREAD_STACK, this, priority, NULL, core) == pdPASS;
+  return _running;
+}
+
+void ytGraphThread::join()
+{
+  if (!_running)
+    return;
+  xSemaphoreTake(_done, portMAX_DELAY);
+  _running = false;
+}
+
+ytGraphSignal::ytGraphSignal() : _sem(xSemaphoreCreateBinary())
+{
+}
+
+ytGraphSignal::~ytGraphSignal()
+{
+  vSemaphoreDelete(_sem);
+}
+
+void ytGraphSignal::give()
+{
+  xSemaphoreGive(_sem);
+}
+
+bool ytGraphSignal::take(uint32_t timeoutMs)
+{
+  return xSemaphoreTake(_sem, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+uint32_t ytGraphNowMs()
+{
+  return millis();
+}
+
+void ytGraphSleepMs(uint32_t ms)
+{
+  vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+#else // host
+
+#include <chrono>
+
+ytGraphThread::ytGraphThread() : _running(false)
+{
+}
+
+ytGraphThread::~ytGraphThread()
+{
+  join();
+}
+
+bool ytGraphThread::start(ytGraphThreadBody body, void *arg, const char *, uint8_t, uint8_t)
+{
+  if (_running)
+    return false;
+  _thread = std::thread(body, arg);
+  _running = true;
+  return true;
+}
+
+void ytGraphThread::join()
+{
+  if (!_running)
+    return;
+  _thread.join();
+  _running = false;
+}
+
+ytGraphSignal::ytGraphSignal() : _given(false)
+{
+}
+
+ytGraphSignal::~ytGraphSignal()
+{
+}
+
+void ytGraphSignal::give()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _given = true;
+  }
+  _cv.notify_one();
+}
+
+bool ytGraphSignal::take(uint32_t timeoutMs)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (!_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return _given; }))
+    return false;
+  _given = false;
+  return true;
+}
+
+uint32_t ytGraphNowMs()
+{
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ytGraphSleepMs(uint32_t ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+#endif
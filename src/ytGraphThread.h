@@ -0,0 +1,85 @@
+/***************************************************************************************
+ * Threading layer for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - ytGraphThread is a FreeRTOS task pinned to a core on the ESP32
+ *    and a std::thread on the host, so the pipeline runs in the benchmarks
+ *  - ytGraphSignal is a binary semaphore (FreeRTOS) or mutex + condition
+ *    variable (host): give() wakes one waiting take()
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_THREAD_h
+#define YTGRAPH_THREAD_h
+
+#include <Arduino.h>
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#else
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#define THREAD_STACK 4096 // bytes, FreeRTOS tasks only
+#define THREAD_PRIORITY 1 // above the idle task, like loop()
+
+typedef void (*ytGraphThreadBody)(void *arg);
+
+class ytGraphThread
+{
+public:
+  ytGraphThread();
+  ~ytGraphThread(); // joins
+
+  // runs body(arg) on core (core and priority are ignored on the host), false if the task could not be created
+  bool start(ytGraphThreadBody body, void *arg, const char *name, uint8_t core, uint8_t priority = THREAD_PRIORITY);
+  void join(); // waits until body() has returned, the body must be told to stop first
+  bool running() const { return _running; }
+
+private:
+  bool _running;
+#ifdef ARDUINO
+  static void task(void *self);
+  ytGraphThreadBody _body;
+  void *_arg;
+  SemaphoreHandle_t _done; // given when the body has returned, a task can not be joined
+#else
+  std::thread _thread;
+#endif
+};
+
+class ytGraphSignal
+{
+public:
+  ytGraphSignal();
+  ~ytGraphSignal();
+
+  void give();                   // wakes one take(), a give() without a waiting take() is kept (not counted)
+  bool take(uint32_t timeoutMs); // false on timeout
+
+private:
+#ifdef ARDUINO
+  SemaphoreHandle_t _sem;
+#else
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _given;
+#endif
+};
+
+uint32_t ytGraphNowMs();          // millis() of the device, a steady clock on the host
+void ytGraphSleepMs(uint32_t ms); // gives the core to other tasks
+
+#endif
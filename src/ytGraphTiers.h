@@ -0,0 +1,183 @@
+/***************************************************************************************
+ * Multi resolution history for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - every raw sample updates the second, minute and hour aggregates (min/max/mean)
+ *  - a finished aggregate is rolled up into the next tier, O(1) per sample
+ *  - each tier is a ring of its own length (memory per tier is a template parameter)
+ *  - switching the view draws from the aggregates, the raw data is never scanned again
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_TIERS_h
+#define YTGRAPH_TIERS_h
+
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+
+#define TIER_SECONDS 0
+#define TIER_MINUTES 1
+#define TIER_HOURS 2
+
+struct ytGraphAggregate // min/max/mean of one channel over one tier interval
+{
+  int16_t min;
+  int16_t max;
+  int64_t sum; // an hour of 100 Hz samples does not fit into 32 bit
+  uint32_t count;
+
+  void add(int16_t v)
+  {
+    if (count == 0 || v < min)
+      min = v;
+    if (count == 0 || v > max)
+      max = v;
+    sum += v;
+    count++;
+  }
+
+  void add(const ytGraphAggregate &a)
+  {
+    if (a.count == 0)
+      return;
+    if (count == 0 || a.min < min)
+      min = a.min;
+    if (count == 0 || a.max > max)
+      max = a.max;
+    sum += a.sum;
+    count += a.count;
+  }
+
+  int16_t mean() const // rounded half away from zero
+  {
+    if (count == 0)
+      return 0;
+    int64_t half = count / 2;
+    return (int16_t)((sum + (sum < 0 ? -half : half)) / (int64_t)count);
+  }
+};
+
+template <uint8_t C>
+struct ytGraphTierSample
+{
+  ytGraphAggregate ch[C];
+};
+
+// C channels, S seconds, M minutes and H hours of history
+template <uint8_t C, uint32_t S, uint32_t M, uint32_t H>
+class ytGraphTiers
+{
+public:
+  explicit ytGraphTiers(uint16_t rawPerSecond = 1) { begin(rawPerSecond); }
+
+  void begin(uint16_t rawPerSecond)
+  {
+    _per[TIER_SECONDS] = rawPerSecond ? rawPerSecond : 1;
+    _per[TIER_MINUTES] = 60;
+    _per[TIER_HOURS] = 60;
+    clear();
+  }
+
+  void clear()
+  {
+    _seconds.clear();
+    _minutes.clear();
+    _hours.clear();
+    for (uint8_t t = 0; t < 3; t++)
+    {
+      _open[t] = ytGraphTierSample<C>{};
+      _fill[t] = 0;
+    }
+  }
+
+  void add(const int16_t *v) // one raw sample of all channels
+  {
+    for (uint8_t c = 0; c < C; c++)
+      _open[TIER_SECONDS].ch[c].add(v[c]);
+    if (++_fill[TIER_SECONDS] < _per[TIER_SECONDS])
+      return;
+
+    // a second is complete, roll it up (and maybe the minute and the hour as well)
+    for (uint8_t t = 0; t < 3; t++)
+    {
+      push(t, _open[t]);
+      bool next = t < 2 && ++_fill[t + 1] >= _per[t + 1];
+      if (t < 2)
+        for (uint8_t c = 0; c < C; c++)
+          _open[t + 1].ch[c].add(_open[t].ch[c]);
+      _open[t] = ytGraphTierSample<C>{};
+      _fill[t] = 0;
+      if (!next)
+        break;
+    }
+  }
+
+  uint32_t size(uint8_t tier) const // finished intervals in the tier
+  {
+    return tier == TIER_SECONDS ? _seconds.size() : tier == TIER_MINUTES ? _minutes.size() : _hours.size();
+  }
+
+  const ytGraphTierSample<C> &at(uint8_t tier, uint32_t i) const // 0 = oldest
+  {
+    return tier == TIER_SECONDS ? _seconds[i] : tier == TIER_MINUTES ? _minutes[i] : _hours[i];
+  }
+
+  const ytGraphTierSample<C> &open(uint8_t tier) const { return _open[tier]; } // interval being filled
+
+  static char timeFormat(uint8_t tier) { return "SMH"[tier < 3 ? tier : 2]; } // for ytGraphFormatTime()
+
+private:
+  void push(uint8_t tier, const ytGraphTierSample<C> &s)
+  {
+    if (tier == TIER_SECONDS)
+      _seconds.push(s);
+    else if (tier == TIER_MINUTES)
+      _minutes.push(s);
+    else
+      _hours.push(s);
+  }
+
+  ytGraphRing<ytGraphTierSample<C>, S> _seconds;
+  ytGraphRing<ytGraphTierSample<C>, M> _minutes;
+  ytGraphRing<ytGraphTierSample<C>, H> _hours;
+  ytGraphTierSample<C> _open[3];
+  uint16_t _fill[3]; // raw samples / seconds / minutes in the open interval
+  uint16_t _per[3];  // raw samples per second, seconds per minute, minutes per hour
+};
+
+// draws the newest SAMPLE_COUNT + 1 intervals of a tier: mean line with min/max spans, one push
+// label the x axis with ytGraphDrawGridXaxis(..., ytGraphTiers::timeFormat(tier)) before
+template <uint8_t C, uint32_t S, uint32_t M, uint32_t H>
+void ytGraphDrawTier(TFT_eSprite &Graph, const ytGraphTiers<C, S, M, H> &t, uint8_t tier, ytGraphChannel *ch, uint8_t channels, bool push = true)
+{
+  uint32_t n = t.size(tier), first = n > SAMPLE_COUNT + 1 ? n - (SAMPLE_COUNT + 1) : 0;
+  for (uint8_t c = 0; c < channels && c < C; c++)
+    for (uint32_t i = first; i < n; i++)
+    {
+      const ytGraphAggregate &a = t.at(tier, i).ch[c];
+      ytGraphColumn col{a.mean(), a.min, a.max, a.mean(), (uint16_t)(a.count ? 1 : 0)};
+      ytGraphDrawColumn(Graph, ytGraphMapX(ytGraphScaleDefault, i - first), col, ch[c]);
+    }
+  if (push)
+    Graph.pushSprite(SPRITE_LEFT_X, SPRITE_UPPER_Y); // left upper position
+}
+
+template <uint8_t C, uint32_t S, uint32_t M, uint32_t H>
+void ytGraphDrawTier(ytGraphCanvas &Graph, const ytGraphTiers<C, S, M, H> &t, uint8_t tier, ytGraphChannel *ch, uint8_t channels)
+{
+  Graph.unwrap(); // drawn with plain sprite coordinates
+  ytGraphDrawTier(Graph.sprite(), t, tier, ch, channels, false);
+  Graph.markAll();
+  Graph.push();
+}
+
+#endif
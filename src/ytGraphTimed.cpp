@@ -0,0 +1,141 @@
+/***************************************************************************************
+ * Timestamped samples for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#include "ytGraphTimed.h"
+
+ytGraphTimeView ytGraphTimeViewInit(const ytGraphLayout &cfg, uint32_t start, uint32_t span, uint32_t gap, uint32_t div)
+{
+  ytGraphTimeView v;
+  v.start = start;
+  v.span = span;
+  v.gap = gap;
+  v.div = div;
+  ytGraphScaleFactor(span > 0 ? (double)cfg.width / span : 0.0, v.xMul, v.xShift);
+  return v;
+}
+
+int16_t ytGraphTimeX(const ytGraphTimeView &v, uint32_t t)
+{
+  // like ytGraphMapX(), the time before start is mirrored
+  uint32_t dt = t >= v.start ? t - v.start : v.start - t;
+  uint64_t x = ((uint64_t)dt * v.xMul) >> v.xShift;
+  if (x > 32767)
+    x = 32767;
+  return t >= v.start ? (int16_t)x : -(int16_t)x;
+}
+
+uint32_t ytGraphTimedRuns::lowerBound(uint32_t time) const
+{
+  uint32_t lo = 0, hi = n;
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (this->time(mid) < time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+uint32_t ytGraphTimedRuns::upperBound(uint32_t time) const
+{
+  uint32_t lo = 0, hi = n;
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (this->time(mid) <= time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+uint32_t ytGraphTimedRuns::lowerBoundX(const ytGraphTimeView &v, int16_t x) const
+{
+  // by column, not by time: the inverse of ytGraphTimeX() would round differently
+  uint32_t lo = 0, hi = n;
+  while (lo < hi)
+  {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (ytGraphTimeX(v, this->time(mid)) < x)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+bool ytGraphDrawTimed(TFT_eSprite &Graph, const ytGraphLayout &cfg, const ytGraphTimeView &v, const ytGraphTimedRuns &s,
+                      const uint16_t *colors, int16_t &x0, int16_t &x1, uint8_t width)
+{
+  ytGraphSpanTarget t;
+  if (!ytGraphSpanBegin(Graph, t))
+    return false;
+  if (x0 < 0)
+    x0 = 0;
+  if (x1 > t.width - 1)
+    x1 = t.width - 1;
+  if (t.bpp == 4)
+    x0 &= ~1; // the columns start on a byte
+  if (x0 > x1)
+    return false;
+  int16_t w = x1 - x0 + 1;
+
+  Graph.fillRect(x0, 0, w, t.height, cfg.bgrndColor);
+  ytGraphDrawGridY(Graph, cfg, x0, w);
+  if (v.div)
+  {
+    for (uint32_t m = (v.start + v.div - 1) / v.div * v.div; m - v.start <= v.span; m += v.div)
+    {
+      int16_t x = ytGraphTimeX(v, m);
+      if (x > x1)
+        break;
+      if (x >= x0)
+        Graph.drawFastVLine(x, 0, cfg.height, cfg.gridColor);
+    }
+  }
+  if (!s.n)
+    return true;
+
+  // the columns x0..x1 as a sprite of their own: every segment is clipped to them
+  ytGraphSpanTarget sub = t;
+  sub.img += t.bpp == 4 ? x0 / 2 : x0 * 2;
+  sub.width = w;
+
+  // the segments that cross the columns: from the last sample left of x0 to the first one right of x1
+  uint32_t a = s.lowerBoundX(v, x0), b = s.lowerBoundX(v, x1 + 1);
+  a = a ? a - 1 : 0;
+  b = b < s.n ? b : s.n - 1;
+  uint8_t channels = s.channels < SPAN_CHANNELS ? s.channels : SPAN_CHANNELS;
+  for (uint8_t c = 0; c < channels; c++)
+  {
+    uint16_t pixel = ytGraphSpanPixel(Graph, t, colors[c]);
+    int16_t ox = 0, oy = 0;
+    for (uint32_t i = a; i <= b; i++)
+    {
+      int16_t px = ytGraphTimeX(v, s.time(i)) - x0, py = ytGraphMapY(cfg.scale, s.value(c, i));
+      bool gap = i == 0 || (v.gap && s.time(i) - s.time(i - 1) > v.gap);
+      if (gap) // a new line starts, a single sample stays visible as a dot
+        ytGraphSpanSegment(sub, px, py, px, py, pixel, width);
+      else if (i > a) // the segment from the sample before
+        ytGraphSpanSegment(sub, ox, oy, px, py, pixel, width);
+      ox = px;
+      oy = py;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,223 @@
+/***************************************************************************************
+ * Timestamped samples for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - ytGraphTimeSeries keeps every sample with its time (ms, or any unit), sorted
+ *    by time, one contiguous array per channel like ytGraphChannelStore
+ *  - the samples are drawn at their true time position, not at their index:
+ *    a missed reading leaves a longer segment, a pause longer than the gap of the
+ *    view breaks the line
+ *  - the visible window (and the samples of a column range) is found by binary
+ *    search, O(log n) instead of a scan over the history
+ *  - a late batch is merged in one backward pass (O(n + k), no heap), then only
+ *    the columns between the samples around the batch are redrawn
+ *  - the lines are drawn with the span rasterizer (4 or 16 bit sprites)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_TIMED_h
+#define YTGRAPH_TIMED_h
+
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+#include "ytGraphSpan.h"
+
+struct ytGraphTimeView // the visible time window of a timestamped graph
+{
+  uint32_t start; // time at x = 0, start + span is at x = width
+  uint32_t span;
+  uint32_t gap;   // a longer pause between two samples breaks the line, 0 = never
+  uint32_t div;   // a vertical grid line at every multiple of div, 0 = none
+  uint32_t xMul;  // time -> px as fixed point number (see ytGraphScale)
+  uint8_t xShift;
+};
+
+ytGraphTimeView ytGraphTimeViewInit(const ytGraphLayout &cfg, uint32_t start, uint32_t span, uint32_t gap = 0, uint32_t div = 0);
+
+// sprite column of time t, left of 0 before start (clamped to +-32767)
+int16_t ytGraphTimeX(const ytGraphTimeView &v, uint32_t t);
+
+struct ytGraphTimedRuns // the samples of a ytGraphTimeSeries as (at most) two runs, oldest first
+{
+  const uint32_t *t[2];
+  const int16_t *y[2][SPAN_CHANNELS];
+  uint32_t split; // first sample of the second run
+  uint32_t n;
+  uint8_t channels;
+
+  uint32_t time(uint32_t i) const { return i < split ? t[0][i] : t[1][i - split]; }
+  int16_t value(uint8_t c, uint32_t i) const { return i < split ? y[0][c][i] : y[1][c][i - split]; }
+
+  uint32_t lowerBound(uint32_t time) const; // first sample at or after time, n if none (binary search)
+  uint32_t upperBound(uint32_t time) const; // first sample after time
+  uint32_t lowerBoundX(const ytGraphTimeView &v, int16_t x) const; // first sample at or right of column x
+};
+
+template <uint8_t C, uint32_t N>
+class ytGraphTimeSeries
+{
+  static_assert(C > 0 && C <= SPAN_CHANNELS, "ytGraphTimeSeries holds 1 to 16 channels");
+  static_assert(N > 0, "ytGraphTimeSeries needs at least one slot");
+
+public:
+  ytGraphTimeSeries() : _head(0), _count(0), _t{}, _y{} {}
+
+  void clear()
+  {
+    _head = 0;
+    _count = 0;
+  }
+
+  // one sample of every channel at time t, in time order O(1), a late one is merged in
+  void push(uint32_t t, const int16_t *y)
+  {
+    if (_count && t < newestTime())
+    {
+      merge(&t, y, 1);
+      return;
+    }
+    _t[_head] = t;
+    for (uint8_t c = 0; c < C; c++)
+      _y[c][_head] = y[c];
+    if (++_head == N)
+      _head = 0;
+    if (_count < N)
+      _count++;
+  }
+
+  // k samples sorted by time, y[i * C + c] is channel c of sample i, merged in one backward pass
+  // if the store overflows, the oldest samples of both are dropped, returns their number
+  uint32_t merge(const uint32_t *t, const int16_t *y, uint32_t k)
+  {
+    // drop the oldest of old and new samples first, then the result fits without overwriting unread samples
+    uint32_t dropped = 0, b = 0;
+    while (_count + (k - b) > N)
+    {
+      if (b < k && (!_count || t[b] < _t[slot(0)]))
+        b++;
+      else
+        _count--;
+      dropped++;
+    }
+    uint32_t base = _head + N - _count; // physical slot of sample 0 is base % N, also after the merge
+    uint32_t total = _count + (k - b);
+    int32_t i = (int32_t)_count - 1, j = (int32_t)k - 1;
+    for (uint32_t w = total; w-- > 0;)
+    {
+      uint32_t s = (base + w) % N;
+      if (j >= (int32_t)b && (i < 0 || t[j] >= _t[(base + i) % N])) // equal times: the new one after the old one
+      {
+        _t[s] = t[j];
+        for (uint8_t c = 0; c < C; c++)
+          _y[c][s] = y[j * C + c];
+        j--;
+      }
+      else
+      {
+        uint32_t r = (base + i) % N;
+        _t[s] = _t[r];
+        for (uint8_t c = 0; c < C; c++)
+          _y[c][s] = _y[c][r];
+        i--;
+      }
+    }
+    _count = total;
+    _head = (base + total) % N;
+    return dropped;
+  }
+
+  uint32_t time(uint32_t i) const { return _t[slot(i)]; } // 0 = oldest
+  int16_t value(uint8_t channel, uint32_t i) const { return _y[channel][slot(i)]; }
+  uint32_t newestTime() const { return _t[_head ? _head - 1 : N - 1]; }
+
+  ytGraphTimedRuns runs() const
+  {
+    ytGraphTimedRuns r;
+    uint32_t start = slot(0);
+    r.n = _count;
+    r.channels = C;
+    r.split = start + _count <= N ? _count : N - start;
+    r.t[0] = &_t[start];
+    r.t[1] = _t;
+    for (uint8_t c = 0; c < C; c++)
+    {
+      r.y[0][c] = &_y[c][start];
+      r.y[1][c] = _y[c];
+    }
+    return r;
+  }
+
+  uint32_t lowerBound(uint32_t t) const { return runs().lowerBound(t); } // first sample at or after t
+
+  uint32_t size() const { return _count; }
+  static constexpr uint32_t capacity() { return N; }
+  static constexpr uint8_t channels() { return C; }
+  bool empty() const { return _count == 0; }
+
+private:
+  uint32_t slot(uint32_t i) const
+  {
+    uint32_t s = _head + N - _count + i; // always < 2N
+    if (s >= N)
+      s -= N;
+    return s;
+  }
+
+  uint32_t _head;
+  uint32_t _count;
+  uint32_t _t[N];
+  int16_t _y[C][N];
+};
+
+// redraws the sprite columns x0..x1: background, grid and every segment that crosses them, no push
+// x0/x1 return the columns that were drawn (4 bit sprites start on an even column)
+// false if the sprite cannot be used by the span rasterizer (1 bit) or no column is inside
+bool ytGraphDrawTimed(TFT_eSprite &Graph, const ytGraphLayout &cfg, const ytGraphTimeView &v, const ytGraphTimedRuns &s,
+                      const uint16_t *colors, int16_t &x0, int16_t &x1, uint8_t width = SPAN_WIDTH);
+
+// the whole page of the view
+template <uint8_t C, uint32_t N>
+void ytGraphDrawTimed(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphTimeView &v,
+                      const ytGraphTimeSeries<C, N> &s, const uint16_t *colors, uint8_t width = SPAN_WIDTH)
+{
+  int16_t x0 = 0, x1 = cfg.spriteWidth() - 1;
+  Graph.unwrap(); // drawn with plain sprite coordinates
+  if (ytGraphDrawTimed(Graph.sprite(), cfg, v, s.runs(), colors, x0, x1, width))
+    Graph.markDirty(x0, 0, x1 - x0 + 1, cfg.spriteHeight());
+}
+
+// merges a late batch (see ytGraphTimeSeries::merge()) and redraws only the columns between
+// the samples around it, returns the number of redrawn columns
+template <uint8_t C, uint32_t N>
+int16_t ytGraphMergeTimed(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphTimeView &v,
+                          ytGraphTimeSeries<C, N> &s, const uint16_t *colors, const uint32_t *t, const int16_t *y,
+                          uint32_t k, uint8_t width = SPAN_WIDTH)
+{
+  if (!k)
+    return 0;
+  uint32_t dropped = s.merge(t, y, k);
+  ytGraphTimedRuns r = s.runs();
+  if (!r.n)
+    return 0;
+  uint32_t lo = r.lowerBound(t[0]), hi = r.upperBound(t[k - 1]);
+  lo = lo ? lo - 1 : 0;                // the segment into the batch
+  hi = hi < r.n ? hi : r.n - 1;        // and the one out of it
+  int16_t x0 = dropped ? 0 : ytGraphTimeX(v, r.time(lo)); // the oldest samples went away
+  int16_t x1 = ytGraphTimeX(v, r.time(hi));
+  Graph.unwrap();
+  if (!ytGraphDrawTimed(Graph.sprite(), cfg, v, r, colors, x0, x1, width))
+    return 0;
+  Graph.markDirty(x0, 0, x1 - x0 + 1, cfg.spriteHeight());
+  return x1 - x0 + 1;
+}
+
+#endif
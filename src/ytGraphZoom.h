@@ -0,0 +1,178 @@
+/***************************************************************************************
+ * Zoom and pan over a long history for the ytGraph function set
+ * Platform: Arduino / ESP
+ *
+ *  - the raw samples of every channel are the leaves of a min/max segment tree,
+ *    the inner nodes keep min and max of their subtree (N - 1 of each per channel)
+ *  - push() overwrites the oldest leaf and updates its path to the root, O(log N)
+ *  - range() answers min/max of the samples [from, to) in O(log N), so a view of
+ *    any zoom level costs O(GRAPH_WIDTH * log N) instead of a scan of the samples
+ *  - samples are numbered since clear(), the view pans by changing the first
+ *    sample number and zooms by changing the number of samples per page
+ *  - memory: 6 bytes per sample and channel (raw value, min and max of the nodes)
+ *
+ * Armin Pressler 2021
+ * https://github.com/ArminPP/ytGraph
+ *
+ *
+ *
+ * MIT License
+ *
+ * Changelog:
+ * v0.6   initial version
+****************************************************************************************/
+
+#ifndef YTGRAPH_ZOOM_h
+#define YTGRAPH_ZOOM_h
+
+#include "ytGraph.h"
+#include "ytGraphCanvas.h"
+
+// C channels, N samples (power of 2) of history
+template <uint8_t C, uint32_t N>
+class ytGraphZoomTree
+{
+  static_assert(C > 0, "ytGraphZoomTree needs at least one channel");
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ytGraphZoomTree needs a power of 2 samples");
+
+public:
+  ytGraphZoomTree() : _next(0), _count(0), _y{}, _min{}, _max{} {}
+
+  void clear() // the nodes are not touched, a query never reaches a subtree without samples
+  {
+    _next = 0;
+    _count = 0;
+  }
+
+  void push(const int16_t *y) // one sample of every channel, overwrites the oldest one if full
+  {
+    uint32_t s = _next % N;
+    for (uint8_t c = 0; c < C; c++)
+    {
+      _y[c][s] = y[c];
+      for (uint32_t p = (s + N) >> 1; p; p >>= 1)
+      {
+        int16_t a = lo(c, 2 * p), b = lo(c, 2 * p + 1);
+        _min[c][p] = a < b ? a : b;
+        a = hi(c, 2 * p);
+        b = hi(c, 2 * p + 1);
+        _max[c][p] = a > b ? a : b;
+      }
+    }
+    _next++;
+    if (_count < N)
+      _count++;
+  }
+
+  uint32_t next() const { return _next; }           // number of the next sample
+  uint32_t oldest() const { return _next - _count; } // number of the oldest stored sample
+  uint32_t size() const { return _count; }
+  static constexpr uint32_t capacity() { return N; }
+  static constexpr uint8_t channels() { return C; }
+  bool empty() const { return _count == 0; }
+
+  int16_t value(uint8_t channel, uint32_t n) const { return _y[channel][n % N]; } // by sample number
+
+  // first/min/max/last of the samples [from, to) of a channel, clipped to the stored ones, count 0 if none
+  ytGraphColumn range(uint8_t channel, uint32_t from, uint32_t to) const
+  {
+    ytGraphColumn col{0, 0, 0, 0, 0};
+    if (from < oldest())
+      from = oldest();
+    if (to > _next)
+      to = _next;
+    if (from >= to)
+      return col;
+    col.first = value(channel, from);
+    col.last = value(channel, to - 1);
+    col.min = INT16_MAX;
+    col.max = INT16_MIN;
+    col.count = to - from > 0xFFFF ? 0xFFFF : (uint16_t)(to - from);
+    uint32_t l = from % N, r = l + (to - from); // at most two runs of slots
+    if (r > N)
+    {
+      query(channel, l, N, col);
+      query(channel, 0, r - N, col);
+    }
+    else
+      query(channel, l, r, col);
+    return col;
+  }
+
+  // clips a view of count samples starting at first to the stored ones (count is kept if possible)
+  void window(uint32_t &first, uint32_t &count) const
+  {
+    if (count > _count)
+      count = _count;
+    if (first < oldest())
+      first = oldest();
+    if (first > _next - count)
+      first = _next - count;
+  }
+
+private:
+  int16_t lo(uint8_t c, uint32_t node) const { return node >= N ? _y[c][node - N] : _min[c][node]; }
+  int16_t hi(uint8_t c, uint32_t node) const { return node >= N ? _y[c][node - N] : _max[c][node]; }
+
+  void query(uint8_t c, uint32_t l, uint32_t r, ytGraphColumn &col) const // slots [l, r), bottom up
+  {
+    for (l += N, r += N; l < r; l >>= 1, r >>= 1)
+    {
+      if (l & 1)
+        take(c, l++, col);
+      if (r & 1)
+        take(c, --r, col);
+    }
+  }
+
+  void take(uint8_t c, uint32_t node, ytGraphColumn &col) const
+  {
+    int16_t a = lo(c, node), b = hi(c, node);
+    if (a < col.min)
+      col.min = a;
+    if (b > col.max)
+      col.max = b;
+  }
+
+  uint32_t _next;  // samples pushed since clear()
+  uint32_t _count; // stored samples
+  int16_t _y[C][N];   // the leaves, sample n is in slot n % N
+  int16_t _min[C][N]; // inner nodes 1..N - 1, node p has the children 2p and 2p + 1
+  int16_t _max[C][N];
+};
+
+// the samples [first, first + count) over the whole graph width of cfg, one min/max column per pixel column
+// (clipped to the history with window()), zoomed in further than one sample per column the line
+// connects the samples, draw the grid before
+template <uint8_t C, uint32_t N>
+void ytGraphDrawZoom(TFT_eSprite &Graph, const ytGraphLayout &cfg, const ytGraphZoomTree<C, N> &h, uint32_t first,
+                     uint32_t count, ytGraphChannel *ch, uint8_t channels, bool push = true)
+{
+  h.window(first, count);
+  if (count)
+  {
+    const uint32_t columns = cfg.width + 1; // x = 0 .. width
+    for (uint8_t c = 0; c < channels && c < C; c++)
+      for (uint32_t x = 0, from = first; x < columns; x++)
+      {
+        // column x holds the samples [ceil(x * count / columns), ceil((x + 1) * count / columns)), column 0 is never empty
+        uint32_t to = first + (uint32_t)(((uint64_t)(x + 1) * count + columns - 1) / columns);
+        ytGraphDrawColumn(Graph, cfg.scale, (int16_t)x, h.range(c, from, to), ch[c]);
+        from = to;
+      }
+  }
+  if (push)
+    Graph.pushSprite(cfg.spriteX(), cfg.spriteY()); // left upper position
+}
+
+template <uint8_t C, uint32_t N>
+void ytGraphDrawZoom(ytGraphCanvas &Graph, const ytGraphLayout &cfg, const ytGraphZoomTree<C, N> &h, uint32_t first,
+                     uint32_t count, ytGraphChannel *ch, uint8_t channels)
+{
+  Graph.unwrap(); // drawn with plain sprite coordinates
+  ytGraphDrawZoom(Graph.sprite(), cfg, h, first, count, ch, channels, false);
+  Graph.markAll();
+  Graph.push();
+}
+
+#endif